@@ -4,18 +4,19 @@
 #define HAVE_ARPA_INET_H 1
 #define HAVE_CRYPT_H 1
 #define HAVE_DIRENT_H 1
-/* #undef HAVE_EXECINFO_H */
+#define HAVE_EXECINFO_H 1
 #define HAVE_FCNTL_H 1
 #define HAVE_FENV_H 1
 #define HAVE_FLOAT_H 1
 /* #undef HAVE_FPU_CONTROL_H */
 #define HAVE_GRP_H 1
-#define HAVE_IEEEFP_H 1
+/* #undef HAVE_IEEEFP_H */
 #define HAVE_LIMITS_H 1
+#define HAVE_LINUX_FUTEX_H 1
 #define HAVE_MALLOC_H 1
 #define HAVE_MEMORY_H 1
 #define HAVE_NETINET_IN_H 1
-/* #undef HAVE_PATHS_H */
+#define HAVE_PATHS_H 1
 #define HAVE_PWD_H 1
 #define HAVE_SCHED_H 1
 /* #undef HAVE_SELECT_H */
@@ -23,18 +24,19 @@
 #define HAVE_STDLIB_H 1
 #define HAVE_STRINGS_H 1
 #define HAVE_STRING_H 1
-#define HAVE_SYNCH_H 1
+/* #undef HAVE_SYNCH_H */
 /* #undef HAVE_SYSENT_H */
 /* #undef HAVE_SYS_FPU_H */
 #define HAVE_SYS_IOCTL_H 1
 #define HAVE_SYS_IPC_H 1
 #define HAVE_SYS_MMAN_H 1
-/* #undef HAVE_SYS_PRCTL_H */
+#define HAVE_SYS_PRCTL_H 1
 #define HAVE_SYS_SELECT_H 1
+#define HAVE_SYS_SENDFILE_H 1
 #define HAVE_SYS_SHM_H 1
 #define HAVE_SYS_SOCKET_H 1
 #define HAVE_SYS_STAT_H 1
-#define HAVE_SYS_STREAM_H 1
+/* #undef HAVE_SYS_STREAM_H */
 #define HAVE_SYS_TIMEB_H 1
 #define HAVE_SYS_TYPES_H 1
 #define HAVE_SYS_UN_H 1
@@ -52,29 +54,29 @@
 /* #undef HAVE_BFILL */
 /* #undef HAVE_BMOVE */
 #define HAVE_BZERO 1
-/* #undef HAVE_CLOCK_GETTIME */
+#define HAVE_CLOCK_GETTIME 1
 /* #undef HAVE_COMPRESS */
-#define HAVE_CRYPT 1
+/* #undef HAVE_CRYPT */
 #define HAVE_DLERROR 1
 #define HAVE_DLOPEN 1
 #define HAVE_FCHMOD 1
 #define HAVE_FCNTL 1
-#define HAVE_FCONVERT 1
-/* #undef HAVE_FDATASYNC */
+/* #undef HAVE_FCONVERT */
+#define HAVE_FDATASYNC 1
 /* #undef HAVE_FESETROUND */
 #define HAVE_FINITE 1
 /* #undef HAVE_FP_EXCEPT */
 #define HAVE_FSEEKO 1
 #define HAVE_FSYNC 1
-/* #undef HAVE_GETADDRINFO */
+#define HAVE_GETADDRINFO 1
 #define HAVE_GETCWD 1
-/* #undef HAVE_GETHOSTBYADDR_R */
-/* #undef HAVE_GETHOSTBYNAME_R */
-#define HAVE_GETHRTIME 1
-/* #undef HAVE_GETNAMEINFO */
+#define HAVE_GETHOSTBYADDR_R 1
+#define HAVE_GETHOSTBYNAME_R 1
+/* #undef HAVE_GETHRTIME */
+#define HAVE_GETNAMEINFO 1
 #define HAVE_GETPAGESIZE 1
 #define HAVE_GETPASS 1
-#define HAVE_GETPASSPHRASE 1
+/* #undef HAVE_GETPASSPHRASE */
 #define HAVE_GETPWNAM 1
 #define HAVE_GETPWUID 1
 #define HAVE_GETRLIMIT 1
@@ -90,7 +92,7 @@
 #define HAVE_LSTAT 1
 #define HAVE_MADVISE 1
 #define HAVE_DECL_MADVISE 1
-/* #undef HAVE_MALLINFO */
+#define HAVE_MALLINFO 1
 #define HAVE_MEMCPY 1
 #define HAVE_MEMCPY 1
 #define HAVE_MEMMOVE 1
@@ -102,6 +104,7 @@
 #define HAVE_MMAP64 1
 #define HAVE_PERROR 1
 #define HAVE_POLL 1
+#define HAVE_POSIX_FADVISE 1
 #define HAVE_PREAD 1
 /* #undef HAVE_PTHREAD_ATTR_CREATE */
 #define HAVE_PTHREAD_ATTR_GETSTACKSIZE 1
@@ -125,8 +128,9 @@
 #define HAVE_REALPATH 1
 #define HAVE_RENAME 1
 #define HAVE_RINT 1
-/* #undef HAVE_SCHED_YIELD */
+#define HAVE_SCHED_YIELD 1
 #define HAVE_SELECT 1
+#define HAVE_SENDFILE 1
 /* #undef HAVE_SETFD */
 /* #undef HAVE_SETFILEPOINTER */
 #define HAVE_SIGACTION 1
@@ -134,12 +138,12 @@
 #define HAVE_SIGWAIT 1
 #define HAVE_SLEEP 1
 #define HAVE_SNPRINTF 1
-/* #undef HAVE_STPCPY */
+#define HAVE_STPCPY 1
 #define HAVE_STRERROR 1
-#define HAVE_STRLCPY 1
-/* #undef HAVE_STRNLEN */
+/* #undef HAVE_STRLCPY */
+#define HAVE_STRNLEN 1
 #define HAVE_STRPBRK 1
-/* #undef HAVE_STRSEP */
+#define HAVE_STRSEP 1
 #define HAVE_STRSTR 1
 #define HAVE_STRTOK_R 1
 #define HAVE_STRTOK_R 1
@@ -147,10 +151,10 @@
 #define HAVE_STRTOLL 1
 #define HAVE_STRTOUL 1
 #define HAVE_STRTOULL 1
-#define HAVE_TELL 1
-#define HAVE_THR_SETCONCURRENCY 1
-#define HAVE_THR_YIELD 1
-/* #undef HAVE_VASPRINTF */
+/* #undef HAVE_TELL */
+/* #undef HAVE_THR_SETCONCURRENCY */
+/* #undef HAVE_THR_YIELD */
+#define HAVE_VASPRINTF 1
 #define HAVE_VSNPRINTF 1
 
 /* Symbols we may use */
@@ -167,7 +171,7 @@
 # define HAVE_CHAR 1
 #endif
 
-#define SIZEOF_CHARP 4
+#define SIZEOF_CHARP 8
 #if SIZEOF_CHARP
 # define HAVE_CHARP 1
 #endif
@@ -182,7 +186,7 @@
 # define HAVE_INT 1
 #endif
 
-#define SIZEOF_LONG 4
+#define SIZEOF_LONG 8
 #if SIZEOF_LONG
 # define HAVE_LONG 1
 #endif
@@ -192,17 +196,17 @@
 # define HAVE_LONG_LONG 1
 #endif
 
-#define SIZEOF_OFF_T 4
+#define SIZEOF_OFF_T 8
 #if SIZEOF_OFF_T
 # define HAVE_OFF_T 1
 #endif
 
-#define SIZEOF_SIGSET_T 16
+#define SIZEOF_SIGSET_T 128
 #if SIZEOF_SIGSET_T
 # define HAVE_SIGSET_T 1
 #endif
 
-#define SIZEOF_SIZE_T 4
+#define SIZEOF_SIZE_T 8
 #if SIZEOF_SIZE_T
 # define HAVE_SIZE_T 1
 #endif
@@ -217,7 +221,7 @@
 # define HAVE_UINT 1
 #endif
 
-#define SIZEOF_ULONG 4
+#define SIZEOF_ULONG 8
 #if SIZEOF_ULONG
 # define HAVE_ULONG 1
 #endif
@@ -276,7 +280,7 @@
 #define SIGNAL_RETURN_TYPE_IS_VOID 1
 #define RETSIGTYPE void
 
-#define WORDS_BIGENDIAN 1
+/* #undef WORDS_BIGENDIAN */
 
 /* Define to `__inline__' or `__inline' if that's what the C compiler calls
    it, or to nothing if 'inline' is not supported under any name.  */
@@ -29,6 +29,8 @@ extern "C" {
 
 /* flags for hash_init */
 #define HASH_UNIQUE     1       /* hash_insert fails on duplicate key */
+#define HASH_OPEN       2       /* open addressing with probed slot groups */
+#define HASH_BINARY     4       /* my_hash_bytes(), for byte compared keys */
 
 typedef uchar *(*my_hash_get_key)(const uchar *,size_t*,my_bool);
 typedef void (*my_hash_free_key)(void *);
@@ -36,16 +38,18 @@ typedef my_bool (*my_hash_walk_action)(void *,void *);
 
 typedef struct st_hash {
   size_t key_offset,key_length;		/* Length of key if const length */
-  size_t blength;
+  size_t blength;                       /* Slots if HASH_OPEN */
   ulong records;
   uint flags;
   DYNAMIC_ARRAY array;				/* Place for hash_keys */
   my_hash_get_key get_key;
   void (*free)(void *);
   CHARSET_INFO *charset;
+  uchar *ctrl;                          /* HASH_OPEN: control bytes, slots */
+  size_t growth_left;                   /* HASH_OPEN: empty slots to fill */
 } HASH;
 
-/* A search iterator state */
+/* A search iterator state, the slot of the record with HASH_OPEN */
 typedef uint HASH_SEARCH_STATE;
 
 #define my_hash_init(A,B,C,D,E,F,G,H) \
@@ -72,6 +76,7 @@ my_bool my_hash_update(HASH *hash, uchar *record, uchar *old_key,
 void my_hash_replace(HASH *hash, HASH_SEARCH_STATE *state, uchar *new_row);
 my_bool my_hash_check(HASH *hash); /* Only in debug library */
 my_bool my_hash_iterate(HASH *hash, my_hash_walk_action action, void *argument);
+ulonglong my_hash_bytes(const uchar *key, size_t length, ulonglong seed);
 
 #define my_hash_clear(H) bzero((char*) (H), sizeof(*(H)))
 #define my_hash_inited(H) ((H)->array.buffer != 0)
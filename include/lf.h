@@ -90,6 +90,9 @@ nolock_wrap(lf_dynarray_iterate, int,
 
 /*
   pin manager for memory allocator, lf_alloc-pin.c
+
+  it can also reclaim memory by epochs instead of pins, see
+  lf_alloc_use_epochs() and _lf_epoch_enter()
 */
 
 #define LF_PINBOX_PINS 4
@@ -104,6 +107,8 @@ typedef struct {
   uint free_ptr_offset;
   uint32 volatile pinstack_top_ver;         /* this is a versioned pointer */
   uint32 volatile pins_in_array;            /* number of elements in array */
+  uint32 volatile pin_retries;              /* pointers changed when pinned */
+  uint32 volatile epoch;                    /* 0 if pins are used */
 } LF_PINBOX;
 
 typedef struct {
@@ -111,11 +116,18 @@ typedef struct {
   LF_PINBOX *pinbox;
   void  **stack_ends_here;
   void  *purgatory;
+  void  *limbo;                         /* purgatory waiting for an epoch */
   uint32 purgatory_count;
   uint32 volatile link;
-/* we want sizeof(LF_PINS) to be 64 to avoid false sharing */
-#if SIZEOF_INT*2+SIZEOF_CHARP*(LF_PINBOX_PINS+3) != 64
-  char pad[64-sizeof(uint32)*2-sizeof(void*)*(LF_PINBOX_PINS+3)];
+  uint32 volatile epoch;                /* 0 or the epoch that was entered */
+  uint32 epoch_depth;                   /* nested _lf_epoch_enter() calls */
+  uint32 limbo_epoch, limbo_count;
+  uint32 search_epoch;                  /* lf_hash_search() holds an epoch */
+/* we want sizeof(LF_PINS) to be a multiple of 64 to avoid false sharing */
+#define LF_PINS_USED (SIZEOF_INT*7+SIZEOF_CHARP*(LF_PINBOX_PINS+4))
+#define LF_PINS_SIZE (LF_PINS_USED > 64 ? 128 : 64)
+#if LF_PINS_USED != LF_PINS_SIZE
+  char pad[LF_PINS_SIZE-LF_PINS_USED];
 #endif
 } LF_PINS;
 
@@ -141,11 +153,14 @@ typedef struct {
 #define _lf_pin(PINS, PIN, ADDR)                                \
   (                                                             \
     assert(PIN < LF_NUM_PINS_IN_THIS_FILE),                     \
+    (PINS)->epoch_depth ? (void) 0 :                            \
     my_atomic_storeptr(&(PINS)->pin[PIN], (ADDR))               \
   )
 #else
 #define LF_REQUIRE_PINS(N)
-#define _lf_pin(PINS, PIN, ADDR)  my_atomic_storeptr(&(PINS)->pin[PIN], (ADDR))
+#define _lf_pin(PINS, PIN, ADDR)                                \
+  ((PINS)->epoch_depth ? (void) 0 :                             \
+   my_atomic_storeptr(&(PINS)->pin[PIN], (ADDR)))
 #endif
 
 #define _lf_unpin(PINS, PIN)      _lf_pin(PINS, PIN, NULL)
@@ -156,9 +171,28 @@ typedef struct {
     lf_rwunlock_by_pins(PINS);    \
   } while (0)
 #define lf_unpin(PINS, PIN)  lf_pin(PINS, PIN, NULL)
-#define _lf_assert_pin(PINS, PIN) assert((PINS)->pin[PIN] != 0)
+#define _lf_assert_pin(PINS, PIN) \
+  assert((PINS)->epoch_depth || (PINS)->pin[PIN] != 0)
 #define _lf_assert_unpin(PINS, PIN) assert((PINS)->pin[PIN] == 0)
 
+/*
+  critical section of the epoch based reclamation: nothing that is freed
+  after _lf_epoch_enter() is reused before the matching _lf_epoch_leave(),
+  and _lf_pin() does nothing in between. they nest, and do nothing if
+  the pinbox uses pins
+*/
+#define _lf_epoch_enter(PINS)                                   \
+  do {                                                          \
+    if ((PINS)->pinbox->epoch && !(PINS)->epoch_depth++)        \
+      my_atomic_store32((int32 volatile *) &(PINS)->epoch,      \
+                        (PINS)->pinbox->epoch);                 \
+  } while (0)
+#define _lf_epoch_leave(PINS)                                   \
+  do {                                                          \
+    if ((PINS)->epoch_depth && !--(PINS)->epoch_depth)          \
+      my_atomic_store32((int32 volatile *) &(PINS)->epoch, 0);  \
+  } while (0)
+
 void lf_pinbox_init(LF_PINBOX *pinbox, uint free_ptr_offset,
                     lf_pinbox_free_func *free_func, void * free_func_arg);
 void lf_pinbox_destroy(LF_PINBOX *pinbox);
@@ -203,18 +237,52 @@ uint lf_alloc_pool_count(LF_ALLOCATOR *allocator);
 #define _lf_alloc_put_pins(PINS)      _lf_pinbox_put_pins(PINS)
 #define lf_alloc_put_pins(PINS)        lf_pinbox_put_pins(PINS)
 #define lf_alloc_direct_free(ALLOC, ADDR) my_free((uchar*)(ADDR), MYF(0))
+/* switch to epochs, before the allocator is used */
+#define lf_alloc_use_epochs(A)         ((A)->pinbox.epoch= 1)
 
 lock_wrap(lf_alloc_new, void *,
           (LF_PINS *pins),
           (pins),
           &pins->pinbox->pinarray.lock)
 
+/*
+  bounded multi-producer multi-consumer queue, lf_queue.c
+*/
+
+typedef struct st_lf_queue {
+  uchar *cells;                         /* sequence number + element each */
+  uint32 mask;                          /* number of cells - 1 */
+  uint element_size, cell_size;
+  my_atomic_rwlock_t lock;
+  /* the two ends are written by different threads, keep them apart */
+  char pad1[64];
+  uint32 volatile push_pos;             /* next cell to push to */
+  char pad2[64-sizeof(uint32)];
+  uint32 volatile pop_pos;              /* next cell to pop from */
+  char pad3[64-sizeof(uint32)];
+  uint32 volatile push_waiters, pop_waiters; /* in lf_queue_*_wait() */
+  uint32 volatile push_event, pop_event;     /* waited on, see lf_queue.c */
+#ifndef HAVE_LINUX_FUTEX_H
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+#endif
+} LF_QUEUE;
+
+my_bool lf_queue_init(LF_QUEUE *queue, uint element_size, uint max_elements);
+void lf_queue_destroy(LF_QUEUE *queue);
+int lf_queue_push(LF_QUEUE *queue, const void *element);
+int lf_queue_pop(LF_QUEUE *queue, void *element);
+void lf_queue_push_wait(LF_QUEUE *queue, const void *element);
+void lf_queue_pop_wait(LF_QUEUE *queue, void *element);
+
 /*
   extendible hash, lf_hash.c
 */
 #include <hash.h>
 
 #define LF_HASH_UNIQUE 1
+#define LF_HASH_BINARY 2 /* my_hash_bytes(), for byte compared keys */
+#define LF_HASH_EPOCHS 4 /* reclaim by epochs, see lf_alloc_use_epochs() */
 
 /* lf_hash overhead per element (that is, sizeof(LF_SLIST) */
 extern const int LF_HASH_OVERHEAD;
@@ -229,8 +297,23 @@ typedef struct {
   uint flags;                           /* LF_HASH_UNIQUE, etc */
   int32 volatile size;                  /* size of array */
   int32 volatile count;                 /* number of elements in the hash */
+  float max_load;                       /* average elements in a bucket */
 } LF_HASH;
 
+/* see lf_hash_get_stats() */
+#define LF_HASH_CHAIN_LENGTHS 8
+
+typedef struct st_lf_hash_stats {
+  uint32 size, count;                   /* see LF_HASH */
+  uint32 buckets;                       /* initialized buckets below size */
+  uint32 dummies;                       /* dummy nodes, of all buckets */
+  uint32 max_chain;                     /* elements in the longest chain */
+  uint32 chains[LF_HASH_CHAIN_LENGTHS]; /* buckets by number of elements */
+  uint32 purgatory;                     /* deleted elements not yet freed */
+  uint32 pins;                          /* LF_PINS allocated */
+  uint32 pin_retries;                   /* see LF_PINBOX */
+} LF_HASH_STATS;
+
 void lf_hash_init(LF_HASH *hash, uint element_size, uint flags,
                   uint key_offset, uint key_length, my_hash_get_key get_key,
                   CHARSET_INFO *charset);
@@ -238,6 +321,9 @@ void lf_hash_destroy(LF_HASH *hash);
 int lf_hash_insert(LF_HASH *hash, LF_PINS *pins, const void *data);
 void *lf_hash_search(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen);
 int lf_hash_delete(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen);
+int lf_hash_iterate(LF_HASH *hash, LF_PINS *pins, my_hash_walk_action action,
+                    void *argument);
+int lf_hash_get_stats(LF_HASH *hash, LF_PINS *pins, LF_HASH_STATS *stats);
 /*
   shortcut macros to access underlying pinbox functions from an LF_HASH
   see _lf_pinbox_get_pins() and _lf_pinbox_put_pins()
@@ -246,7 +332,17 @@ int lf_hash_delete(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen);
 #define lf_hash_get_pins(HASH)       lf_alloc_get_pins(&(HASH)->alloc)
 #define _lf_hash_put_pins(PINS)     _lf_pinbox_put_pins(PINS)
 #define lf_hash_put_pins(PINS)       lf_pinbox_put_pins(PINS)
-#define lf_hash_search_unpin(PINS)   lf_unpin((PINS), 2)
+#define lf_hash_search_unpin(PINS)    \
+  do {                                \
+    lf_rwlock_by_pins(PINS);          \
+    _lf_unpin((PINS), 2);             \
+    if ((PINS)->search_epoch)         \
+    {                                 \
+      (PINS)->search_epoch= 0;        \
+      _lf_epoch_leave(PINS);          \
+    }                                 \
+    lf_rwunlock_by_pins(PINS);        \
+  } while (0)
 /*
   cleanup
 */
@@ -278,6 +278,8 @@ typedef struct my_charset_handler_st
 
 extern MY_CHARSET_HANDLER my_charset_8bit_handler;
 extern MY_CHARSET_HANDLER my_charset_ucs2_handler;
+extern MY_CHARSET_HANDLER my_charset_utf8mb3_handler;
+extern MY_CHARSET_HANDLER my_charset_utf8mb4_handler;
 
 
 /* See strings/CHARSET_INFO.txt about information on this structure  */
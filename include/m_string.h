@@ -252,6 +252,10 @@ extern char *int10_to_str(long val,char *dst,int radix);
 extern char *str2int(const char *src,int radix,long lower,long upper,
 			 long *val);
 longlong my_strtoll10(const char *nptr, char **endptr, int *error);
+void my_strtoll10_batch(const char **strs, char **ends, longlong *values,
+                        int *errors, size_t count);
+extern size_t my_hex_encode(char *to, const uchar *from, size_t length);
+extern size_t my_hex_decode(uchar *to, const char *from, size_t length);
 #if SIZEOF_LONG == SIZEOF_LONG_LONG
 #define ll2str(A,B,C,D) int2str((A),(B),(C),(D))
 #define longlong2str(A,B,C) int2str((A),(B),(C),1)
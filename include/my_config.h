@@ -12,6 +12,7 @@
 #define HAVE_GRP_H 1
 #define HAVE_IEEEFP_H 1
 #define HAVE_LIMITS_H 1
+#define HAVE_LINUX_FUTEX_H 1
 #define HAVE_MALLOC_H 1
 #define HAVE_MEMORY_H 1
 #define HAVE_NETINET_IN_H 1
@@ -31,6 +32,7 @@
 #define HAVE_SYS_MMAN_H 1
 /* #undef HAVE_SYS_PRCTL_H */
 #define HAVE_SYS_SELECT_H 1
+#define HAVE_SYS_SENDFILE_H 1
 #define HAVE_SYS_SHM_H 1
 #define HAVE_SYS_SOCKET_H 1
 #define HAVE_SYS_STAT_H 1
@@ -102,6 +104,7 @@
 #define HAVE_MMAP64 1
 #define HAVE_PERROR 1
 #define HAVE_POLL 1
+#define HAVE_POSIX_FADVISE 1
 #define HAVE_PREAD 1
 /* #undef HAVE_PTHREAD_ATTR_CREATE */
 #define HAVE_PTHREAD_ATTR_GETSTACKSIZE 1
@@ -127,6 +130,7 @@
 #define HAVE_RINT 1
 /* #undef HAVE_SCHED_YIELD */
 #define HAVE_SELECT 1
+#define HAVE_SENDFILE 1
 /* #undef HAVE_SETFD */
 /* #undef HAVE_SETFILEPOINTER */
 #define HAVE_SIGACTION 1
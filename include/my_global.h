@@ -771,12 +771,13 @@ C_MODE_END
 #define IO_SIZE			4096
 /*
   How much overhead does malloc have. The code often allocates
-  something like 1024-MALLOC_OVERHEAD bytes
+  something like 1024-MALLOC_OVERHEAD bytes. Without safemalloc this
+  includes the header my_malloc() puts in front of each block.
 */
 #ifdef SAFEMALLOC
 #define MALLOC_OVERHEAD (8+24+4)
 #else
-#define MALLOC_OVERHEAD 8
+#define MALLOC_OVERHEAD (8+16)
 #endif
 	/* get memory in huncs */
 #define ONCE_ALLOC_INIT		(uint) (4096-MALLOC_OVERHEAD)
@@ -639,6 +639,7 @@ struct st_my_thread_var
   uint  lock_type; /* used by conditional release the queue */
   void  *stack_ends_here;
   safe_mutex_t *mutex_in_use;
+  struct st_my_memory_counters *memory_counters; /* See my_malloc.c */
 #ifndef DBUG_OFF
   void *dbug;
   char name[THREAD_NAME_SIZE+1];
@@ -186,6 +186,60 @@ extern char *my_strndup(const char *from, size_t length,
 #define ORIG_CALLER_INFO    /* nothing */
 #endif
 
+/*
+  Categories of memory for my_malloc() and my_realloc(), given in the
+  MyFlags as MY_MEM_xxx. They must match enum mysql_memory_category
+  in mysql.h.
+*/
+enum my_memory_category
+{
+  MY_MEMORY_OTHER= 0, MY_MEMORY_NET, MY_MEMORY_ROOT, MY_MEMORY_RESULT,
+  MY_MEMORY_STATEMENT, MY_MEMORY_CHARSET, MY_MEMORY_OPTIONS,
+  MY_MEMORY_CATEGORIES
+};
+#define MY_MEMORY_CATEGORY_SHIFT 24
+#define MY_MEMORY_CATEGORY(F) (((uint) (F) >> MY_MEMORY_CATEGORY_SHIFT) & 15)
+#define MY_MEM_CATEGORY_MASK (15 << MY_MEMORY_CATEGORY_SHIFT)
+#define MY_MEM_NET       (MY_MEMORY_NET << MY_MEMORY_CATEGORY_SHIFT)
+#define MY_MEM_ROOT      (MY_MEMORY_ROOT << MY_MEMORY_CATEGORY_SHIFT)
+#define MY_MEM_RESULT    (MY_MEMORY_RESULT << MY_MEMORY_CATEGORY_SHIFT)
+#define MY_MEM_STATEMENT (MY_MEMORY_STATEMENT << MY_MEMORY_CATEGORY_SHIFT)
+#define MY_MEM_CHARSET   (MY_MEMORY_CHARSET << MY_MEMORY_CATEGORY_SHIFT)
+#define MY_MEM_OPTIONS   (MY_MEMORY_OPTIONS << MY_MEMORY_CATEGORY_SHIFT)
+
+/*
+  my_malloc(), my_realloc(): map blocks of a huge page or more on huge
+  pages, see my_largepage.c. With MY_HUGE_PAGES_RESERVED the pages
+  reserved by the system administrator are tried first.
+*/
+#define MY_HUGE_PAGES          (1 << 28)
+#define MY_HUGE_PAGES_RESERVED (1 << 29)
+
+/*
+  Functions my_malloc(), my_realloc() and my_free() get their memory
+  from, see my_set_allocator(). The size and the category are those of
+  the whole block, including the header of my_malloc().
+*/
+typedef struct st_my_allocator
+{
+  void *(*malloc_func)(void *context, size_t size, uint category);
+  void *(*realloc_func)(void *context, void *ptr, size_t size,
+                        uint category);
+  void (*free_func)(void *context, void *ptr, size_t size, uint category);
+  void *context;
+} MY_ALLOCATOR;
+
+/* Bytes allocated now and at most, and allocations made per category */
+typedef struct st_my_memory_stats
+{
+  ulonglong bytes[MY_MEMORY_CATEGORIES];
+  ulonglong peak[MY_MEMORY_CATEGORIES];
+  ulonglong allocations[MY_MEMORY_CATEGORIES];
+} MY_MEMORY_STATS;
+
+extern my_bool my_set_allocator(const MY_ALLOCATOR *allocator);
+extern void my_get_memory_stats(MY_MEMORY_STATS *stats);
+
 /*
   ERROR INJECTION: Non-thread-safe global variable to request error inject.
   Set this variable to non-zero to request the next my_malloc() to fail.
@@ -198,6 +252,7 @@ extern char *my_strndup(const char *from, size_t length,
 */
 IF_DBUG(extern int my_malloc_error_inject);
 
+extern size_t my_huge_page_size(void);
 #ifdef HAVE_LARGE_PAGES
 extern uint my_get_large_page_size(void);
 extern uchar * my_large_malloc(size_t size, myf my_flags);
@@ -909,11 +964,56 @@ extern void *alloc_root(MEM_ROOT *mem_root, size_t Size);
 extern void *multi_alloc_root(MEM_ROOT *mem_root, ...);
 extern void free_root(MEM_ROOT *root, myf MyFLAGS);
 extern void set_prealloc_root(MEM_ROOT *root, char *ptr);
+extern void move_root(MEM_ROOT *to, MEM_ROOT *from);
 extern void reset_root_defaults(MEM_ROOT *mem_root, size_t block_size,
                                 size_t prealloc_size);
 extern char *strdup_root(MEM_ROOT *root,const char *str);
 extern char *strmake_root(MEM_ROOT *root,const char *str,size_t len);
 extern void *memdup_root(MEM_ROOT *root,const void *str, size_t len);
+#define ALLOC_ROOT_GROWTH_LINEAR ((uint) ~0)
+extern my_bool set_alloc_root_limit(MEM_ROOT *root, size_t limit,
+                                    void (*handler)(MEM_ROOT *, size_t,
+                                                    void *),
+                                    void *handler_arg);
+extern my_bool set_alloc_root_growth(MEM_ROOT *root, uint growth,
+                                     size_t max_block_size);
+extern my_bool set_alloc_root_huge_pages(MEM_ROOT *root, myf flags);
+extern size_t alloc_root_allocated(MEM_ROOT *root);
+
+typedef struct st_alloc_root_cache ALLOC_ROOT_CACHE;
+typedef struct st_alloc_root_cache_stats
+{
+  ulonglong hits;                       /* Blocks taken from the cache */
+  ulonglong misses;                     /* Blocks that had to be malloced */
+  ulonglong discarded;                  /* Blocks freed as it was full */
+  size_t blocks, size;                  /* Blocks and bytes in the cache */
+} ALLOC_ROOT_CACHE_STATS;
+extern ALLOC_ROOT_CACHE *create_alloc_root_cache(size_t max_size);
+extern void release_alloc_root_cache(ALLOC_ROOT_CACHE *cache);
+extern void resize_alloc_root_cache(ALLOC_ROOT_CACHE *cache, size_t max_size);
+extern void get_alloc_root_cache_stats(ALLOC_ROOT_CACHE *cache,
+                                       ALLOC_ROOT_CACHE_STATS *stats);
+extern my_bool set_alloc_root_cache(MEM_ROOT *root, ALLOC_ROOT_CACHE *cache);
+
+/*
+  alloc_root() for loops that allocate a lot of small objects: the
+  object is cut from the current block inline while it has room.
+*/
+
+static inline void *alloc_root_inline(MEM_ROOT *root, size_t length)
+{
+#ifndef HAVE_purify
+  USED_MEM *block= root->free;
+  length= ALIGN_SIZE(length);
+  if (block && block->left >= length + root->min_malloc)
+  {
+    uchar *point= (uchar*) block + (block->size - block->left);
+    block->left-= length;
+    return (void*) point;
+  }
+#endif
+  return alloc_root(root, length);
+}
 extern int get_defaults_options(int argc, char **argv,
                                 char **defaults, char **extra_defaults,
                                 char **group_suffix);
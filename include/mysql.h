@@ -167,7 +167,10 @@ enum mysql_option
   MYSQL_OPT_USE_REMOTE_CONNECTION, MYSQL_OPT_USE_EMBEDDED_CONNECTION,
   MYSQL_OPT_GUESS_CONNECTION, MYSQL_SET_CLIENT_IP, MYSQL_SECURE_AUTH,
   MYSQL_REPORT_DATA_TRUNCATION, MYSQL_OPT_RECONNECT,
-  MYSQL_OPT_SSL_VERIFY_SERVER_CERT
+  MYSQL_OPT_SSL_VERIFY_SERVER_CERT, MYSQL_OPT_PARALLEL_READ,
+  MYSQL_OPT_LAZY_METADATA, MYSQL_OPT_RESULT_MEMORY_LIMIT,
+  MYSQL_OPT_RESULT_BLOCK_CACHE, MYSQL_OPT_HUGE_PAGES,
+  MYSQL_OPT_LOCAL_INFILE_THREAD
 };
 
 struct st_mysql_options {
@@ -217,6 +220,18 @@ enum mysql_protocol_type
   MYSQL_PROTOCOL_PIPE, MYSQL_PROTOCOL_MEMORY
 };
 
+/*
+  Values of MYSQL_OPT_HUGE_PAGES: where large stored results and large
+  network buffers are put. TRANSPARENT asks the system for transparent
+  huge pages, RESERVED tries the reserved huge pages first. Normal
+  pages are used where huge pages are not available.
+*/
+enum mysql_huge_pages
+{
+  MYSQL_HUGE_PAGES_OFF, MYSQL_HUGE_PAGES_TRANSPARENT,
+  MYSQL_HUGE_PAGES_RESERVED
+};
+
 typedef struct character_set
 {
   unsigned int      number;     /* character set number              */
@@ -335,6 +350,49 @@ void STDCALL mysql_server_end(void);
 
 MYSQL_PARAMETERS *STDCALL mysql_get_parameters(void);
 
+/* What the memory of the library is used for */
+enum mysql_memory_category
+{
+  MYSQL_MEMORY_OTHER, MYSQL_MEMORY_NET, MYSQL_MEMORY_ROOT,
+  MYSQL_MEMORY_RESULT, MYSQL_MEMORY_STATEMENT, MYSQL_MEMORY_CHARSET,
+  MYSQL_MEMORY_OPTIONS, MYSQL_MEMORY_CATEGORIES
+};
+
+/*
+  Functions the library allocates its memory with, see
+  mysql_set_allocator(). Each gets the context and the category.
+*/
+typedef struct st_mysql_allocator
+{
+  void *(*malloc_func)(void *context, size_t size, unsigned int category);
+  void *(*realloc_func)(void *context, void *ptr, size_t size,
+                        unsigned int category);
+  void (*free_func)(void *context, void *ptr, size_t size,
+                    unsigned int category);
+  void *context;
+} MYSQL_ALLOCATOR;
+
+typedef struct st_mysql_memory_stats
+{
+  my_ulonglong bytes[MYSQL_MEMORY_CATEGORIES];       /* In use now */
+  my_ulonglong peak[MYSQL_MEMORY_CATEGORIES];        /* Most in use */
+  my_ulonglong allocations[MYSQL_MEMORY_CATEGORIES]; /* Allocations made */
+} MYSQL_MEMORY_STATS;
+
+/*
+  Install the allocator before mysql_library_init() or before memory is
+  allocated in other threads; memory allocated earlier is still freed
+  with the functions it came from. 0 goes back to malloc() and free().
+*/
+my_bool STDCALL mysql_set_allocator(const MYSQL_ALLOCATOR *allocator);
+void STDCALL mysql_memory_stats(MYSQL_MEMORY_STATS *stats);
+/*
+  Bytes a connection holds now: its network buffer, its options and
+  its statements with their memory roots. Result sets handed to the
+  application are not included.
+*/
+void STDCALL mysql_memory_usage(MYSQL *mysql, MYSQL_MEMORY_STATS *stats);
+
 /*
   Set up and bring down a thread; these function should be called
   for each thread in an application which opens at least one MySQL
@@ -400,6 +458,14 @@ void        STDCALL mysql_get_character_set_info(MYSQL *mysql,
 
 #define LOCAL_INFILE_ERROR_LEN 512
 
+/*
+  With MYSQL_OPT_LOCAL_INFILE_THREAD set, the file of LOAD DATA LOCAL
+  INFILE is read ahead in a thread of the library while the connection
+  thread sends it. local_infile_read is then called in that thread, one
+  call at a time, and must not depend on the calling thread. The other
+  handlers are always called in the calling thread.
+*/
+
 void
 mysql_set_local_infile_handler(MYSQL *mysql,
                                int (*local_infile_init)(void **, const char *,
@@ -437,6 +503,17 @@ MYSQL_RES *	STDCALL mysql_list_tables(MYSQL *mysql,const char *wild);
 MYSQL_RES *	STDCALL mysql_list_processes(MYSQL *mysql);
 int		STDCALL mysql_options(MYSQL *mysql,enum mysql_option option,
 				      const void *arg);
+/* Statistics of the cache set up with MYSQL_OPT_RESULT_BLOCK_CACHE */
+typedef struct st_mysql_block_cache_stats
+{
+  my_ulonglong hits;                    /* Blocks reused from the cache */
+  my_ulonglong misses;                  /* Blocks that had to be allocated */
+  my_ulonglong discarded;               /* Blocks freed as it was full */
+  unsigned long blocks;                 /* Blocks in the cache now */
+  unsigned long bytes;                  /* Bytes in the cache now */
+} MYSQL_BLOCK_CACHE_STATS;
+my_bool		STDCALL mysql_block_cache_stats(MYSQL *mysql,
+						MYSQL_BLOCK_CACHE_STATS *stats);
 void		STDCALL mysql_free_result(MYSQL_RES *result);
 void		STDCALL mysql_data_seek(MYSQL_RES *result,
 					my_ulonglong offset);
@@ -445,7 +522,49 @@ MYSQL_ROW_OFFSET STDCALL mysql_row_seek(MYSQL_RES *result,
 MYSQL_FIELD_OFFSET STDCALL mysql_field_seek(MYSQL_RES *result,
 					   MYSQL_FIELD_OFFSET offset);
 MYSQL_ROW	STDCALL mysql_fetch_row(MYSQL_RES *result);
+/*
+  Called by mysql_fetch_row_stream() for each piece of the streamed
+  column. Return non zero to skip the rest of the value.
+*/
+typedef my_bool (*mysql_stream_func)(void *arg, const char *data,
+                                     unsigned long length);
+MYSQL_ROW	STDCALL mysql_fetch_row_stream(MYSQL_RES *result,
+					       unsigned int column,
+					       mysql_stream_func stream_func,
+					       void *arg);
 unsigned long * STDCALL mysql_fetch_lengths(MYSQL_RES *result);
+int		STDCALL mysql_fetch_int64(MYSQL_RES *result, unsigned int column,
+					  long long *value, my_bool *is_null);
+int		STDCALL mysql_fetch_uint64(MYSQL_RES *result, unsigned int column,
+					   unsigned long long *value,
+					   my_bool *is_null);
+int		STDCALL mysql_fetch_double(MYSQL_RES *result,
+					   unsigned int column, double *value,
+					   my_bool *is_null);
+int		STDCALL mysql_fetch_datetime(MYSQL_RES *result,
+					     unsigned int column,
+					     MYSQL_TIME *value, my_bool *is_null);
+unsigned long	STDCALL mysql_fetch_int64_batch(MYSQL_RES *result,
+						unsigned int column,
+						long long *values,
+						my_bool *is_null, int *status,
+						unsigned long count);
+unsigned long	STDCALL mysql_fetch_uint64_batch(MYSQL_RES *result,
+						 unsigned int column,
+						 unsigned long long *values,
+						 my_bool *is_null, int *status,
+						 unsigned long count);
+unsigned long	STDCALL mysql_fetch_double_batch(MYSQL_RES *result,
+						 unsigned int column,
+						 double *values,
+						 my_bool *is_null, int *status,
+						 unsigned long count);
+unsigned long	STDCALL mysql_fetch_datetime_batch(MYSQL_RES *result,
+						   unsigned int column,
+						   MYSQL_TIME *values,
+						   my_bool *is_null,
+						   int *status,
+						   unsigned long count);
 MYSQL_FIELD *	STDCALL mysql_fetch_field(MYSQL_RES *result);
 MYSQL_RES *     STDCALL mysql_list_fields(MYSQL *mysql, const char *table,
 					  const char *wild);
@@ -453,6 +572,8 @@ unsigned long	STDCALL mysql_escape_string(char *to,const char *from,
 					    unsigned long from_length);
 unsigned long	STDCALL mysql_hex_string(char *to,const char *from,
                                          unsigned long from_length);
+unsigned long	STDCALL mysql_unhex_string(char *to,const char *from,
+                                           unsigned long from_length);
 unsigned long STDCALL mysql_real_escape_string(MYSQL *mysql,
 					       char *to,const char *from,
 					       unsigned long length);
@@ -634,7 +755,26 @@ enum enum_stmt_attr_type
     Amount of rows to retrieve from server per one fetch if using cursors.
     Accepts unsigned long attribute in the range 1 - ulong_max
   */
-  STMT_ATTR_PREFETCH_ROWS
+  STMT_ATTR_PREFETCH_ROWS,
+  /*
+    unsigned long byte budget for one fetch if using cursors. If not 0,
+    the number of rows per fetch starts at STMT_ATTR_PREFETCH_ROWS and
+    grows with every fetch as long as the rows fit in the budget.
+  */
+  STMT_ATTR_PREFETCH_BYTES,
+  /*
+    my_bool; if set, the next batch of rows is requested from a cursor
+    as soon as the current batch is read, so that the server prepares it
+    while the application processes the current one. Until the batch is
+    read no other command can be sent on the connection.
+  */
+  STMT_ATTR_PREFETCH_PIPELINE,
+  /*
+    my_bool; if set, mysql_stmt_store_result records where each column
+    starts in every row. Fetching a row then doesn't walk the columns,
+    and mysql_stmt_fetch_column works without mysql_stmt_bind_result.
+  */
+  STMT_ATTR_ROW_OFFSETS
 };
 
 
@@ -695,6 +835,13 @@ my_bool STDCALL mysql_stmt_send_long_data(MYSQL_STMT *stmt,
                                           unsigned int param_number,
                                           const char *data, 
                                           unsigned long length);
+my_bool STDCALL mysql_stmt_long_data_open(MYSQL_STMT *stmt,
+                                          unsigned int param_number);
+my_bool STDCALL mysql_stmt_long_data_write(MYSQL_STMT *stmt,
+                                           const char *data,
+                                           unsigned long length);
+my_bool STDCALL mysql_stmt_long_data_write_fd(MYSQL_STMT *stmt, int fd);
+my_bool STDCALL mysql_stmt_long_data_close(MYSQL_STMT *stmt);
 MYSQL_RES *STDCALL mysql_stmt_result_metadata(MYSQL_STMT *stmt);
 MYSQL_RES *STDCALL mysql_stmt_param_metadata(MYSQL_STMT *stmt);
 unsigned int STDCALL mysql_stmt_errno(MYSQL_STMT * stmt);
@@ -89,13 +89,32 @@ void my_net_local_init(NET *net);
 void net_end(NET *net);
   void net_clear(NET *net, my_bool clear_buffer);
 my_bool net_realloc(NET *net, size_t length);
+my_bool net_set_buff_flags(NET *net, int flags);
 my_bool net_flush(NET *net);
 my_bool my_net_write(NET *net,const unsigned char *packet, size_t len);
+my_bool my_net_write_inplace(NET *net, unsigned char *buff, size_t len);
+unsigned char *my_net_frame_packet(unsigned char *buff, size_t *len,
+                                   my_bool compress, unsigned int *pkt_nr,
+                                   unsigned int *compress_pkt_nr);
+my_bool my_net_write_framed(NET *net, const unsigned char *packet,
+                            size_t len);
 my_bool net_write_command(NET *net,unsigned char command,
      const unsigned char *header, size_t head_len,
      const unsigned char *packet, size_t len);
 int net_real_write(NET *net,const unsigned char *packet, size_t len);
 unsigned long my_net_read(NET *net);
+typedef struct st_net_stream
+{
+  NET *net;
+  unsigned long remain;
+  my_bool more;
+  my_bool buffered;
+} NET_STREAM;
+unsigned long my_net_stream_start(NET *net, NET_STREAM *stream,
+                                  unsigned long max_buffered);
+my_bool my_net_stream_read(NET_STREAM *stream, unsigned char *buff,
+                           size_t length);
+my_bool my_net_stream_end(NET_STREAM *stream);
 struct sockaddr;
 int my_connect(my_socket s, const struct sockaddr *name, unsigned int namelen,
         unsigned int timeout);
@@ -257,7 +276,10 @@ enum mysql_option
   MYSQL_OPT_USE_REMOTE_CONNECTION, MYSQL_OPT_USE_EMBEDDED_CONNECTION,
   MYSQL_OPT_GUESS_CONNECTION, MYSQL_SET_CLIENT_IP, MYSQL_SECURE_AUTH,
   MYSQL_REPORT_DATA_TRUNCATION, MYSQL_OPT_RECONNECT,
-  MYSQL_OPT_SSL_VERIFY_SERVER_CERT
+  MYSQL_OPT_SSL_VERIFY_SERVER_CERT, MYSQL_OPT_PARALLEL_READ,
+  MYSQL_OPT_LAZY_METADATA, MYSQL_OPT_RESULT_MEMORY_LIMIT,
+  MYSQL_OPT_RESULT_BLOCK_CACHE, MYSQL_OPT_HUGE_PAGES,
+  MYSQL_OPT_LOCAL_INFILE_THREAD
 };
 struct st_mysql_options {
   unsigned int connect_timeout, read_timeout, write_timeout;
@@ -299,6 +321,11 @@ enum mysql_protocol_type
   MYSQL_PROTOCOL_DEFAULT, MYSQL_PROTOCOL_TCP, MYSQL_PROTOCOL_SOCKET,
   MYSQL_PROTOCOL_PIPE, MYSQL_PROTOCOL_MEMORY
 };
+enum mysql_huge_pages
+{
+  MYSQL_HUGE_PAGES_OFF, MYSQL_HUGE_PAGES_TRANSPARENT,
+  MYSQL_HUGE_PAGES_RESERVED
+};
 typedef struct character_set
 {
   unsigned int number;
@@ -372,6 +399,30 @@ typedef struct st_mysql_parameters
 int mysql_server_init(int argc, char **argv, char **groups);
 void mysql_server_end(void);
 MYSQL_PARAMETERS * mysql_get_parameters(void);
+enum mysql_memory_category
+{
+  MYSQL_MEMORY_OTHER, MYSQL_MEMORY_NET, MYSQL_MEMORY_ROOT,
+  MYSQL_MEMORY_RESULT, MYSQL_MEMORY_STATEMENT, MYSQL_MEMORY_CHARSET,
+  MYSQL_MEMORY_OPTIONS, MYSQL_MEMORY_CATEGORIES
+};
+typedef struct st_mysql_allocator
+{
+  void *(*malloc_func)(void *context, size_t size, unsigned int category);
+  void *(*realloc_func)(void *context, void *ptr, size_t size,
+                        unsigned int category);
+  void (*free_func)(void *context, void *ptr, size_t size,
+                    unsigned int category);
+  void *context;
+} MYSQL_ALLOCATOR;
+typedef struct st_mysql_memory_stats
+{
+  my_ulonglong bytes[MYSQL_MEMORY_CATEGORIES];
+  my_ulonglong peak[MYSQL_MEMORY_CATEGORIES];
+  my_ulonglong allocations[MYSQL_MEMORY_CATEGORIES];
+} MYSQL_MEMORY_STATS;
+my_bool mysql_set_allocator(const MYSQL_ALLOCATOR *allocator);
+void mysql_memory_stats(MYSQL_MEMORY_STATS *stats);
+void mysql_memory_usage(MYSQL *mysql, MYSQL_MEMORY_STATS *stats);
 my_bool mysql_thread_init(void);
 void mysql_thread_end(void);
 my_ulonglong mysql_num_rows(MYSQL_RES *res);
@@ -452,6 +503,16 @@ MYSQL_RES * mysql_list_tables(MYSQL *mysql,const char *wild);
 MYSQL_RES * mysql_list_processes(MYSQL *mysql);
 int mysql_options(MYSQL *mysql,enum mysql_option option,
           const void *arg);
+typedef struct st_mysql_block_cache_stats
+{
+  my_ulonglong hits;
+  my_ulonglong misses;
+  my_ulonglong discarded;
+  unsigned long blocks;
+  unsigned long bytes;
+} MYSQL_BLOCK_CACHE_STATS;
+my_bool mysql_block_cache_stats(MYSQL *mysql,
+      MYSQL_BLOCK_CACHE_STATS *stats);
 void mysql_free_result(MYSQL_RES *result);
 void mysql_data_seek(MYSQL_RES *result,
      my_ulonglong offset);
@@ -460,7 +521,45 @@ MYSQL_ROW_OFFSET mysql_row_seek(MYSQL_RES *result,
 MYSQL_FIELD_OFFSET mysql_field_seek(MYSQL_RES *result,
         MYSQL_FIELD_OFFSET offset);
 MYSQL_ROW mysql_fetch_row(MYSQL_RES *result);
+typedef my_bool (*mysql_stream_func)(void *arg, const char *data,
+                                     unsigned long length);
+MYSQL_ROW mysql_fetch_row_stream(MYSQL_RES *result,
+            unsigned int column,
+            mysql_stream_func stream_func,
+            void *arg);
 unsigned long * mysql_fetch_lengths(MYSQL_RES *result);
+int mysql_fetch_int64(MYSQL_RES *result, unsigned int column,
+       long long *value, my_bool *is_null);
+int mysql_fetch_uint64(MYSQL_RES *result, unsigned int column,
+        unsigned long long *value,
+        my_bool *is_null);
+int mysql_fetch_double(MYSQL_RES *result,
+        unsigned int column, double *value,
+        my_bool *is_null);
+int mysql_fetch_datetime(MYSQL_RES *result,
+          unsigned int column,
+          MYSQL_TIME *value, my_bool *is_null);
+unsigned long mysql_fetch_int64_batch(MYSQL_RES *result,
+      unsigned int column,
+      long long *values,
+      my_bool *is_null, int *status,
+      unsigned long count);
+unsigned long mysql_fetch_uint64_batch(MYSQL_RES *result,
+       unsigned int column,
+       unsigned long long *values,
+       my_bool *is_null, int *status,
+       unsigned long count);
+unsigned long mysql_fetch_double_batch(MYSQL_RES *result,
+       unsigned int column,
+       double *values,
+       my_bool *is_null, int *status,
+       unsigned long count);
+unsigned long mysql_fetch_datetime_batch(MYSQL_RES *result,
+         unsigned int column,
+         MYSQL_TIME *values,
+         my_bool *is_null,
+         int *status,
+         unsigned long count);
 MYSQL_FIELD * mysql_fetch_field(MYSQL_RES *result);
 MYSQL_RES * mysql_list_fields(MYSQL *mysql, const char *table,
        const char *wild);
@@ -468,6 +567,8 @@ unsigned long mysql_escape_string(char *to,const char *from,
          unsigned long from_length);
 unsigned long mysql_hex_string(char *to,const char *from,
                                          unsigned long from_length);
+unsigned long mysql_unhex_string(char *to,const char *from,
+                                           unsigned long from_length);
 unsigned long mysql_real_escape_string(MYSQL *mysql,
             char *to,const char *from,
             unsigned long length);
@@ -540,7 +641,10 @@ enum enum_stmt_attr_type
 {
   STMT_ATTR_UPDATE_MAX_LENGTH,
   STMT_ATTR_CURSOR_TYPE,
-  STMT_ATTR_PREFETCH_ROWS
+  STMT_ATTR_PREFETCH_ROWS,
+  STMT_ATTR_PREFETCH_BYTES,
+  STMT_ATTR_PREFETCH_PIPELINE,
+  STMT_ATTR_ROW_OFFSETS
 };
 typedef struct st_mysql_methods
 {
@@ -595,6 +699,13 @@ my_bool mysql_stmt_send_long_data(MYSQL_STMT *stmt,
                                           unsigned int param_number,
                                           const char *data,
                                           unsigned long length);
+my_bool mysql_stmt_long_data_open(MYSQL_STMT *stmt,
+                                          unsigned int param_number);
+my_bool mysql_stmt_long_data_write(MYSQL_STMT *stmt,
+                                           const char *data,
+                                           unsigned long length);
+my_bool mysql_stmt_long_data_write_fd(MYSQL_STMT *stmt, int fd);
+my_bool mysql_stmt_long_data_close(MYSQL_STMT *stmt);
 MYSQL_RES * mysql_stmt_result_metadata(MYSQL_STMT *stmt);
 MYSQL_RES * mysql_stmt_param_metadata(MYSQL_STMT *stmt);
 unsigned int mysql_stmt_errno(MYSQL_STMT * stmt);
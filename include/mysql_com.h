@@ -420,14 +420,39 @@ void	my_net_local_init(NET *net);
 void	net_end(NET *net);
   void	net_clear(NET *net, my_bool clear_buffer);
 my_bool net_realloc(NET *net, size_t length);
+my_bool net_set_buff_flags(NET *net, int flags);
 my_bool	net_flush(NET *net);
 my_bool	my_net_write(NET *net,const unsigned char *packet, size_t len);
+my_bool	my_net_write_inplace(NET *net, unsigned char *buff, size_t len);
+unsigned char *my_net_frame_packet(unsigned char *buff, size_t *len,
+                                   my_bool compress, unsigned int *pkt_nr,
+                                   unsigned int *compress_pkt_nr);
+my_bool	my_net_write_framed(NET *net, const unsigned char *packet,
+                            size_t len);
 my_bool	net_write_command(NET *net,unsigned char command,
 			  const unsigned char *header, size_t head_len,
 			  const unsigned char *packet, size_t len);
 int	net_real_write(NET *net,const unsigned char *packet, size_t len);
 unsigned long my_net_read(NET *net);
 
+/*
+  State of a packet that is read piece by piece with my_net_stream_read()
+  instead of being assembled in net->buff by my_net_read().
+*/
+typedef struct st_net_stream
+{
+  NET *net;
+  unsigned long remain;                 /* Bytes left in current sub packet */
+  my_bool more;                         /* Current sub packet isn't last */
+  my_bool buffered;                     /* Packet was read to net->read_pos */
+} NET_STREAM;
+
+unsigned long my_net_stream_start(NET *net, NET_STREAM *stream,
+                                  unsigned long max_buffered);
+my_bool my_net_stream_read(NET_STREAM *stream, unsigned char *buff,
+                           size_t length);
+my_bool my_net_stream_end(NET_STREAM *stream);
+
 #ifdef _global_h
 void my_net_set_write_timeout(NET *net, uint timeout);
 void my_net_set_read_timeout(NET *net, uint timeout);
@@ -484,6 +509,8 @@ typedef struct st_udf_init
   /* Constants when using compression */
 #define NET_HEADER_SIZE 4		/* standard header size */
 #define COMP_HEADER_SIZE 3		/* compression header extra size */
+/* Room my_net_frame_packet() needs in front of the payload */
+#define NET_FRAME_HEADER_SIZE (2*NET_HEADER_SIZE+COMP_HEADER_SIZE)
 
   /* Prototypes to password functions */
 
@@ -22,10 +22,79 @@ extern const char	*not_error_sqlstate;
 extern "C" {
 #endif
 
+/*
+  Client options that don't fit into st_mysql_options; reached through
+  st_mysql_options::extension and allocated on first use.
+*/
+struct st_mysql_options_extention {
+  my_bool parallel_read;                /* MYSQL_OPT_PARALLEL_READ */
+  my_bool lazy_metadata;                /* MYSQL_OPT_LAZY_METADATA */
+  size_t result_memory_limit;           /* MYSQL_OPT_RESULT_MEMORY_LIMIT */
+  /* MYSQL_OPT_RESULT_BLOCK_CACHE, shared with the result sets */
+  struct st_alloc_root_cache *block_cache;
+  myf huge_pages;                       /* MYSQL_OPT_HUGE_PAGES as flags */
+  my_bool local_infile_thread;          /* MYSQL_OPT_LOCAL_INFILE_THREAD */
+};
+
+#define ENSURE_EXTENSIONS_PRESENT(OPTS)                                 \
+    do {                                                                \
+      if (!(OPTS)->extension)                                           \
+        (OPTS)->extension=                                              \
+          my_malloc(sizeof(struct st_mysql_options_extention),          \
+                    MYF(MY_WME | MY_ZEROFILL | MY_MEM_OPTIONS));        \
+    } while (0)
+
+/* Flags for the memory of the strings and arrays of the options */
+#define OPT_ALLOC_FLAGS MYF(MY_WME | MY_MEM_OPTIONS)
+
+#define OPTIONS_EXTENSION(OPTS)                                         \
+    ((struct st_mysql_options_extention *) (OPTS)->extension)
+
+/*
+  Client state of a result set that doesn't fit into st_mysql_res;
+  reached through st_mysql_res::extension and allocated in its
+  field_alloc on first use.
+*/
+struct st_mysql_res_extension {
+  /* column of the current row read by mysql_fetch_row_stream() */
+  uint streamed_column;
+};
+
+#define RES_NOT_STREAMED ((uint) ~0)
+
+#define RES_EXTENSION(RES)                                              \
+    ((struct st_mysql_res_extension *) (RES)->extension)
+
+/*
+  Source of the packets of a result set. With MYSQL_OPT_PARALLEL_READ a
+  thread reads the packets ahead into slabs while the caller parses the
+  rows, otherwise the packets are read with cli_safe_read().
+*/
+typedef struct st_row_reader
+{
+  MYSQL *mysql;
+#if defined(THREAD) && !defined(WITH_GREENIFY)
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;                  /* Signalled on every change */
+  struct st_reader_slab *first, *last;  /* Slabs with read packets */
+  struct st_reader_slab *free_slabs;
+  size_t read_offset;                   /* Next packet in first slab */
+  uint slab_count;                      /* Slabs in the first - last list */
+  ulong last_length;                    /* Length of the last packet */
+  my_bool threaded;
+  my_bool done;                         /* Reader thread has stopped */
+  my_bool abort;                        /* Rest of packets is not needed */
+  my_bool out_of_memory;                /* Reader stopped, no slab */
+#endif
+} ROW_READER;
+
 extern CHARSET_INFO *default_client_charset_info;
-MYSQL_FIELD *unpack_fields(MYSQL_DATA *data,MEM_ROOT *alloc,uint fields,
-			   my_bool default_value, uint server_capabilities);
+MYSQL_FIELD *unpack_fields(MYSQL *mysql, MYSQL_DATA *data,MEM_ROOT *alloc,
+                           uint fields, my_bool default_value,
+                           uint server_capabilities);
 void free_rows(MYSQL_DATA *cur);
+my_bool set_result_root_options(MYSQL *mysql, MEM_ROOT *root);
 void free_old_query(MYSQL *mysql);
 void end_server(MYSQL *mysql);
 my_bool mysql_reconnect(MYSQL *mysql);
@@ -37,11 +106,19 @@ cli_advanced_command(MYSQL *mysql, enum enum_server_command command,
 		     const unsigned char *arg, ulong arg_length,
                      my_bool skip_check, MYSQL_STMT *stmt);
 unsigned long cli_safe_read(MYSQL *mysql);
+void row_reader_init(ROW_READER *reader, MYSQL *mysql, my_bool threaded);
+unsigned long row_reader_read(ROW_READER *reader, unsigned char **packet);
+void row_reader_end(ROW_READER *reader);
 void net_clear_error(NET *net);
 void set_stmt_errmsg(MYSQL_STMT *stmt, NET *net);
 void set_stmt_error(MYSQL_STMT *stmt, int errcode, const char *sqlstate,
                     const char *err);
 void set_mysql_error(MYSQL *mysql, int errcode, const char *sqlstate);
+#if defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H) && \
+    !defined(WITH_GREENIFY)
+#define HAVE_NET_SENDFILE
+my_bool my_net_write_file(NET *net, File fd, size_t len);
+#endif
 #ifdef	__cplusplus
 }
 #endif
@@ -130,6 +130,7 @@ const char 	*def_shared_memory_base_name= default_shared_memory_base_name;
 
 static void mysql_close_free_options(MYSQL *mysql);
 static void mysql_close_free(MYSQL *mysql);
+static ulong cli_check_packet(MYSQL *mysql, ulong len);
 
 #if !(defined(__WIN__) || defined(__NETWARE__))
 static int wait_for_data(my_socket fd, uint timeout);
@@ -683,6 +684,27 @@ cli_safe_read(MYSQL *mysql)
     len=my_net_read(net);
   reset_sigpipe(mysql);
 
+  return cli_check_packet(mysql, len);
+}
+
+
+/**
+  Check the result of reading a packet from server. Give error message
+  if socket was down or packet is an error message.
+
+  @param mysql  Connection handle
+  @param len    Length of the packet in net->read_pos or packet_error
+
+  @retval  packet_error    An error occurred during reading.
+                           Error message is set.
+  @retval  len             The packet is ok
+*/
+
+static ulong
+cli_check_packet(MYSQL *mysql, ulong len)
+{
+  NET *net= &mysql->net;
+
   if (len == packet_error || len == 0)
   {
     DBUG_PRINT("error",("Wrong connection or packet. fd: %s  len: %lu",
@@ -753,6 +775,26 @@ void free_rows(MYSQL_DATA *cur)
   }
 }
 
+
+/*
+  Apply MYSQL_OPT_RESULT_MEMORY_LIMIT, MYSQL_OPT_RESULT_BLOCK_CACHE and
+  MYSQL_OPT_HUGE_PAGES to the memory root of the rows of a result set
+
+  RETURN
+    0   ok
+    1   out of memory
+*/
+
+my_bool set_result_root_options(MYSQL *mysql, MEM_ROOT *root)
+{
+  struct st_mysql_options_extention *ext= OPTIONS_EXTENSION(&mysql->options);
+  if (!ext)
+    return 0;
+  return (set_alloc_root_limit(root, ext->result_memory_limit, 0, 0) ||
+          set_alloc_root_cache(root, ext->block_cache) ||
+          set_alloc_root_huge_pages(root, ext->huge_pages));
+}
+
 my_bool
 cli_advanced_command(MYSQL *mysql, enum enum_server_command command,
 		     const uchar *header, ulong header_length,
@@ -1109,11 +1151,11 @@ static int add_init_command(struct st_mysql_options *options, const char *cmd)
   if (!options->init_commands)
   {
     options->init_commands= (DYNAMIC_ARRAY*)my_malloc(sizeof(DYNAMIC_ARRAY),
-						      MYF(MY_WME));
+						      OPT_ALLOC_FLAGS);
     init_dynamic_array(options->init_commands,sizeof(char*),5,5 CALLER_INFO);
   }
 
-  if (!(tmp= my_strdup(cmd,MYF(MY_WME))) ||
+  if (!(tmp= my_strdup(cmd,OPT_ALLOC_FLAGS)) ||
       insert_dynamic(options->init_commands, (uchar*)&tmp))
   {
     my_free(tmp, MYF(MY_ALLOW_ZERO_PTR));
@@ -1165,7 +1207,7 @@ void mysql_read_default_options(struct st_mysql_options *options,
 	  if (opt_arg)
 	  {
 	    my_free(options->unix_socket,MYF(MY_ALLOW_ZERO_PTR));
-	    options->unix_socket=my_strdup(opt_arg,MYF(MY_WME));
+	    options->unix_socket=my_strdup(opt_arg,OPT_ALLOC_FLAGS);
 	  }
 	  break;
 	case 3:				/* compress */
@@ -1176,7 +1218,7 @@ void mysql_read_default_options(struct st_mysql_options *options,
 	  if (opt_arg)
 	  {
 	    my_free(options->password,MYF(MY_ALLOW_ZERO_PTR));
-	    options->password=my_strdup(opt_arg,MYF(MY_WME));
+	    options->password=my_strdup(opt_arg,OPT_ALLOC_FLAGS);
 	  }
 	  break;
         case 5:
@@ -1190,7 +1232,7 @@ void mysql_read_default_options(struct st_mysql_options *options,
 	  if (opt_arg)
 	  {
 	    my_free(options->user,MYF(MY_ALLOW_ZERO_PTR));
-	    options->user=my_strdup(opt_arg,MYF(MY_WME));
+	    options->user=my_strdup(opt_arg,OPT_ALLOC_FLAGS);
 	  }
 	  break;
 	case 8:				/* init-command */
@@ -1200,14 +1242,14 @@ void mysql_read_default_options(struct st_mysql_options *options,
 	  if (opt_arg)
 	  {
 	    my_free(options->host,MYF(MY_ALLOW_ZERO_PTR));
-	    options->host=my_strdup(opt_arg,MYF(MY_WME));
+	    options->host=my_strdup(opt_arg,OPT_ALLOC_FLAGS);
 	  }
 	  break;
 	case 10:			/* database */
 	  if (opt_arg)
 	  {
 	    my_free(options->db,MYF(MY_ALLOW_ZERO_PTR));
-	    options->db=my_strdup(opt_arg,MYF(MY_WME));
+	    options->db=my_strdup(opt_arg,OPT_ALLOC_FLAGS);
 	  }
 	  break;
 	case 11:			/* debug */
@@ -1221,23 +1263,23 @@ void mysql_read_default_options(struct st_mysql_options *options,
 #if defined(HAVE_OPENSSL) && !defined(EMBEDDED_LIBRARY)
 	case 13:			/* ssl_key */
 	  my_free(options->ssl_key, MYF(MY_ALLOW_ZERO_PTR));
-          options->ssl_key = my_strdup(opt_arg, MYF(MY_WME));
+          options->ssl_key = my_strdup(opt_arg, OPT_ALLOC_FLAGS);
           break;
 	case 14:			/* ssl_cert */
 	  my_free(options->ssl_cert, MYF(MY_ALLOW_ZERO_PTR));
-          options->ssl_cert = my_strdup(opt_arg, MYF(MY_WME));
+          options->ssl_cert = my_strdup(opt_arg, OPT_ALLOC_FLAGS);
           break;
 	case 15:			/* ssl_ca */
 	  my_free(options->ssl_ca, MYF(MY_ALLOW_ZERO_PTR));
-          options->ssl_ca = my_strdup(opt_arg, MYF(MY_WME));
+          options->ssl_ca = my_strdup(opt_arg, OPT_ALLOC_FLAGS);
           break;
 	case 16:			/* ssl_capath */
 	  my_free(options->ssl_capath, MYF(MY_ALLOW_ZERO_PTR));
-          options->ssl_capath = my_strdup(opt_arg, MYF(MY_WME));
+          options->ssl_capath = my_strdup(opt_arg, OPT_ALLOC_FLAGS);
           break;
         case 23:			/* ssl_cipher */
           my_free(options->ssl_cipher, MYF(MY_ALLOW_ZERO_PTR));
-          options->ssl_cipher= my_strdup(opt_arg, MYF(MY_WME));
+          options->ssl_cipher= my_strdup(opt_arg, OPT_ALLOC_FLAGS);
           break;
 #else
 	case 13:				/* Ignore SSL options */
@@ -1249,11 +1291,11 @@ void mysql_read_default_options(struct st_mysql_options *options,
 #endif /* HAVE_OPENSSL && !EMBEDDED_LIBRARY */
 	case 17:			/* charset-lib */
 	  my_free(options->charset_dir,MYF(MY_ALLOW_ZERO_PTR));
-          options->charset_dir = my_strdup(opt_arg, MYF(MY_WME));
+          options->charset_dir = my_strdup(opt_arg, OPT_ALLOC_FLAGS);
 	  break;
 	case 18:
 	  my_free(options->charset_name,MYF(MY_ALLOW_ZERO_PTR));
-          options->charset_name = my_strdup(opt_arg, MYF(MY_WME));
+          options->charset_name = my_strdup(opt_arg, OPT_ALLOC_FLAGS);
 	  break;
 	case 19:				/* Interactive-timeout */
 	  options->client_flag|= CLIENT_INTERACTIVE;
@@ -1283,7 +1325,7 @@ void mysql_read_default_options(struct st_mysql_options *options,
 #ifdef HAVE_SMEM
           if (options->shared_memory_base_name != def_shared_memory_base_name)
             my_free(options->shared_memory_base_name,MYF(MY_ALLOW_ZERO_PTR));
-          options->shared_memory_base_name=my_strdup(opt_arg,MYF(MY_WME));
+          options->shared_memory_base_name=my_strdup(opt_arg,OPT_ALLOC_FLAGS);
 #endif
           break;
 	case 27: /* multi-results */
@@ -1340,15 +1382,21 @@ static void cli_fetch_lengths(ulong *to, MYSQL_ROW column,
 
 /***************************************************************************
   Change field rows to field structs
+
+  With MYSQL_OPT_LAZY_METADATA the strings of the fields are not copied;
+  they point into the field packets, which are moved into 'alloc'
+  instead of being freed. The packets are already null terminated per
+  column.
 ***************************************************************************/
 
 MYSQL_FIELD *
-unpack_fields(MYSQL_DATA *data,MEM_ROOT *alloc,uint fields,
+unpack_fields(MYSQL *mysql, MYSQL_DATA *data,MEM_ROOT *alloc,uint fields,
 	      my_bool default_value, uint server_capabilities)
 {
   MYSQL_ROWS	*row;
   MYSQL_FIELD	*field,*result;
   ulong lengths[9];				/* Max of fields */
+  my_bool lazy;
   DBUG_ENTER("unpack_fields");
 
   field= result= (MYSQL_FIELD*) alloc_root(alloc,
@@ -1359,6 +1407,9 @@ unpack_fields(MYSQL_DATA *data,MEM_ROOT *alloc,uint fields,
     DBUG_RETURN(0);
   }
   bzero((char*) field, (uint) sizeof(MYSQL_FIELD)*fields);
+  lazy= (mysql->options.extension &&
+         OPTIONS_EXTENSION(&mysql->options)->lazy_metadata &&
+         (server_capabilities & CLIENT_PROTOCOL_41));
   if (server_capabilities & CLIENT_PROTOCOL_41)
   {
     /* server is 4.1, and returns the new field result format */
@@ -1368,12 +1419,24 @@ unpack_fields(MYSQL_DATA *data,MEM_ROOT *alloc,uint fields,
       /* fields count may be wrong */
       DBUG_ASSERT((uint) (field - result) < fields);
       cli_fetch_lengths(&lengths[0], row->data, default_value ? 8 : 7);
-      field->catalog=   strmake_root(alloc,(char*) row->data[0], lengths[0]);
-      field->db=        strmake_root(alloc,(char*) row->data[1], lengths[1]);
-      field->table=     strmake_root(alloc,(char*) row->data[2], lengths[2]);
-      field->org_table= strmake_root(alloc,(char*) row->data[3], lengths[3]);
-      field->name=      strmake_root(alloc,(char*) row->data[4], lengths[4]);
-      field->org_name=  strmake_root(alloc,(char*) row->data[5], lengths[5]);
+      if (lazy)
+      {
+        field->catalog=   row->data[0];
+        field->db=        row->data[1];
+        field->table=     row->data[2];
+        field->org_table= row->data[3];
+        field->name=      row->data[4];
+        field->org_name=  row->data[5];
+      }
+      else
+      {
+        field->catalog=   strmake_root(alloc,(char*) row->data[0], lengths[0]);
+        field->db=        strmake_root(alloc,(char*) row->data[1], lengths[1]);
+        field->table=     strmake_root(alloc,(char*) row->data[2], lengths[2]);
+        field->org_table= strmake_root(alloc,(char*) row->data[3], lengths[3]);
+        field->name=      strmake_root(alloc,(char*) row->data[4], lengths[4]);
+        field->org_name=  strmake_root(alloc,(char*) row->data[5], lengths[5]);
+      }
 
       field->catalog_length=	lengths[0];
       field->db_length=		lengths[1];
@@ -1394,7 +1457,8 @@ unpack_fields(MYSQL_DATA *data,MEM_ROOT *alloc,uint fields,
         field->flags|= NUM_FLAG;
       if (default_value && row->data[7])
       {
-        field->def=strmake_root(alloc,(char*) row->data[7], lengths[7]);
+        field->def= lazy ? row->data[7] :
+                    strmake_root(alloc,(char*) row->data[7], lengths[7]);
 	field->def_length= lengths[7];
       }
       else
@@ -1444,10 +1508,321 @@ unpack_fields(MYSQL_DATA *data,MEM_ROOT *alloc,uint fields,
     }
   }
 #endif /* DELETE_SUPPORT_OF_4_0_PROTOCOL */
-  free_rows(data);				/* Free old data */
+  if (lazy)
+  {
+    /* Keep the packets the strings point into */
+    move_root(alloc, &data->alloc);
+    free_root(&data->alloc, MYF(0));            /* Only its control block */
+    my_free(data, MYF(0));
+  }
+  else
+    free_rows(data);				/* Free old data */
   DBUG_RETURN(result);
 }
 
+/*****************************************************************************
+  Reading of result set packets ahead in a separate thread
+*****************************************************************************/
+
+#if defined(THREAD) && !defined(WITH_GREENIFY)
+
+/*
+  Packets are stored in slabs as the packet length followed by the
+  packet data, aligned for the next length. Packets bigger than a slab
+  get a slab of their own. The reader thread waits when READER_MAX_SLABS
+  slabs are waiting to be parsed, so that a slow consumer doesn't make
+  it buffer the whole result set twice.
+*/
+
+#define READER_SLAB_SIZE (128*1024L)
+#define READER_MAX_SLABS 16
+
+typedef struct st_reader_slab
+{
+  struct st_reader_slab *next;
+  size_t size;                          /* Size of the data area */
+  size_t used;                          /* Bytes filled by reader thread */
+} READER_SLAB;
+
+#define SLAB_DATA(slab) ((uchar*) (slab) + ALIGN_SIZE(sizeof(READER_SLAB)))
+#define SLAB_PACKET_SIZE(len) ALIGN_SIZE(sizeof(ulong) + (len))
+
+
+/*
+  Get a slab with room for a packet of the given length at the end of
+  the queue. Called with reader->lock held.
+
+  RETURN
+    0   ok, *slab is set
+    1   the consumer is gone, the packet isn't needed
+    2   out of memory
+*/
+
+static int reader_get_slab(ROW_READER *reader, ulong len, READER_SLAB **slab)
+{
+  size_t need= SLAB_PACKET_SIZE(len);
+
+  if (reader->abort)
+    return 1;
+  if ((*slab= reader->last) && (*slab)->size - (*slab)->used >= need)
+    return 0;
+
+  while (reader->slab_count >= READER_MAX_SLABS && !reader->abort)
+    pthread_cond_wait(&reader->cond, &reader->lock);
+  if (reader->abort)
+    return 1;
+
+  if (need <= READER_SLAB_SIZE && reader->free_slabs)
+  {
+    *slab= reader->free_slabs;
+    reader->free_slabs= (*slab)->next;
+  }
+  else
+  {
+    size_t size= max(need, READER_SLAB_SIZE);
+    if (!(*slab= (READER_SLAB*) my_malloc(ALIGN_SIZE(sizeof(READER_SLAB)) +
+                                          size, MYF(MY_MEM_RESULT))))
+      return 2;
+    (*slab)->size= size;
+  }
+  (*slab)->next= 0;
+  (*slab)->used= 0;
+  if (reader->last)
+    reader->last->next= *slab;
+  else
+    reader->first= *slab;
+  reader->last= *slab;
+  reader->slab_count++;
+  return 0;
+}
+
+
+/*
+  Reader thread: read packets until the end of the result set
+
+  The last packet (EOF, error or a read error) is left in net->read_pos
+  where row_reader_read() checks it with cli_check_packet() after the
+  thread has ended. If a slab can't be allocated, the thread stops
+  reading and row_reader_read() reports CR_OUT_OF_MEMORY after the
+  packets read before.
+*/
+
+static pthread_handler_t row_reader_thread(void *arg)
+{
+  ROW_READER *reader= (ROW_READER*) arg;
+  MYSQL *mysql= reader->mysql;
+  NET *net= &mysql->net;
+  READER_SLAB *slab;
+  uchar *pos;
+  ulong len;
+  int res;
+  init_sigpipe_variables
+
+  my_thread_init();
+  set_sigpipe(mysql);
+  for (;;)
+  {
+    len= net->vio ? my_net_read(net) : packet_error;
+    if (len == packet_error || len == 0 || net->read_pos[0] == 255 ||
+        (net->read_pos[0] == 254 && len < 8))
+      break;
+
+    pthread_mutex_lock(&reader->lock);
+    res= reader_get_slab(reader, len, &slab);
+    pthread_mutex_unlock(&reader->lock);
+    if (res == 1)
+      continue;                         /* Skip packets nobody will read */
+    if (res)
+    {
+      reader->out_of_memory= 1;
+      break;
+    }
+
+    /* The consumer doesn't look beyond slab->used */
+    pos= SLAB_DATA(slab) + slab->used;
+    *(ulong*) pos= len;
+    memcpy(pos + sizeof(ulong), net->read_pos, len);
+
+    pthread_mutex_lock(&reader->lock);
+    slab->used+= SLAB_PACKET_SIZE(len);
+    pthread_cond_signal(&reader->cond);
+    pthread_mutex_unlock(&reader->lock);
+  }
+  reset_sigpipe(mysql);
+
+  pthread_mutex_lock(&reader->lock);
+  reader->last_length= len;
+  reader->done= 1;
+  pthread_cond_signal(&reader->cond);
+  pthread_mutex_unlock(&reader->lock);
+  my_thread_end();
+  return 0;
+}
+
+
+/* Wait for the reader thread to end and free the slabs */
+
+static void reader_finish(ROW_READER *reader)
+{
+  READER_SLAB *slab, *next;
+  pthread_join(reader->thread, NULL);
+  pthread_cond_destroy(&reader->cond);
+  pthread_mutex_destroy(&reader->lock);
+  for (slab= reader->first; slab; slab= next)
+  {
+    next= slab->next;
+    my_free(slab, MYF(0));
+  }
+  for (slab= reader->free_slabs; slab; slab= next)
+  {
+    next= slab->next;
+    my_free(slab, MYF(0));
+  }
+  reader->threaded= 0;
+}
+
+#endif /* THREAD && !WITH_GREENIFY */
+
+
+/**
+  Prepare to read the packets of a result set
+
+  @param reader    Reader to initialize
+  @param mysql     Connection handle
+  @param threaded  Read ahead in a thread if MYSQL_OPT_PARALLEL_READ is set
+
+  @note
+    If the thread can't be started the packets are read directly.
+    Until row_reader_end() is called, the NET of the connection may only
+    be used through row_reader_read().
+*/
+
+void row_reader_init(ROW_READER *reader, MYSQL *mysql, my_bool threaded)
+{
+  reader->mysql= mysql;
+#if defined(THREAD) && !defined(WITH_GREENIFY)
+  reader->threaded= 0;
+  if (threaded && mysql->options.extension &&
+      OPTIONS_EXTENSION(&mysql->options)->parallel_read)
+  {
+    reader->first= reader->last= reader->free_slabs= 0;
+    reader->read_offset= 0;
+    reader->slab_count= 0;
+    reader->done= reader->abort= reader->out_of_memory= 0;
+    pthread_mutex_init(&reader->lock, MY_MUTEX_INIT_FAST);
+    pthread_cond_init(&reader->cond, NULL);
+    if (pthread_create(&reader->thread, NULL, row_reader_thread,
+                       (void*) reader))
+    {
+      pthread_cond_destroy(&reader->cond);
+      pthread_mutex_destroy(&reader->lock);
+    }
+    else
+      reader->threaded= 1;
+  }
+#endif
+}
+
+
+/**
+  Read the next packet of a result set
+
+  @param reader    Reader set up by row_reader_init()
+  @param packet    Set to the packet data. It stays valid until the next
+                   call.
+
+  @retval  packet_error    An error occurred during reading.
+                           Error message is set.
+  @retval  len             Length of the packet
+*/
+
+ulong row_reader_read(ROW_READER *reader, uchar **packet)
+{
+#if defined(THREAD) && !defined(WITH_GREENIFY)
+  if (reader->threaded)
+  {
+    READER_SLAB *slab;
+    ulong len;
+
+    pthread_mutex_lock(&reader->lock);
+    for (;;)
+    {
+      slab= reader->first;
+      if (slab && reader->read_offset < slab->used)
+      {
+        uchar *pos= SLAB_DATA(slab) + reader->read_offset;
+        len= *(ulong*) pos;
+        *packet= pos + sizeof(ulong);
+        reader->read_offset+= SLAB_PACKET_SIZE(len);
+        pthread_mutex_unlock(&reader->lock);
+        return len;
+      }
+      if (slab && (slab != reader->last || reader->done))
+      {
+        /* All packets in the slab are parsed; reuse it */
+        reader->first= slab->next;
+        if (!reader->first)
+          reader->last= 0;
+        if (slab->size == READER_SLAB_SIZE)
+        {
+          slab->next= reader->free_slabs;
+          reader->free_slabs= slab;
+        }
+        else
+          my_free(slab, MYF(0));
+        reader->read_offset= 0;
+        reader->slab_count--;
+        pthread_cond_signal(&reader->cond);
+        continue;
+      }
+      if (reader->done)
+        break;
+      pthread_cond_wait(&reader->cond, &reader->lock);
+    }
+    pthread_mutex_unlock(&reader->lock);
+
+    /* Only the last packet is left; it's in the net buffer */
+    reader_finish(reader);
+    if (reader->out_of_memory)
+    {
+      /* The rest of the result set is still on the connection */
+      set_mysql_error(reader->mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
+      return packet_error;
+    }
+    len= cli_check_packet(reader->mysql, reader->last_length);
+    *packet= reader->mysql->net.read_pos;
+    return len;
+  }
+#endif
+  {
+    ulong len= cli_safe_read(reader->mysql);
+    *packet= reader->mysql->net.read_pos;
+    return len;
+  }
+}
+
+
+/**
+  Stop reading a result set before its end was reached. If the reader
+  thread is still running, it reads the rest of the result set and
+  throws it away.
+*/
+
+void row_reader_end(ROW_READER *reader)
+{
+#if defined(THREAD) && !defined(WITH_GREENIFY)
+  if (reader->threaded)
+  {
+    pthread_mutex_lock(&reader->lock);
+    reader->abort= 1;
+    pthread_cond_signal(&reader->cond);
+    pthread_mutex_unlock(&reader->lock);
+    reader_finish(reader);
+  }
+#endif
+}
+
+
 /* Read all rows (fields or data) from server */
 
 MYSQL_DATA *cli_read_rows(MYSQL *mysql,MYSQL_FIELD *mysql_fields,
@@ -1460,19 +1835,34 @@ MYSQL_DATA *cli_read_rows(MYSQL *mysql,MYSQL_FIELD *mysql_fields,
   char	*to, *end_to;
   MYSQL_DATA *result;
   MYSQL_ROWS **prev_ptr,*cur;
-  NET *net = &mysql->net;
+  ROW_READER reader;
   DBUG_ENTER("cli_read_rows");
 
-  if ((pkt_len= cli_safe_read(mysql)) == packet_error)
+  /* Only rows of a result set are worth reading ahead, not metadata */
+  row_reader_init(&reader, mysql, mysql_fields != 0);
+  if ((pkt_len= row_reader_read(&reader, &cp)) == packet_error)
     DBUG_RETURN(0);
   if (!(result=(MYSQL_DATA*) my_malloc(sizeof(MYSQL_DATA),
-				       MYF(MY_WME | MY_ZEROFILL))))
+				       MYF(MY_WME | MY_ZEROFILL |
+                                           MY_MEM_RESULT))))
   {
+    row_reader_end(&reader);
     set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
     DBUG_RETURN(0);
   }
   init_alloc_root(&result->alloc,8192,0);	/* Assume rowlength < 8192 */
   result->alloc.min_malloc=sizeof(MYSQL_ROWS);
+  /*
+    The root of field metadata may be moved into the root of the fields
+    by unpack_fields(), so the options only apply to rows
+  */
+  if (mysql_fields && set_result_root_options(mysql, &result->alloc))
+  {
+    row_reader_end(&reader);
+    my_free(result, MYF(0));
+    set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
+    DBUG_RETURN(0);
+  }
   prev_ptr= &result->data;
   result->rows=0;
   result->fields=fields;
@@ -1485,15 +1875,16 @@ MYSQL_DATA *cli_read_rows(MYSQL *mysql,MYSQL_FIELD *mysql_fields,
     string where the length of the string is 8 bytes. (see net_field_length())
   */
 
-  while (*(cp=net->read_pos) != 254 || pkt_len >= 8)
+  while (*cp != 254 || pkt_len >= 8)
   {
     result->rows++;
-    if (!(cur= (MYSQL_ROWS*) alloc_root(&result->alloc,
-					sizeof(MYSQL_ROWS))) ||
+    if (!(cur= (MYSQL_ROWS*) alloc_root_inline(&result->alloc,
+					       sizeof(MYSQL_ROWS))) ||
 	!(cur->data= ((MYSQL_ROW)
-		      alloc_root(&result->alloc,
-				 (fields+1)*sizeof(char *)+pkt_len))))
+		      alloc_root_inline(&result->alloc,
+					(fields+1)*sizeof(char *)+pkt_len))))
     {
+      row_reader_end(&reader);
       free_rows(result);
       set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
       DBUG_RETURN(0);
@@ -1513,6 +1904,7 @@ MYSQL_DATA *cli_read_rows(MYSQL *mysql,MYSQL_FIELD *mysql_fields,
 	cur->data[field] = to;
         if (len > (ulong) (end_to - to))
         {
+          row_reader_end(&reader);
           free_rows(result);
           set_mysql_error(mysql, CR_MALFORMED_PACKET, unknown_sqlstate);
           DBUG_RETURN(0);
@@ -1528,7 +1920,7 @@ MYSQL_DATA *cli_read_rows(MYSQL *mysql,MYSQL_FIELD *mysql_fields,
       }
     }
     cur->data[field]=to;			/* End of last field */
-    if ((pkt_len=cli_safe_read(mysql)) == packet_error)
+    if ((pkt_len= row_reader_read(&reader, &cp)) == packet_error)
     {
       free_rows(result);
       DBUG_RETURN(0);
@@ -1553,15 +1945,14 @@ MYSQL_DATA *cli_read_rows(MYSQL *mysql,MYSQL_FIELD *mysql_fields,
 
 
 static int
-read_one_row(MYSQL *mysql,uint fields,MYSQL_ROW row, ulong *lengths)
+unpack_one_row(MYSQL *mysql,uint fields,MYSQL_ROW row, ulong *lengths,
+               ulong pkt_len)
 {
   uint field;
-  ulong pkt_len,len;
+  ulong len;
   uchar *pos, *prev_pos, *end_pos;
   NET *net= &mysql->net;
 
-  if ((pkt_len=cli_safe_read(mysql)) == packet_error)
-    return -1;
   if (pkt_len <= 8 && net->read_pos[0] == 254)
   {
     if (pkt_len > 1)				/* MySQL 4.1 protocol */
@@ -1602,6 +1993,143 @@ read_one_row(MYSQL *mysql,uint fields,MYSQL_ROW row, ulong *lengths)
 }
 
 
+static int
+read_one_row(MYSQL *mysql,uint fields,MYSQL_ROW row, ulong *lengths)
+{
+  ulong pkt_len;
+
+  if ((pkt_len=cli_safe_read(mysql)) == packet_error)
+    return -1;
+  return unpack_one_row(mysql, fields, row, lengths, pkt_len);
+}
+
+
+/*
+  Read one row like read_one_row(), but hand the value of one column to
+  stream_func piece by piece as it is read from the connection.
+
+  Rows that fit in the packet buffer are read as usual and the column is
+  passed to stream_func in one piece. For bigger rows only the other
+  columns are stored in the packet buffer; the streamed column is read
+  through a window of the buffer and never kept as a whole. In the
+  returned row it's an empty string, while lengths[column] holds its
+  full length; *streamed is set then.
+*/
+
+static int
+read_one_row_stream(MYSQL *mysql, uint fields, MYSQL_ROW row, ulong *lengths,
+                    uint column, mysql_stream_func stream_func, void *arg,
+                    my_bool *streamed)
+{
+  uint field;
+  ulong pkt_len, len, offset= 0;
+  uchar *pos;
+  my_bool skip_rest= 0;
+  NET *net= &mysql->net;
+  NET_STREAM stream;
+  init_sigpipe_variables
+
+  *streamed= 0;
+  stream.buffered= 1;
+  set_sigpipe(mysql);
+  pkt_len= net->vio ? my_net_stream_start(net, &stream, net->max_packet) : 0;
+  reset_sigpipe(mysql);
+
+  if (stream.buffered)
+  {
+    int res;
+    if ((pkt_len= cli_check_packet(mysql, pkt_len)) == packet_error)
+      return -1;
+    if ((res= unpack_one_row(mysql, fields, row, lengths, pkt_len)))
+      return res;
+    if (stream_func && row[column])
+      (void) (*stream_func)(arg, row[column], lengths[column]);
+    return 0;
+  }
+
+  /* A packet this big can be neither an error nor an EOF packet */
+  for (field=0 ; field < fields ; field++)
+  {
+    uchar header[9];
+    uint header_length;
+
+    if (my_net_stream_read(&stream, header, 1))
+      goto err;
+    header_length= (header[0] < 251 ? 0 : header[0] == 252 ? 2 :
+                    header[0] == 253 ? 3 : header[0] == 254 ? 8 : 0);
+    if (header_length &&
+        my_net_stream_read(&stream, header + 1, header_length))
+      goto err;
+    pos= header;
+    if ((len=(ulong) net_field_length(&pos)) == NULL_LENGTH)
+    {						/* null field */
+      row[field]= 0;
+      lengths[field]= 0;
+      continue;
+    }
+    row[field]= (char*) net->buff;		/* Set below */
+    lengths[field]= len;
+    if (field == column)
+    {
+      /* Stream the value through the free part of the buffer */
+      if (net->max_packet - offset <= IO_SIZE &&
+          net_realloc(net, offset + IO_SIZE + 1))
+        goto err;
+      while (len)
+      {
+        uchar *chunk= net->buff + offset + 1;
+        ulong part= min(len, net->max_packet - offset - 1);
+        if (my_net_stream_read(&stream, chunk, part))
+          goto err;
+        if (!skip_rest)
+          skip_rest= (*stream_func)(arg, (char*) chunk, part);
+        len-= part;
+      }
+      net->buff[offset++]= 0;
+    }
+    else
+    {
+      if (offset + len >= net->max_packet &&
+          net_realloc(net, offset + len + 1))
+        goto err;
+      if (my_net_stream_read(&stream, net->buff + offset, len))
+        goto err;
+      net->buff[offset+len]= 0;
+      offset+= len + 1;
+    }
+  }
+  if (my_net_stream_end(&stream))
+    goto err;
+
+  /* net->buff can't be moved any more, set the column pointers */
+  pos= net->buff;
+  for (field=0 ; field < fields ; field++)
+  {
+    if (!row[field])
+      continue;
+    row[field]= (char*) pos;
+    pos+= (field == column ? 0 : lengths[field]) + 1;
+  }
+  row[field]= (char*) pos;			/* End of last field */
+  *streamed= 1;
+  return 0;
+
+err:
+  if (net->error)
+  {
+    end_server(mysql);
+    set_mysql_error(mysql, net->last_errno == ER_NET_PACKET_TOO_LARGE ?
+                    CR_NET_PACKET_TOO_LARGE: CR_SERVER_LOST, unknown_sqlstate);
+  }
+  else
+  {
+    (void) my_net_stream_end(&stream);
+    set_mysql_error(mysql, CR_MALFORMED_PACKET, unknown_sqlstate);
+  }
+  return -1;
+}
+
+
 /****************************************************************************
   Init MySQL structure or allocate one
 ****************************************************************************/
@@ -1668,7 +2196,7 @@ mysql_init(MYSQL *mysql)
   NB! Errors are not reported until you do mysql_real_connect.
 */
 
-#define strdup_if_not_null(A) (A) == 0 ? 0 : my_strdup((A),MYF(MY_WME))
+#define strdup_if_not_null(A) (A) == 0 ? 0 : my_strdup((A),OPT_ALLOC_FLAGS)
 
 my_bool STDCALL
 mysql_ssl_set(MYSQL *mysql __attribute__((unused)) ,
@@ -1847,7 +2375,7 @@ static MYSQL_METHODS client_methods=
   cli_read_statistics,                         /* read_statistics */
   cli_read_query_result,                       /* next_result */
   cli_read_change_user_result,                 /* read_change_user_result */
-  cli_read_binary_rows                         /* read_rows_from_cursor */
+  cli_read_rows_from_cursor                    /* read_rows_from_cursor */
 #endif
 };
 
@@ -1861,7 +2389,7 @@ int mysql_init_character_set(MYSQL *mysql)
   {
     default_collation_name= MYSQL_DEFAULT_COLLATION_NAME;
     if (!(mysql->options.charset_name= 
-       my_strdup(MYSQL_DEFAULT_CHARSET_NAME,MYF(MY_WME))))
+       my_strdup(MYSQL_DEFAULT_CHARSET_NAME,OPT_ALLOC_FLAGS)))
     return 1;
   }
   else
@@ -2218,7 +2746,11 @@ CLI_MYSQL_REAL_CONNECT(MYSQL *mysql,const char *host, const char *user,
     goto error;
   }
 
-  if (my_net_init(net, net->vio))
+  if (my_net_init(net, net->vio) ||
+      (mysql->options.extension &&
+       OPTIONS_EXTENSION(&mysql->options)->huge_pages &&
+       net_set_buff_flags(net,
+                          OPTIONS_EXTENSION(&mysql->options)->huge_pages)))
   {
     vio_delete(net->vio);
     net->vio = 0;
@@ -2734,6 +3266,10 @@ static void mysql_close_free_options(MYSQL *mysql)
   if (mysql->options.shared_memory_base_name != def_shared_memory_base_name)
     my_free(mysql->options.shared_memory_base_name,MYF(MY_ALLOW_ZERO_PTR));
 #endif /* HAVE_SMEM */
+  if (mysql->options.extension &&
+      OPTIONS_EXTENSION(&mysql->options)->block_cache)
+    release_alloc_root_cache(OPTIONS_EXTENSION(&mysql->options)->block_cache);
+  my_free(mysql->options.extension,MYF(MY_ALLOW_ZERO_PTR));
   bzero((char*) &mysql->options,sizeof(mysql->options));
   DBUG_VOID_RETURN;
 }
@@ -2881,7 +3417,7 @@ get_info:
 
   if (!(fields=cli_read_rows(mysql,(MYSQL_FIELD*)0, protocol_41(mysql) ? 7:5)))
     DBUG_RETURN(1);
-  if (!(mysql->fields=unpack_fields(fields,&mysql->field_alloc,
+  if (!(mysql->fields=unpack_fields(mysql,fields,&mysql->field_alloc,
 				    (uint) field_count,0,
 				    mysql->server_capabilities)))
     DBUG_RETURN(1);
@@ -2940,7 +3476,8 @@ MYSQL_RES * STDCALL mysql_store_result(MYSQL *mysql)
   if (!(result=(MYSQL_RES*) my_malloc((uint) (sizeof(MYSQL_RES)+
 					      sizeof(ulong) *
 					      mysql->field_count),
-				      MYF(MY_WME | MY_ZEROFILL))))
+				      MYF(MY_WME | MY_ZEROFILL |
+                                          MY_MEM_RESULT))))
   {
     set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
     DBUG_RETURN(0);
@@ -2992,12 +3529,14 @@ static MYSQL_RES * cli_use_result(MYSQL *mysql)
   }
   if (!(result=(MYSQL_RES*) my_malloc(sizeof(*result)+
 				      sizeof(ulong)*mysql->field_count,
-				      MYF(MY_WME | MY_ZEROFILL))))
+				      MYF(MY_WME | MY_ZEROFILL |
+                                          MY_MEM_RESULT))))
     DBUG_RETURN(0);
   result->lengths=(ulong*) (result+1);
   result->methods= mysql->methods;
   if (!(result->row=(MYSQL_ROW)
-	my_malloc(sizeof(result->row[0])*(mysql->field_count+1), MYF(MY_WME))))
+	my_malloc(sizeof(result->row[0])*(mysql->field_count+1),
+                  MYF(MY_WME | MY_MEM_RESULT))))
   {					/* Ptrs: to one row */
     my_free((uchar*) result,MYF(0));
     DBUG_RETURN(0);
@@ -3020,40 +3559,64 @@ static MYSQL_RES * cli_use_result(MYSQL *mysql)
   Return next row of the query results
 **************************************************************************/
 
+/*
+  Fetch next row of a mysql_use_result() result set. If stream_func is
+  set, the value of the given column is passed to it while it's read.
+  The result set remembers whether that column was streamed, so that
+  the typed accessors don't parse the empty string left in its place.
+*/
+
+static MYSQL_ROW
+fetch_unbuffered_row(MYSQL_RES *res, uint column,
+                     mysql_stream_func stream_func, void *arg)
+{
+  DBUG_ENTER("fetch_unbuffered_row");
+  if (!res->eof)
+  {
+    MYSQL *mysql= res->handle;
+    my_bool streamed= 0;
+    if (mysql->status != MYSQL_STATUS_USE_RESULT)
+    {
+      set_mysql_error(mysql,
+                      res->unbuffered_fetch_cancelled ? 
+                      CR_FETCH_CANCELED : CR_COMMANDS_OUT_OF_SYNC,
+                      unknown_sqlstate);
+    }
+    else if (!(stream_func ?
+               read_one_row_stream(mysql, res->field_count, res->row,
+                                   res->lengths, column, stream_func, arg,
+                                   &streamed) :
+               read_one_row(mysql, res->field_count, res->row, res->lengths)))
+    {
+      if (res->extension)
+        RES_EXTENSION(res)->streamed_column= streamed ? column :
+                                                        RES_NOT_STREAMED;
+      res->row_count++;
+      DBUG_RETURN(res->current_row=res->row);
+    }
+    DBUG_PRINT("info",("end of data"));
+    res->eof=1;
+    mysql->status=MYSQL_STATUS_READY;
+    /*
+      Reset only if owner points to us: there is a chance that somebody
+      started new query after mysql_stmt_close():
+    */
+    if (mysql->unbuffered_fetch_owner == &res->unbuffered_fetch_cancelled)
+      mysql->unbuffered_fetch_owner= 0;
+    /* Don't clear handle in mysql_free_result */
+    res->handle=0;
+  }
+  DBUG_RETURN((MYSQL_ROW) NULL);
+}
+
+
 MYSQL_ROW STDCALL
 mysql_fetch_row(MYSQL_RES *res)
 {
   DBUG_ENTER("mysql_fetch_row");
   if (!res->data)
   {						/* Unbufferred fetch */
-    if (!res->eof)
-    {
-      MYSQL *mysql= res->handle;
-      if (mysql->status != MYSQL_STATUS_USE_RESULT)
-      {
-        set_mysql_error(mysql,
-                        res->unbuffered_fetch_cancelled ? 
-                        CR_FETCH_CANCELED : CR_COMMANDS_OUT_OF_SYNC,
-                        unknown_sqlstate);
-      }
-      else if (!(read_one_row(mysql, res->field_count, res->row, res->lengths)))
-      {
-	res->row_count++;
-	DBUG_RETURN(res->current_row=res->row);
-      }
-      DBUG_PRINT("info",("end of data"));
-      res->eof=1;
-      mysql->status=MYSQL_STATUS_READY;
-      /*
-        Reset only if owner points to us: there is a chance that somebody
-        started new query after mysql_stmt_close():
-      */
-      if (mysql->unbuffered_fetch_owner == &res->unbuffered_fetch_cancelled)
-        mysql->unbuffered_fetch_owner= 0;
-      /* Don't clear handle in mysql_free_result */
-      res->handle=0;
-    }
-    DBUG_RETURN((MYSQL_ROW) NULL);
+    DBUG_RETURN(fetch_unbuffered_row(res, 0, 0, 0));
   }
   {
     MYSQL_ROW tmp;
@@ -3069,6 +3632,53 @@ mysql_fetch_row(MYSQL_RES *res)
 }
 
 
+/**************************************************************************
+  Return next row of the query results, passing the value of one column
+  to stream_func in pieces as it's read from the server.
+
+  With mysql_use_result() a value that doesn't fit in the packet buffer
+  is never kept in memory as a whole: stream_func is called for each
+  piece read from the connection, and row[column] is an empty string
+  while mysql_fetch_lengths() gives the full length of the value. If
+  stream_func returns non zero, the rest of the value is skipped.
+  Smaller values, and rows of buffered results, are passed to
+  stream_func in one piece. stream_func isn't called for NULL values.
+  With a NULL stream_func this is mysql_fetch_row(). A column that was
+  streamed can't be read with mysql_fetch_int64() and the like, they
+  fail with CR_NO_DATA.
+**************************************************************************/
+
+MYSQL_ROW STDCALL
+mysql_fetch_row_stream(MYSQL_RES *res, unsigned int column,
+                       mysql_stream_func stream_func, void *arg)
+{
+  MYSQL_ROW row;
+  DBUG_ENTER("mysql_fetch_row_stream");
+
+  if (column >= res->field_count)
+  {
+    if (res->handle)
+      set_mysql_error(res->handle, CR_INVALID_PARAMETER_NO, unknown_sqlstate);
+    DBUG_RETURN((MYSQL_ROW) NULL);
+  }
+  if (!res->data)
+  {
+    if (stream_func && !res->extension && !res->eof &&
+        !(res->extension=
+          alloc_root(&res->field_alloc, sizeof(struct st_mysql_res_extension))))
+    {
+      set_mysql_error(res->handle, CR_OUT_OF_MEMORY, unknown_sqlstate);
+      DBUG_RETURN((MYSQL_ROW) NULL);
+    }
+    DBUG_RETURN(fetch_unbuffered_row(res, column, stream_func, arg));
+  }
+
+  if ((row= mysql_fetch_row(res)) && stream_func && row[column])
+    (void) (*stream_func)(arg, row[column], mysql_fetch_lengths(res)[column]);
+  DBUG_RETURN(row);
+}
+
+
 /**************************************************************************
   Get column lengths of the current row
   If one uses mysql_use_result, res->lengths contains the length information,
@@ -3121,19 +3731,19 @@ mysql_options(MYSQL *mysql,enum mysql_option option, const void *arg)
     break;
   case MYSQL_READ_DEFAULT_FILE:
     my_free(mysql->options.my_cnf_file,MYF(MY_ALLOW_ZERO_PTR));
-    mysql->options.my_cnf_file=my_strdup(arg,MYF(MY_WME));
+    mysql->options.my_cnf_file=my_strdup(arg,OPT_ALLOC_FLAGS);
     break;
   case MYSQL_READ_DEFAULT_GROUP:
     my_free(mysql->options.my_cnf_group,MYF(MY_ALLOW_ZERO_PTR));
-    mysql->options.my_cnf_group=my_strdup(arg,MYF(MY_WME));
+    mysql->options.my_cnf_group=my_strdup(arg,OPT_ALLOC_FLAGS);
     break;
   case MYSQL_SET_CHARSET_DIR:
     my_free(mysql->options.charset_dir,MYF(MY_ALLOW_ZERO_PTR));
-    mysql->options.charset_dir=my_strdup(arg,MYF(MY_WME));
+    mysql->options.charset_dir=my_strdup(arg,OPT_ALLOC_FLAGS);
     break;
   case MYSQL_SET_CHARSET_NAME:
     my_free(mysql->options.charset_name,MYF(MY_ALLOW_ZERO_PTR));
-    mysql->options.charset_name=my_strdup(arg,MYF(MY_WME));
+    mysql->options.charset_name=my_strdup(arg,OPT_ALLOC_FLAGS);
     break;
   case MYSQL_OPT_PROTOCOL:
     mysql->options.protocol= *(uint*) arg;
@@ -3142,7 +3752,7 @@ mysql_options(MYSQL *mysql,enum mysql_option option, const void *arg)
 #ifdef HAVE_SMEM
     if (mysql->options.shared_memory_base_name != def_shared_memory_base_name)
       my_free(mysql->options.shared_memory_base_name,MYF(MY_ALLOW_ZERO_PTR));
-    mysql->options.shared_memory_base_name=my_strdup(arg,MYF(MY_WME));
+    mysql->options.shared_memory_base_name=my_strdup(arg,OPT_ALLOC_FLAGS);
 #endif
     break;
   case MYSQL_OPT_USE_REMOTE_CONNECTION:
@@ -3151,7 +3761,7 @@ mysql_options(MYSQL *mysql,enum mysql_option option, const void *arg)
     mysql->options.methods_to_use= option;
     break;
   case MYSQL_SET_CLIENT_IP:
-    mysql->options.client_ip= my_strdup(arg, MYF(MY_WME));
+    mysql->options.client_ip= my_strdup(arg, OPT_ALLOC_FLAGS);
     break;
   case MYSQL_SECURE_AUTH:
     mysql->options.secure_auth= *(my_bool *) arg;
@@ -3168,6 +3778,70 @@ mysql_options(MYSQL *mysql,enum mysql_option option, const void *arg)
     else
       mysql->options.client_flag&= ~CLIENT_SSL_VERIFY_SERVER_CERT;
     break;
+  case MYSQL_OPT_PARALLEL_READ:
+    ENSURE_EXTENSIONS_PRESENT(&mysql->options);
+    if (!mysql->options.extension)
+      DBUG_RETURN(1);
+    OPTIONS_EXTENSION(&mysql->options)->parallel_read= test(*(my_bool*) arg);
+    break;
+  case MYSQL_OPT_LAZY_METADATA:
+    ENSURE_EXTENSIONS_PRESENT(&mysql->options);
+    if (!mysql->options.extension)
+      DBUG_RETURN(1);
+    OPTIONS_EXTENSION(&mysql->options)->lazy_metadata= test(*(my_bool*) arg);
+    break;
+  case MYSQL_OPT_RESULT_MEMORY_LIMIT:
+    ENSURE_EXTENSIONS_PRESENT(&mysql->options);
+    if (!mysql->options.extension)
+      DBUG_RETURN(1);
+    OPTIONS_EXTENSION(&mysql->options)->result_memory_limit=
+      (size_t) *(ulong*) arg;
+    break;
+  case MYSQL_OPT_RESULT_BLOCK_CACHE:
+  {
+    struct st_mysql_options_extention *ext;
+    size_t size= (size_t) *(ulong*) arg;
+    ENSURE_EXTENSIONS_PRESENT(&mysql->options);
+    if (!(ext= OPTIONS_EXTENSION(&mysql->options)))
+      DBUG_RETURN(1);
+    if (ext->block_cache && size)
+      resize_alloc_root_cache(ext->block_cache, size);
+    else if (ext->block_cache)
+    {
+      /* Result sets still using the cache keep it until they are freed */
+      release_alloc_root_cache(ext->block_cache);
+      ext->block_cache= 0;
+    }
+    else if (size && !(ext->block_cache= create_alloc_root_cache(size)))
+      DBUG_RETURN(1);
+    break;
+  }
+  case MYSQL_OPT_HUGE_PAGES:
+    ENSURE_EXTENSIONS_PRESENT(&mysql->options);
+    if (!mysql->options.extension)
+      DBUG_RETURN(1);
+    switch (*(uint*) arg) {
+    case MYSQL_HUGE_PAGES_OFF:
+      OPTIONS_EXTENSION(&mysql->options)->huge_pages= 0;
+      break;
+    case MYSQL_HUGE_PAGES_TRANSPARENT:
+      OPTIONS_EXTENSION(&mysql->options)->huge_pages= MY_HUGE_PAGES;
+      break;
+    case MYSQL_HUGE_PAGES_RESERVED:
+      OPTIONS_EXTENSION(&mysql->options)->huge_pages=
+        MY_HUGE_PAGES | MY_HUGE_PAGES_RESERVED;
+      break;
+    default:
+      DBUG_RETURN(1);
+    }
+    break;
+  case MYSQL_OPT_LOCAL_INFILE_THREAD:
+    ENSURE_EXTENSIONS_PRESENT(&mysql->options);
+    if (!mysql->options.extension)
+      DBUG_RETURN(1);
+    OPTIONS_EXTENSION(&mysql->options)->local_infile_thread=
+      test(*(my_bool*) arg);
+    break;
   default:
     DBUG_RETURN(1);
   }
@@ -3175,6 +3849,31 @@ mysql_options(MYSQL *mysql,enum mysql_option option, const void *arg)
 }
 
 
+/*
+  Get the statistics of the result block cache of a connection
+
+  RETURN
+    0   ok
+    1   the connection has no cache, see MYSQL_OPT_RESULT_BLOCK_CACHE
+*/
+
+my_bool STDCALL
+mysql_block_cache_stats(MYSQL *mysql, MYSQL_BLOCK_CACHE_STATS *stats)
+{
+  ALLOC_ROOT_CACHE_STATS cache_stats;
+  struct st_mysql_options_extention *ext= OPTIONS_EXTENSION(&mysql->options);
+  if (!ext || !ext->block_cache)
+    return 1;
+  get_alloc_root_cache_stats(ext->block_cache, &cache_stats);
+  stats->hits= cache_stats.hits;
+  stats->misses= cache_stats.misses;
+  stats->discarded= cache_stats.discarded;
+  stats->blocks= (ulong) cache_stats.blocks;
+  stats->bytes= (ulong) cache_stats.size;
+  return 0;
+}
+
+
 /****************************************************************************
   Functions to get information from the MySQL structure
   These are functions to make shared libraries more usable.
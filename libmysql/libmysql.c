@@ -21,6 +21,7 @@
 #include <my_sys.h>
 #include <my_time.h>
 #include <mysys_err.h>
+#include <my_dir.h>
 #include <m_string.h>
 #include <m_ctype.h>
 #include "mysql.h"
@@ -233,6 +234,49 @@ MYSQL_PARAMETERS *STDCALL mysql_get_parameters(void)
   return &mysql_internal_parameters;
 }
 
+
+/*
+  Install the functions the library allocates its memory with
+
+  SYNOPSIS
+    mysql_set_allocator()
+    allocator   Functions and their context, 0 for malloc() and free()
+
+  RETURN
+    0  ok
+    1  A function is missing or too many allocators were installed
+*/
+
+my_bool STDCALL mysql_set_allocator(const MYSQL_ALLOCATOR *allocator)
+{
+  MY_ALLOCATOR tmp;
+  if (!allocator)
+    return my_set_allocator(0);
+  tmp.malloc_func= allocator->malloc_func;
+  tmp.realloc_func= allocator->realloc_func;
+  tmp.free_func= allocator->free_func;
+  tmp.context= allocator->context;
+  return my_set_allocator(&tmp);
+}
+
+
+/* Bytes in use, their peak and allocations made, by category */
+
+void STDCALL mysql_memory_stats(MYSQL_MEMORY_STATS *stats)
+{
+  MY_MEMORY_STATS tmp;
+  uint i;
+  compile_time_assert((int) MYSQL_MEMORY_CATEGORIES ==
+                      (int) MY_MEMORY_CATEGORIES);
+  my_get_memory_stats(&tmp);
+  for (i= 0; i < MYSQL_MEMORY_CATEGORIES; i++)
+  {
+    stats->bytes[i]= tmp.bytes[i];
+    stats->peak[i]= tmp.peak[i];
+    stats->allocations[i]= tmp.allocations[i];
+  }
+}
+
 my_bool STDCALL mysql_thread_init()
 {
 #ifdef THREAD
@@ -531,17 +575,269 @@ void read_user_name(char *name)
 
 #endif
 
+typedef struct st_default_local_infile
+{
+  int fd;
+  int error_num;
+  const char *filename;
+  char error_msg[LOCAL_INFILE_ERROR_LEN];
+} default_local_infile_data;
+
+static int default_local_infile_read(void *ptr, char *buf, uint buf_len);
+
+
+#if defined(THREAD) && !defined(WITH_GREENIFY)
+/*
+  LOAD DATA LOCAL INFILE with the file read ahead in a thread
+
+  The thread reads blocks with local_infile_read into two buffers in
+  turn, and frames (and compresses) them, while the caller's thread
+  sends the other buffer. A buffer holds as many packets as fit into
+  INFILE_BUFFER_SIZE, so that the threads don't hand over every packet.
+  The thread owns the packet numbers until it has ended.
+*/
+
+#define INFILE_BUFFER_SIZE (256*1024)
+
+typedef struct st_infile_reader
+{
+  MYSQL *mysql;
+  void *li_ptr;
+  uint packet_length;                   /* Max payload of a packet */
+  size_t buffer_size;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;                  /* Signalled on every change */
+  uchar *buff[2];
+  uchar *packets[2];                    /* Framed packets, 0 if free */
+  size_t length[2];                     /* Length of framed packets */
+  uint pkt_nr, compress_pkt_nr;
+  int readcount;                        /* Last local_infile_read result */
+  my_bool done;                         /* Reader thread has stopped */
+  my_bool abort;                        /* Stop reading */
+} INFILE_READER;
+
+
+static pthread_handler_t infile_reader_thread(void *arg)
+{
+  INFILE_READER *infile= (INFILE_READER*) arg;
+  struct st_mysql_options *options= &infile->mysql->options;
+  my_bool compress= infile->mysql->net.compress, stop;
+  uint i= 0;
+  int readcount= 0;
+
+  my_thread_init();
+  for (;;)
+  {
+    uchar *pos, *end, *start= 0;
+    size_t total= 0;
+
+    pthread_mutex_lock(&infile->lock);
+    while (infile->packets[i] && !infile->abort)
+      pthread_cond_wait(&infile->cond, &infile->lock);
+    stop= infile->abort;
+    pthread_mutex_unlock(&infile->lock);
+    if (stop)
+      break;
+
+    /*
+      Framed packets take the same room in front of the payload, so the
+      next one starts where the last one ends
+    */
+    end= infile->buff[i] + infile->buffer_size;
+    for (pos= infile->buff[i];
+         (size_t) (end - pos) >= infile->packet_length + NET_FRAME_HEADER_SIZE;
+         pos= infile->buff[i] + total)
+    {
+      size_t length;
+      uchar *packet;
+      if ((readcount=
+           (*options->local_infile_read)(infile->li_ptr,
+                                         (char*) pos + NET_FRAME_HEADER_SIZE,
+                                         infile->packet_length)) <= 0)
+        break;
+      length= readcount;
+      packet= my_net_frame_packet(pos, &length, compress, &infile->pkt_nr,
+                                  &infile->compress_pkt_nr);
+      if (!start)
+        start= packet;
+      total+= length;
+    }
+
+    if (start)
+    {
+      pthread_mutex_lock(&infile->lock);
+      infile->packets[i]= start;
+      infile->length[i]= total;
+      pthread_cond_signal(&infile->cond);
+      pthread_mutex_unlock(&infile->lock);
+    }
+    if (readcount <= 0)
+      break;
+    i^= 1;
+  }
+
+  pthread_mutex_lock(&infile->lock);
+  infile->readcount= readcount;
+  infile->done= 1;
+  pthread_cond_signal(&infile->cond);
+  pthread_mutex_unlock(&infile->lock);
+  my_thread_end();
+  return 0;
+}
+
+
+/*
+  Send the file with a reader thread
+
+  RETURN
+    -1  the thread couldn't be started, nothing was sent
+    0   ok; *readcount is the last result of local_infile_read
+    1   write error
+*/
+
+static int send_infile_pipelined(MYSQL *mysql, void *li_ptr,
+                                 uint packet_length, int *readcount)
+{
+  NET *net= &mysql->net;
+  INFILE_READER infile;
+  uint i= 0;
+  int error= 0;
+  DBUG_ENTER("send_infile_pipelined");
+
+  infile.buffer_size= max(INFILE_BUFFER_SIZE,
+                          packet_length + NET_FRAME_HEADER_SIZE);
+  if (net_flush(net) ||
+      !(infile.buff[0]= (uchar*) my_malloc(2 * infile.buffer_size,
+                                            MYF(MY_MEM_NET))))
+    DBUG_RETURN(-1);
+  infile.buff[1]= infile.buff[0] + infile.buffer_size;
+  infile.mysql= mysql;
+  infile.li_ptr= li_ptr;
+  infile.packet_length= packet_length;
+  infile.packets[0]= infile.packets[1]= 0;
+  infile.pkt_nr= net->pkt_nr;
+  infile.compress_pkt_nr= net->compress_pkt_nr;
+  infile.readcount= 0;
+  infile.done= infile.abort= 0;
+  pthread_mutex_init(&infile.lock, MY_MUTEX_INIT_FAST);
+  pthread_cond_init(&infile.cond, NULL);
+  if (pthread_create(&infile.thread, NULL, infile_reader_thread,
+                     (void*) &infile))
+  {
+    error= -1;
+    goto end;
+  }
+
+  for (;;)
+  {
+    pthread_mutex_lock(&infile.lock);
+    while (!infile.packets[i] && !infile.done)
+      pthread_cond_wait(&infile.cond, &infile.lock);
+    pthread_mutex_unlock(&infile.lock);
+    /* Buffers are filled in turn, so when this one is empty none is left */
+    if (!infile.packets[i])
+      break;
+
+    if (my_net_write_framed(net, infile.packets[i], infile.length[i]))
+    {
+      error= 1;
+      pthread_mutex_lock(&infile.lock);
+      infile.abort= 1;
+      pthread_cond_signal(&infile.cond);
+      pthread_mutex_unlock(&infile.lock);
+      break;
+    }
+
+    pthread_mutex_lock(&infile.lock);
+    infile.packets[i]= 0;
+    pthread_cond_signal(&infile.cond);
+    pthread_mutex_unlock(&infile.lock);
+    i^= 1;
+  }
+  pthread_join(infile.thread, NULL);
+  net->pkt_nr= infile.pkt_nr;
+  net->compress_pkt_nr= infile.compress_pkt_nr;
+  *readcount= infile.readcount;
+
+end:
+  pthread_cond_destroy(&infile.cond);
+  pthread_mutex_destroy(&infile.lock);
+  my_free(infile.buff[0], MYF(0));
+  DBUG_RETURN(error);
+}
+#endif /* THREAD && !WITH_GREENIFY */
+
+
+#ifdef HAVE_NET_SENDFILE
+/*
+  Send what the file has now with sendfile(), if the connection allows
+
+  RETURN
+    -1  sendfile() can't be used, nothing was sent
+    0   ok; anything added to the file since is read as usual
+    1   write error
+*/
+
+static int send_infile_sendfile(NET *net, File fd, uint packet_length)
+{
+  MY_STAT stat_info;
+  my_off_t pos, left;
+  DBUG_ENTER("send_infile_sendfile");
+
+  if (net->compress || !net->vio ||
+      (vio_type(net->vio) != VIO_TYPE_TCPIP &&
+       vio_type(net->vio) != VIO_TYPE_SOCKET) ||
+      my_fstat(fd, &stat_info, MYF(0)) ||
+      !MY_S_ISREG(stat_info.st_mode) ||
+      (pos= my_tell(fd, MYF(0))) == MY_FILEPOS_ERROR ||
+      (my_off_t) stat_info.st_size <= pos)
+    DBUG_RETURN(-1);
+
+  for (left= stat_info.st_size - pos; left; )
+  {
+    size_t part= (size_t) min(left, packet_length);
+    if (my_net_write_file(net, fd, part))
+      DBUG_RETURN(1);
+    left-= part;
+  }
+  DBUG_RETURN(0);
+}
+#endif
+
+
+/*
+  Send the file of LOAD DATA LOCAL INFILE to the server
+
+  DESCRIPTION
+    The file is sent in packets of at most max_packet bytes, each
+    block read with local_infile_read is one packet.
+
+    With the default handlers, the file is sent with sendfile() on
+    connections without SSL or compression, so that it's not copied
+    through user space. On other connections, and with handlers set by
+    mysql_set_local_infile_handler() if MYSQL_OPT_LOCAL_INFILE_THREAD is
+    set, a thread reads ahead and compresses, while this thread sends.
+    The read handler is then called in that thread, one call at a time.
+    Otherwise blocks are read and sent in turn.
+*/
+
 my_bool handle_local_infile(MYSQL *mysql, const char *net_filename)
 {
   my_bool result= 1;
   uint packet_length=MY_ALIGN(mysql->net.max_packet-16,IO_SIZE);
   NET *net= &mysql->net;
-  int readcount;
+  int readcount= 0, sent= -1;
   void *li_ptr;          /* pass state to local_infile functions */
-  char *buf;		/* buffer to be filled by local_infile_read */
+  uchar *buf;		/* packet header + data from local_infile_read */
+  my_bool default_handler, read_done= 0;
   struct st_mysql_options *options= &mysql->options;
   DBUG_ENTER("handle_local_infile");
 
+  /* Every block is sent as one packet, which must stay below 16M */
+  set_if_smaller(packet_length,
+                 (256L*256L*256L - 1 - NET_HEADER_SIZE) / IO_SIZE * IO_SIZE);
+
   /* check that we've got valid callback functions */
   if (!(options->local_infile_init &&
 	options->local_infile_read &&
@@ -551,9 +847,15 @@ my_bool handle_local_infile(MYSQL *mysql, const char *net_filename)
     /* if any of the functions is invalid, set the default */
     mysql_set_local_infile_default(mysql);
   }
+  default_handler= options->local_infile_read == default_local_infile_read;
 
-  /* copy filename into local memory and allocate read buffer */
-  if (!(buf=my_malloc(packet_length, MYF(0))))
+  /*
+    Allocate read buffer. Room for the packet headers is reserved in
+    front of the data so that blocks can be sent without copying them to
+    the net buffer.
+  */
+  if (!(buf= (uchar*) my_malloc(packet_length + NET_FRAME_HEADER_SIZE,
+                                MYF(MY_MEM_NET))))
   {
     set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
     DBUG_RETURN(1);
@@ -573,17 +875,45 @@ my_bool handle_local_infile(MYSQL *mysql, const char *net_filename)
     goto err;
   }
 
+#ifdef HAVE_NET_SENDFILE
+  if (default_handler)
+    sent= send_infile_sendfile(net,
+                               ((default_local_infile_data*) li_ptr)->fd,
+                               packet_length);
+#endif
+#if defined(THREAD) && !defined(WITH_GREENIFY)
+  if (sent < 0 &&
+      (default_handler ||
+       (options->extension &&
+        OPTIONS_EXTENSION(options)->local_infile_thread)))
+  {
+    sent= send_infile_pipelined(mysql, li_ptr, packet_length, &readcount);
+    read_done= sent == 0;
+  }
+#endif
+  if (sent > 0)
+  {
+    DBUG_PRINT("error",
+               ("Lost connection to MySQL server during LOAD DATA of local file"));
+    set_mysql_error(mysql, CR_SERVER_LOST, unknown_sqlstate);
+    goto err;
+  }
+
   /* read blocks of data from local infile callback */
-  while ((readcount =
-	  (*options->local_infile_read)(li_ptr, buf,
-					packet_length)) > 0)
+  if (!read_done)
   {
-    if (my_net_write(net, (uchar*) buf, readcount))
+    while ((readcount =
+            (*options->local_infile_read)(li_ptr,
+                                          (char*) buf + NET_FRAME_HEADER_SIZE,
+                                          packet_length)) > 0)
     {
-      DBUG_PRINT("error",
-		 ("Lost connection to MySQL server during LOAD DATA of local file"));
-      set_mysql_error(mysql, CR_SERVER_LOST, unknown_sqlstate);
-      goto err;
+      if (my_net_write_inplace(net, buf, readcount))
+      {
+        DBUG_PRINT("error",
+                   ("Lost connection to MySQL server during LOAD DATA of local file"));
+        set_mysql_error(mysql, CR_SERVER_LOST, unknown_sqlstate);
+        goto err;
+      }
     }
   }
 
@@ -617,15 +947,6 @@ err:
   Default handlers for LOAD LOCAL INFILE
 ****************************************************************************/
 
-typedef struct st_default_local_infile
-{
-  int fd;
-  int error_num;
-  const char *filename;
-  char error_msg[LOCAL_INFILE_ERROR_LEN];
-} default_local_infile_data;
-
-
 /*
   Open file for LOAD LOCAL INFILE
 
@@ -666,6 +987,13 @@ static int default_local_infile_init(void **ptr, const char *filename,
                 EE(EE_FILENOTFOUND), tmp_name, data->error_num);
     return 1;
   }
+#ifdef HAVE_POSIX_FADVISE
+  /*
+    The file is read once from start to end. Let the kernel read ahead
+    aggressively so that disk reads overlap with sending to the server.
+  */
+  (void) posix_fadvise(data->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
   return 0; /* ok */
 }
 
@@ -804,6 +1132,87 @@ mysql_fetch_field(MYSQL_RES *result)
 }
 
 
+/*
+  Index of the rows of a stored result, so that seeking doesn't walk the
+  row list. It's kept in MYSQL_DATA::extension and allocated on
+  MYSQL_DATA::alloc, so it goes away with the rows; whoever frees the
+  rows but keeps the MYSQL_DATA must reset extension. It's built on the
+  first seek past ROWS_INDEX_MIN rows. The row pointers are kept in
+  chunks of ROWS_INDEX_CHUNK, so the index costs one pointer per row and
+  no large block is ever allocated or copied.
+*/
+
+#define ROWS_INDEX_CHUNK_BITS 10
+#define ROWS_INDEX_CHUNK      (1 << ROWS_INDEX_CHUNK_BITS)
+#define ROWS_INDEX_MIN        64
+
+typedef struct st_rows_index
+{
+  MYSQL_ROWS ***chunks;
+  my_ulonglong rows;
+} ROWS_INDEX;
+
+static ROWS_INDEX *build_rows_index(MYSQL_DATA *data)
+{
+  ROWS_INDEX *index;
+  MYSQL_ROWS *cur, **chunk= NULL;
+  my_ulonglong rows= 0, i;
+  DBUG_ENTER("build_rows_index");
+
+  for (cur= data->data; cur; cur= cur->next)
+    rows++;
+  if (!(index= (ROWS_INDEX*) alloc_root(&data->alloc, sizeof(ROWS_INDEX))) ||
+      !(index->chunks= (MYSQL_ROWS***)
+        alloc_root(&data->alloc, (size_t) ((rows + ROWS_INDEX_CHUNK - 1) >>
+                                           ROWS_INDEX_CHUNK_BITS) *
+                                 sizeof(MYSQL_ROWS**) + 1)))
+    DBUG_RETURN(0);
+  for (cur= data->data, i= 0; cur; cur= cur->next, i++)
+  {
+    if (!(i & (ROWS_INDEX_CHUNK - 1)))
+    {
+      size_t count= (size_t) min(rows - i, ROWS_INDEX_CHUNK);
+      if (!(chunk= (MYSQL_ROWS**) alloc_root(&data->alloc,
+                                              count * sizeof(MYSQL_ROWS*))))
+        DBUG_RETURN(0);
+      index->chunks[i >> ROWS_INDEX_CHUNK_BITS]= chunk;
+    }
+    chunk[i & (ROWS_INDEX_CHUNK - 1)]= cur;
+  }
+  index->rows= rows;
+  data->extension= index;
+  DBUG_RETURN(index);
+}
+
+
+/*
+  Find a row of a stored result
+
+  SYNOPSIS
+    seek_stored_row()
+    data        Stored rows
+    row         Number of the row, the first row is 0
+
+  RETURN
+    The row, or NULL if there are not that many rows
+*/
+
+static MYSQL_ROWS *seek_stored_row(MYSQL_DATA *data, my_ulonglong row)
+{
+  ROWS_INDEX *index= (ROWS_INDEX*) data->extension;
+  MYSQL_ROWS *tmp;
+
+  /* If the index can't be allocated, just walk the list */
+  if (index || (row >= ROWS_INDEX_MIN && (index= build_rows_index(data))))
+    return row < index->rows ?
+           index->chunks[row >> ROWS_INDEX_CHUNK_BITS]
+                        [row & (ROWS_INDEX_CHUNK - 1)] : NULL;
+  for (tmp= data->data; row-- && tmp; tmp= tmp->next)
+    ;
+  return tmp;
+}
+
+
 /**************************************************************************
   Move to a specific row and column
 **************************************************************************/
@@ -814,7 +1223,7 @@ mysql_data_seek(MYSQL_RES *result, my_ulonglong row)
   MYSQL_ROWS	*tmp=0;
   DBUG_PRINT("info",("mysql_data_seek(%ld)",(long) row));
   if (result->data)
-    for (tmp=result->data->data; row-- && tmp ; tmp = tmp->next) ;
+    tmp= seek_stored_row(result->data, row);
   result->current_row=0;
   result->data_cursor = tmp;
 }
@@ -888,7 +1297,7 @@ MYSQL_FIELD *cli_list_fields(MYSQL *mysql)
     return NULL;
 
   mysql->field_count= (uint) query->rows;
-  return unpack_fields(query,&mysql->field_alloc,
+  return unpack_fields(mysql, query,&mysql->field_alloc,
 		       mysql->field_count, 1, mysql->server_capabilities);
 }
 
@@ -917,7 +1326,8 @@ mysql_list_fields(MYSQL *mysql, const char *table, const char *wild)
     DBUG_RETURN(NULL);
 
   if (!(result = (MYSQL_RES *) my_malloc(sizeof(MYSQL_RES),
-					 MYF(MY_WME | MY_ZEROFILL))))
+					 MYF(MY_WME | MY_ZEROFILL |
+                                             MY_MEM_RESULT))))
     DBUG_RETURN(NULL);
 
   result->methods= mysql->methods;
@@ -948,7 +1358,7 @@ mysql_list_processes(MYSQL *mysql)
   if (!(fields = (*mysql->methods->read_rows)(mysql,(MYSQL_FIELD*) 0,
 					      protocol_41(mysql) ? 7 : 5)))
     DBUG_RETURN(NULL);
-  if (!(mysql->fields=unpack_fields(fields,&mysql->field_alloc,field_count,0,
+  if (!(mysql->fields=unpack_fields(mysql,fields,&mysql->field_alloc,field_count,0,
 				    mysql->server_capabilities)))
     DBUG_RETURN(0);
   mysql->status=MYSQL_STATUS_GET_RESULT;
@@ -1115,6 +1525,425 @@ MYSQL_FIELD_OFFSET STDCALL mysql_field_tell(MYSQL_RES *res)
   return (res)->current_field;
 }
 
+
+/**************************************************************************
+  Typed access to the columns of the current row
+
+  mysql_fetch_int64(), mysql_fetch_uint64(), mysql_fetch_double() and
+  mysql_fetch_datetime() convert one column of the row last returned by
+  mysql_fetch_row() directly from the row buffer, without copying it or
+  relying on the terminating null.
+
+  *is_null is set for a NULL value, which zeroes *value; is_null may be
+  NULL if the caller doesn't need to tell NULL from zero. Columns with
+  UNSIGNED_FLAG are read with mysql_fetch_uint64(); mysql_fetch_int64()
+  truncates their values above LONGLONG_MAX.
+
+  A NULL res, as left by a failed mysql_store_result() or
+  mysql_use_result(), is an error like any other; the batch versions
+  fetch no rows from it.
+
+  RETURN VALUES
+    0                     ok, or NULL
+    1                     error: no result set, no current row, column out
+                          of range or a column type that can't be
+                          converted; the error is set in res->handle if
+                          there is one
+    MYSQL_DATA_TRUNCATED  the value didn't fit, or only a prefix of it
+                          could be converted; *value holds the nearest
+                          value that could be converted
+**************************************************************************/
+
+static void set_result_error(MYSQL_RES *res, int errcode, uint column)
+{
+  MYSQL *mysql= res->handle;
+  if (!mysql)
+    return;
+  if (errcode == CR_UNSUPPORTED_PARAM_TYPE)
+  {
+    strmov(mysql->net.sqlstate, unknown_sqlstate);
+    sprintf(mysql->net.last_error,
+            ER(mysql->net.last_errno= CR_UNSUPPORTED_PARAM_TYPE),
+            res->fields[column].type, column);
+  }
+  else
+    set_mysql_error(mysql, errcode, unknown_sqlstate);
+}
+
+
+/*
+  Find a column of the current row and its length
+
+  RETURN VALUES
+    1   error
+    0   ok, *data is NULL for NULL values
+*/
+
+static my_bool get_column_data(MYSQL_RES *res, uint column,
+                               const char **data, ulong *length)
+{
+  MYSQL_ROW row;
+  uint next;
+
+  if (!res)
+    return 1;
+  row= res->current_row;
+  if (column >= res->field_count)
+  {
+    set_result_error(res, CR_INVALID_PARAMETER_NO, column);
+    return 1;
+  }
+  if (!row || (!res->data && res->eof))
+  {
+    set_result_error(res, CR_NO_DATA, column);
+    return 1;
+  }
+  if (!(*data= row[column]))
+    return 0;
+  if (!res->data)
+  {
+    /* a streamed value isn't in the row, only its length is */
+    if (res->extension && RES_EXTENSION(res)->streamed_column == column)
+    {
+      set_result_error(res, CR_NO_DATA, column);
+      return 1;
+    }
+    /* unbuffered rows have their lengths set when they are read */
+    *length= res->lengths[column];
+    return 0;
+  }
+  /*
+    In buffered rows the next non NULL column starts one byte after the
+    end of this one; row[field_count] points past the last column.
+  */
+  for (next= column + 1; !row[next]; next++)
+    ;
+  *length= (ulong) (row[next] - row[column] - 1);
+  return 0;
+}
+
+
+static my_bool is_temporal_type(enum enum_field_types type)
+{
+  return type == MYSQL_TYPE_DATE || type == MYSQL_TYPE_TIME ||
+         type == MYSQL_TYPE_DATETIME || type == MYSQL_TYPE_TIMESTAMP ||
+         type == MYSQL_TYPE_NEWDATE;
+}
+
+
+/*
+  Return code of fetch_column_int64() and fetch_column_uint64() for a
+  my_strtoll10() result, which is stored in *value. For is_unsigned
+  *value is taken as an ulonglong.
+*/
+
+static int int64_status(const char *data, const char *end, ulong length,
+                        int error, longlong *value, my_bool is_unsigned)
+{
+  if (error > 0)
+  {
+    /* out of range, *value is ~0 or LONGLONG_MIN */
+    if (error == MY_ERRNO_ERANGE)
+    {
+      if (is_unsigned)
+        *value= *value == LONGLONG_MIN ? 0 : (longlong) ULONGLONG_MAX;
+      else
+        *value= *value == LONGLONG_MIN ? LONGLONG_MIN : LONGLONG_MAX;
+    }
+    return MYSQL_DATA_TRUNCATED;
+  }
+  if (is_unsigned && error && *value)
+  {
+    /* a negative value */
+    *value= 0;
+    return MYSQL_DATA_TRUNCATED;
+  }
+  if (!is_unsigned && !error && *value < 0)
+  {
+    /* an unsigned value above LONGLONG_MAX */
+    *value= LONGLONG_MAX;
+    return MYSQL_DATA_TRUNCATED;
+  }
+  return end != data + length ? MYSQL_DATA_TRUNCATED : 0;
+}
+
+
+/* Set *is_null, if given, and tell if the value is NULL */
+
+static my_bool set_is_null(const char *data, my_bool *is_null)
+{
+  if (is_null)
+    *is_null= !data;
+  return !data;
+}
+
+
+static int fetch_column_int(MYSQL_RES *res, uint column, longlong *to,
+                            my_bool *is_null, my_bool is_unsigned)
+{
+  const char *data;
+  char *end;
+  ulong length;
+  int error;
+
+  if (get_column_data(res, column, &data, &length))
+    return 1;
+  if (is_temporal_type(res->fields[column].type))
+  {
+    set_result_error(res, CR_UNSUPPORTED_PARAM_TYPE, column);
+    return 1;
+  }
+  if (set_is_null(data, is_null))
+  {
+    *to= 0;
+    return 0;
+  }
+  end= (char*) data + length;
+  *to= my_strtoll10(data, &end, &error);
+  return int64_status(data, end, length, error, to, is_unsigned);
+}
+
+
+static int fetch_column_int64(MYSQL_RES *res, uint column, void *value,
+                              my_bool *is_null)
+{
+  return fetch_column_int(res, column, (longlong*) value, is_null, FALSE);
+}
+
+
+static int fetch_column_uint64(MYSQL_RES *res, uint column, void *value,
+                               my_bool *is_null)
+{
+  return fetch_column_int(res, column, (longlong*) value, is_null, TRUE);
+}
+
+
+static int fetch_column_double(MYSQL_RES *res, uint column, void *value,
+                               my_bool *is_null)
+{
+  double *to= (double*) value;
+  const char *data;
+  char *end;
+  ulong length;
+  int error;
+
+  if (get_column_data(res, column, &data, &length))
+    return 1;
+  if (is_temporal_type(res->fields[column].type))
+  {
+    set_result_error(res, CR_UNSUPPORTED_PARAM_TYPE, column);
+    return 1;
+  }
+  if (set_is_null(data, is_null))
+  {
+    *to= 0.0;
+    return 0;
+  }
+  end= (char*) data + length;
+  *to= my_strtod(data, &end, &error);
+  return (error || end != data + length) ? MYSQL_DATA_TRUNCATED : 0;
+}
+
+
+static int fetch_column_datetime(MYSQL_RES *res, uint column, void *value,
+                                 my_bool *is_null)
+{
+  MYSQL_TIME *to= (MYSQL_TIME*) value;
+  enum enum_field_types type;
+  const char *data;
+  ulong length;
+  int warning;
+
+  if (get_column_data(res, column, &data, &length))
+    return 1;
+  type= res->fields[column].type;
+  if (IS_NUM(type))
+  {
+    set_result_error(res, CR_UNSUPPORTED_PARAM_TYPE, column);
+    return 1;
+  }
+  if (set_is_null(data, is_null))
+  {
+    bzero((char*) to, sizeof(*to));
+    to->time_type= MYSQL_TIMESTAMP_NONE;
+    return 0;
+  }
+  if (type == MYSQL_TYPE_TIME)
+  {
+    if (str_to_time(data, (uint) length, to, &warning))
+      return MYSQL_DATA_TRUNCATED;
+  }
+  else if (str_to_datetime(data, (uint) length, to, TIME_FUZZY_DATE,
+                           &warning) <= MYSQL_TIMESTAMP_ERROR)
+    return MYSQL_DATA_TRUNCATED;
+  return warning ? MYSQL_DATA_TRUNCATED : 0;
+}
+
+
+/*
+  Convert one column of the next count rows
+
+  SYNOPSIS
+    fetch_column_batch()
+    res             result set
+    column          column number
+    values          array of count values of value_size bytes each
+    is_null         array of count NULL indicators, or NULL
+    status          array of count return codes of fetch_func, or NULL
+    count           number of rows to fetch
+    fetch_func      conversion function
+
+  RETURN VALUES
+    Number of rows fetched. Fewer than count rows are fetched at the end
+    of the result set, or on error; mysql_errno() tells which.
+*/
+
+typedef int (*fetch_column_func)(MYSQL_RES *res, uint column, void *value,
+                                 my_bool *is_null);
+
+static ulong fetch_column_batch(MYSQL_RES *res, uint column, uchar *values,
+                                size_t value_size, my_bool *is_null,
+                                int *status, ulong count,
+                                fetch_column_func fetch_func)
+{
+  ulong rows;
+  int rc;
+
+  if (!res)
+    return 0;
+  if (column >= res->field_count)
+  {
+    set_result_error(res, CR_INVALID_PARAMETER_NO, column);
+    return 0;
+  }
+  for (rows= 0; rows < count && mysql_fetch_row(res); rows++)
+  {
+    if ((rc= (*fetch_func)(res, column, values + rows * value_size,
+                           is_null ? is_null + rows : NULL)) == 1)
+      break;
+    if (status)
+      status[rows]= rc;
+  }
+  return rows;
+}
+
+
+int STDCALL
+mysql_fetch_int64(MYSQL_RES *res, unsigned int column, long long *value,
+                  my_bool *is_null)
+{
+  return fetch_column_int64(res, column, value, is_null);
+}
+
+int STDCALL
+mysql_fetch_uint64(MYSQL_RES *res, unsigned int column,
+                   unsigned long long *value, my_bool *is_null)
+{
+  return fetch_column_uint64(res, column, value, is_null);
+}
+
+int STDCALL
+mysql_fetch_double(MYSQL_RES *res, unsigned int column, double *value,
+                   my_bool *is_null)
+{
+  return fetch_column_double(res, column, value, is_null);
+}
+
+int STDCALL
+mysql_fetch_datetime(MYSQL_RES *res, unsigned int column, MYSQL_TIME *value,
+                     my_bool *is_null)
+{
+  return fetch_column_datetime(res, column, value, is_null);
+}
+
+/*
+  For buffered results, whose rows stay in memory, the strings of up to
+  FETCH_INT64_CHUNK rows are collected and converted with one
+  my_strtoll10_batch() call.
+*/
+
+#define FETCH_INT64_CHUNK 64
+
+static ulong fetch_int_batch(MYSQL_RES *res, uint column, longlong *values,
+                             my_bool *is_null, int *status, ulong count,
+                             my_bool is_unsigned)
+{
+  const char *strs[FETCH_INT64_CHUNK];
+  char *ends[FETCH_INT64_CHUNK];
+  ulong lengths[FETCH_INT64_CHUNK];
+  int errors[FETCH_INT64_CHUNK];
+  ulong rows= 0, n, i;
+  my_bool eof= FALSE;
+
+  /* Errors are reported after the first row, as the row at a time way does */
+  if (!res || !res->data || column >= res->field_count ||
+      is_temporal_type(res->fields[column].type))
+    return fetch_column_batch(res, column, (uchar*) values, sizeof(*values),
+                              is_null, status, count,
+                              is_unsigned ? fetch_column_uint64 :
+                                            fetch_column_int64);
+
+  while (rows < count && !eof)
+  {
+    for (n= 0; n < FETCH_INT64_CHUNK && rows + n < count; n++)
+    {
+      if (!mysql_fetch_row(res))
+      {
+        eof= TRUE;
+        break;
+      }
+      get_column_data(res, column, strs + n, lengths + n);
+      if (strs[n])
+        ends[n]= (char*) strs[n] + lengths[n];
+    }
+    my_strtoll10_batch(strs, ends, values + rows, errors, n);
+    for (i= 0; i < n; i++)
+    {
+      int rc= strs[i] ? int64_status(strs[i], ends[i], lengths[i], errors[i],
+                                     values + rows + i, is_unsigned) : 0;
+      if (is_null)
+        is_null[rows + i]= !strs[i];
+      if (status)
+        status[rows + i]= rc;
+    }
+    rows+= n;
+  }
+  return rows;
+}
+
+unsigned long STDCALL
+mysql_fetch_int64_batch(MYSQL_RES *res, unsigned int column, long long *values,
+                        my_bool *is_null, int *status, unsigned long count)
+{
+  return fetch_int_batch(res, column, values, is_null, status, count, FALSE);
+}
+
+unsigned long STDCALL
+mysql_fetch_uint64_batch(MYSQL_RES *res, unsigned int column,
+                         unsigned long long *values, my_bool *is_null,
+                         int *status, unsigned long count)
+{
+  return fetch_int_batch(res, column, (longlong*) values, is_null, status,
+                         count, TRUE);
+}
+
+unsigned long STDCALL
+mysql_fetch_double_batch(MYSQL_RES *res, unsigned int column, double *values,
+                         my_bool *is_null, int *status, unsigned long count)
+{
+  return fetch_column_batch(res, column, (uchar*) values, sizeof(*values),
+                            is_null, status, count, fetch_column_double);
+}
+
+unsigned long STDCALL
+mysql_fetch_datetime_batch(MYSQL_RES *res, unsigned int column,
+                           MYSQL_TIME *values, my_bool *is_null, int *status,
+                           unsigned long count)
+{
+  return fetch_column_batch(res, column, (uchar*) values, sizeof(*values),
+                            is_null, status, count, fetch_column_datetime);
+}
+
 /* MYSQL */
 
 unsigned int STDCALL mysql_field_count(MYSQL *mysql)
@@ -1232,16 +2061,28 @@ void my_net_local_init(NET *net)
 ulong STDCALL
 mysql_hex_string(char *to, const char *from, ulong length)
 {
-  char *to0= to;
-  const char *end;
-            
-  for (end= from + length; from < end; from++)
-  {
-    *to++= _dig_vec_upper[((unsigned char) *from) >> 4];
-    *to++= _dig_vec_upper[((unsigned char) *from) & 0x0F];
-  }
-  *to= '\0';
-  return (ulong) (to-to0);
+  size_t to_length= my_hex_encode(to, (const uchar*) from, length);
+  to[to_length]= '\0';
+  return (ulong) to_length;
+}
+
+/*
+  The reverse of mysql_hex_string(): converts the hex digits in "from"
+  back to binary. Upper and lower case digits are accepted, but no
+  leading 0x or X' and no trailing '.
+
+  The "to" buffer must be at least length/2 bytes long. No terminating
+  null byte is added.
+
+  The return value is the number of bytes written to "to", or (ulong) -1
+  if "length" is odd or "from" contains anything but hex digits.
+*/
+
+ulong STDCALL
+mysql_unhex_string(char *to, const char *from, ulong length)
+{
+  size_t to_length= my_hex_decode((uchar*) to, from, length);
+  return to_length == (size_t) -1 ? (ulong) -1 : (ulong) to_length;
 }
 
 /*
@@ -1314,6 +2155,43 @@ myodbc_remove_escape(MYSQL *mysql,char *name)
 
 #define DEFAULT_PREFETCH_ROWS (ulong) 1
 
+/*
+  Size of the buffer used to coalesce mysql_stmt_long_data_write() calls.
+  Each COM_STMT_SEND_LONG_DATA packet is at most this big, which keeps it
+  below the default max_allowed_packet of the server.
+*/
+
+#define LONG_DATA_STREAM_BUFFER (ulong) (1024L*1024L - IO_SIZE)
+
+/*
+  Client side state of a statement that doesn't fit into MYSQL_STMT.
+  It's allocated together with the statement and is reached through
+  MYSQL_STMT::extension.
+*/
+
+typedef struct st_mysql_stmt_extension
+{
+  /*
+    Buffer of the long data stream: stmt id and parameter number
+    followed by the data that is not yet sent. Kept between streams.
+  */
+  uchar *long_data_buff;
+  ulong long_data_length;               /* Bytes pending in the buffer */
+  uint long_data_param;                 /* Parameter of the stream */
+  my_bool long_data_open;               /* A stream is open */
+  /* Cursor fetch, see STMT_ATTR_PREFETCH_BYTES and _PIPELINE */
+  ulong prefetch_bytes;
+  ulong fetch_rows;                     /* Rows to ask for in next fetch */
+  my_bool prefetch_pipeline;
+  my_bool fetch_pending;                /* COM_STMT_FETCH already sent */
+  /* Column offset tables, see STMT_ATTR_ROW_OFFSETS */
+  my_bool row_offsets;
+  my_bool rows_have_offsets;            /* Stored rows have the tables */
+  uchar *fetch_row;                     /* Row of last mysql_stmt_fetch */
+} MYSQL_STMT_EXT;
+
+#define STMT_EXT(stmt) ((MYSQL_STMT_EXT *) (stmt)->extension)
+
 /*
   These functions are called by function pointer MYSQL_STMT::read_row_func.
   Each function corresponds to one of the read methods:
@@ -1327,6 +2205,8 @@ static int stmt_read_row_buffered(MYSQL_STMT *stmt, unsigned char **row);
 static int stmt_read_row_from_cursor(MYSQL_STMT *stmt, unsigned char **row);
 static int stmt_read_row_no_data(MYSQL_STMT *stmt, unsigned char **row);
 static int stmt_read_row_no_result_set(MYSQL_STMT *stmt, unsigned char **row);
+static my_bool stmt_send_fetch(MYSQL_STMT *stmt);
+static void stmt_adjust_prefetch(MYSQL_STMT *stmt);
 
 /*
   This function is used in mysql_stmt_store_result if
@@ -1343,6 +2223,7 @@ static my_bool setup_one_fetch_function(MYSQL_BIND *, MYSQL_FIELD *field);
 #define RESET_CLEAR_ERROR 8
 
 static my_bool reset_stmt_handle(MYSQL_STMT *stmt, uint flags);
+static my_bool stmt_flush_long_data(MYSQL_STMT *stmt);
 
 /*
   Maximum sizes of MYSQL_TYPE_DATE, MYSQL_TYPE_TIME, MYSQL_TYPE_DATETIME
@@ -1442,7 +2323,7 @@ void set_stmt_error(MYSQL_STMT * stmt, int errcode,
     err= ER(errcode);
 
   stmt->last_errno= errcode;
-  strmov(stmt->last_error, ER(errcode));
+  strmake(stmt->last_error, err, sizeof(stmt->last_error) - 1);
   strmov(stmt->sqlstate, sqlstate);
 
   DBUG_VOID_RETURN;
@@ -1525,7 +2406,7 @@ my_bool cli_read_prepare_result(MYSQL *mysql, MYSQL_STMT *stmt)
 
     if (!(fields_data= (*mysql->methods->read_rows)(mysql,(MYSQL_FIELD*)0,7)))
       DBUG_RETURN(1);
-    if (!(stmt->fields= unpack_fields(fields_data,&stmt->mem_root,
+    if (!(stmt->fields= unpack_fields(mysql,fields_data,&stmt->mem_root,
 				      field_count,0,
 				      mysql->server_capabilities)))
       DBUG_RETURN(1);
@@ -1576,8 +2457,10 @@ mysql_stmt_init(MYSQL *mysql)
   MYSQL_STMT *stmt;
   DBUG_ENTER("mysql_stmt_init");
 
-  if (!(stmt= (MYSQL_STMT *) my_malloc(sizeof(MYSQL_STMT),
-                                       MYF(MY_WME | MY_ZEROFILL))))
+  if (!(stmt= (MYSQL_STMT *) my_malloc(sizeof(MYSQL_STMT) +
+                                       sizeof(MYSQL_STMT_EXT),
+                                       MYF(MY_WME | MY_ZEROFILL |
+                                           MY_MEM_STATEMENT))))
   {
     set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
     DBUG_RETURN(0);
@@ -1592,6 +2475,7 @@ mysql_stmt_init(MYSQL *mysql)
   stmt->mysql= mysql;
   stmt->read_row_func= stmt_read_row_no_result_set;
   stmt->prefetch_rows= DEFAULT_PREFETCH_ROWS;
+  stmt->extension= stmt + 1;
   strmov(stmt->sqlstate, not_error_sqlstate);
   /* The rest of statement members was bzeroed inside malloc */
 
@@ -1861,7 +2745,8 @@ mysql_stmt_result_metadata(MYSQL_STMT *stmt)
      DBUG_RETURN(0);
 
   if (!(result=(MYSQL_RES*) my_malloc(sizeof(*result),
-                                      MYF(MY_WME | MY_ZEROFILL))))
+                                      MYF(MY_WME | MY_ZEROFILL |
+                                          MY_MEM_RESULT))))
   {
     set_stmt_error(stmt, CR_OUT_OF_MEMORY, unknown_sqlstate, NULL);
     DBUG_RETURN(0);
@@ -2204,7 +3089,8 @@ int cli_stmt_execute(MYSQL_STMT *stmt)
     }
     length= (ulong) (net->write_pos - net->buff);
     /* TODO: Look into avoding the following memdup */
-    if (!(param_data= my_memdup(net->buff, length, MYF(0))))
+    if (!(param_data= my_memdup(net->buff, length,
+                                   MYF(MY_MEM_STATEMENT))))
     {
       set_stmt_error(stmt, CR_OUT_OF_MEMORY, unknown_sqlstate, NULL);
       DBUG_RETURN(1);
@@ -2330,18 +3216,28 @@ stmt_read_row_from_cursor(MYSQL_STMT *stmt, unsigned char **row)
     MYSQL *mysql= stmt->mysql;
     NET *net= &mysql->net;
     MYSQL_DATA *result= &stmt->result;
-    uchar buff[4 /* statement id */ +
-               4 /* number of rows to fetch */];
+    MYSQL_STMT_EXT *ext= STMT_EXT(stmt);
 
     free_root(&result->alloc, MYF(MY_KEEP_PREALLOC));
     result->data= NULL;
+    result->extension= NULL;
     result->rows= 0;
-    /* Send row request to the server */
-    int4store(buff, stmt->stmt_id);
-    int4store(buff + 4, stmt->prefetch_rows); /* number of rows to fetch */
-    if ((*mysql->methods->advanced_command)(mysql, COM_STMT_FETCH,
-                                            buff, sizeof(buff), (uchar*) 0, 0,
-                                            1, stmt))
+    if (ext->fetch_pending)
+    {
+      /* Rows were requested when the previous batch was read */
+      ext->fetch_pending= 0;
+      if (stmt->unbuffered_fetch_cancelled ||
+          mysql->unbuffered_fetch_owner != &stmt->unbuffered_fetch_cancelled)
+      {
+        set_stmt_error(stmt, stmt->unbuffered_fetch_cancelled ?
+                       CR_FETCH_CANCELED : CR_COMMANDS_OUT_OF_SYNC,
+                       unknown_sqlstate, NULL);
+        return 1;
+      }
+      mysql->unbuffered_fetch_owner= 0;
+      mysql->status= MYSQL_STATUS_READY;
+    }
+    else if (stmt_send_fetch(stmt))             /* Send row request */
     {
       set_stmt_errmsg(stmt, net);
       return 1;
@@ -2349,8 +3245,23 @@ stmt_read_row_from_cursor(MYSQL_STMT *stmt, unsigned char **row)
     if ((*mysql->methods->read_rows_from_cursor)(stmt))
       return 1;
     stmt->server_status= mysql->server_status;
-
     stmt->data_cursor= result->data;
+
+    if (ext->prefetch_bytes)
+      stmt_adjust_prefetch(stmt);
+    /*
+      Let the server prepare the next batch while this one is consumed.
+      If the request can't be sent, the error is reported by next fetch.
+    */
+    if (ext->prefetch_pipeline &&
+        !(stmt->server_status & SERVER_STATUS_LAST_ROW_SENT) &&
+        !stmt_send_fetch(stmt))
+    {
+      ext->fetch_pending= 1;
+      mysql->status= MYSQL_STATUS_GET_RESULT;
+      mysql->unbuffered_fetch_owner= &stmt->unbuffered_fetch_cancelled;
+      stmt->unbuffered_fetch_cancelled= FALSE;
+    }
     return stmt_read_row_buffered(stmt, row);
   }
   *row= 0;
@@ -2358,6 +3269,65 @@ stmt_read_row_from_cursor(MYSQL_STMT *stmt, unsigned char **row)
 }
 
 
+/*
+  Ask the server for the next batch of rows from a cursor
+
+  SYNOPSIS
+    stmt_send_fetch()
+
+  RETURN VALUE
+    0            success
+    1            error
+*/
+
+static my_bool stmt_send_fetch(MYSQL_STMT *stmt)
+{
+  MYSQL *mysql= stmt->mysql;
+  MYSQL_STMT_EXT *ext= STMT_EXT(stmt);
+  uchar buff[4 /* statement id */ +
+             4 /* number of rows to fetch */];
+
+  int4store(buff, stmt->stmt_id);
+  int4store(buff + 4, ext->prefetch_bytes ? ext->fetch_rows :
+                      stmt->prefetch_rows);
+  return (*mysql->methods->advanced_command)(mysql, COM_STMT_FETCH,
+                                             buff, sizeof(buff),
+                                             (uchar*) 0, 0, 1, stmt);
+}
+
+
+/*
+  Compute the number of rows to ask for in the next cursor fetch
+
+  SYNOPSIS
+    stmt_adjust_prefetch()
+
+  DESCRIPTION
+    The batch size is doubled after each fetch, like a TCP window, so
+    that short scans don't pay for a big first batch and long scans
+    need few round trips. It's limited by the byte budget divided by
+    the average length of the rows just read, and never goes below
+    STMT_ATTR_PREFETCH_ROWS.
+*/
+
+static void stmt_adjust_prefetch(MYSQL_STMT *stmt)
+{
+  MYSQL_STMT_EXT *ext= STMT_EXT(stmt);
+  MYSQL_ROWS *cur;
+  ulonglong bytes= 0;
+  ulong limit;
+
+  if (!stmt->result.rows)
+    return;
+  for (cur= stmt->result.data; cur; cur= cur->next)
+    bytes+= cur->length;
+  limit= (ulong) (ext->prefetch_bytes / (bytes / stmt->result.rows));
+  ext->fetch_rows= ext->fetch_rows < limit / 2 ? ext->fetch_rows * 2 : limit;
+  set_if_bigger(ext->fetch_rows, stmt->prefetch_rows);
+  set_if_smaller(ext->fetch_rows, UINT_MAX32);
+}
+
+
 /*
   Default read row function to not SIGSEGV in client in
   case of wrong sequence of API calls.
@@ -2419,6 +3389,15 @@ my_bool STDCALL mysql_stmt_attr_set(MYSQL_STMT *stmt,
     stmt->prefetch_rows= prefetch_rows;
     break;
   }
+  case STMT_ATTR_PREFETCH_BYTES:
+    STMT_EXT(stmt)->prefetch_bytes= value ? *(ulong*) value : 0;
+    break;
+  case STMT_ATTR_PREFETCH_PIPELINE:
+    STMT_EXT(stmt)->prefetch_pipeline= value ? *(const my_bool*) value : 0;
+    break;
+  case STMT_ATTR_ROW_OFFSETS:
+    STMT_EXT(stmt)->row_offsets= value ? *(const my_bool*) value : 0;
+    break;
   default:
     goto err_not_implemented;
   }
@@ -2443,6 +3422,15 @@ my_bool STDCALL mysql_stmt_attr_get(MYSQL_STMT *stmt,
   case STMT_ATTR_PREFETCH_ROWS:
     *(ulong*) value= stmt->prefetch_rows;
     break;
+  case STMT_ATTR_PREFETCH_BYTES:
+    *(ulong*) value= STMT_EXT(stmt)->prefetch_bytes;
+    break;
+  case STMT_ATTR_PREFETCH_PIPELINE:
+    *(my_bool*) value= STMT_EXT(stmt)->prefetch_pipeline;
+    break;
+  case STMT_ATTR_ROW_OFFSETS:
+    *(my_bool*) value= STMT_EXT(stmt)->row_offsets;
+    break;
   default:
     return TRUE;
   }
@@ -2500,6 +3488,7 @@ static void prepare_to_fetch_result(MYSQL_STMT *stmt)
   {
     stmt->mysql->status= MYSQL_STATUS_READY;
     stmt->read_row_func= stmt_read_row_from_cursor;
+    STMT_EXT(stmt)->fetch_rows= stmt->prefetch_rows;
   }
   else if (stmt->flags & CURSOR_TYPE_READ_ONLY)
   {
@@ -2578,6 +3567,9 @@ int STDCALL mysql_stmt_execute(MYSQL_STMT *stmt)
 
   if (reset_stmt_handle(stmt, RESET_STORE_RESULT | RESET_CLEAR_ERROR))
     DBUG_RETURN(1);
+  /* Data of an open long data stream must reach the server first */
+  if (stmt_flush_long_data(stmt))
+    DBUG_RETURN(1);
   /*
     No need to check for stmt->state: if the statement wasn't
     prepared we'll get 'unknown statement handler' error from server.
@@ -2928,17 +3920,87 @@ my_bool STDCALL mysql_stmt_bind_param(MYSQL_STMT *stmt, MYSQL_BIND *my_bind)
     if (!param->length)
       param->length= &param->buffer_length;
   }
-  /* We have to send/resend type information to MySQL */
-  stmt->send_types_to_server= TRUE;
-  stmt->bind_param_done= TRUE;
-  DBUG_RETURN(0);
+  /* We have to send/resend type information to MySQL */
+  stmt->send_types_to_server= TRUE;
+  stmt->bind_param_done= TRUE;
+  DBUG_RETURN(0);
+}
+
+
+/********************************************************************
+ Long data implementation
+*********************************************************************/
+
+/*
+  Check that long data can be sent for a parameter
+
+  RETURN VALUES
+    0	ok
+    1	error; error is set in stmt
+*/
+
+static my_bool check_long_data_param(MYSQL_STMT *stmt, uint param_number)
+{
+  MYSQL_BIND *param;
+  /*
+    We only need to check for stmt->param_count, if it's not null
+    prepare was done.
+  */
+  if (param_number >= stmt->param_count)
+  {
+    set_stmt_error(stmt, CR_INVALID_PARAMETER_NO, unknown_sqlstate, NULL);
+    return 1;
+  }
+
+  param= stmt->params+param_number;
+  if (!IS_LONGDATA(param->buffer_type))
+  {
+    /* Long data handling should be used only for string/binary types */
+    strmov(stmt->sqlstate, unknown_sqlstate);
+    sprintf(stmt->last_error, ER(stmt->last_errno= CR_INVALID_BUFFER_USE),
+	    param->param_number);
+    return 1;
+  }
+  return 0;
+}
+
+
+/*
+  Send one COM_STMT_SEND_LONG_DATA packet
+
+  SYNOPSIS
+    stmt_send_long_data()
+    stmt			Statement handler
+    header			Stmt id (4 bytes) and param no (2 bytes)
+    data			Data to send to server
+    length			Length of data to send (may be 0)
+
+  RETURN VALUES
+    0	ok
+    1	error
+*/
+
+static my_bool stmt_send_long_data(MYSQL_STMT *stmt, const uchar *header,
+                                   const uchar *data, ulong length)
+{
+  MYSQL *mysql= stmt->mysql;
+  stmt->params[uint2korr(header + 4)].long_data_used= 1;
+
+  /*
+    Note that we don't get any ok packet from the server in this case
+    This is intentional to save bandwidth.
+  */
+  if ((*mysql->methods->advanced_command)(mysql, COM_STMT_SEND_LONG_DATA,
+                                          header, MYSQL_LONG_DATA_HEADER,
+                                          data, length, 1, stmt))
+  {
+    set_stmt_errmsg(stmt, &mysql->net);
+    return 1;
+  }
+  return 0;
 }
 
 
-/********************************************************************
- Long data implementation
-*********************************************************************/
-
 /*
   Send long data in pieces to the server
 
@@ -2982,62 +4044,259 @@ my_bool STDCALL
 mysql_stmt_send_long_data(MYSQL_STMT *stmt, uint param_number,
 		     const char *data, ulong length)
 {
-  MYSQL_BIND *param;
   DBUG_ENTER("mysql_stmt_send_long_data");
   DBUG_ASSERT(stmt != 0);
   DBUG_PRINT("enter",("param no: %d  data: %p, length : %ld",
 		      param_number, data, length));
 
-  /*
-    We only need to check for stmt->param_count, if it's not null
-    prepare was done.
-  */
-  if (param_number >= stmt->param_count)
-  {
-    set_stmt_error(stmt, CR_INVALID_PARAMETER_NO, unknown_sqlstate, NULL);
-    DBUG_RETURN(1);
-  }
-
-  param= stmt->params+param_number;
-  if (!IS_LONGDATA(param->buffer_type))
-  {
-    /* Long data handling should be used only for string/binary types */
-    strmov(stmt->sqlstate, unknown_sqlstate);
-    sprintf(stmt->last_error, ER(stmt->last_errno= CR_INVALID_BUFFER_USE),
-	    param->param_number);
+  if (check_long_data_param(stmt, param_number))
     DBUG_RETURN(1);
-  }
 
   /*
     Send long data packet if there is data or we're sending long data
     for the first time.
   */
-  if (length || param->long_data_used == 0)
+  if (length || stmt->params[param_number].long_data_used == 0)
   {
-    MYSQL *mysql= stmt->mysql;
     /* Packet header: stmt id (4 bytes), param no (2 bytes) */
     uchar buff[MYSQL_LONG_DATA_HEADER];
 
     int4store(buff, stmt->stmt_id);
     int2store(buff + 4, param_number);
-    param->long_data_used= 1;
+    DBUG_RETURN(stmt_send_long_data(stmt, buff, (uchar*) data, length));
+  }
+  DBUG_RETURN(0);
+}
 
-    /*
-      Note that we don't get any ok packet from the server in this case
-      This is intentional to save bandwidth.
-    */
-    if ((*mysql->methods->advanced_command)(mysql, COM_STMT_SEND_LONG_DATA,
-                                            buff, sizeof(buff), (uchar*) data,
-                                            length, 1, stmt))
+
+/*
+  Stream long data for one parameter to the server
+
+  SYNOPSIS
+    mysql_stmt_long_data_open()
+    stmt			Statement handler
+    param_number		Parameter number (0 - N-1)
+
+  DESCRIPTION
+    Starts a stream of long data for a string/binary placeholder.
+    Data is then given with mysql_stmt_long_data_write() or
+    mysql_stmt_long_data_write_fd() in pieces of any size and the stream
+    is finished with mysql_stmt_long_data_close(). Small pieces are
+    collected into packets of LONG_DATA_STREAM_BUFFER bytes, big pieces
+    are sent as they are, so the number of packets and copies is the
+    same no matter how the data was split by the application.
+    Only one stream can be open for a statement at a time; opening a
+    new one closes the previous one. mysql_stmt_execute() closes an
+    open stream, mysql_stmt_reset() discards it.
+
+  RETURN VALUES
+    0	ok
+    1	error
+*/
+
+my_bool STDCALL
+mysql_stmt_long_data_open(MYSQL_STMT *stmt, uint param_number)
+{
+  MYSQL_STMT_EXT *ext= STMT_EXT(stmt);
+  DBUG_ENTER("mysql_stmt_long_data_open");
+  DBUG_PRINT("enter",("param no: %d", param_number));
+
+  if (check_long_data_param(stmt, param_number) ||
+      stmt_flush_long_data(stmt))
+    DBUG_RETURN(1);
+
+  if (!ext->long_data_buff &&
+      !(ext->long_data_buff= (uchar*) my_malloc(MYSQL_LONG_DATA_HEADER +
+                                                LONG_DATA_STREAM_BUFFER,
+                                                MYF(MY_MEM_STATEMENT))))
+  {
+    set_stmt_error(stmt, CR_OUT_OF_MEMORY, unknown_sqlstate, NULL);
+    DBUG_RETURN(1);
+  }
+  int4store(ext->long_data_buff, stmt->stmt_id);
+  int2store(ext->long_data_buff + 4, param_number);
+  ext->long_data_param= param_number;
+  ext->long_data_length= 0;
+  ext->long_data_open= 1;
+  /* Make sure that the parameter is sent as long data even if empty */
+  stmt->params[param_number].long_data_used= 0;
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Add data to the long data stream of a statement
+
+  SYNOPSIS
+    mysql_stmt_long_data_write()
+    stmt			Statement handler
+    data			Data to send to server
+    length			Length of data (may be 0)
+
+  RETURN VALUES
+    0	ok
+    1	error
+*/
+
+my_bool STDCALL
+mysql_stmt_long_data_write(MYSQL_STMT *stmt, const char *data, ulong length)
+{
+  MYSQL_STMT_EXT *ext= STMT_EXT(stmt);
+  uchar *buff= ext->long_data_buff;
+  DBUG_ENTER("mysql_stmt_long_data_write");
+  DBUG_PRINT("enter",("data: %p, length : %ld", data, length));
+
+  if (!ext->long_data_open)
+  {
+    set_stmt_error(stmt, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate, NULL);
+    DBUG_RETURN(1);
+  }
+
+  if (ext->long_data_length + length > LONG_DATA_STREAM_BUFFER)
+  {
+    /* Fill up the pending packet and send it */
+    if (ext->long_data_length)
     {
-      set_stmt_errmsg(stmt, &mysql->net);
+      ulong part= LONG_DATA_STREAM_BUFFER - ext->long_data_length;
+      memcpy(buff + MYSQL_LONG_DATA_HEADER + ext->long_data_length,
+             data, part);
+      if (stmt_send_long_data(stmt, buff, buff + MYSQL_LONG_DATA_HEADER,
+                              LONG_DATA_STREAM_BUFFER))
+        DBUG_RETURN(1);
+      ext->long_data_length= 0;
+      data+= part;
+      length-= part;
+    }
+    /* Send full sized packets directly from the caller's buffer */
+    while (length >= LONG_DATA_STREAM_BUFFER)
+    {
+      if (stmt_send_long_data(stmt, buff, (uchar*) data,
+                              LONG_DATA_STREAM_BUFFER))
+        DBUG_RETURN(1);
+      data+= LONG_DATA_STREAM_BUFFER;
+      length-= LONG_DATA_STREAM_BUFFER;
+    }
+  }
+  memcpy(buff + MYSQL_LONG_DATA_HEADER + ext->long_data_length, data, length);
+  ext->long_data_length+= length;
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Add the contents of a file to the long data stream of a statement
+
+  SYNOPSIS
+    mysql_stmt_long_data_write_fd()
+    stmt			Statement handler
+    fd				File to read from its current position
+				to end of file
+
+  DESCRIPTION
+    The file is read directly into the packet buffer of the stream.
+
+  RETURN VALUES
+    0	ok
+    1	error
+*/
+
+my_bool STDCALL
+mysql_stmt_long_data_write_fd(MYSQL_STMT *stmt, int fd)
+{
+  MYSQL_STMT_EXT *ext= STMT_EXT(stmt);
+  uchar *buff= ext->long_data_buff;
+  size_t count;
+  DBUG_ENTER("mysql_stmt_long_data_write_fd");
+  DBUG_PRINT("enter",("fd: %d", fd));
+
+  if (!ext->long_data_open)
+  {
+    set_stmt_error(stmt, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate, NULL);
+    DBUG_RETURN(1);
+  }
+
+  for (;;)
+  {
+    if (ext->long_data_length == LONG_DATA_STREAM_BUFFER)
+    {
+      if (stmt_send_long_data(stmt, buff, buff + MYSQL_LONG_DATA_HEADER,
+                              LONG_DATA_STREAM_BUFFER))
+        DBUG_RETURN(1);
+      ext->long_data_length= 0;
+    }
+    count= my_read((File) fd,
+                   buff + MYSQL_LONG_DATA_HEADER + ext->long_data_length,
+                   LONG_DATA_STREAM_BUFFER - ext->long_data_length, MYF(0));
+    if (count == 0)
+      break;
+    if (count == (size_t) -1)
+    {
+      char errmsg[MYSQL_ERRMSG_SIZE];
+      my_snprintf(errmsg, sizeof(errmsg) - 1, ER(CR_FILE_READ),
+                  my_filename((File) fd), my_errno);
+      set_stmt_error(stmt, CR_FILE_READ, unknown_sqlstate, errmsg);
       DBUG_RETURN(1);
     }
+    ext->long_data_length+= (ulong) count;
   }
   DBUG_RETURN(0);
 }
 
 
+/*
+  Send what is left of the long data stream of a statement and close it
+
+  SYNOPSIS
+    mysql_stmt_long_data_close()
+    stmt			Statement handler
+
+  RETURN VALUES
+    0	ok
+    1	error
+*/
+
+my_bool STDCALL
+mysql_stmt_long_data_close(MYSQL_STMT *stmt)
+{
+  DBUG_ENTER("mysql_stmt_long_data_close");
+
+  if (!STMT_EXT(stmt)->long_data_open)
+  {
+    set_stmt_error(stmt, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate, NULL);
+    DBUG_RETURN(1);
+  }
+  DBUG_RETURN(stmt_flush_long_data(stmt));
+}
+
+
+/*
+  Send pending data of an open long data stream and close the stream.
+  Does nothing if no stream is open.
+*/
+
+static my_bool stmt_flush_long_data(MYSQL_STMT *stmt)
+{
+  MYSQL_STMT_EXT *ext= STMT_EXT(stmt);
+  uchar *buff= ext->long_data_buff;
+  my_bool rc= 0;
+
+  if (!ext->long_data_open)
+    return 0;
+  /*
+    As with mysql_stmt_send_long_data(), send a packet even if the stream
+    was empty so that the server knows the parameter is long data.
+  */
+  if (ext->long_data_length ||
+      stmt->params[ext->long_data_param].long_data_used == 0)
+    rc= stmt_send_long_data(stmt, buff, buff + MYSQL_LONG_DATA_HEADER,
+                            ext->long_data_length);
+  ext->long_data_open= 0;
+  ext->long_data_length= 0;
+  return rc;
+}
+
+
+
 /********************************************************************
  Fetch and conversion of result set rows (binary protocol).
 *********************************************************************/
@@ -4135,6 +5394,103 @@ my_bool STDCALL mysql_stmt_bind_result(MYSQL_STMT *stmt, MYSQL_BIND *my_bind)
 }
 
 
+/*
+  Build the column offset table of a stored binary protocol row
+
+  SYNOPSIS
+    stmt_build_row_offsets()
+    stmt                Statement handler
+    row                 Row data, preceded by room for field_count offsets
+    length              Length of the row data
+
+  DESCRIPTION
+    Stores for each column where its value starts, counted from the start
+    of the row, or 0 if the column is NULL. Values always come after the
+    null bitmap, so 0 is never a real offset.
+
+  RETURN
+    0   ok
+    1   the row is shorter than its columns
+*/
+
+static my_bool stmt_build_row_offsets(MYSQL_STMT *stmt, uchar *row,
+                                      ulong length)
+{
+  uint32 *offsets= (uint32*) row - stmt->field_count;
+  MYSQL_FIELD *field, *end;
+  uchar *null_ptr= row, *pos, *row_end= row + length, bit= 4;
+
+  pos= row + (stmt->field_count + 9) / 8;         /* skip null bits */
+  if (pos > row_end)
+    return 1;
+  for (field= stmt->fields, end= field + stmt->field_count ;
+       field < end ;
+       field++, offsets++)
+  {
+    if (*null_ptr & bit)
+      *offsets= 0;
+    else
+    {
+      ulong value_length;
+      *offsets= (uint32) (pos - row);
+      /* As the skip_result functions in setup_one_fetch_function() */
+      switch (field->type) {
+      case MYSQL_TYPE_NULL:
+        value_length= 0;
+        break;
+      case MYSQL_TYPE_TINY:
+        value_length= 1;
+        break;
+      case MYSQL_TYPE_SHORT:
+      case MYSQL_TYPE_YEAR:
+        value_length= 2;
+        break;
+      case MYSQL_TYPE_INT24:
+      case MYSQL_TYPE_LONG:
+      case MYSQL_TYPE_FLOAT:
+        value_length= 4;
+        break;
+      case MYSQL_TYPE_LONGLONG:
+      case MYSQL_TYPE_DOUBLE:
+        value_length= 8;
+        break;
+      default:
+        if (pos >= row_end ||
+            (*pos >= 251 && (pos + (*pos == 252 ? 3 : *pos == 253 ? 4 : 9) >
+                             row_end)))
+          return 1;
+        value_length= net_field_length(&pos);
+        break;
+      }
+      if (value_length > (ulong) (row_end - pos))
+        return 1;
+      pos+= value_length;
+    }
+    if (!((bit<<=1) & 255))
+    {
+      bit= 1;					/* To next uchar */
+      null_ptr++;
+    }
+  }
+  return 0;
+}
+
+
+/*
+  The column offset table of a row, if it has one. Only rows stored by
+  mysql_stmt_store_result() with STMT_ATTR_ROW_OFFSETS set have it, right
+  in front of the row data.
+*/
+
+static inline uint32 *stmt_row_offsets(MYSQL_STMT *stmt, uchar *row)
+{
+  if (stmt->read_row_func != stmt_read_row_buffered ||
+      !STMT_EXT(stmt)->rows_have_offsets)
+    return NULL;
+  return (uint32*) row - stmt->field_count;
+}
+
+
 /*
   Fetch row data to bind buffers
 */
@@ -4144,6 +5500,7 @@ static int stmt_fetch_row(MYSQL_STMT *stmt, uchar *row)
   MYSQL_BIND  *my_bind, *end;
   MYSQL_FIELD *field;
   uchar *null_ptr, bit;
+  uint32 *offsets;
   int truncation_count= 0;
   /*
     Precondition: if stmt->field_count is zero or row is NULL, read_row_*
@@ -4152,12 +5509,39 @@ static int stmt_fetch_row(MYSQL_STMT *stmt, uchar *row)
   DBUG_ASSERT(stmt->field_count);
   DBUG_ASSERT(row);
 
+  STMT_EXT(stmt)->fetch_row= row;
   if (!stmt->bind_result_done)
   {
     /* If output parameters were not bound we should just return success */
     return 0;
   }
 
+  if ((offsets= stmt_row_offsets(stmt, row)))
+  {
+    /* Every column is found through the table; 0 means NULL */
+    for (my_bind= stmt->bind, end= my_bind + stmt->field_count,
+           field= stmt->fields ;
+         my_bind < end ;
+         my_bind++, field++, offsets++)
+    {
+      *my_bind->error= 0;
+      if (!*offsets)
+      {
+        my_bind->row_ptr= NULL;
+        *my_bind->is_null= 1;
+      }
+      else
+      {
+        uchar *pos= row + *offsets;
+        *my_bind->is_null= 0;
+        my_bind->row_ptr= pos;
+        (*my_bind->fetch_result)(my_bind, field, &pos);
+        truncation_count+= *my_bind->error;
+      }
+    }
+    goto end;
+  }
+
   null_ptr= row;
   row+= (stmt->field_count+9)/8;		/* skip null bits */
   bit= 4;					/* first 2 bits are reserved */
@@ -4194,6 +5578,7 @@ static int stmt_fetch_row(MYSQL_STMT *stmt, uchar *row)
       null_ptr++;
     }
   }
+end:
   if (truncation_count && (stmt->bind_result_done & REPORT_DATA_TRUNCATION))
     return MYSQL_DATA_TRUNCATED;
   return 0;
@@ -4257,6 +5642,8 @@ int STDCALL mysql_stmt_fetch_column(MYSQL_STMT *stmt, MYSQL_BIND *my_bind,
                                     uint column, ulong offset)
 {
   MYSQL_BIND *param= stmt->bind+column;
+  uint32 *offsets;
+  uchar *row;
   DBUG_ENTER("mysql_stmt_fetch_column");
 
   if ((int) stmt->state < (int) MYSQL_STMT_FETCH_DONE)
@@ -4273,15 +5660,24 @@ int STDCALL mysql_stmt_fetch_column(MYSQL_STMT *stmt, MYSQL_BIND *my_bind,
   if (!my_bind->error)
     my_bind->error= &my_bind->error_value;
   *my_bind->error= 0;
-  if (param->row_ptr)
+  if ((offsets= stmt_row_offsets(stmt, STMT_EXT(stmt)->fetch_row)))
+  {
+    /* Found directly, so this also works for columns that aren't bound */
+    row= offsets[column] ? STMT_EXT(stmt)->fetch_row + offsets[column] : NULL;
+  }
+  else
+    row= param->row_ptr;
+  if (row)
   {
     MYSQL_FIELD *field= stmt->fields+column;
-    uchar *row= param->row_ptr;
     my_bind->offset= offset;
     if (my_bind->is_null)
       *my_bind->is_null= 0;
     if (my_bind->length) /* Set the length if non char/binary types */
-      *my_bind->length= *param->length;
+    {
+      if (stmt->bind_result_done)
+        *my_bind->length= *param->length;
+    }
     else
       my_bind->length= &param->length_value;       /* Needed for fetch_result() */
     fetch_result_with_conversion(my_bind, field, &row);
@@ -4297,18 +5693,28 @@ int STDCALL mysql_stmt_fetch_column(MYSQL_STMT *stmt, MYSQL_BIND *my_bind,
 
 /*
   Read all rows of data from server  (binary format)
+
+  SYNOPSIS
+    read_binary_rows()
+    stmt			Statement handler
+    threaded			Allow MYSQL_OPT_PARALLEL_READ; not worth it
+				for the small batches of a cursor fetch
+    offsets			Put a column offset table in front of each
+				row, see STMT_ATTR_ROW_OFFSETS
 */
 
-int cli_read_binary_rows(MYSQL_STMT *stmt)
+static int read_binary_rows(MYSQL_STMT *stmt, my_bool threaded,
+                            my_bool offsets)
 {
   ulong      pkt_len;
   uchar      *cp;
   MYSQL      *mysql= stmt->mysql;
   MYSQL_DATA *result= &stmt->result;
   MYSQL_ROWS *cur, **prev_ptr= &result->data;
-  NET        *net;
+  ROW_READER reader;
+  size_t     offsets_size= offsets ? stmt->field_count * sizeof(uint32) : 0;
 
-  DBUG_ENTER("cli_read_binary_rows");
+  DBUG_ENTER("read_binary_rows");
 
   if (!mysql)
   {
@@ -4316,25 +5722,38 @@ int cli_read_binary_rows(MYSQL_STMT *stmt)
     DBUG_RETURN(1);
   }
 
-  net = &mysql->net;
-
-  while ((pkt_len= cli_safe_read(mysql)) != packet_error)
+  if (set_result_root_options(mysql, &result->alloc))
+  {
+    set_stmt_error(stmt, CR_OUT_OF_MEMORY, unknown_sqlstate, NULL);
+    DBUG_RETURN(1);
+  }
+  STMT_EXT(stmt)->rows_have_offsets= offsets;
+  row_reader_init(&reader, mysql, threaded);
+  while ((pkt_len= row_reader_read(&reader, &cp)) != packet_error)
   {
-    cp= net->read_pos;
     if (cp[0] != 254 || pkt_len >= 8)
     {
-      if (!(cur= (MYSQL_ROWS*) alloc_root(&result->alloc,
-                                          sizeof(MYSQL_ROWS) + pkt_len - 1)))
+      if (!(cur= (MYSQL_ROWS*) alloc_root_inline(&result->alloc,
+                                                 sizeof(MYSQL_ROWS) +
+                                                 offsets_size + pkt_len - 1)))
       {
+        row_reader_end(&reader);
         set_stmt_error(stmt, CR_OUT_OF_MEMORY, unknown_sqlstate, NULL);
         goto err;
       }
-      cur->data= (MYSQL_ROW) (cur+1);
+      cur->data= (MYSQL_ROW) ((char*) (cur+1) + offsets_size);
       *prev_ptr= cur;
       prev_ptr= &cur->next;
       memcpy((char *) cur->data, (char *) cp+1, pkt_len-1);
       cur->length= pkt_len;		/* To allow us to do sanity checks */
       result->rows++;
+      if (offsets &&
+          stmt_build_row_offsets(stmt, (uchar*) cur->data, pkt_len - 1))
+      {
+        row_reader_end(&reader);
+        set_stmt_error(stmt, CR_MALFORMED_PACKET, unknown_sqlstate, NULL);
+        goto err;
+      }
     }
     else
     {
@@ -4347,13 +5766,25 @@ int cli_read_binary_rows(MYSQL_STMT *stmt)
       DBUG_RETURN(0);
     }
   }
-  set_stmt_errmsg(stmt, net);
+  set_stmt_errmsg(stmt, &mysql->net);
 
 err:
   DBUG_RETURN(1);
 }
 
 
+int cli_read_binary_rows(MYSQL_STMT *stmt)
+{
+  return read_binary_rows(stmt, TRUE, STMT_EXT(stmt)->row_offsets);
+}
+
+
+int cli_read_rows_from_cursor(MYSQL_STMT *stmt)
+{
+  return read_binary_rows(stmt, FALSE, FALSE);
+}
+
+
 /*
   Update meta data for statement
 
@@ -4483,6 +5914,7 @@ int STDCALL mysql_stmt_store_result(MYSQL_STMT *stmt)
   {
     free_root(&result->alloc, MYF(MY_KEEP_PREALLOC));
     result->data= NULL;
+    result->extension= NULL;
     result->rows= 0;
     mysql->status= MYSQL_STATUS_READY;
     DBUG_RETURN(1);
@@ -4543,14 +5975,13 @@ mysql_stmt_row_tell(MYSQL_STMT *stmt)
 void STDCALL
 mysql_stmt_data_seek(MYSQL_STMT *stmt, my_ulonglong row)
 {
-  MYSQL_ROWS *tmp= stmt->result.data;
+  MYSQL_ROWS *tmp;
   DBUG_ENTER("mysql_stmt_data_seek");
   DBUG_PRINT("enter",("row id to seek: %ld",(long) row));
 
-  for (; tmp && row; --row, tmp= tmp->next)
-    ;
+  tmp= seek_stored_row(&stmt->result, row);
   stmt->data_cursor= tmp;
-  if (!row && tmp)
+  if (tmp)
   {
        /*  Rewind the counter */
     stmt->read_row_func= stmt_read_row_buffered;
@@ -4595,17 +6026,22 @@ static my_bool reset_stmt_handle(MYSQL_STMT *stmt, uint flags)
       /* Result buffered */
       free_root(&result->alloc, MYF(MY_KEEP_PREALLOC));
       result->data= NULL;
+      result->extension= NULL;
       result->rows= 0;
       stmt->data_cursor= NULL;
     }
     if (flags & RESET_LONG_DATA)
     {
       MYSQL_BIND *param= stmt->params, *param_end= param + stmt->param_count;
+      /* Discard an open long data stream */
+      STMT_EXT(stmt)->long_data_open= 0;
       /* Clear long_data_used flags */
       for (; param < param_end; param++)
         param->long_data_used= 0;
     }
     stmt->read_row_func= stmt_read_row_no_result_set;
+    /* A pipelined cursor fetch is flushed below with the result set */
+    STMT_EXT(stmt)->fetch_pending= 0;
     if (mysql)
     {
       if ((int) stmt->state > (int) MYSQL_STMT_PREPARE_DONE)
@@ -4678,6 +6114,7 @@ my_bool STDCALL mysql_stmt_close(MYSQL_STMT *stmt)
 
   free_root(&stmt->result.alloc, MYF(0));
   free_root(&stmt->mem_root, MYF(0));
+  my_free(STMT_EXT(stmt)->long_data_buff, MYF(MY_ALLOW_ZERO_PTR));
 
   if (mysql)
   {
@@ -4900,3 +6337,79 @@ my_bool STDCALL mysql_read_query_result(MYSQL *mysql)
   return (*mysql->methods->read_query_result)(mysql);
 }
 
+
+
+#define STRING_SIZE(S) ((S) ? strlen(S) + 1 : 0)
+
+/* Bytes of the strings, the init commands and the extension of options */
+
+static size_t options_memory(struct st_mysql_options *options)
+{
+  size_t size= 0;
+  uint i;
+
+  size+= STRING_SIZE(options->host) + STRING_SIZE(options->user);
+  size+= STRING_SIZE(options->password) + STRING_SIZE(options->unix_socket);
+  size+= STRING_SIZE(options->db) + STRING_SIZE(options->my_cnf_file);
+  size+= STRING_SIZE(options->my_cnf_group);
+  size+= STRING_SIZE(options->charset_dir);
+  size+= STRING_SIZE(options->charset_name);
+  size+= STRING_SIZE(options->ssl_key) + STRING_SIZE(options->ssl_cert);
+  size+= STRING_SIZE(options->ssl_ca) + STRING_SIZE(options->ssl_capath);
+  size+= STRING_SIZE(options->ssl_cipher);
+  size+= STRING_SIZE(options->shared_memory_base_name);
+  size+= STRING_SIZE(options->client_ip);
+  if (options->init_commands)
+  {
+    DYNAMIC_ARRAY *commands= options->init_commands;
+    size+= sizeof(DYNAMIC_ARRAY) +
+           commands->max_element * commands->size_of_element;
+    for (i= 0; i < commands->elements; i++)
+      size+= STRING_SIZE(*dynamic_element(commands, i, char**));
+  }
+  if (options->extension)
+    size+= sizeof(struct st_mysql_options_extention);
+  return size;
+}
+
+
+/*
+  Memory held by a connection
+
+  SYNOPSIS
+    mysql_memory_usage()
+    mysql       Connection
+    stats       Set to the bytes of each category; peak and allocations
+                are not counted per connection and set to 0
+
+  NOTES
+    The memory is found by walking the structures of the connection,
+    so this costs nothing while the connection is used. Result sets
+    handed to the application, like the one of mysql_store_result(),
+    belong to the application and are not included.
+*/
+
+void STDCALL mysql_memory_usage(MYSQL *mysql, MYSQL_MEMORY_STATS *stats)
+{
+  LIST *element;
+
+  bzero((char*) stats, sizeof(*stats));
+  if (mysql->free_me)
+    stats->bytes[MYSQL_MEMORY_OTHER]= sizeof(*mysql);
+  if (mysql->net.buff)
+    stats->bytes[MYSQL_MEMORY_NET]= mysql->net.max_packet +
+                                    NET_HEADER_SIZE + COMP_HEADER_SIZE;
+  stats->bytes[MYSQL_MEMORY_ROOT]= alloc_root_allocated(&mysql->field_alloc);
+  stats->bytes[MYSQL_MEMORY_OPTIONS]= options_memory(&mysql->options);
+  for (element= mysql->stmts; element; element= element->next)
+  {
+    MYSQL_STMT *stmt= (MYSQL_STMT*) element->data;
+    stats->bytes[MYSQL_MEMORY_STATEMENT]+= sizeof(MYSQL_STMT) +
+                                           sizeof(MYSQL_STMT_EXT);
+    if (STMT_EXT(stmt)->long_data_buff)
+      stats->bytes[MYSQL_MEMORY_STATEMENT]+= MYSQL_LONG_DATA_HEADER +
+                                             LONG_DATA_STREAM_BUFFER;
+    stats->bytes[MYSQL_MEMORY_ROOT]+= alloc_root_allocated(&stmt->mem_root) +
+                                      alloc_root_allocated(&stmt->result.alloc);
+  }
+}
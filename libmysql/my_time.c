@@ -103,6 +103,115 @@ my_bool check_date(const MYSQL_TIME *ltime, my_bool not_zero_date,
 }
 
 
+/*
+  Templates for the canonical 'YYYY-MM-DD HH:MM:SS' layout, used by
+  str_to_datetime_fast(). After an xor with datetime_template every digit
+  position of a well formed string holds 0..9 and every separator 0.
+  Adding datetime_overflow (0x76 per digit, 0x7F per separator) then sets
+  the top bit of each byte that is out of range. A carry into the next
+  byte can only come from a byte that has its top bit set already.
+*/
+
+static const char datetime_template[]= "0000-00-00 00:00:00";
+static const char datetime_overflow[]=
+  "\x76\x76\x76\x76\x7F\x76\x76\x7F\x76\x76"
+  "\x7F\x76\x76\x7F\x76\x76\x7F\x76\x76";
+
+/* Check 8 bytes of str, starting at offset, against the templates */
+
+static inline my_bool datetime_word_bad(const char *str, uint offset)
+{
+  ulonglong word, templ, overflow;
+  memcpy(&word, str + offset, 8);
+  memcpy(&templ, datetime_template + offset, 8);
+  memcpy(&overflow, datetime_overflow + offset, 8);
+  word^= templ;
+  return (((word + overflow) | word) & 0x8080808080808080ULL) != 0;
+}
+
+#define DATETIME_DIGITS2(S) \
+  ((uint) ((S)[0] - '0') * 10 + (uint) ((S)[1] - '0'))
+
+/*
+  Parse a date or datetime in canonical layout.
+
+  SYNOPSIS
+    str_to_datetime_fast()
+    str, length, l_time, flags, was_cut   As for str_to_datetime()
+
+  DESCRIPTION
+    Handles exactly 'YYYY-MM-DD', 'YYYY-MM-DD HH:MM:SS' and
+    'YYYY-MM-DD HH:MM:SS.f' with 1 to 6 fraction digits, without any
+    leading or trailing characters, which is what the server sends.
+    Everything else, including values that str_to_datetime() would
+    reject or cut, is left to the general parser, which gives the same
+    result for these strings.
+
+  RETURN VALUES
+    0   l_time, l_time->time_type and *was_cut are set
+    1   Not handled, use the general parser
+*/
+
+static my_bool str_to_datetime_fast(const char *str, uint length,
+                                    MYSQL_TIME *l_time, uint flags,
+                                    int *was_cut)
+{
+  uint hour= 0, minute= 0, second= 0, month, day, i;
+  ulong second_part= 0;
+
+  if (length == 10)
+  {
+    if ((flags & TIME_DATETIME_ONLY) ||
+        datetime_word_bad(str, 0) || datetime_word_bad(str, 2))
+      return 1;
+  }
+  else if (length == 19 || (length > 20 && length <= 26))
+  {
+    if (datetime_word_bad(str, 0) || datetime_word_bad(str, 8) ||
+        datetime_word_bad(str, 11))
+      return 1;
+    if (length > 19)
+    {
+      if (str[19] != '.')
+        return 1;
+      for (i= 20; i < length; i++)
+      {
+        if ((uint) (uchar) (str[i] - '0') > 9)
+          return 1;
+        second_part= second_part * 10 + (ulong) (str[i] - '0');
+      }
+      second_part*= (ulong) log_10_int[26 - length];
+    }
+    hour=   DATETIME_DIGITS2(str + 11);
+    minute= DATETIME_DIGITS2(str + 14);
+    second= DATETIME_DIGITS2(str + 17);
+  }
+  else
+    return 1;
+
+  month= DATETIME_DIGITS2(str + 5);
+  day=   DATETIME_DIGITS2(str + 8);
+  if (month > 12 || day > 31 || hour > 23 || minute > 59 || second > 59)
+    return 1;
+
+  l_time->year= DATETIME_DIGITS2(str) * 100 + DATETIME_DIGITS2(str + 2);
+  l_time->month= month;
+  l_time->day= day;
+  l_time->hour= hour;
+  l_time->minute= minute;
+  l_time->second= second;
+  l_time->second_part= second_part;
+  l_time->neg= 0;
+  if (check_date(l_time, (l_time->year | month | day | hour | minute |
+                          second | second_part) != 0, flags, was_cut))
+    return 1;
+  *was_cut= 0;
+  l_time->time_type= (length == 10 ? MYSQL_TIMESTAMP_DATE :
+                                     MYSQL_TIMESTAMP_DATETIME);
+  return 0;
+}
+
+
 /*
   Convert a timestamp string to a MYSQL_TIME value.
 
@@ -173,6 +282,9 @@ str_to_datetime(const char *str, uint length, MYSQL_TIME *l_time,
   DBUG_ENTER("str_to_datetime");
   DBUG_PRINT("ENTER",("str: %.*s",length,str));
 
+  if (!str_to_datetime_fast(str, length, l_time, flags, was_cut))
+    DBUG_RETURN(l_time->time_type);
+
   LINT_INIT(field_length);
   LINT_INIT(year_length);
   LINT_INIT(last_field_pos);
@@ -1034,23 +1146,62 @@ int my_time_to_str(const MYSQL_TIME *l_time, char *to)
                          l_time->second));
 }
 
+/*
+  Write the date part as YYYY-MM-DD. All values that fit in their field
+  width are written without going through my_sprintf(); the caller has
+  checked that.
+*/
+
+static inline char *date_to_str_fast(const MYSQL_TIME *l_time, char *to)
+{
+  uint year= l_time->year;
+  to[0]= (char) ('0' + year / 1000);
+  to[1]= (char) ('0' + year / 100 % 10);
+  to[2]= (char) ('0' + year / 10 % 10);
+  to[3]= (char) ('0' + year % 10);
+  to[4]= '-';
+  to[5]= (char) ('0' + l_time->month / 10);
+  to[6]= (char) ('0' + l_time->month % 10);
+  to[7]= '-';
+  to[8]= (char) ('0' + l_time->day / 10);
+  to[9]= (char) ('0' + l_time->day % 10);
+  return to + 10;
+}
+
 int my_date_to_str(const MYSQL_TIME *l_time, char *to)
 {
-  return my_sprintf(to, (to, "%04u-%02u-%02u",
-                         l_time->year,
-                         l_time->month,
-                         l_time->day));
+  if (l_time->year > 9999 || l_time->month > 99 || l_time->day > 99)
+    return my_sprintf(to, (to, "%04u-%02u-%02u",
+                           l_time->year,
+                           l_time->month,
+                           l_time->day));
+  *date_to_str_fast(l_time, to)= 0;
+  return 10;
 }
 
 int my_datetime_to_str(const MYSQL_TIME *l_time, char *to)
 {
-  return my_sprintf(to, (to, "%04u-%02u-%02u %02u:%02u:%02u",
-                         l_time->year,
-                         l_time->month,
-                         l_time->day,
-                         l_time->hour,
-                         l_time->minute,
-                         l_time->second));
+  if (l_time->year > 9999 || l_time->month > 99 || l_time->day > 99 ||
+      l_time->hour > 99 || l_time->minute > 99 || l_time->second > 99)
+    return my_sprintf(to, (to, "%04u-%02u-%02u %02u:%02u:%02u",
+                           l_time->year,
+                           l_time->month,
+                           l_time->day,
+                           l_time->hour,
+                           l_time->minute,
+                           l_time->second));
+  to= date_to_str_fast(l_time, to);
+  to[0]= ' ';
+  to[1]= (char) ('0' + l_time->hour / 10);
+  to[2]= (char) ('0' + l_time->hour % 10);
+  to[3]= ':';
+  to[4]= (char) ('0' + l_time->minute / 10);
+  to[5]= (char) ('0' + l_time->minute % 10);
+  to[6]= ':';
+  to[7]= (char) ('0' + l_time->second / 10);
+  to[8]= (char) ('0' + l_time->second % 10);
+  to[9]= 0;
+  return 19;
 }
 
 
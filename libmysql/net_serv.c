@@ -55,6 +55,9 @@
 #include <violite.h>
 #include <signal.h>
 #include <errno.h>
+#if defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H)
+#include <sys/sendfile.h>
+#endif
 #ifdef __NETWARE__
 #include <sys/select.h>
 #endif
@@ -122,6 +125,16 @@ extern void query_cache_insert(const char *packet, ulong length,
 #define TEST_BLOCKING		8
 #define MAX_PACKET_LENGTH (256L*256L*256L-1)
 
+/* Settings NET has no room for, in NET::extension */
+
+typedef struct st_net_extension
+{
+  myf buff_flags;                       /* More my_malloc() flags for buff */
+} NET_EXTENSION;
+
+#define NET_BUFF_FLAGS(N) \
+  ((N)->extension ? ((NET_EXTENSION*) (N)->extension)->buff_flags : 0)
+
 static my_bool net_write_buff(NET *net,const uchar *packet,ulong len);
 
 
@@ -134,7 +147,7 @@ my_bool my_net_init(NET *net, Vio* vio)
   my_net_local_init(net);			/* Set some limits */
   if (!(net->buff=(uchar*) my_malloc((size_t) net->max_packet+
 				     NET_HEADER_SIZE + COMP_HEADER_SIZE,
-				     MYF(MY_WME))))
+				     MYF(MY_WME | MY_MEM_NET))))
     DBUG_RETURN(1);
   net->buff_end=net->buff+net->max_packet;
   net->error=0; net->return_status=0;
@@ -167,10 +180,33 @@ void net_end(NET *net)
   DBUG_ENTER("net_end");
   my_free(net->buff,MYF(MY_ALLOW_ZERO_PTR));
   net->buff=0;
+  my_free(net->extension, MYF(MY_ALLOW_ZERO_PTR));
+  net->extension= 0;
   DBUG_VOID_RETURN;
 }
 
 
+/**
+  Set more my_malloc() flags for the packet buffer when it grows, like
+  MY_HUGE_PAGES to put large buffers on huge pages. They are kept until
+  net_end().
+
+  @retval 0 ok
+  @retval 1 out of memory
+*/
+
+my_bool net_set_buff_flags(NET *net, int flags)
+{
+  DBUG_ENTER("net_set_buff_flags");
+  if (!net->extension &&
+      !(net->extension= my_malloc(sizeof(NET_EXTENSION),
+                                  MYF(MY_WME | MY_ZEROFILL | MY_MEM_NET))))
+    DBUG_RETURN(1);
+  ((NET_EXTENSION*) net->extension)->buff_flags= flags;
+  DBUG_RETURN(0);
+}
+
+
 /** Realloc the packet buffer. */
 
 my_bool net_realloc(NET *net, size_t length)
@@ -199,7 +235,8 @@ my_bool net_realloc(NET *net, size_t length)
   */
   if (!(buff= (uchar*) my_realloc((char*) net->buff, pkt_length +
                                   NET_HEADER_SIZE + COMP_HEADER_SIZE,
-                                  MYF(MY_WME))))
+                                  MYF(MY_WME | MY_MEM_NET |
+                                      NET_BUFF_FLAGS(net)))))
   {
     /* @todo: 1 and 2 codes are identical. */
     net->error= 1;
@@ -418,6 +455,186 @@ my_net_write(NET *net,const uchar *packet,size_t len)
   return rc;
 }
 
+/**
+  Put a packet into the framing of the connection without copying it.
+
+  The payload is expected at buff+NET_FRAME_HEADER_SIZE.  The packet
+  header is stored in front of it and, for compressed connections, the
+  packet is compressed in place and gets the compression header.  The
+  packet numbers are passed separately from the NET, so that packets can
+  be framed in another thread than the one writing them; nothing else
+  may be written to the connection until they are stored back.
+
+  @param buff		NET_FRAME_HEADER_SIZE bytes followed by the payload
+  @param len		In: length of payload; must be less than
+			MAX_PACKET_LENGTH minus NET_HEADER_SIZE.
+			Out: length of the framed packet
+  @param compress	Use the compressed protocol
+  @param pkt_nr		Packet number, incremented
+  @param compress_pkt_nr Compressed packet number, incremented
+
+  @return
+    Start of the framed packet, to be sent with my_net_write_framed()
+*/
+
+uchar *
+my_net_frame_packet(uchar *buff, size_t *len, my_bool compress,
+                    uint *pkt_nr, uint *compress_pkt_nr)
+{
+  uchar *packet= buff + NET_FRAME_HEADER_SIZE - NET_HEADER_SIZE;
+  DBUG_ASSERT(*len + NET_HEADER_SIZE < MAX_PACKET_LENGTH);
+
+  int3store(packet, *len);
+  packet[3]= (uchar) (*pkt_nr)++;
+  *len+= NET_HEADER_SIZE;
+#ifdef HAVE_COMPRESS
+  if (compress)
+  {
+    size_t complen;
+    if (my_compress(packet, len, &complen))
+      complen= 0;
+    packet-= NET_HEADER_SIZE + COMP_HEADER_SIZE;
+    int3store(packet + NET_HEADER_SIZE, complen);
+    int3store(packet, *len);
+    packet[3]= (uchar) (*compress_pkt_nr)++;
+    *len+= NET_HEADER_SIZE + COMP_HEADER_SIZE;
+    /* Sync packet number as net_flush() does */
+    *pkt_nr= *compress_pkt_nr;
+  }
+#endif
+  return packet;
+}
+
+
+/**
+  Write packets framed by my_net_frame_packet() as they are.
+
+  @retval
+    0	ok
+  @retval
+    1	error
+*/
+
+my_bool
+my_net_write_framed(NET *net, const uchar *packet, size_t len)
+{
+  my_bool rc, compress= net->compress;
+  if (unlikely(!net->vio)) /* nowhere to write */
+    return 0;
+
+  MYSQL_NET_WRITE_START(len);
+  /* Anything already buffered has to go first */
+  if (net_flush(net))
+  {
+    MYSQL_NET_WRITE_DONE(1);
+    return 1;
+  }
+  /* The packet is compressed already */
+  net->compress= 0;
+  rc= test(net_real_write(net, packet, len));
+  net->compress= compress;
+  MYSQL_NET_WRITE_DONE(rc);
+  return rc;
+}
+
+
+/**
+  Write a packet whose header space is reserved in the caller's buffer.
+
+  The packet is framed by my_net_frame_packet() and sent with one write,
+  without being copied to the net buffer first.  This is meant for
+  callers that stream big amounts of data, like LOAD DATA LOCAL INFILE.
+
+  @param net		NET handler
+  @param buff		NET_FRAME_HEADER_SIZE bytes followed by the payload
+  @param len		Length of payload; must be less than MAX_PACKET_LENGTH
+			minus NET_HEADER_SIZE
+
+  @retval
+    0	ok
+  @retval
+    1	error
+*/
+
+my_bool
+my_net_write_inplace(NET *net, uchar *buff, size_t len)
+{
+  uchar *packet;
+  if (unlikely(!net->vio)) /* nowhere to write */
+    return 0;
+  /* net_flush() syncs the packet numbers */
+  if (net_flush(net))
+    return 1;
+  packet= my_net_frame_packet(buff, &len, net->compress, &net->pkt_nr,
+                              &net->compress_pkt_nr);
+  return my_net_write_framed(net, packet, len);
+}
+
+
+#if defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H) && \
+    !defined(WITH_GREENIFY)
+/**
+  Send a packet with the next len bytes of a file, using sendfile() so
+  that the data isn't copied through user space.
+
+  Only for plain TCP/IP or socket connections without compression.
+  If the file ends before len bytes are sent, the connection can't be
+  used any more as the packet header was sent already.
+
+  @param net		NET handler
+  @param fd		File, read from its current position
+  @param len		Length of payload; must be less than MAX_PACKET_LENGTH
+
+  @retval
+    0	ok
+  @retval
+    1	error
+*/
+
+my_bool
+my_net_write_file(NET *net, File fd, size_t len)
+{
+  uchar header[NET_HEADER_SIZE];
+  my_socket sd;
+  DBUG_ASSERT(!net->compress && len < MAX_PACKET_LENGTH);
+  DBUG_ASSERT(vio_type(net->vio) == VIO_TYPE_TCPIP ||
+              vio_type(net->vio) == VIO_TYPE_SOCKET);
+
+  if (net_flush(net))
+    return 1;
+  int3store(header, len);
+  header[3]= (uchar) net->pkt_nr++;
+  if (net_real_write(net, header, NET_HEADER_SIZE))
+    return 1;
+
+  sd= vio_fd(net->vio);
+  net->reading_or_writing= 2;
+  while (len)
+  {
+    ssize_t sent= sendfile(sd, fd, NULL, len);
+    if (sent <= 0)
+    {
+      my_bool old_mode;
+      if (sent < 0 && errno == EINTR)
+        continue;
+      if (sent < 0 && errno == EAGAIN && !vio_is_blocking(net->vio) &&
+          vio_blocking(net->vio, TRUE, &old_mode) >= 0)
+        continue;
+      net->error= 2;                            /* Close socket */
+      net->last_errno= (sent < 0 && errno == EAGAIN ?
+                        ER_NET_WRITE_INTERRUPTED : ER_NET_ERROR_ON_WRITE);
+      net->reading_or_writing= 0;
+      return 1;
+    }
+    len-= sent;
+    update_statistics(thd_increment_bytes_sent(sent));
+  }
+  net->reading_or_writing= 0;
+  return 0;
+}
+#endif
+
+
 /**
   Send a command to the server.
 
@@ -605,7 +822,8 @@ net_real_write(NET *net,const uchar *packet, size_t len)
     uchar *b;
     uint header_length=NET_HEADER_SIZE+COMP_HEADER_SIZE;
     if (!(b= (uchar*) my_malloc(len + NET_HEADER_SIZE +
-                                COMP_HEADER_SIZE, MYF(MY_WME))))
+                                COMP_HEADER_SIZE,
+                                MYF(MY_WME | MY_MEM_NET))))
     {
       net->error= 2;
       net->last_errno= ER_OUT_OF_RESOURCES;
@@ -1159,6 +1377,235 @@ my_net_read(NET *net)
 }
 
 
+/*****************************************************************************
+** Incremental reading of big packets
+*****************************************************************************/
+
+/**
+  Read exactly length bytes from the connection, bypassing net->buff.
+
+  @note
+    Follows the retry logic of my_real_read() for the client; timeouts
+    are expected to be handled by the vio layer (see NO_ALARM).
+
+  @retval
+    0	ok
+  @retval
+    1	error, net->error and net->last_errno are set
+*/
+
+static my_bool net_stream_fill(NET *net, uchar *buff, size_t length)
+{
+  my_bool net_blocking= vio_is_blocking(net->vio);
+  my_bool switched_mode= 0, old_mode;
+
+  net->reading_or_writing=1;
+  while (length > 0)
+  {
+    size_t tmp;
+    if ((long) (tmp= vio_read(net->vio, buff, length)) <= 0L)
+    {
+      my_bool interrupted= vio_should_retry(net->vio);
+      if ((interrupted || tmp == 0) && !switched_mode)
+      {
+        switched_mode= 1;
+        if (vio_blocking(net->vio, TRUE, &old_mode) >= 0)
+          continue;
+      }
+#ifdef THREAD_SAFE_CLIENT
+      if (vio_errno(net->vio) == SOCKET_EINTR)
+      {
+        DBUG_PRINT("warning",("Interrupted read. Retrying..."));
+        continue;
+      }
+#endif
+      DBUG_PRINT("error",("Couldn't read packet: remain: %lu  errno: %d",
+                          (ulong) length, vio_errno(net->vio)));
+      net->error= 2;				/* Close socket */
+      net->last_errno= (vio_was_interrupted(net->vio) ?
+                        ER_NET_READ_INTERRUPTED : ER_NET_READ_ERROR);
+      break;
+    }
+    length-= tmp;
+    buff+= tmp;
+  }
+  if (switched_mode)
+    vio_blocking(net->vio, net_blocking, &old_mode);
+  net->reading_or_writing=0;
+  return test(length);
+}
+
+
+/**
+  Read the header of the next (sub) packet.
+
+  @return
+    Length of the (sub) packet or packet_error.
+*/
+
+static ulong net_stream_header(NET *net)
+{
+  uchar header[NET_HEADER_SIZE];
+
+  if (net_stream_fill(net, header, NET_HEADER_SIZE))
+    return packet_error;
+  DBUG_DUMP("packet_header", header, NET_HEADER_SIZE);
+  if (header[3] != (uchar) net->pkt_nr)
+  {
+    DBUG_PRINT("error", ("Packets out of order (Found: %d, expected %u)",
+                         (int) header[3], net->pkt_nr));
+    net->error= 2;
+    net->last_errno= ER_NET_PACKETS_OUT_OF_ORDER;
+    return packet_error;
+  }
+  net->compress_pkt_nr= ++net->pkt_nr;
+  return uint3korr(header);
+}
+
+
+/**
+  Start reading a packet from the server without assembling it in
+  net->buff.
+
+  Packets shorter than max_buffered are read as a whole, exactly like
+  my_net_read() would do, and stream->buffered is set. Bigger packets
+  are left on the connection and must be consumed with
+  my_net_stream_read() and finished with my_net_stream_end(). This lets
+  the caller process a multi-packet value of any size in fixed memory.
+
+  Compressed packets can't be split before they are uncompressed, so
+  with compression the whole packet is always read by my_net_read().
+
+  @param net		NET handler
+  @param stream	Stream state to initialize
+  @param max_buffered	Packets up to this size are read as a whole
+
+  @return
+    Length of the packet (the first sub packet if not buffered)
+    or packet_error.
+*/
+
+ulong my_net_stream_start(NET *net, NET_STREAM *stream, ulong max_buffered)
+{
+  ulong len;
+  DBUG_ENTER("my_net_stream_start");
+
+  stream->net= net;
+  stream->remain= 0;
+  stream->more= 0;
+  stream->buffered= 1;
+
+  if (net->compress)
+    DBUG_RETURN(my_net_read(net));
+
+  if ((len= net_stream_header(net)) == packet_error)
+    DBUG_RETURN(packet_error);
+
+  if (len < MAX_PACKET_LENGTH && len < max_buffered)
+  {
+    if (len >= net->max_packet && net_realloc(net, len))
+      DBUG_RETURN(packet_error);
+    net->read_pos= net->buff + net->where_b;
+    if (net_stream_fill(net, net->read_pos, len))
+      DBUG_RETURN(packet_error);
+    net->read_pos[len]=0;		/* Safeguard for mysql_use_result */
+    DBUG_RETURN(len);
+  }
+  DBUG_PRINT("info", ("streaming packet, first part: %lu", len));
+  stream->buffered= 0;
+  stream->remain= len;
+  stream->more= (len == MAX_PACKET_LENGTH);
+  DBUG_RETURN(len);
+}
+
+
+/**
+  Read the next length bytes of a packet started by my_net_stream_start().
+  Sub packet headers are removed on the fly.
+
+  @retval
+    0	ok
+  @retval
+    1	error; if net->error is not set, the packet ended before
+        length bytes could be read.
+*/
+
+my_bool my_net_stream_read(NET_STREAM *stream, uchar *buff, size_t length)
+{
+  NET *net= stream->net;
+  DBUG_ASSERT(!stream->buffered);
+
+  while (length > 0)
+  {
+    size_t part;
+    if (!stream->remain)
+    {
+      if (!stream->more)
+        return 1;				/* Read past end of packet */
+      if ((stream->remain= net_stream_header(net)) == packet_error)
+      {
+        stream->remain= 0;
+        stream->more= 0;
+        return 1;
+      }
+      stream->more= (stream->remain == MAX_PACKET_LENGTH);
+      continue;
+    }
+    part= min(length, stream->remain);
+    if (net_stream_fill(net, buff, part))
+    {
+      stream->remain= 0;
+      stream->more= 0;
+      return 1;
+    }
+    buff+= part;
+    length-= part;
+    stream->remain-= part;
+  }
+  return 0;
+}
+
+
+/**
+  Finish reading a packet started by my_net_stream_start().
+  Any unread data of the packet is read and thrown away.
+
+  @retval
+    0	The whole packet was consumed by the caller
+  @retval
+    1	Data was left in the packet, or a read error occurred
+*/
+
+my_bool my_net_stream_end(NET_STREAM *stream)
+{
+  uchar buff[IO_SIZE];
+  my_bool left= 0;
+
+  if (stream->buffered)
+    return 0;
+  while (stream->remain || stream->more)
+  {
+    size_t part= stream->remain ? min(sizeof(buff), stream->remain) : 0;
+    if (!part)
+    {
+      /*
+        Only the header of the next packet is unread; if the caller
+        consumed a multiple of MAX_PACKET_LENGTH it's the empty one
+        that ends the value, which doesn't count as data left.
+      */
+      if ((stream->remain= net_stream_header(stream->net)) == packet_error)
+        return 1;
+      stream->more= (stream->remain == MAX_PACKET_LENGTH);
+      continue;
+    }
+    left= 1;
+    if (my_net_stream_read(stream, buff, part))
+      return 1;
+  }
+  return left;
+}
+
+
 void my_net_set_read_timeout(NET *net, uint timeout)
 {
   DBUG_ENTER("my_net_set_read_timeout");
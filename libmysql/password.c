@@ -294,12 +294,7 @@ void create_random_string(char *to, uint length,
 
 char *octet2hex(char *to, const char *str, uint len)
 {
-  const char *str_end= str + len; 
-  for (; str != str_end; ++str)
-  {
-    *to++= _dig_vec_upper[((uchar) *str) >> 4];
-    *to++= _dig_vec_upper[((uchar) *str) & 0x0F];
-  }
+  to+= my_hex_encode(to, (const uchar*) str, len);
   *to= '\0';
   return to;
 }
@@ -313,17 +308,16 @@ char *octet2hex(char *to, const char *str, uint len)
     to        OUT buffer to place result; must be at least len/2 bytes
     str, len  IN  begin, length for character string; str and to may not
                   overlap; len % 2 == 0
+  NOTE
+    If str isn't all hex digits, 'to' is zero filled, so that a broken
+    password entry never matches a scramble.
 */ 
 
 static void
 hex2octet(uint8 *to, const char *str, uint len)
 {
-  const char *str_end= str + len;
-  while (str < str_end)
-  {
-    register char tmp= char_val(*str++);
-    *to++= (tmp << 4) | char_val(*str++);
-  }
+  if (my_hex_decode(to, str, len) == (size_t) -1)
+    bzero((char*) to, len / 2);
 }
 
 
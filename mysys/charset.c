@@ -19,6 +19,13 @@
 #include <m_string.h>
 #include <my_dir.h>
 #include <my_xml.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 8))
+#define ESCAPE_HAVE_AVX2
+#include <immintrin.h>
+#endif
+#endif
 
 
 /*
@@ -31,6 +38,9 @@
     - Setting server default character set
 */
 
+/* Flags for the memory the character sets are loaded into */
+#define CS_ALLOC_FLAGS MYF(MY_WME | MY_MEM_CHARSET)
+
 my_bool my_charset_same(CHARSET_INFO *cs1, CHARSET_INFO *cs2)
 {
   return ((cs1 == cs2) || !strcmp(cs1->csname,cs2->csname));
@@ -59,10 +69,10 @@ static my_bool init_state_maps(CHARSET_INFO *cs)
   uchar *state_map;
   uchar *ident_map;
 
-  if (!(cs->state_map= (uchar*) my_once_alloc(256, MYF(MY_WME))))
+  if (!(cs->state_map= (uchar*) my_once_alloc(256, CS_ALLOC_FLAGS)))
     return 1;
     
-  if (!(cs->ident_map= (uchar*) my_once_alloc(256, MYF(MY_WME))))
+  if (!(cs->ident_map= (uchar*) my_once_alloc(256, CS_ALLOC_FLAGS)))
     return 1;
 
   state_map= cs->state_map;
@@ -135,22 +145,22 @@ static int cs_copy_data(CHARSET_INFO *to, CHARSET_INFO *from)
   to->number= from->number ? from->number : to->number;
 
   if (from->csname)
-    if (!(to->csname= my_once_strdup(from->csname,MYF(MY_WME))))
+    if (!(to->csname= my_once_strdup(from->csname,CS_ALLOC_FLAGS)))
       goto err;
   
   if (from->name)
-    if (!(to->name= my_once_strdup(from->name,MYF(MY_WME))))
+    if (!(to->name= my_once_strdup(from->name,CS_ALLOC_FLAGS)))
       goto err;
   
   if (from->comment)
-    if (!(to->comment= my_once_strdup(from->comment,MYF(MY_WME))))
+    if (!(to->comment= my_once_strdup(from->comment,CS_ALLOC_FLAGS)))
       goto err;
   
   if (from->ctype)
   {
     if (!(to->ctype= (uchar*) my_once_memdup((char*) from->ctype,
 					     MY_CS_CTYPE_TABLE_SIZE,
-					     MYF(MY_WME))))
+					     CS_ALLOC_FLAGS)))
       goto err;
     if (init_state_maps(to))
       goto err;
@@ -158,19 +168,19 @@ static int cs_copy_data(CHARSET_INFO *to, CHARSET_INFO *from)
   if (from->to_lower)
     if (!(to->to_lower= (uchar*) my_once_memdup((char*) from->to_lower,
 						MY_CS_TO_LOWER_TABLE_SIZE,
-						MYF(MY_WME))))
+						CS_ALLOC_FLAGS)))
       goto err;
 
   if (from->to_upper)
     if (!(to->to_upper= (uchar*) my_once_memdup((char*) from->to_upper,
 						MY_CS_TO_UPPER_TABLE_SIZE,
-						MYF(MY_WME))))
+						CS_ALLOC_FLAGS)))
       goto err;
   if (from->sort_order)
   {
     if (!(to->sort_order= (uchar*) my_once_memdup((char*) from->sort_order,
 						  MY_CS_SORT_ORDER_TABLE_SIZE,
-						  MYF(MY_WME))))
+						  CS_ALLOC_FLAGS)))
       goto err;
 
   }
@@ -178,11 +188,11 @@ static int cs_copy_data(CHARSET_INFO *to, CHARSET_INFO *from)
   {
     uint sz= MY_CS_TO_UNI_TABLE_SIZE*sizeof(uint16);
     if (!(to->tab_to_uni= (uint16*)  my_once_memdup((char*)from->tab_to_uni,
-						    sz, MYF(MY_WME))))
+						    sz, CS_ALLOC_FLAGS)))
       goto err;
   }
   if (from->tailoring)
-    if (!(to->tailoring= my_once_strdup(from->tailoring,MYF(MY_WME))))
+    if (!(to->tailoring= my_once_strdup(from->tailoring,CS_ALLOC_FLAGS)))
       goto err;
 
   return 0;
@@ -225,7 +235,8 @@ static int add_collation(CHARSET_INFO *cs)
     if (!all_charsets[cs->number])
     {
       if (!(all_charsets[cs->number]=
-         (CHARSET_INFO*) my_once_alloc(sizeof(CHARSET_INFO),MYF(0))))
+         (CHARSET_INFO*) my_once_alloc(sizeof(CHARSET_INFO),
+                                       MYF(MY_MEM_CHARSET))))
         return MY_XML_ERROR;
       bzero((void*)all_charsets[cs->number],sizeof(CHARSET_INFO));
     }
@@ -324,13 +335,13 @@ static int add_collation(CHARSET_INFO *cs)
       CHARSET_INFO *dst= all_charsets[cs->number];
       dst->number= cs->number;
       if (cs->comment)
-	if (!(dst->comment= my_once_strdup(cs->comment,MYF(MY_WME))))
+	if (!(dst->comment= my_once_strdup(cs->comment,CS_ALLOC_FLAGS)))
 	  return MY_XML_ERROR;
       if (cs->csname && !dst->csname)
-        if (!(dst->csname= my_once_strdup(cs->csname,MYF(MY_WME))))
+        if (!(dst->csname= my_once_strdup(cs->csname,CS_ALLOC_FLAGS)))
 	  return MY_XML_ERROR;
       if (cs->name && !dst->name)
-	if (!(dst->name= my_once_strdup(cs->name,MYF(MY_WME))))
+	if (!(dst->name= my_once_strdup(cs->name,CS_ALLOC_FLAGS)))
 	  return MY_XML_ERROR;
     }
     cs->number= 0;
@@ -423,7 +434,7 @@ void add_compiled_collation(CHARSET_INFO *cs)
 
 static void *cs_alloc(size_t size)
 {
-  return my_once_alloc(size, MYF(MY_WME));
+  return my_once_alloc(size, CS_ALLOC_FLAGS);
 }
 
 
@@ -693,6 +704,192 @@ my_bool resolve_collation(const char *cl_name,
 }
 
 
+/*
+  Find the length of the leading run of bytes that need no escaping
+
+  SYNOPSIS
+    escape_scan_plain()
+    from                Start of the string to scan
+    end                 End of the string
+    stop_at_8bit        If set, bytes >= 0x80 also end the run
+
+  DESCRIPTION
+    Special bytes are 0, \n, \r, \\, ', " and \032. The scan is done 32
+    bytes at a time with AVX2 if the CPU has it, which is checked on the
+    first call, 16 bytes at a time with SSE2 where available, and 8 bytes
+    at a time in a machine word otherwise; the byte that ends the run is
+    found by the scalar loop at the end.
+
+  RETURN VALUES
+    #           Number of bytes that can be copied as they are
+*/
+
+#define ESCAPE_ONES  ((ulonglong) 0x0101010101010101ULL)
+#define ESCAPE_HIGHS ((ulonglong) 0x8080808080808080ULL)
+#define ESCAPE_HAS_BYTE(W,C) \
+  ((((W) ^ (ESCAPE_ONES * (C))) - ESCAPE_ONES) & ~((W) ^ (ESCAPE_ONES * (C))) & \
+   ESCAPE_HIGHS)
+
+static inline my_bool escape_is_special(uchar c)
+{
+  return c == 0 || c == '\n' || c == '\r' || c == '\\' || c == '\'' ||
+         c == '"' || c == '\032';
+}
+
+static size_t escape_scan_default(const uchar *from, const uchar *end,
+                                  my_bool stop_at_8bit)
+{
+  const uchar *pos= from;
+#ifdef __SSE2__
+  const __m128i zero= _mm_setzero_si128();
+  const __m128i nl= _mm_set1_epi8('\n'), cr= _mm_set1_epi8('\r');
+  const __m128i bs= _mm_set1_epi8('\\'), sq= _mm_set1_epi8('\'');
+  const __m128i dq= _mm_set1_epi8('"'), ctrlz= _mm_set1_epi8('\032');
+
+  for (; end - pos >= 16; pos+= 16)
+  {
+    __m128i v= _mm_loadu_si128((const __m128i*) pos);
+    __m128i hit= _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, zero),
+                                           _mm_cmpeq_epi8(v, nl)),
+                              _mm_or_si128(_mm_cmpeq_epi8(v, cr),
+                                           _mm_cmpeq_epi8(v, bs)));
+    int mask;
+    hit= _mm_or_si128(hit, _mm_or_si128(_mm_cmpeq_epi8(v, sq),
+                                        _mm_or_si128(_mm_cmpeq_epi8(v, dq),
+                                                     _mm_cmpeq_epi8(v, ctrlz))));
+    mask= _mm_movemask_epi8(hit);
+    if (stop_at_8bit)
+      mask|= _mm_movemask_epi8(v);
+    if (mask)
+      break;
+  }
+#else
+  for (; end - pos >= 8; pos+= 8)
+  {
+    ulonglong w;
+    memcpy(&w, pos, 8);
+    if ((stop_at_8bit && (w & ESCAPE_HIGHS)) ||
+        ESCAPE_HAS_BYTE(w, 0) | ESCAPE_HAS_BYTE(w, '\n') |
+        ESCAPE_HAS_BYTE(w, '\r') | ESCAPE_HAS_BYTE(w, '\\') |
+        ESCAPE_HAS_BYTE(w, '\'') | ESCAPE_HAS_BYTE(w, '"') |
+        ESCAPE_HAS_BYTE(w, '\032'))
+      break;
+  }
+#endif
+  for (; pos < end; pos++)
+  {
+    if (escape_is_special(*pos) || (stop_at_8bit && *pos >= 0x80))
+      break;
+  }
+  return (size_t) (pos - from);
+}
+
+#ifdef ESCAPE_HAVE_AVX2
+
+#define ESCAPE_AVX2 __attribute__((target("avx2")))
+
+static ESCAPE_AVX2 size_t escape_scan_avx2(const uchar *from,
+                                           const uchar *end,
+                                           my_bool stop_at_8bit)
+{
+  const uchar *pos= from;
+  const __m256i zero= _mm256_setzero_si256();
+  const __m256i nl= _mm256_set1_epi8('\n'), cr= _mm256_set1_epi8('\r');
+  const __m256i bs= _mm256_set1_epi8('\\'), sq= _mm256_set1_epi8('\'');
+  const __m256i dq= _mm256_set1_epi8('"'), ctrlz= _mm256_set1_epi8('\032');
+
+  for (; end - pos >= 32; pos+= 32)
+  {
+    __m256i v= _mm256_loadu_si256((const __m256i*) pos);
+    __m256i hit= _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, zero),
+                                                 _mm256_cmpeq_epi8(v, nl)),
+                                 _mm256_or_si256(_mm256_cmpeq_epi8(v, cr),
+                                                 _mm256_cmpeq_epi8(v, bs)));
+    uint mask;
+    hit= _mm256_or_si256(hit,
+                         _mm256_or_si256(_mm256_cmpeq_epi8(v, sq),
+                                         _mm256_or_si256(_mm256_cmpeq_epi8(v, dq),
+                                                         _mm256_cmpeq_epi8(v, ctrlz))));
+    mask= (uint) _mm256_movemask_epi8(hit);
+    if (stop_at_8bit)
+      mask|= (uint) _mm256_movemask_epi8(v);
+    if (mask)
+      return (size_t) (pos - from) + __builtin_ctz(mask);
+  }
+  return (size_t) (pos - from) + escape_scan_default(pos, end, stop_at_8bit);
+}
+
+#endif /* ESCAPE_HAVE_AVX2 */
+
+/*
+  The implementation is picked on the first call. The pointer is only
+  ever set to equivalent functions, so racing first calls are harmless.
+*/
+
+static size_t escape_scan_init(const uchar *from, const uchar *end,
+                               my_bool stop_at_8bit);
+
+static size_t (*escape_scan_plain)(const uchar*, const uchar*, my_bool)=
+  escape_scan_init;
+
+static size_t escape_scan_init(const uchar *from, const uchar *end,
+                               my_bool stop_at_8bit)
+{
+  escape_scan_plain= escape_scan_default;
+#ifdef ESCAPE_HAVE_AVX2
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    escape_scan_plain= escape_scan_avx2;
+#endif
+  return escape_scan_plain(from, end, stop_at_8bit);
+}
+
+
+/*
+  Length of the run at 'from' of bytes which need no escaping and of
+  well-formed utf8 characters, as accepted by my_ismbchar(). 'mb4' allows
+  four byte characters. The run stops at an ill-formed or truncated
+  sequence, which is left to the byte at a time code.
+*/
+
+static size_t escape_scan_utf8(const uchar *from, const uchar *end,
+                               my_bool mb4)
+{
+  const uchar *pos= from;
+  for (;;)
+  {
+    uchar c;
+    pos+= escape_scan_plain(pos, end, TRUE);
+    if (pos == end || (c= *pos) < 0xc2)
+      break;
+    if (c < 0xe0)
+    {
+      if (end - pos < 2 || (pos[1] ^ 0x80) >= 0x40)
+        break;
+      pos+= 2;
+    }
+    else if (c < 0xf0)
+    {
+      if (end - pos < 3 || (pos[1] ^ 0x80) >= 0x40 ||
+          (pos[2] ^ 0x80) >= 0x40 || (c < 0xe1 && pos[1] < 0xa0))
+        break;
+      pos+= 3;
+    }
+    else if (mb4 && c < 0xf5)
+    {
+      if (end - pos < 4 || (pos[1] ^ 0x80) >= 0x40 ||
+          (pos[2] ^ 0x80) >= 0x40 || (pos[3] ^ 0x80) >= 0x40 ||
+          (c < 0xf1 && pos[1] < 0x90) || (c > 0xf3 && pos[1] > 0x8f))
+        break;
+      pos+= 4;
+    }
+    else
+      break;
+  }
+  return (size_t) (pos - from);
+}
+
+
 /*
   Escape string with backslashes (\)
 
@@ -709,6 +906,15 @@ my_bool resolve_collation(const char *cl_name,
     characters, and turning others into specific escape sequences, such as
     turning newlines into \n and null bytes into \0.
 
+    Runs of bytes which need no escaping are found with escape_scan_plain()
+    and copied in one go. For multi-byte character sets such a run stops at
+    the first byte >= 0x80, so the charset handlers are still called for
+    every multi-byte character and the GBK/SJIS checks below are kept. In
+    all ASCII-based character sets a byte < 0x80 at a character boundary is
+    a character of its own. For utf8 the run also takes in well-formed
+    multi-byte characters, see escape_scan_utf8(), as none of their bytes
+    can be mistaken for one that needs escaping.
+
   NOTE
     To maintain compatibility with the old C API, to_length may be 0 to mean
     "big enough"
@@ -725,14 +931,46 @@ size_t escape_string_for_mysql(CHARSET_INFO *charset_info,
   const char *to_start= to;
   const char *end, *to_end=to_start + (to_length ? to_length-1 : 2*length);
   my_bool overflow= FALSE;
+  my_bool use_scan= charset_info->mbminlen == 1;
+  my_bool scan_utf8= (charset_info->cset == &my_charset_utf8mb3_handler ||
+                      charset_info->cset == &my_charset_utf8mb4_handler);
 #ifdef USE_MB
   my_bool use_mb_flag= use_mb(charset_info);
+#else
+  my_bool use_mb_flag= FALSE;
 #endif
   for (end= from + length; from < end; from++)
   {
     char escape= 0;
 #ifdef USE_MB
     int tmp_length;
+#endif
+    if (use_scan)
+    {
+      size_t plain= (scan_utf8 ?
+                     escape_scan_utf8((const uchar*) from, (const uchar*) end,
+                                      charset_info->cset ==
+                                      &my_charset_utf8mb4_handler) :
+                     escape_scan_plain((const uchar*) from, (const uchar*) end,
+                                       use_mb_flag));
+      if (plain)
+      {
+        if (plain > (size_t) (to_end - to))
+        {
+          /* Don't split a utf8 character, back up to its lead byte */
+          plain= (size_t) (to_end - to);
+          while (scan_utf8 && plain && ((uchar) from[plain] & 0xc0) == 0x80)
+            plain--;
+          overflow= TRUE;
+        }
+        memcpy(to, from, plain);
+        to+= plain;
+        from+= plain;
+        if (overflow || from == end)
+          break;
+      }
+    }
+#ifdef USE_MB
     if (use_mb_flag && (tmp_length= my_ismbchar(charset_info, from, end)))
     {
       if (to + tmp_length > to_end)
@@ -41,10 +41,413 @@ static int hashcmp(const HASH *hash, HASH_LINK *pos, const uchar *key,
 static uint calc_hash(const HASH *hash, const uchar *key, size_t length)
 {
   ulong nr1=1, nr2=4;
+  if (hash->flags & HASH_BINARY)
+    return (uint) my_hash_bytes(key, length, 0);
   hash->charset->coll->hash_sort(hash->charset,(uchar*) key,length,&nr1,&nr2);
   return nr1;
 }
 
+/*
+  This function is char* instead of uchar* as HPUX11 compiler can't
+  handle inline functions that are not defined as native types
+*/
+
+static inline char*
+my_hash_key(const HASH *hash, const uchar *record, size_t *length,
+            my_bool first)
+{
+  if (hash->get_key)
+    return (char*) (*hash->get_key)(record,length,first);
+  *length=hash->key_length;
+  return (char*) record+hash->key_offset;
+}
+
+
+/*
+  Open addressing (HASH_OPEN)
+
+  The records are kept dense in hash->array as for the chained table,
+  but HASH_LINK::next holds the hash number of the key instead of a
+  link.  The records are found through a table of hash->blength slots,
+  a power of two.  hash->ctrl has a control byte for each slot, followed
+  by GROUP_WIDTH bytes mirroring the first ones so that any group of
+  slots can be loaded at once, followed by the index of the record in
+  each slot.  A control byte is CTRL_EMPTY, CTRL_DELETED or the low
+  7 bits of the hash number of the record in the slot: a whole group is
+  matched against a key with a few instructions, and only the slots
+  with the same 7 bits and the same hash number need a key comparison.
+  Groups are probed with growing steps from the slot given by the high
+  bits of the hash number until a group with an empty slot is found.
+*/
+
+#define CTRL_EMPTY      ((uchar) 0x80)
+#define CTRL_DELETED    ((uchar) 0xFE)
+#define CTRL_HASH(N)    ((uchar) ((N) & 0x7F))
+#define SLOT_HASH(N)    ((size_t) ((N) >> 7))
+#define MIN_SLOTS       16
+#define MAX_LOAD(S)     ((S) - (S) / 8)
+#define OPEN_SLOTS(H)   ((uint*) ((H)->ctrl + \
+                                  ALIGN_SIZE((H)->blength + GROUP_WIDTH)))
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+#define GROUP_WIDTH     16
+#define GROUP_SHIFT     0
+
+static inline ulonglong group_match(const uchar *ctrl, uchar value)
+{
+  __m128i group= _mm_loadu_si128((const __m128i*) ctrl);
+  return (uint) _mm_movemask_epi8(_mm_cmpeq_epi8(group,
+                                                 _mm_set1_epi8((char) value)));
+}
+
+static inline ulonglong group_match_empty(const uchar *ctrl)
+{
+  return group_match(ctrl, CTRL_EMPTY);
+}
+
+/* Empty and deleted slots are the ones with the high bit set */
+static inline ulonglong group_match_free(const uchar *ctrl)
+{
+  return (uint) _mm_movemask_epi8(_mm_loadu_si128((const __m128i*) ctrl));
+}
+
+#else
+
+/* Eight control bytes at a time in a 64 bit word */
+#define GROUP_WIDTH     8
+#define GROUP_SHIFT     3
+#define GROUP_LSBS      0x0101010101010101ULL
+#define GROUP_MSBS      0x8080808080808080ULL
+
+/*
+  May report a byte after a matching one that differs from value only
+  in the lowest bit; that is a used slot and fails the hash comparison
+*/
+static inline ulonglong group_match(const uchar *ctrl, uchar value)
+{
+  ulonglong group= uint8korr(ctrl) ^ (GROUP_LSBS * value);
+  return (group - GROUP_LSBS) & ~group & GROUP_MSBS;
+}
+
+static inline ulonglong group_match_empty(const uchar *ctrl)
+{
+  ulonglong group= uint8korr(ctrl);
+  return group & ~(group << 6) & GROUP_MSBS;
+}
+
+static inline ulonglong group_match_free(const uchar *ctrl)
+{
+  return uint8korr(ctrl) & GROUP_MSBS;
+}
+
+#endif
+
+/* Position in the group of the lowest match in bits */
+
+static inline uint group_first(ulonglong bits)
+{
+#ifdef __GNUC__
+  return (uint) __builtin_ctzll(bits) >> GROUP_SHIFT;
+#else
+  uint i;
+  for (i= 0; !(bits & 1); i++)
+    bits>>= 1;
+  return i >> GROUP_SHIFT;
+#endif
+}
+
+
+/*
+  Hash number of a key in an open addressing table
+
+  NOTES
+    The hash numbers of the collations are mixed, as their low bits
+    are used for the control bytes.
+*/
+
+static uint open_hash_nr(const HASH *hash, const uchar *key, size_t length)
+{
+  uint nr= calc_hash(hash, key, length);
+  if (hash->flags & HASH_BINARY)
+    return nr;
+  nr^= nr >> 16;
+  nr*= 0x85EBCA6B;
+  nr^= nr >> 13;
+  nr*= 0xC2B2AE35;
+  return nr ^ (nr >> 16);
+}
+
+
+static inline uint open_rec_hash_nr(const HASH *hash, const uchar *record)
+{
+  size_t length;
+  uchar *key= (uchar*) my_hash_key(hash, record, &length, 0);
+  return open_hash_nr(hash, key, length);
+}
+
+
+static inline void set_ctrl(HASH *hash, size_t slot, uchar value)
+{
+  hash->ctrl[slot]= value;
+  if (slot < GROUP_WIDTH)
+    hash->ctrl[hash->blength + slot]= value;
+}
+
+
+/*
+  Search after a record with a key
+
+  SYNOPSIS
+    open_find()
+    hash         hash table
+    key, length  key to search for
+    hash_nr      hash number of the key
+    after        slot found by the previous call or NO_RECORD
+
+  RETURN
+    slot of the next record with the key, in probe order
+    NO_RECORD if there is none
+*/
+
+static uint open_find(const HASH *hash, const uchar *key, size_t length,
+                      uint hash_nr, uint after)
+{
+  HASH_LINK *data= dynamic_element(&hash->array, 0, HASH_LINK*);
+  uint *slots= OPEN_SLOTS(hash);
+  size_t mask= hash->blength - 1, pos= SLOT_HASH(hash_nr) & mask, step= 0;
+
+  for (;;)
+  {
+    ulonglong bits;
+    for (bits= group_match(hash->ctrl + pos, CTRL_HASH(hash_nr)) ; bits ;
+         bits&= bits - 1)
+    {
+      uint slot= (uint) ((pos + group_first(bits)) & mask);
+      if (after != NO_RECORD)
+      {
+        if (slot == after)
+          after= NO_RECORD;
+        continue;
+      }
+      if (data[slots[slot]].next == hash_nr &&
+          !hashcmp(hash, data + slots[slot], key, length))
+        return slot;
+    }
+    if (group_match_empty(hash->ctrl + pos))
+      return NO_RECORD;
+    step+= GROUP_WIDTH;
+    pos= (pos + step) & mask;
+  }
+}
+
+
+/* Find the slot of a record in the table, NO_RECORD if not there */
+
+static uint open_find_record(const HASH *hash, uint hash_nr,
+                             const uchar *record)
+{
+  HASH_LINK *data= dynamic_element(&hash->array, 0, HASH_LINK*);
+  uint *slots= OPEN_SLOTS(hash);
+  size_t mask= hash->blength - 1, pos= SLOT_HASH(hash_nr) & mask, step= 0;
+
+  for (;;)
+  {
+    ulonglong bits;
+    for (bits= group_match(hash->ctrl + pos, CTRL_HASH(hash_nr)) ; bits ;
+         bits&= bits - 1)
+    {
+      uint slot= (uint) ((pos + group_first(bits)) & mask);
+      if (data[slots[slot]].data == record)
+        return slot;
+    }
+    if (group_match_empty(hash->ctrl + pos))
+      return NO_RECORD;
+    step+= GROUP_WIDTH;
+    pos= (pos + step) & mask;
+  }
+}
+
+
+/* First empty or deleted slot for a hash number */
+
+static size_t open_free_slot(const HASH *hash, uint hash_nr)
+{
+  size_t mask= hash->blength - 1, pos= SLOT_HASH(hash_nr) & mask, step= 0;
+  ulonglong bits;
+
+  while (!(bits= group_match_free(hash->ctrl + pos)))
+  {
+    step+= GROUP_WIDTH;
+    pos= (pos + step) & mask;
+  }
+  return (pos + group_first(bits)) & mask;
+}
+
+
+static inline void open_set_slot(HASH *hash, size_t slot, uint hash_nr,
+                                 uint idx)
+{
+  if (hash->ctrl[slot] == CTRL_EMPTY)
+    hash->growth_left--;
+  set_ctrl(hash, slot, CTRL_HASH(hash_nr));
+  OPEN_SLOTS(hash)[slot]= idx;
+}
+
+
+/* Smallest number of slots to hold records, a power of two */
+
+static size_t open_slots(size_t records)
+{
+  size_t slots= MIN_SLOTS;
+  while (MAX_LOAD(slots) <= records)
+    slots<<= 1;
+  return slots;
+}
+
+
+/*
+  Allocate a new slot table and put all records of the hash in it
+
+  SYNOPSIS
+    open_rehash()
+    hash         hash table
+    slot_count   number of slots, a power of two with room for the
+                 records
+
+  NOTES
+    Also used to clean out the deleted slots.
+
+  RETURN
+    0  ok
+    1  out of memory, the old table is kept
+*/
+
+static my_bool open_rehash(HASH *hash, size_t slot_count)
+{
+  HASH_LINK *data= dynamic_element(&hash->array, 0, HASH_LINK*);
+  size_t ctrl_length= ALIGN_SIZE(slot_count + GROUP_WIDTH);
+  uchar *ctrl;
+  uint idx;
+  DBUG_ENTER("open_rehash");
+  DBUG_PRINT("enter",("records: %lu  slots: %lu", hash->records,
+                      (ulong) slot_count));
+
+  if (!(ctrl= (uchar*) my_malloc(ctrl_length + slot_count * sizeof(uint),
+                                 MYF(MY_WME))))
+    DBUG_RETURN(1);
+  my_free(hash->ctrl, MYF(MY_ALLOW_ZERO_PTR));
+  hash->ctrl= ctrl;
+  hash->blength= slot_count;
+  hash->growth_left= MAX_LOAD(slot_count);
+  memset(ctrl, CTRL_EMPTY, slot_count + GROUP_WIDTH);
+  for (idx= 0 ; idx < hash->records ; idx++)
+    open_set_slot(hash, open_free_slot(hash, data[idx].next),
+                  data[idx].next, idx);
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Make room for one more slot: grow the table, or only clean out the
+  deleted slots if that frees enough of them
+*/
+
+static my_bool open_make_room(HASH *hash, size_t records)
+{
+  if (records <= MAX_LOAD(hash->blength) / 2)
+    return open_rehash(hash, hash->blength);
+  return open_rehash(hash, open_slots(records));
+}
+
+
+static my_bool open_insert(HASH *hash, const uchar *record)
+{
+  HASH_LINK *link;
+  uint hash_nr= open_rec_hash_nr(hash, record);
+  size_t slot;
+
+  if (!(link= (HASH_LINK*) alloc_dynamic(&hash->array)))
+    return TRUE;				/* No more memory */
+  link->data= (uchar*) record;
+  link->next= hash_nr;
+
+  slot= open_free_slot(hash, hash_nr);
+  if (hash->ctrl[slot] == CTRL_EMPTY && !hash->growth_left)
+  {
+    hash->records++;
+    if (open_make_room(hash, hash->records))
+    {
+      hash->records--;
+      (void) pop_dynamic(&hash->array);
+      return TRUE;
+    }
+    return FALSE;                               /* Placed by open_rehash */
+  }
+  open_set_slot(hash, slot, hash_nr, (uint) hash->records++);
+  return FALSE;
+}
+
+
+static my_bool open_delete(HASH *hash, uchar *record)
+{
+  HASH_LINK *data= dynamic_element(&hash->array, 0, HASH_LINK*);
+  uint *slots= OPEN_SLOTS(hash);
+  uint slot, idx;
+
+  if ((slot= open_find_record(hash, open_rec_hash_nr(hash, record),
+                              record)) == NO_RECORD)
+    return 1;					/* Key not found */
+  idx= slots[slot];
+  set_ctrl(hash, slot, CTRL_DELETED);
+
+  /* Move the last record into the hole */
+  if (idx != --hash->records)
+  {
+    data[idx]= data[hash->records];
+    slots[open_find_record(hash, data[idx].next, data[idx].data)]= idx;
+  }
+  (void) pop_dynamic(&hash->array);
+  if (!hash->records)
+  {
+    memset(hash->ctrl, CTRL_EMPTY, hash->blength + GROUP_WIDTH);
+    hash->growth_left= MAX_LOAD(hash->blength);
+  }
+  return 0;
+}
+
+
+static my_bool open_update(HASH *hash, uchar *record, uint old_hash_nr)
+{
+  HASH_LINK *data= dynamic_element(&hash->array, 0, HASH_LINK*);
+  uint hash_nr= open_rec_hash_nr(hash, record);
+  uint slot, idx;
+  size_t new_slot;
+
+  if ((slot= open_find_record(hash, old_hash_nr, record)) == NO_RECORD)
+    return 1;					/* Not found */
+  if (hash_nr == old_hash_nr)
+    return 0;
+  idx= OPEN_SLOTS(hash)[slot];
+
+  new_slot= open_free_slot(hash, hash_nr);
+  if (hash->ctrl[new_slot] == CTRL_EMPTY && !hash->growth_left)
+  {
+    data[idx].next= hash_nr;
+    if (open_make_room(hash, hash->records))
+    {
+      data[idx].next= old_hash_nr;
+      return 1;
+    }
+    return 0;
+  }
+  data[idx].next= hash_nr;
+  set_ctrl(hash, slot, CTRL_DELETED);
+  open_set_slot(hash, new_slot, hash_nr, idx);
+  return 0;
+}
+
 my_bool
 _my_hash_init(HASH *hash, uint growth_size, CHARSET_INFO *charset,
               ulong size, size_t key_offset, size_t key_length,
@@ -54,7 +457,14 @@ _my_hash_init(HASH *hash, uint growth_size, CHARSET_INFO *charset,
   DBUG_ENTER("my_hash_init");
   DBUG_PRINT("enter",("hash: %p  size: %u", hash, (uint) size));
 
+  /* The open tables are new, their binary keys use my_hash_bytes() */
+  if (flags & HASH_OPEN)
+    flags|= HASH_BINARY;
+  if (!my_binary_compare(charset))
+    flags&= ~HASH_BINARY;
   hash->records=0;
+  hash->flags=flags;
+  hash->ctrl=0;
   if (my_init_dynamic_array_ci(&hash->array, sizeof(HASH_LINK), size,
                                growth_size))
   {
@@ -66,8 +476,13 @@ _my_hash_init(HASH *hash, uint growth_size, CHARSET_INFO *charset,
   hash->blength=1;
   hash->get_key=get_key;
   hash->free=free_element;
-  hash->flags=flags;
   hash->charset=charset;
+  if ((flags & HASH_OPEN) && open_rehash(hash, open_slots(size)))
+  {
+    hash->free=0;
+    delete_dynamic(&hash->array);
+    DBUG_RETURN(1);
+  }
   DBUG_RETURN(0);
 }
 
@@ -114,6 +529,11 @@ void my_hash_free(HASH *hash)
   my_hash_free_elements(hash);
   hash->free= 0;
   delete_dynamic(&hash->array);
+  if (hash->flags & HASH_OPEN)
+  {
+    my_free(hash->ctrl, MYF(MY_ALLOW_ZERO_PTR));
+    hash->ctrl= 0;
+  }
   DBUG_VOID_RETURN;
 }
 
@@ -133,28 +553,21 @@ void my_hash_reset(HASH *hash)
 
   my_hash_free_elements(hash);
   reset_dynamic(&hash->array);
-  /* Set row pointers so that the hash can be reused at once */
-  hash->blength= 1;
+  if (hash->flags & HASH_OPEN)
+  {
+    memset(hash->ctrl, CTRL_EMPTY, hash->blength + GROUP_WIDTH);
+    hash->growth_left= MAX_LOAD(hash->blength);
+  }
+  else
+  {
+    /* Set row pointers so that the hash can be reused at once */
+    hash->blength= 1;
+  }
   DBUG_VOID_RETURN;
 }
 
 /* some helper functions */
 
-/*
-  This function is char* instead of uchar* as HPUX11 compiler can't
-  handle inline functions that are not defined as native types
-*/
-
-static inline char*
-my_hash_key(const HASH *hash, const uchar *record, size_t *length,
-            my_bool first)
-{
-  if (hash->get_key)
-    return (char*) (*hash->get_key)(record,length,first);
-  *length=hash->key_length;
-  return (char*) record+hash->key_offset;
-}
-
 	/* Calculate pos according to keys */
 
 static uint my_hash_mask(size_t hashnr, size_t buffmax, size_t maxlength)
@@ -186,6 +599,7 @@ unsigned int rec_hashnr(HASH *hash,const uchar *record)
 }
 
 
+
 uchar* my_hash_search(const HASH *hash, const uchar *key, size_t length)
 {
   HASH_SEARCH_STATE state;
@@ -206,6 +620,21 @@ uchar* my_hash_first(const HASH *hash, const uchar *key, size_t length,
   uint flag,idx;
   DBUG_ENTER("my_hash_first");
 
+  if (hash->flags & HASH_OPEN)
+  {
+    if (!length)
+      length= hash->key_length;
+    if ((idx= open_find(hash, key, length, open_hash_nr(hash, key, length),
+                        NO_RECORD)) == NO_RECORD)
+    {
+      *current_record= NO_RECORD;
+      DBUG_RETURN(0);
+    }
+    *current_record= idx;
+    DBUG_RETURN(dynamic_element(&hash->array, OPEN_SLOTS(hash)[idx],
+                                HASH_LINK*)->data);
+  }
+
   flag=1;
   if (hash->records)
   {
@@ -242,6 +671,20 @@ uchar* my_hash_next(const HASH *hash, const uchar *key, size_t length,
   HASH_LINK *pos;
   uint idx;
 
+  if (*current_record != NO_RECORD && (hash->flags & HASH_OPEN))
+  {
+    if (!length)
+      length= hash->key_length;
+    if ((idx= open_find(hash, key, length, open_hash_nr(hash, key, length),
+                        *current_record)) == NO_RECORD)
+    {
+      *current_record= NO_RECORD;
+      return 0;
+    }
+    *current_record= idx;
+    return dynamic_element(&hash->array, OPEN_SLOTS(hash)[idx],
+                           HASH_LINK*)->data;
+  }
   if (*current_record != NO_RECORD)
   {
     HASH_LINK *data=dynamic_element(&hash->array,0,HASH_LINK*);
@@ -298,9 +741,12 @@ static int hashcmp(const HASH *hash, HASH_LINK *pos, const uchar *key,
 {
   size_t rec_keylength;
   uchar *rec_key= (uchar*) my_hash_key(hash, pos->data, &rec_keylength, 1);
-  return ((length && length != rec_keylength) ||
-	  my_strnncoll(hash->charset, (uchar*) rec_key, rec_keylength,
-		       (uchar*) key, rec_keylength));
+  if (length && length != rec_keylength)
+    return 1;
+  if ((hash->flags & HASH_BINARY) || hash->charset == &my_charset_bin)
+    return memcmp(rec_key, key, rec_keylength);
+  return my_strnncoll(hash->charset, (uchar*) rec_key, rec_keylength,
+                      (uchar*) key, rec_keylength);
 }
 
 
@@ -330,6 +776,8 @@ my_bool my_hash_insert(HASH *info, const uchar *record)
     if (my_hash_search(info, key, idx))
       return(TRUE);				/* Duplicate entry */
   }
+  if (info->flags & HASH_OPEN)
+    return open_insert(info, record);
 
   flag=0;
   if (!(empty=(HASH_LINK*) alloc_dynamic(&info->array)))
@@ -471,6 +919,14 @@ my_bool my_hash_delete(HASH *hash, uchar *record)
   DBUG_ENTER("my_hash_delete");
   if (!hash->records)
     DBUG_RETURN(1);
+  if (hash->flags & HASH_OPEN)
+  {
+    if (open_delete(hash, record))
+      DBUG_RETURN(1);
+    if (hash->free)
+      (*hash->free)((uchar*) record);
+    DBUG_RETURN(0);
+  }
 
   blength=hash->blength;
   data=dynamic_element(&hash->array,0,HASH_LINK*);
@@ -575,14 +1031,18 @@ my_bool my_hash_update(HASH *hash, uchar *record, uchar *old_key,
     }
   }
 
+  if (!old_key_length)
+    old_key_length= hash->key_length;
+  if (hash->flags & HASH_OPEN)
+    DBUG_RETURN(open_update(hash, record,
+                            open_hash_nr(hash, old_key, old_key_length)));
+
   data=dynamic_element(&hash->array,0,HASH_LINK*);
   blength=hash->blength; records=hash->records;
 
   /* Search after record with key */
 
-  idx= my_hash_mask(calc_hash(hash, old_key, (old_key_length ?
-                                              old_key_length :
-                                              hash->key_length)),
+  idx= my_hash_mask(calc_hash(hash, old_key, old_key_length),
                     blength, records);
   new_index= my_hash_mask(rec_hashnr(hash, record), blength, records);
   if (idx == new_index)
@@ -668,7 +1128,12 @@ uchar *my_hash_element(HASH *hash, ulong idx)
 void my_hash_replace(HASH *hash, HASH_SEARCH_STATE *current_record,
                      uchar *new_row)
 {
-  if (*current_record != NO_RECORD)            /* Safety */
+  if (*current_record == NO_RECORD)            /* Safety */
+    return;
+  if (hash->flags & HASH_OPEN)
+    dynamic_element(&hash->array, OPEN_SLOTS(hash)[*current_record],
+                    HASH_LINK*)->data= new_row;
+  else
     dynamic_element(&hash->array, *current_record, HASH_LINK*)->data= new_row;
 }
 
@@ -706,6 +1171,56 @@ my_bool my_hash_iterate(HASH *hash, my_hash_walk_action action, void *argument)
 
 #ifndef DBUG_OFF
 
+static my_bool open_check(HASH *hash)
+{
+  HASH_LINK *data= dynamic_element(&hash->array, 0, HASH_LINK*);
+  uint *slots= OPEN_SLOTS(hash);
+  size_t i, used, empty;
+  my_bool error= 0;
+
+  for (i= used= empty= 0 ; i < hash->blength ; i++)
+  {
+    if (hash->ctrl[i] == CTRL_EMPTY)
+      empty++;
+    else if (hash->ctrl[i] != CTRL_DELETED)
+    {
+      used++;
+      if (slots[i] >= hash->records ||
+          hash->ctrl[i] != CTRL_HASH(data[slots[i]].next))
+      {
+        DBUG_PRINT("error", ("Wrong slot %lu", (ulong) i));
+        error= 1;
+      }
+    }
+    if (i < GROUP_WIDTH && hash->ctrl[i] != hash->ctrl[hash->blength + i])
+    {
+      DBUG_PRINT("error", ("Control byte %lu not mirrored", (ulong) i));
+      error= 1;
+    }
+  }
+  if (used != hash->records ||
+      empty != hash->growth_left + hash->blength / 8)
+  {
+    DBUG_PRINT("error", ("Found %lu of %lu records, %lu empty slots",
+                         (ulong) used, hash->records, (ulong) empty));
+    error= 1;
+  }
+  for (i= 0 ; i < hash->records ; i++)
+  {
+    uint slot;
+    if (data[i].next != open_rec_hash_nr(hash, data[i].data) ||
+        (slot= open_find_record(hash, data[i].next,
+                                data[i].data)) == NO_RECORD ||
+        slots[slot] != i)
+    {
+      DBUG_PRINT("error", ("Record %lu not found", (ulong) i));
+      error= 1;
+    }
+  }
+  return error;
+}
+
+
 my_bool my_hash_check(HASH *hash)
 {
   int error;
@@ -713,6 +1228,9 @@ my_bool my_hash_check(HASH *hash)
   uint records,blength;
   HASH_LINK *data,*hash_info;
 
+  if (hash->flags & HASH_OPEN)
+    return open_check(hash);
+
   records=hash->records; blength=hash->blength;
   data=dynamic_element(&hash->array,0,HASH_LINK*);
   error=0;
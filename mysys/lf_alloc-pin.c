@@ -98,6 +98,23 @@
   It is assumed that pins belong to a THD and are not transferable
   between THD's (LF_PINS::stack_ends_here being a primary reason
   for this limitation).
+
+  Epochs:
+
+  Instead of pins, a pinbox can use epoch based reclamation, see
+  lf_alloc_use_epochs(). A thread then does not pin what it reads, but
+  brackets every operation with _lf_epoch_enter() and _lf_epoch_leave(),
+  which store the current global epoch (LF_PINBOX::epoch) in its LF_PINS,
+  and 0 on leave. That is two stores with a memory barrier per operation,
+  instead of two for every pointer that the operation follows.
+
+  The purgatory is not compared against the pins. It is moved to a
+  "limbo", and the global epoch is advanced. The objects in the limbo
+  were unlinked before that, so only threads that entered an older epoch
+  can still see them. When no thread is in such an epoch anymore, the
+  limbo is freed. The price is that a thread that stays in a critical
+  section holds back reclamation for all threads, not only for the
+  objects it has pinned.
 */
 #include <my_global.h>
 #include <my_sys.h>
@@ -106,6 +123,7 @@
 #define LF_PINBOX_MAX_PINS 65536
 
 static void _lf_pinbox_real_free(LF_PINS *pins);
+static void _lf_epoch_real_free(LF_PINS *pins);
 
 /*
   Initialize a pinbox. Normally called from lf_alloc_init.
@@ -115,10 +133,12 @@ void lf_pinbox_init(LF_PINBOX *pinbox, uint free_ptr_offset,
                     lf_pinbox_free_func *free_func, void *free_func_arg)
 {
   DBUG_ASSERT(free_ptr_offset % sizeof(void *) == 0);
-  compile_time_assert(sizeof(LF_PINS) == 64);
+  compile_time_assert(sizeof(LF_PINS) == LF_PINS_SIZE);
   lf_dynarray_init(&pinbox->pinarray, sizeof(LF_PINS));
   pinbox->pinstack_top_ver= 0;
   pinbox->pins_in_array= 0;
+  pinbox->pin_retries= 0;
+  pinbox->epoch= 0;
   pinbox->free_ptr_offset= free_ptr_offset;
   pinbox->free_func= free_func;
   pinbox->free_func_arg= free_func_arg;
@@ -187,6 +207,9 @@ LF_PINS *_lf_pinbox_get_pins(LF_PINBOX *pinbox)
   */
   el->link= pins;
   el->purgatory_count= 0;
+  el->limbo_count= 0;
+  el->epoch_depth= 0;
+  el->search_epoch= 0;
   el->pinbox= pinbox;
   el->stack_ends_here= & my_thread_var->stack_ends_here;
   return el;
@@ -218,10 +241,14 @@ void _lf_pinbox_put_pins(LF_PINS *pins)
     and they would have pinned addresses that the caller wants to free.
     Thus: only free pins when all work is done and nobody can wait for you!!!
   */
-  while (pins->purgatory_count)
+  DBUG_ASSERT(pins->epoch_depth == 0);
+  while (pins->purgatory_count || pins->limbo_count)
   {
-    _lf_pinbox_real_free(pins);
-    if (pins->purgatory_count)
+    if (pinbox->epoch)
+      _lf_epoch_real_free(pins);
+    else
+      _lf_pinbox_real_free(pins);
+    if (pins->purgatory_count || pins->limbo_count)
     {
       my_atomic_rwlock_wrunlock(&pins->pinbox->pinarray.lock);
       pthread_yield();
@@ -258,12 +285,21 @@ static int ptr_cmp(void **a, void **b)
   DESCRIPTION
     add an object to purgatory. if necessary, call _lf_pinbox_real_free()
     to actually free something.
+
+  NOTE
+    the pins of all threads are scanned once for every LF_PURGATORY_SIZE
+    objects, not for every object
 */
 void _lf_pinbox_free(LF_PINS *pins, void *addr)
 {
   add_to_purgatory(pins, addr);
-  if (pins->purgatory_count % LF_PURGATORY_SIZE)
-    _lf_pinbox_real_free(pins);
+  if (!(pins->purgatory_count % LF_PURGATORY_SIZE))
+  {
+    if (pins->pinbox->epoch)
+      _lf_epoch_real_free(pins);
+    else
+      _lf_pinbox_real_free(pins);
+  }
 }
 
 struct st_harvester {
@@ -400,6 +436,60 @@ found:
     pinbox->free_func(first, last, pinbox->free_func_arg);
 }
 
+/*
+  callback for _lf_dynarray_iterate:
+  scan all threads and see if one is in 'epoch', or an older one
+*/
+static int match_epoch(LF_PINS *el, uint32 *epoch)
+{
+  LF_PINS *el_end= el+LF_DYNARRAY_LEVEL_LENGTH;
+  for (; el < el_end; el++)
+  {
+    uint32 cur= el->epoch;
+    if (cur && (int32)(cur - *epoch) <= 0)
+      return 1;
+  }
+  return 0;
+}
+
+/*
+  Free the limbo if no thread can see it anymore, and move the purgatory
+  into the limbo
+
+  NOTE
+    the global epoch is always odd, so that 0 means "not entered". the
+    comparison of epochs is modulo 2^32. the limbo is freed at the second
+    call at the earliest, _lf_pinbox_put_pins() loops until it is
+*/
+static void _lf_epoch_real_free(LF_PINS *pins)
+{
+  LF_PINBOX *pinbox= pins->pinbox;
+  void *last;
+
+  if (pins->limbo &&
+      !_lf_dynarray_iterate(&pinbox->pinarray,
+                            (lf_dynarray_func)match_epoch, &pins->limbo_epoch))
+  {
+    for (last= pins->limbo; next_node(pinbox, last); )
+      last= next_node(pinbox, last);
+    pinbox->free_func(pins->limbo, last, pinbox->free_func_arg);
+    pins->limbo= 0;
+    pins->limbo_count= 0;
+  }
+  if (pins->purgatory)
+  {
+    for (last= pins->purgatory; next_node(pinbox, last); )
+      last= next_node(pinbox, last);
+    next_node(pinbox, last)= pins->limbo;
+    pins->limbo= pins->purgatory;
+    pins->limbo_count+= pins->purgatory_count;
+    pins->purgatory= 0;
+    pins->purgatory_count= 0;
+    /* threads that enter from now on cannot see the limbo */
+    pins->limbo_epoch= my_atomic_add32((int32 volatile*) &pinbox->epoch, 2);
+  }
+}
+
 /* lock-free memory allocator for fixed-size objects */
 
 LF_REQUIRE_PINS(1)
@@ -485,12 +575,14 @@ void lf_alloc_destroy(LF_ALLOCATOR *allocator)
 
   DESCRIPTION
     Pop an unused object from the stack or malloc it is the stack is empty.
-    pin[0] is used, it's removed on return.
+    pin[0] is used, it's removed on return. With epochs, the stack is
+    read in a critical section instead.
 */
 void *_lf_alloc_new(LF_PINS *pins)
 {
   LF_ALLOCATOR *allocator= (LF_ALLOCATOR *)(pins->pinbox->free_func_arg);
   uchar *node;
+  _lf_epoch_enter(pins);
   for (;;)
   {
     do
@@ -514,6 +606,7 @@ void *_lf_alloc_new(LF_PINS *pins)
       break;
   }
   _lf_unpin(pins, 0);
+  _lf_epoch_leave(pins);
   return node;
 }
 
@@ -59,21 +59,33 @@ typedef struct {
 #define PTR(V)      (LF_SLIST *)((V) & (~(intptr)1))
 #define DELETED(V)  ((V) & 1)
 
+/* LF_BACKOFF, counting the retry in LF_PINBOX::pin_retries */
+#define RETRY(PINS) (my_atomic_add32((int32 volatile*)                   \
+                                     &(PINS)->pinbox->pin_retries, 1),   \
+                     LF_BACKOFF)
+
+/* called by lfind() for each node of a list, see lwalk() */
+typedef int (*lf_walk_func)(LF_SLIST *, void *);
+
 /*
   DESCRIPTION
     Search for hashnr/key/keylen in the list starting from 'head' and
     position the cursor. The list is ORDER BY hashnr, key
 
+    If 'walk' is given, it is called for every node of the list instead,
+    until it returns non-zero.
+
   RETURN
     0 - not found
-    1 - found
+    1 - found (or 'walk' returned non-zero)
 
   NOTE
     cursor is positioned in either case
     pins[0..2] are used, they are NOT removed on return
 */
 static int lfind(LF_SLIST * volatile *head, CHARSET_INFO *cs, uint32 hashnr,
-                 const uchar *key, uint keylen, CURSOR *cursor, LF_PINS *pins)
+                 const uchar *key, uint keylen, CURSOR *cursor, LF_PINS *pins,
+                 lf_walk_func walk, void *walk_arg)
 {
   uint32       cur_hashnr;
   const uchar  *cur_key;
@@ -85,7 +97,7 @@ retry:
   do { /* PTR() isn't necessary below, head is a dummy node */
     cursor->curr= (LF_SLIST *)(*cursor->prev);
     _lf_pin(pins, 1, cursor->curr);
-  } while (*cursor->prev != (intptr)cursor->curr && LF_BACKOFF);
+  } while (*cursor->prev != (intptr)cursor->curr && RETRY(pins));
   for (;;)
   {
     if (unlikely(!cursor->curr))
@@ -95,18 +107,23 @@ retry:
       link= cursor->curr->link;
       cursor->next= PTR(link);
       _lf_pin(pins, 0, cursor->next);
-    } while (link != cursor->curr->link && LF_BACKOFF);
+    } while (link != cursor->curr->link && RETRY(pins));
     cur_hashnr= cursor->curr->hashnr;
     cur_key= cursor->curr->key;
     cur_keylen= cursor->curr->keylen;
     if (*cursor->prev != (intptr)cursor->curr)
     {
-      (void)LF_BACKOFF;
+      (void)RETRY(pins);
       goto retry;
     }
     if (!DELETED(link))
     {
-      if (cur_hashnr >= hashnr)
+      if (unlikely(walk != 0))
+      {
+        if ((*walk)(cursor->curr, walk_arg))
+          return 1;
+      }
+      else if (cur_hashnr >= hashnr)
       {
         int r= 1;
         if (cur_hashnr > hashnr ||
@@ -128,7 +145,7 @@ retry:
         _lf_alloc_free(pins, cursor->curr);
       else
       {
-        (void)LF_BACKOFF;
+        (void)RETRY(pins);
         goto retry;
       }
     }
@@ -159,7 +176,7 @@ static LF_SLIST *linsert(LF_SLIST * volatile *head, CHARSET_INFO *cs,
   for (;;)
   {
     if (lfind(head, cs, node->hashnr, node->key, node->keylen,
-              &cursor, pins) &&
+              &cursor, pins, 0, 0) &&
         (flags & LF_HASH_UNIQUE))
     {
       res= 0; /* duplicate found */
@@ -209,7 +226,7 @@ static int ldelete(LF_SLIST * volatile *head, CHARSET_INFO *cs, uint32 hashnr,
 
   for (;;)
   {
-    if (!lfind(head, cs, hashnr, key, keylen, &cursor, pins))
+    if (!lfind(head, cs, hashnr, key, keylen, &cursor, pins, 0, 0))
     {
       res= 1; /* not found */
       break;
@@ -233,7 +250,7 @@ static int ldelete(LF_SLIST * volatile *head, CHARSET_INFO *cs, uint32 hashnr,
             (to ensure the number of "set DELETED flag" actions
             is equal to the number of "remove from the list" actions)
           */
-          lfind(head, cs, hashnr, key, keylen, &cursor, pins);
+          lfind(head, cs, hashnr, key, keylen, &cursor, pins, 0, 0);
         }
         res= 0;
         break;
@@ -264,7 +281,7 @@ static LF_SLIST *lsearch(LF_SLIST * volatile *head, CHARSET_INFO *cs,
                          LF_PINS *pins)
 {
   CURSOR cursor;
-  int res= lfind(head, cs, hashnr, key, keylen, &cursor, pins);
+  int res= lfind(head, cs, hashnr, key, keylen, &cursor, pins, 0, 0);
   if (res)
     _lf_pin(pins, 2, cursor.curr);
   _lf_unpin(pins, 0);
@@ -290,12 +307,14 @@ static inline const uchar* hash_key(const LF_HASH *hash,
 static inline uint calc_hash(LF_HASH *hash, const uchar *key, uint keylen)
 {
   ulong nr1= 1, nr2= 4;
+  if (hash->flags & LF_HASH_BINARY)
+    return (uint) my_hash_bytes(key, keylen, 0) & INT_MAX32;
   hash->charset->coll->hash_sort(hash->charset, (uchar*) key, keylen,
                                  &nr1, &nr2);
   return nr1 & INT_MAX32;
 }
 
-#define MAX_LOAD 1.0    /* average number of elements in a bucket */
+#define MAX_LOAD 1.0    /* default LF_HASH::max_load */
 
 static int initialize_bucket(LF_HASH *, LF_SLIST * volatile*, uint, LF_PINS *);
 
@@ -311,6 +330,15 @@ static int initialize_bucket(LF_HASH *, LF_SLIST * volatile*, uint, LF_PINS *);
   DYNAMIC_ARRAY. In this case they should be initialize in the
   LF_ALLOCATOR::constructor, and lf_hash_insert should not overwrite them.
   See wt_init() for example.
+
+  LF_HASH::max_load can be changed after lf_hash_init too. The number
+  of buckets is doubled when there are more elements per bucket than
+  that on average, and halved when there are less than a quarter of it.
+
+  With LF_HASH_EPOCHS deleted elements are reclaimed by epochs, see
+  lf_alloc-pin.c: searches do not pin every node they pass. The API is
+  the same, but an element returned by lf_hash_search() holds back all
+  reclamation until lf_hash_search_unpin().
 */
 void lf_hash_init(LF_HASH *hash, uint element_size, uint flags,
                   uint key_offset, uint key_length, my_hash_get_key get_key,
@@ -319,11 +347,15 @@ void lf_hash_init(LF_HASH *hash, uint element_size, uint flags,
   lf_alloc_init(&hash->alloc, sizeof(LF_SLIST)+element_size,
                 offsetof(LF_SLIST, key));
   lf_dynarray_init(&hash->array, sizeof(LF_SLIST *));
+  if (flags & LF_HASH_EPOCHS)
+    lf_alloc_use_epochs(&hash->alloc);
   hash->size= 1;
   hash->count= 0;
+  hash->max_load= MAX_LOAD;
   hash->element_size= element_size;
-  hash->flags= flags;
   hash->charset= charset ? charset : &my_charset_bin;
+  hash->flags= my_binary_compare(hash->charset) ? flags :
+               flags & ~LF_HASH_BINARY;
   hash->key_offset= key_offset;
   hash->key_length= key_length;
   hash->get_key= get_key;
@@ -334,9 +366,8 @@ void lf_hash_destroy(LF_HASH *hash)
 {
   LF_SLIST *el, **head= (LF_SLIST **)_lf_dynarray_value(&hash->array, 0);
 
-  if (unlikely(!head))
-    return;
-  el= *head;
+  /* the allocator and the array are there even if bucket 0 is not */
+  el= head ? *head : 0;
 
   while (el)
   {
@@ -370,30 +401,37 @@ int lf_hash_insert(LF_HASH *hash, LF_PINS *pins, const void *data)
   LF_SLIST *node, * volatile *el;
 
   lf_rwlock_by_pins(pins);
+  _lf_epoch_enter(pins);
   node= (LF_SLIST *)_lf_alloc_new(pins);
   if (unlikely(!node))
-    return -1;
+    goto err;
   memcpy(node+1, data, hash->element_size);
   node->key= hash_key(hash, (uchar *)(node+1), &node->keylen);
   hashnr= calc_hash(hash, node->key, node->keylen);
   bucket= hashnr % hash->size;
   el= _lf_dynarray_lvalue(&hash->array, bucket);
   if (unlikely(!el))
-    return -1;
+    goto err;
   if (*el == NULL && unlikely(initialize_bucket(hash, el, bucket, pins)))
-    return -1;
+    goto err;
   node->hashnr= my_reverse_bits(hashnr) | 1; /* normal node */
   if (linsert(el, hash->charset, node, pins, hash->flags))
   {
     _lf_alloc_free(pins, node);
+    _lf_epoch_leave(pins);
     lf_rwunlock_by_pins(pins);
     return 1;
   }
   csize= hash->size;
-  if ((my_atomic_add32(&hash->count, 1)+1.0) / csize > MAX_LOAD)
+  if ((my_atomic_add32(&hash->count, 1)+1.0) / csize > hash->max_load)
     my_atomic_cas32(&hash->size, &csize, csize*2);
+  _lf_epoch_leave(pins);
   lf_rwunlock_by_pins(pins);
   return 0;
+err:
+  _lf_epoch_leave(pins);
+  lf_rwunlock_by_pins(pins);
+  return -1;
 }
 
 /*
@@ -412,12 +450,14 @@ int lf_hash_delete(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen)
 {
   LF_SLIST * volatile *el;
   uint bucket, hashnr= calc_hash(hash, (uchar *)key, keylen);
+  int csize;
 
   bucket= hashnr % hash->size;
   lf_rwlock_by_pins(pins);
+  _lf_epoch_enter(pins);
   el= _lf_dynarray_lvalue(&hash->array, bucket);
   if (unlikely(!el))
-    return -1;
+    goto err;
   /*
     note that we still need to initialize_bucket here,
     we cannot return "node not found", because an old bucket of that
@@ -425,16 +465,30 @@ int lf_hash_delete(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen)
     that was never accessed before and thus is not initialized.
   */
   if (*el == NULL && unlikely(initialize_bucket(hash, el, bucket, pins)))
-    return -1;
+    goto err;
   if (ldelete(el, hash->charset, my_reverse_bits(hashnr) | 1,
               (uchar *)key, keylen, pins))
   {
+    _lf_epoch_leave(pins);
     lf_rwunlock_by_pins(pins);
     return 1;
   }
-  my_atomic_add32(&hash->count, -1);
+  /*
+    Shrinking only drops the upper buckets: their dummy nodes stay in the
+    list, as other threads may still start a search from them. The nodes
+    are used again when the hash grows.
+  */
+  csize= hash->size;
+  if ((my_atomic_add32(&hash->count, -1)-1.0) / csize < hash->max_load / 4 &&
+      csize > 1)
+    my_atomic_cas32(&hash->size, &csize, csize/2);
+  _lf_epoch_leave(pins);
   lf_rwunlock_by_pins(pins);
   return 0;
+err:
+  _lf_epoch_leave(pins);
+  lf_rwunlock_by_pins(pins);
+  return -1;
 }
 
 /*
@@ -445,7 +499,11 @@ int lf_hash_delete(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen)
     MY_ERRPTR    if OOM
 
   NOTE
-    see lsearch() for pin usage notes
+    see lsearch() for pin usage notes. with LF_HASH_EPOCHS a found
+    element is kept in a critical section instead of pinned, either way
+    lf_hash_search_unpin() releases it. like pin 2 there is one such
+    hold per LF_PINS: the next search replaces it, and an unpin without
+    a found element does nothing
 */
 void *lf_hash_search(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen)
 {
@@ -454,17 +512,193 @@ void *lf_hash_search(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen)
 
   bucket= hashnr % hash->size;
   lf_rwlock_by_pins(pins);
+  _lf_epoch_enter(pins);
   el= _lf_dynarray_lvalue(&hash->array, bucket);
-  if (unlikely(!el))
-    return MY_ERRPTR;
-  if (*el == NULL && unlikely(initialize_bucket(hash, el, bucket, pins)))
+  if (unlikely(!el) ||
+      (*el == NULL && unlikely(initialize_bucket(hash, el, bucket, pins))))
+  {
+    _lf_epoch_leave(pins);
+    lf_rwunlock_by_pins(pins);
     return MY_ERRPTR;
+  }
   found= lsearch(el, hash->charset, my_reverse_bits(hashnr) | 1,
                  (uchar *)key, keylen, pins);
+  if (pins->search_epoch)
+  {
+    pins->search_epoch= 0;
+    _lf_epoch_leave(pins);
+  }
+  if (!found)
+    _lf_epoch_leave(pins);
+  else if (pins->epoch_depth)
+    pins->search_epoch= 1;
   lf_rwunlock_by_pins(pins);
   return found ? found+1 : 0;
 }
 
+/*
+  DESCRIPTION
+    calls 'walk' for every node of the hash, in list order, until
+    it returns non-zero
+
+  RETURN
+    0 - all nodes visited
+    1 - 'walk' returned non-zero
+   -1 - out of memory
+
+  NOTE
+    nodes inserted or deleted by other threads meanwhile may or may not
+    be visited. when a concurrent change makes lfind() retry, it starts
+    again from the head of the list, so the nodes before that point are
+    passed to 'walk' again. the node passed to 'walk' is pinned,
+    pins[0..2] are used and are removed on return
+*/
+static int lwalk(LF_HASH *hash, LF_PINS *pins, lf_walk_func walk, void *arg)
+{
+  LF_SLIST * volatile *el;
+  CURSOR cursor;
+  int res;
+
+  lf_rwlock_by_pins(pins);
+  _lf_epoch_enter(pins);
+  el= _lf_dynarray_lvalue(&hash->array, 0);
+  if (unlikely(!el) ||
+      (*el == NULL && unlikely(initialize_bucket(hash, el, 0, pins))))
+  {
+    _lf_epoch_leave(pins);
+    lf_rwunlock_by_pins(pins);
+    return -1;
+  }
+  res= lfind(el, hash->charset, 0, 0, 0, &cursor, pins, walk, arg);
+  _lf_unpin(pins, 0);
+  _lf_unpin(pins, 1);
+  _lf_unpin(pins, 2);
+  _lf_epoch_leave(pins);
+  lf_rwunlock_by_pins(pins);
+  return res;
+}
+
+struct st_iterate_arg {
+  my_hash_walk_action action;
+  void *argument;
+};
+
+static int iterate_node(LF_SLIST *node, struct st_iterate_arg *arg)
+{
+  if (!(node->hashnr & 1))
+    return 0; /* dummy node */
+  return (*arg->action)(node+1, arg->argument);
+}
+
+/*
+  DESCRIPTION
+    calls 'action' with every element of the hash and 'argument', like
+    my_hash_iterate(). the elements come in the order of the reversed
+    hash numbers. without concurrent changes every element is seen once,
+    with them an element can be seen more than once, see lwalk()
+
+  RETURN
+    0 - ok
+    1 - the iteration was aborted because 'action' returned 1
+   -1 - out of memory
+
+  NOTE
+    see lwalk() for concurrent changes and pin usage.
+    'action' must not use the same pins.
+*/
+int lf_hash_iterate(LF_HASH *hash, LF_PINS *pins, my_hash_walk_action action,
+                    void *argument)
+{
+  struct st_iterate_arg arg;
+  arg.action= action;
+  arg.argument= argument;
+  return lwalk(hash, pins, (lf_walk_func)iterate_node, &arg);
+}
+
+struct st_stats_arg {
+  LF_HASH_STATS *stats;
+  uint32 chain;
+};
+
+static void add_chain(struct st_stats_arg *arg)
+{
+  LF_HASH_STATS *stats= arg->stats;
+  stats->buckets++;
+  stats->chains[min(arg->chain, LF_HASH_CHAIN_LENGTHS-1)]++;
+  set_if_bigger(stats->max_chain, arg->chain);
+  arg->chain= 0;
+}
+
+/*
+  a dummy node starts the chain of its bucket, unless the bucket was
+  dropped when the hash shrank. the first node is the dummy of bucket 0,
+  and is seen again only when lwalk() restarts: what was counted before
+  is dropped then, so that nothing is counted twice
+*/
+static int stats_node(LF_SLIST *node, struct st_stats_arg *arg)
+{
+  LF_HASH_STATS *stats= arg->stats;
+  if (node->hashnr & 1)
+    arg->chain++;
+  else
+  {
+    if (!node->hashnr)
+    {
+      stats->buckets= stats->dummies= stats->max_chain= 0;
+      bzero(stats->chains, sizeof(stats->chains));
+      arg->chain= 0;
+    }
+    else if (my_reverse_bits(node->hashnr) < stats->size)
+      add_chain(arg);
+    stats->dummies++;
+  }
+  return 0;
+}
+
+/*
+  DESCRIPTION
+    fills 'stats' with the chain lengths of the buckets, the number of
+    elements deleted but not yet freed and the pin usage.
+    a chain is made of the elements between the dummy node of a bucket
+    and the next one, it is what a search walks through. buckets that
+    were not used yet share the chain of their parent bucket
+
+  RETURN
+    0 - ok
+   -1 - out of memory
+
+  NOTE
+    the list is walked like in lf_hash_iterate(), but a restarted walk
+    starts counting again, so chains are not counted twice. the counters
+    of the other threads are read without synchronization: with
+    concurrent changes the statistics are approximate
+*/
+int lf_hash_get_stats(LF_HASH *hash, LF_PINS *pins, LF_HASH_STATS *stats)
+{
+  LF_PINBOX *pinbox= &hash->alloc.pinbox;
+  struct st_stats_arg arg;
+  uint32 i;
+
+  bzero(stats, sizeof(*stats));
+  stats->size= hash->size;
+  stats->count= hash->count;
+  arg.stats= stats;
+  arg.chain= 0;
+  if (lwalk(hash, pins, (lf_walk_func)stats_node, &arg) < 0)
+    return -1;
+  add_chain(&arg);
+
+  stats->pins= pinbox->pins_in_array;
+  for (i= 1; i <= stats->pins; i++)
+  {
+    LF_PINS *el= (LF_PINS *)_lf_dynarray_value(&pinbox->pinarray, i);
+    if (el)
+      stats->purgatory+= el->purgatory_count + el->limbo_count;
+  }
+  stats->pin_retries= pinbox->pin_retries;
+  return 0;
+}
+
 static const uchar *dummy_key= (uchar*)"";
 
 /*
@@ -0,0 +1,307 @@
+/* Copyright (C) 2026 MySQL Connector/C contributors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*
+  bounded multi-producer multi-consumer FIFO queue
+
+  The queue is a ring of cells, the number of cells is a power of 2.
+  Every cell has a sequence number next to the element (the algorithm
+  is Dmitry Vyukov's). Pushing to position POS:
+
+   1. wait until the sequence number of the cell is POS
+   2. claim POS by a CAS of push_pos from POS to POS+1
+   3. copy the element to the cell
+   4. set the sequence number to POS+1
+
+  and popping from position POS:
+
+   1. wait until the sequence number of the cell is POS+1
+   2. claim POS by a CAS of pop_pos from POS to POS+1
+   3. copy the element from the cell
+   4. set the sequence number to POS+number of cells, which is the
+      next position that will push to this cell
+
+  "wait" here means "fail": when the sequence number of the cell is
+  behind, the queue is full (push) or empty (pop). The only shared
+  writes are one CAS and one store per operation, pushers and poppers
+  use different cache lines, and a pusher and a popper touch the same
+  cell only when the queue is nearly full or empty.
+
+  Positions and sequence numbers are 32 bit and compared modulo 2^32.
+
+  Waiting:
+
+  lf_queue_push_wait() and lf_queue_pop_wait() block when the queue is
+  full or empty. A blocked thread increments the number of waiters, reads
+  the event counter, tries once more, and sleeps on the event counter
+  (a futex, or a condition on other systems) unless it has changed.
+  Every push or pop looks at the number of waiters of the other side
+  after it is done, and if there are any, increments the event counter
+  and wakes one. Both sides write first and read second, with a memory
+  barrier in between, so either the waiter sees the change in its last
+  try, or the other thread sees the waiter.
+
+  Only a waiter changes its own registration: it decrements the number
+  of waiters when its last try succeeds or when it wakes up, whoever
+  woke it. So the count is never below the number of sleeping threads.
+  It can be above it while a woken thread has not run yet, which only
+  makes the next push or pop wake another sleeper, if there is one.
+  Pushes and pops that have no one to wake up cost nothing extra.
+*/
+
+#include <my_global.h>
+#include <m_string.h>
+#include <my_sys.h>
+#include <my_bit.h>
+#include <lf.h>
+
+#ifdef HAVE_LINUX_FUTEX_H
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#define CELL_DATA       ALIGN_SIZE(sizeof(uint32))
+#define CELL(Q, POS)    ((Q)->cells + ((POS) & (Q)->mask) * (Q)->cell_size)
+#define CELL_SEQ(C)     (*(uint32 volatile *)(C))
+
+/*
+  initialize a queue
+
+  SYNOPSYS
+    queue               -
+    element_size        size of an element, elements are copied in and out
+    max_elements        capacity, rounded up to a power of 2
+
+  RETURN
+    0 - ok
+    1 - out of memory
+*/
+my_bool lf_queue_init(LF_QUEUE *queue, uint element_size, uint max_elements)
+{
+  uint32 i, cells= my_round_up_to_next_power(max(max_elements, 2));
+  DBUG_ENTER("lf_queue_init");
+
+  queue->element_size= element_size;
+  queue->cell_size= ALIGN_SIZE(CELL_DATA + element_size);
+  queue->mask= cells - 1;
+  if (!(queue->cells= (uchar*) my_malloc(cells * queue->cell_size,
+                                         MYF(MY_WME))))
+    DBUG_RETURN(1);
+  for (i= 0; i < cells; i++)
+    CELL_SEQ(CELL(queue, i))= i;
+  queue->push_pos= queue->pop_pos= 0;
+  queue->push_waiters= queue->pop_waiters= 0;
+  queue->push_event= queue->pop_event= 0;
+  my_atomic_rwlock_init(&queue->lock);
+#ifndef HAVE_LINUX_FUTEX_H
+  pthread_mutex_init(&queue->mutex, MY_MUTEX_INIT_FAST);
+  pthread_cond_init(&queue->cond, 0);
+#endif
+  DBUG_RETURN(0);
+}
+
+/*
+  destroy the queue, the elements still in it are dropped
+
+  NOTE
+    not thread safe, no thread may use or wait on the queue
+*/
+void lf_queue_destroy(LF_QUEUE *queue)
+{
+  my_free(queue->cells, MYF(MY_ALLOW_ZERO_PTR));
+  queue->cells= 0;
+  my_atomic_rwlock_destroy(&queue->lock);
+#ifndef HAVE_LINUX_FUTEX_H
+  pthread_mutex_destroy(&queue->mutex);
+  pthread_cond_destroy(&queue->cond);
+#endif
+}
+
+/* register a waiter, return the event counter to wait on */
+static uint32 add_waiter(LF_QUEUE *queue, uint32 volatile *waiters,
+                         uint32 volatile *event)
+{
+  uint32 seen;
+  my_atomic_rwlock_wrlock(&queue->lock);
+  my_atomic_add32((int32 volatile*) waiters, 1);
+  seen= my_atomic_load32((int32 volatile*) event);
+  my_atomic_rwlock_wrunlock(&queue->lock);
+  return seen;
+}
+
+static void remove_waiter(LF_QUEUE *queue, uint32 volatile *waiters)
+{
+  my_atomic_rwlock_wrlock(&queue->lock);
+  my_atomic_add32((int32 volatile*) waiters, -1);
+  my_atomic_rwlock_wrunlock(&queue->lock);
+}
+
+#ifdef HAVE_LINUX_FUTEX_H
+static void wait_for_event(LF_QUEUE *queue __attribute__((unused)),
+                           uint32 volatile *event, uint32 seen)
+{
+  syscall(SYS_futex, event, FUTEX_WAIT_PRIVATE, seen, NULL, NULL, 0);
+}
+
+static void signal_event(LF_QUEUE *queue, uint32 volatile *event)
+{
+  my_atomic_rwlock_wrlock(&queue->lock);
+  my_atomic_add32((int32 volatile*) event, 1);
+  my_atomic_rwlock_wrunlock(&queue->lock);
+  syscall(SYS_futex, event, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+#else
+static void wait_for_event(LF_QUEUE *queue, uint32 volatile *event,
+                           uint32 seen)
+{
+  pthread_mutex_lock(&queue->mutex);
+  while (*event == seen)
+    pthread_cond_wait(&queue->cond, &queue->mutex);
+  pthread_mutex_unlock(&queue->mutex);
+}
+
+/* both sides share the condition, so everybody is woken */
+static void signal_event(LF_QUEUE *queue, uint32 volatile *event)
+{
+  pthread_mutex_lock(&queue->mutex);
+  (*event)++;
+  pthread_cond_broadcast(&queue->cond);
+  pthread_mutex_unlock(&queue->mutex);
+}
+#endif
+
+/*
+  DESCRIPTION
+    copies the element to the tail of the queue
+
+  RETURN
+    0 - pushed
+    1 - didn't, the queue is full
+*/
+int lf_queue_push(LF_QUEUE *queue, const void *element)
+{
+  uint32 pos, seq;
+  uchar *cell;
+
+  my_atomic_rwlock_wrlock(&queue->lock);
+  pos= queue->push_pos;
+  for (;;)
+  {
+    cell= CELL(queue, pos);
+    seq= CELL_SEQ(cell);
+    if (seq == pos)
+    {
+      if (my_atomic_cas32((int32 volatile*) &queue->push_pos,
+                          (int32*) &pos, pos + 1))
+        break;
+    }
+    else if ((int32) (seq - pos) < 0)
+    {
+      my_atomic_rwlock_wrunlock(&queue->lock);
+      return 1;
+    }
+    else
+      pos= queue->push_pos;
+  }
+  memcpy(cell + CELL_DATA, element, queue->element_size);
+  my_atomic_store32((int32 volatile*) &CELL_SEQ(cell), pos + 1);
+  my_atomic_rwlock_wrunlock(&queue->lock);
+  if (queue->pop_waiters)
+    signal_event(queue, &queue->pop_event);
+  return 0;
+}
+
+/*
+  DESCRIPTION
+    copies the element at the head of the queue to 'element', and
+    removes it
+
+  RETURN
+    0 - popped
+    1 - didn't, the queue is empty
+*/
+int lf_queue_pop(LF_QUEUE *queue, void *element)
+{
+  uint32 pos, seq;
+  uchar *cell;
+
+  my_atomic_rwlock_wrlock(&queue->lock);
+  pos= queue->pop_pos;
+  for (;;)
+  {
+    cell= CELL(queue, pos);
+    seq= CELL_SEQ(cell);
+    if (seq == pos + 1)
+    {
+      if (my_atomic_cas32((int32 volatile*) &queue->pop_pos,
+                          (int32*) &pos, pos + 1))
+        break;
+    }
+    else if ((int32) (seq - (pos + 1)) < 0)
+    {
+      my_atomic_rwlock_wrunlock(&queue->lock);
+      return 1;
+    }
+    else
+      pos= queue->pop_pos;
+  }
+  memcpy(element, cell + CELL_DATA, queue->element_size);
+  my_atomic_store32((int32 volatile*) &CELL_SEQ(cell),
+                    pos + queue->mask + 1);
+  my_atomic_rwlock_wrunlock(&queue->lock);
+  if (queue->push_waiters)
+    signal_event(queue, &queue->push_event);
+  return 0;
+}
+
+/*
+  DESCRIPTION
+    like lf_queue_push(), but waits while the queue is full
+*/
+void lf_queue_push_wait(LF_QUEUE *queue, const void *element)
+{
+  while (lf_queue_push(queue, element))
+  {
+    uint32 seen= add_waiter(queue, &queue->push_waiters, &queue->push_event);
+    my_bool done= !lf_queue_push(queue, element);
+    if (!done)
+      wait_for_event(queue, &queue->push_event, seen);
+    remove_waiter(queue, &queue->push_waiters);
+    if (done)
+      break;
+  }
+}
+
+/*
+  DESCRIPTION
+    like lf_queue_pop(), but waits while the queue is empty
+
+  NOTE
+    there is no timeout, to stop the threads that wait here push an
+    element that tells them to
+*/
+void lf_queue_pop_wait(LF_QUEUE *queue, void *element)
+{
+  while (lf_queue_pop(queue, element))
+  {
+    uint32 seen= add_waiter(queue, &queue->pop_waiters, &queue->pop_event);
+    my_bool done= !lf_queue_pop(queue, element);
+    if (!done)
+      wait_for_event(queue, &queue->pop_event, seen);
+    remove_waiter(queue, &queue->pop_waiters);
+    if (done)
+      break;
+  }
+}
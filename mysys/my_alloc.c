@@ -21,6 +21,194 @@
 #undef EXTRA_DEBUG
 #define EXTRA_DEBUG
 
+/*
+  Limit, growth and huge page settings of a root, see
+  set_alloc_root_limit(), set_alloc_root_growth() and
+  set_alloc_root_huge_pages(). MEM_ROOT is part of the client ABI and has no
+  room for them, so they are kept in a record that is always the first
+  entry of the used list. Its size of 0 tells it apart from the blocks.
+  It lives until free_root() is called without MY_KEEP_PREALLOC.
+*/
+
+typedef struct st_root_control
+{
+  USED_MEM header;                      /* size is 0 */
+  size_t limit;                         /* 0 if no limit */
+  size_t allocated;                     /* Bytes in blocks of the root */
+  size_t next_block_size;               /* For a percentage growth */
+  size_t max_block_size;                /* 0 if no maximum */
+  uint growth;                          /* Percentage or LINEAR */
+  void (*limit_handler)(MEM_ROOT *, size_t, void *);
+  void *handler_arg;
+  ALLOC_ROOT_CACHE *cache;              /* Where freed blocks go, or 0 */
+  myf huge_pages;                       /* MY_HUGE_PAGES flags, or 0 */
+} ROOT_CONTROL;
+
+/*
+  Blocks freed by roots, for other roots to reuse instead of going
+  through malloc() and free() again. See create_alloc_root_cache().
+*/
+
+struct st_alloc_root_cache
+{
+  USED_MEM *blocks;                     /* Most recently freed first */
+  size_t max_size;
+  uint refs;                            /* Owner and attached roots */
+  ALLOC_ROOT_CACHE_STATS stats;
+#ifdef THREAD
+  pthread_mutex_t lock;
+#endif
+};
+
+#ifdef THREAD
+#define cache_lock(C)   pthread_mutex_lock(&(C)->lock)
+#define cache_unlock(C) pthread_mutex_unlock(&(C)->lock)
+#else
+#define cache_lock(C)
+#define cache_unlock(C)
+#endif
+
+
+/*
+  Take a block of at least min_size bytes from the cache, or 0 if it
+  has none. Blocks of max_size bytes or more are not taken, so that
+  a root within a limit stays within it.
+*/
+
+static USED_MEM *cache_get_block(ALLOC_ROOT_CACHE *cache, size_t min_size,
+                                 size_t max_size)
+{
+  USED_MEM *block, **prev;
+  cache_lock(cache);
+  for (prev= &cache->blocks; (block= *prev); prev= &block->next)
+  {
+    if (block->size >= min_size && block->size <= max_size)
+    {
+      *prev= block->next;
+      cache->stats.blocks--;
+      cache->stats.size-= block->size;
+      cache->stats.hits++;
+      break;
+    }
+  }
+  if (!block)
+    cache->stats.misses++;
+  cache_unlock(cache);
+  return block;
+}
+
+
+/* Free a block of a root, keeping it in the cache of the root if any */
+
+static void root_free_block(ROOT_CONTROL *ctl, USED_MEM *block)
+{
+  ALLOC_ROOT_CACHE *cache= ctl ? ctl->cache : 0;
+  if (cache)
+  {
+    cache_lock(cache);
+    if (cache->stats.size + block->size <= cache->max_size)
+    {
+      block->next= cache->blocks;
+      cache->blocks= block;
+      cache->stats.blocks++;
+      cache->stats.size+= block->size;
+      block= 0;
+    }
+    else
+      cache->stats.discarded++;
+    cache_unlock(cache);
+  }
+  my_free(block, MYF(MY_ALLOW_ZERO_PTR));
+}
+
+static inline ROOT_CONTROL *root_control(MEM_ROOT *root)
+{
+  return root->used && !root->used->size ? (ROOT_CONTROL*) root->used : 0;
+}
+
+/* Put a block on the used list, after the control record if any */
+
+static inline void root_add_used(MEM_ROOT *root, USED_MEM *block)
+{
+  USED_MEM **head= &root->used;
+  if (*head && !(*head)->size)
+    head= &(*head)->next;
+  block->next= *head;
+  *head= block;
+}
+
+
+/* Size of the next block the root allocates, for at least one object */
+
+static size_t root_next_block_size(MEM_ROOT *root, ROOT_CONTROL *ctl)
+{
+  size_t size;
+  if (!ctl || ctl->growth == ALLOC_ROOT_GROWTH_LINEAR)
+    size= root->block_size * (root->block_num >> 2);
+  else
+    size= ctl->next_block_size;
+  if (ctl && ctl->max_block_size && size > ctl->max_block_size)
+    size= ctl->max_block_size;
+  return size;
+}
+
+
+/*
+  Check a new block of get_size bytes against the limit of the root
+
+  RETURN
+    size of the block to allocate, possibly reduced to min_size to stay
+    within the limit, or 0 if even that is over the limit. The limit
+    handler is called in the latter case.
+*/
+
+static size_t root_check_limit(MEM_ROOT *root, ROOT_CONTROL *ctl,
+                               size_t get_size, size_t min_size)
+{
+  if (!ctl || !ctl->limit || ctl->allocated + get_size <= ctl->limit)
+    return get_size;
+  if (ctl->allocated + min_size <= ctl->limit)
+    return min_size;
+  if (ctl->limit_handler)
+    (*ctl->limit_handler)(root, min_size, ctl->handler_arg);
+  return 0;
+}
+
+
+/*
+  Round a new block up to whole huge pages if the root puts its blocks
+  on huge pages and has a huge page worth of memory with it. The header
+  of my_malloc() is in MALLOC_OVERHEAD. Blocks that would go over the
+  limit are not rounded.
+*/
+
+static size_t root_huge_block_size(ROOT_CONTROL *ctl, size_t size)
+{
+  size_t page= my_huge_page_size(), rounded;
+  if (ctl->allocated + size < page)
+    return size;
+  rounded= MY_ALIGN(size + MALLOC_OVERHEAD, page) - MALLOC_OVERHEAD;
+  if (ctl->limit && ctl->allocated + rounded > ctl->limit)
+    return size;
+  return rounded;
+}
+
+
+/* Account for a new block of the root */
+
+static inline void root_block_added(MEM_ROOT *root, ROOT_CONTROL *ctl,
+                                    size_t size)
+{
+  root->block_num++;
+  if (ctl)
+  {
+    ctl->allocated+= size;
+    if (ctl->growth != ALLOC_ROOT_GROWTH_LINEAR &&
+        (!ctl->max_block_size || ctl->next_block_size < ctl->max_block_size))
+      ctl->next_block_size+= ctl->next_block_size * ctl->growth / 100;
+  }
+}
+
 
 /*
   Initialize memory root
@@ -61,7 +249,7 @@ void init_alloc_root(MEM_ROOT *mem_root, size_t block_size,
   {
     if ((mem_root->free= mem_root->pre_alloc=
 	 (USED_MEM*) my_malloc(pre_alloc_size+ ALIGN_SIZE(sizeof(USED_MEM)),
-			       MYF(0))))
+			       MYF(MY_MEM_ROOT))))
     {
       mem_root->free->size= pre_alloc_size+ALIGN_SIZE(sizeof(USED_MEM));
       mem_root->free->left= pre_alloc_size;
@@ -93,9 +281,11 @@ void init_alloc_root(MEM_ROOT *mem_root, size_t block_size,
 void reset_root_defaults(MEM_ROOT *mem_root, size_t block_size,
                          size_t pre_alloc_size __attribute__((unused)))
 {
+  ROOT_CONTROL *ctl;
   DBUG_ASSERT(alloc_root_inited(mem_root));
 
   mem_root->block_size= block_size - ALLOC_ROOT_MIN_BLOCK_SIZE;
+  ctl= root_control(mem_root);
 #if !(defined(HAVE_purify) && defined(EXTRA_DEBUG))
   if (pre_alloc_size)
   {
@@ -120,18 +310,22 @@ void reset_root_defaults(MEM_ROOT *mem_root, size_t block_size,
         {
           /* remove block from the list and free it */
           *prev= mem->next;
-          my_free(mem, MYF(0));
+          if (ctl)
+            ctl->allocated-= mem->size;
+          root_free_block(ctl, mem);
         }
         else
           prev= &mem->next;
       }
       /* Allocate new prealloc block and add it to the end of free list */
-      if ((mem= (USED_MEM *) my_malloc(size, MYF(0))))
+      if ((mem= (USED_MEM *) my_malloc(size, MYF(MY_MEM_ROOT))))
       {
         mem->size= size; 
         mem->left= pre_alloc_size;
         mem->next= *prev;
         *prev= mem_root->pre_alloc= mem; 
+        if (ctl)
+          ctl->allocated+= size;
       }
       else
       {
@@ -145,38 +339,24 @@ void reset_root_defaults(MEM_ROOT *mem_root, size_t block_size,
 }
 
 
-void *alloc_root(MEM_ROOT *mem_root, size_t length)
-{
-#if defined(HAVE_purify) && defined(EXTRA_DEBUG)
-  reg1 USED_MEM *next;
-  DBUG_ENTER("alloc_root");
-  DBUG_PRINT("enter",("root: %p", mem_root));
+#if !(defined(HAVE_purify) && defined(EXTRA_DEBUG))
 
-  DBUG_ASSERT(alloc_root_inited(mem_root));
+/*
+  The part of alloc_root() that searches the free list and allocates
+  blocks. length is aligned already.
+*/
 
-  length+=ALIGN_SIZE(sizeof(USED_MEM));
-  if (!(next = (USED_MEM*) my_malloc(length,MYF(MY_WME | ME_FATALERROR))))
-  {
-    if (mem_root->error_handler)
-      (*mem_root->error_handler)();
-    DBUG_RETURN((uchar*) 0);			/* purecov: inspected */
-  }
-  next->next= mem_root->used;
-  next->size= length;
-  mem_root->used= next;
-  DBUG_PRINT("exit",("ptr: %p", (((char*) next)+
-                                           ALIGN_SIZE(sizeof(USED_MEM)))));
-  DBUG_RETURN((uchar*) (((char*) next)+ALIGN_SIZE(sizeof(USED_MEM))));
-#else
+static void *alloc_root_block(MEM_ROOT *mem_root, size_t length)
+{
   size_t get_size, block_size;
   uchar* point;
   reg1 USED_MEM *next= 0;
   reg2 USED_MEM **prev;
+  ROOT_CONTROL *ctl;
   DBUG_ENTER("alloc_root");
   DBUG_PRINT("enter",("root: %p", mem_root));
   DBUG_ASSERT(alloc_root_inited(mem_root));
 
-  length= ALIGN_SIZE(length);
   if ((*(prev= &mem_root->free)) != NULL)
   {
     if ((*prev)->left < length &&
@@ -185,8 +365,7 @@ void *alloc_root(MEM_ROOT *mem_root, size_t length)
     {
       next= *prev;
       *prev= next->next;			/* Remove block from list */
-      next->next= mem_root->used;
-      mem_root->used= next;
+      root_add_used(mem_root, next);
       mem_root->first_block_usage= 0;
     }
     for (next= *prev ; next && next->left < length ; next= next->next)
@@ -194,17 +373,31 @@ void *alloc_root(MEM_ROOT *mem_root, size_t length)
   }
   if (! next)
   {						/* Time to alloc new block */
-    block_size= mem_root->block_size * (mem_root->block_num >> 2);
+    ctl= root_control(mem_root);
+    block_size= root_next_block_size(mem_root, ctl);
     get_size= length+ALIGN_SIZE(sizeof(USED_MEM));
-    get_size= max(get_size, block_size);
+    if (!(get_size= root_check_limit(mem_root, ctl, max(get_size, block_size),
+                                     get_size)))
+      DBUG_RETURN((void*) 0);
+    if (ctl && ctl->huge_pages)
+      get_size= root_huge_block_size(ctl, get_size);
 
-    if (!(next = (USED_MEM*) my_malloc(get_size,MYF(MY_WME | ME_FATALERROR))))
+    if (ctl && ctl->cache &&
+        (next= cache_get_block(ctl->cache, get_size,
+                               ctl->limit ? ctl->limit - ctl->allocated :
+                                            ~(size_t) 0)))
+      get_size= next->size;
+    else if (!(next = (USED_MEM*) my_malloc(get_size,
+                                            MYF(MY_WME | ME_FATALERROR |
+                                                MY_MEM_ROOT |
+                                                (ctl ? ctl->huge_pages :
+                                                       0)))))
     {
       if (mem_root->error_handler)
 	(*mem_root->error_handler)();
       DBUG_RETURN((void*) 0);                      /* purecov: inspected */
     }
-    mem_root->block_num++;
+    root_block_added(mem_root, ctl, get_size);
     next->next= *prev;
     next->size= get_size;
     next->left= get_size-ALIGN_SIZE(sizeof(USED_MEM));
@@ -216,12 +409,74 @@ void *alloc_root(MEM_ROOT *mem_root, size_t length)
   if ((next->left-= length) < mem_root->min_malloc)
   {						/* Full block */
     *prev= next->next;				/* Remove block from list */
-    next->next= mem_root->used;
-    mem_root->used= next;
+    root_add_used(mem_root, next);
     mem_root->first_block_usage= 0;
   }
   DBUG_PRINT("exit",("ptr: %p", point));
   DBUG_RETURN((void*) point);
+}
+#endif
+
+
+/*
+  Allocate memory from a memory root
+
+  SYNOPSIS
+    alloc_root()
+      mem_root       - memory root to allocate from
+      length         - number of bytes
+
+  DESCRIPTION
+    As long as the first block of the free list has room, the object is
+    cut from it without any further work; alloc_root_inline() in my_sys.h
+    does the same inline. Otherwise the free list is searched and a new
+    block is allocated if needed, within the limit of the root if it has
+    one.
+
+  RETURN
+    pointer to the memory or 0 if out of memory or over the limit
+*/
+
+void *alloc_root(MEM_ROOT *mem_root, size_t length)
+{
+#if defined(HAVE_purify) && defined(EXTRA_DEBUG)
+  reg1 USED_MEM *next;
+  ROOT_CONTROL *ctl;
+  DBUG_ENTER("alloc_root");
+  DBUG_PRINT("enter",("root: %p", mem_root));
+
+  DBUG_ASSERT(alloc_root_inited(mem_root));
+
+  length+=ALIGN_SIZE(sizeof(USED_MEM));
+  ctl= root_control(mem_root);
+  if (!root_check_limit(mem_root, ctl, length, length))
+    DBUG_RETURN((uchar*) 0);
+  if (!(next = (USED_MEM*) my_malloc(length,MYF(MY_WME | ME_FATALERROR |
+                                                 MY_MEM_ROOT))))
+  {
+    if (mem_root->error_handler)
+      (*mem_root->error_handler)();
+    DBUG_RETURN((uchar*) 0);			/* purecov: inspected */
+  }
+  next->size= length;
+  root_add_used(mem_root, next);
+  root_block_added(mem_root, ctl, length);
+  DBUG_PRINT("exit",("ptr: %p", (((char*) next)+
+                                           ALIGN_SIZE(sizeof(USED_MEM)))));
+  DBUG_RETURN((uchar*) (((char*) next)+ALIGN_SIZE(sizeof(USED_MEM))));
+#else
+  reg1 USED_MEM *next= mem_root->free;
+  uchar *point;
+
+  /* The common case, which leaves the lists as they are */
+  length= ALIGN_SIZE(length);
+  if (next && next->left >= length + mem_root->min_malloc)
+  {
+    point= (uchar*) next + (next->size - next->left);
+    next->left-= length;
+    return (void*) point;
+  }
+  return alloc_root_block(mem_root, length);
 #endif
 }
 
@@ -284,6 +539,7 @@ static inline void mark_blocks_free(MEM_ROOT* root)
 {
   reg1 USED_MEM *next;
   reg2 USED_MEM **last;
+  ROOT_CONTROL *ctl= root_control(root);
 
   /* iterate through (partially) free blocks, mark them free */
   last= &root->free;
@@ -293,8 +549,8 @@ static inline void mark_blocks_free(MEM_ROOT* root)
     TRASH_MEM(next);
   }
 
-  /* Combine the free and the used list */
-  *last= next=root->used;
+  /* Combine the free and the used list, except for the control record */
+  *last= next= ctl ? ctl->header.next : root->used;
 
   /* now go through the used blocks and mark them free */
   for (; next; next= next->next)
@@ -304,7 +560,9 @@ static inline void mark_blocks_free(MEM_ROOT* root)
   }
 
   /* Now everything is set; Indicate that nothing is used anymore */
-  root->used= 0;
+  if (ctl)
+    ctl->header.next= 0;
+  root->used= ctl ? &ctl->header : 0;
   root->first_block_usage= 0;
 }
 
@@ -320,9 +578,13 @@ static inline void mark_blocks_free(MEM_ROOT* root)
 
         MY_MARK_BLOCKS_FREED	Don't free blocks, just mark them free
         MY_KEEP_PREALLOC	If this is not set, then free also the
-        		        preallocated block
+        		        preallocated block and the limit, growth,
+        		        cache and huge page settings of the root
 
   NOTES
+    The blocks go to the cache of the root if it has one and there is
+    room in it.
+
     One can call this function either with root block initialised with
     init_alloc_root() or with a bzero()-ed block.
     It's also safe to call this multiple times with the same mem_root.
@@ -331,6 +593,7 @@ static inline void mark_blocks_free(MEM_ROOT* root)
 void free_root(MEM_ROOT *root, myf MyFlags)
 {
   reg1 USED_MEM *next,*old;
+  ROOT_CONTROL *ctl= root_control(root);
   DBUG_ENTER("free_root");
   DBUG_PRINT("enter",("root: %p  flags: %u", root, (uint) MyFlags));
 
@@ -342,17 +605,24 @@ void free_root(MEM_ROOT *root, myf MyFlags)
   if (!(MyFlags & MY_KEEP_PREALLOC))
     root->pre_alloc=0;
 
-  for (next=root->used; next ;)
+  for (next= ctl ? ctl->header.next : root->used; next ;)
   {
     old=next; next= next->next ;
     if (old != root->pre_alloc)
-      my_free(old,MYF(0));
+      root_free_block(ctl, old);
   }
   for (next=root->free ; next ;)
   {
     old=next; next= next->next;
     if (old != root->pre_alloc)
-      my_free(old,MYF(0));
+      root_free_block(ctl, old);
+  }
+  if (ctl && !(MyFlags & MY_KEEP_PREALLOC))
+  {
+    if (ctl->cache)
+      release_alloc_root_cache(ctl->cache);
+    my_free(ctl, MYF(0));
+    ctl= 0;
   }
   root->used=root->free=0;
   if (root->pre_alloc)
@@ -362,11 +632,373 @@ void free_root(MEM_ROOT *root, myf MyFlags)
     TRASH_MEM(root->pre_alloc);
     root->free->next=0;
   }
+  if (ctl)
+  {
+    ctl->header.next= 0;
+    ctl->allocated= root->pre_alloc ? root->pre_alloc->size : 0;
+    ctl->next_block_size= root->block_size;
+    root->used= &ctl->header;
+  }
   root->block_num= 4;
   root->first_block_usage= 0;
   DBUG_VOID_RETURN;
 }
 
+/*
+  Move all memory of one root to another
+
+  SYNOPSIS
+    move_root()
+      to		Memory root that takes over the blocks
+      from		Memory root to empty
+
+  NOTES
+    The blocks of 'from', including its preallocated block, are put on
+    the used list of 'to'. Everything allocated from 'from' stays valid
+    until 'to' is freed. 'from' is left empty, but can still be used.
+*/
+
+void move_root(MEM_ROOT *to, MEM_ROOT *from)
+{
+  USED_MEM *next, *block;
+  USED_MEM *lists[2];
+  ROOT_CONTROL *from_ctl= root_control(from), *to_ctl= root_control(to);
+  size_t moved= 0;
+  uint i;
+  DBUG_ENTER("move_root");
+
+  lists[0]= from_ctl ? from_ctl->header.next : from->used;
+  lists[1]= from->free;
+  for (i= 0; i < 2; i++)
+  {
+    for (next= lists[i]; next ;)
+    {
+      block= next; next= next->next;
+      moved+= block->size;
+      root_add_used(to, block);
+    }
+  }
+  from->used= from->free= from->pre_alloc= 0;
+  from->first_block_usage= 0;
+  if (from_ctl)
+  {
+    from_ctl->header.next= 0;
+    from_ctl->allocated= 0;
+    from->used= &from_ctl->header;
+  }
+  if (to_ctl)
+    to_ctl->allocated+= moved;
+  DBUG_VOID_RETURN;
+}
+
+/* Get the control record of a root, creating it if needed */
+
+static ROOT_CONTROL *get_root_control(MEM_ROOT *root)
+{
+  ROOT_CONTROL *ctl;
+  USED_MEM *next;
+  USED_MEM *lists[2];
+  uint i;
+
+  if ((ctl= root_control(root)))
+    return ctl;
+  if (!(ctl= (ROOT_CONTROL*) my_malloc(sizeof(ROOT_CONTROL),
+                                       MYF(MY_WME | MY_ZEROFILL |
+                                           MY_MEM_ROOT))))
+    return 0;
+  ctl->growth= ALLOC_ROOT_GROWTH_LINEAR;
+  ctl->next_block_size= root->block_size;
+  lists[0]= root->used;
+  lists[1]= root->free;
+  for (i= 0; i < 2; i++)
+    for (next= lists[i]; next; next= next->next)
+      ctl->allocated+= next->size;
+  ctl->header.next= root->used;
+  root->used= &ctl->header;
+  return ctl;
+}
+
+
+/*
+  Set a limit on the memory of a root
+
+  SYNOPSIS
+    set_alloc_root_limit()
+      root           - memory root
+      limit          - maximum number of bytes in the blocks of the root,
+                       0 for no limit
+      handler        - if not 0, called with the root, the size of the
+                       block that was refused and handler_arg when an
+                       allocation fails because of the limit
+      handler_arg    - argument for handler
+
+  DESCRIPTION
+    An allocation that would take the blocks of the root over the limit
+    fails as if the memory was exhausted, but without the error handler
+    of the root being called. Blocks that are already allocated are not
+    affected if the limit is lowered below them. The limit is kept by
+    free_root() with MY_KEEP_PREALLOC or MY_MARK_BLOCKS_FREE.
+
+    The root must not be cleared with clear_alloc_root() afterwards, as
+    the memory used for the limit would be lost.
+
+  RETURN
+    0   ok
+    1   out of memory
+*/
+
+my_bool set_alloc_root_limit(MEM_ROOT *root, size_t limit,
+                             void (*handler)(MEM_ROOT *, size_t, void *),
+                             void *handler_arg)
+{
+  ROOT_CONTROL *ctl;
+  DBUG_ENTER("set_alloc_root_limit");
+  DBUG_PRINT("enter",("root: %p  limit: %lu", root, (ulong) limit));
+
+  if (!limit && !handler && !root_control(root))
+    DBUG_RETURN(0);                             /* Nothing to remember */
+  if (!(ctl= get_root_control(root)))
+    DBUG_RETURN(1);
+  ctl->limit= limit;
+  ctl->limit_handler= handler;
+  ctl->handler_arg= handler_arg;
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Set how the blocks of a root grow
+
+  SYNOPSIS
+    set_alloc_root_growth()
+      root           - memory root
+      growth         - percentage by which each block is larger than the
+                       one before, or ALLOC_ROOT_GROWTH_LINEAR to grow by
+                       a quarter of the block size of the root per block
+                       (the default)
+      max_block_size - the size blocks stop growing at, 0 for no maximum
+
+  NOTES
+    Objects larger than the blocks still get a block of their own. With
+    a percentage the blocks start from the block size of the root again
+    after free_root().
+
+  RETURN
+    0   ok
+    1   out of memory
+*/
+
+my_bool set_alloc_root_growth(MEM_ROOT *root, uint growth,
+                              size_t max_block_size)
+{
+  ROOT_CONTROL *ctl;
+  DBUG_ENTER("set_alloc_root_growth");
+
+  if (!(ctl= get_root_control(root)))
+    DBUG_RETURN(1);
+  if (ctl->growth != growth)
+    ctl->next_block_size= root->block_size;
+  ctl->growth= growth;
+  ctl->max_block_size= max_block_size;
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Put the blocks of a root on huge pages once it is large
+
+  SYNOPSIS
+    set_alloc_root_huge_pages()
+      root           - memory root
+      flags          - MY_HUGE_PAGES, with MY_HUGE_PAGES_RESERVED to try
+                       the reserved huge pages first, or 0 to stop
+
+  DESCRIPTION
+    Once the root has a huge page worth of memory, its new blocks are
+    whole huge pages, which my_malloc() maps on huge pages. Going through
+    a large root then takes far fewer TLB misses. Where huge pages can't
+    be had the blocks are on normal pages or from malloc() as before.
+
+  RETURN
+    0   ok
+    1   out of memory
+*/
+
+my_bool set_alloc_root_huge_pages(MEM_ROOT *root, myf flags)
+{
+  ROOT_CONTROL *ctl;
+  DBUG_ENTER("set_alloc_root_huge_pages");
+
+  if (!flags && !root_control(root))
+    DBUG_RETURN(0);                             /* Nothing to remember */
+  if (!(ctl= get_root_control(root)))
+    DBUG_RETURN(1);
+  ctl->huge_pages= flags & (MY_HUGE_PAGES | MY_HUGE_PAGES_RESERVED);
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Number of bytes in the blocks of a root, including the ones
+  free_root() with MY_MARK_BLOCKS_FREE has made free again
+*/
+
+size_t alloc_root_allocated(MEM_ROOT *root)
+{
+  ROOT_CONTROL *ctl;
+  USED_MEM *next;
+  size_t size= 0;
+
+  if ((ctl= root_control(root)))
+    return ctl->allocated;
+  for (next= root->used; next; next= next->next)
+    size+= next->size;
+  for (next= root->free; next; next= next->next)
+    size+= next->size;
+  return size;
+}
+
+
+/*
+  Create a cache for the blocks of memory roots
+
+  SYNOPSIS
+    create_alloc_root_cache()
+      max_size       - maximum number of bytes in the cached blocks
+
+  DESCRIPTION
+    Roots attached to the cache with set_alloc_root_cache() put the
+    blocks free_root() frees in it while there is room, and take their
+    new blocks from it. This saves the malloc() and free() of the
+    blocks of a root that is filled and freed again and again, as the
+    root of a result set is. The cache may be used by roots in
+    different threads.
+
+    The cache is freed when release_alloc_root_cache() has been called
+    and no root is attached to it any more.
+
+  RETURN
+    the cache or 0 if out of memory
+*/
+
+ALLOC_ROOT_CACHE *create_alloc_root_cache(size_t max_size)
+{
+  ALLOC_ROOT_CACHE *cache;
+  DBUG_ENTER("create_alloc_root_cache");
+
+  if (!(cache= (ALLOC_ROOT_CACHE*) my_malloc(sizeof(ALLOC_ROOT_CACHE),
+                                             MYF(MY_WME | MY_ZEROFILL |
+                                                 MY_MEM_ROOT))))
+    DBUG_RETURN(0);
+  cache->max_size= max_size;
+  cache->refs= 1;
+#ifdef THREAD
+  pthread_mutex_init(&cache->lock, MY_MUTEX_INIT_FAST);
+#endif
+  DBUG_RETURN(cache);
+}
+
+
+/* Drop a reference to a cache, freeing it with the last one */
+
+void release_alloc_root_cache(ALLOC_ROOT_CACHE *cache)
+{
+  USED_MEM *block;
+  uint refs;
+
+  cache_lock(cache);
+  refs= --cache->refs;
+  cache_unlock(cache);
+  if (refs)
+    return;
+  while ((block= cache->blocks))
+  {
+    cache->blocks= block->next;
+    my_free(block, MYF(0));
+  }
+#ifdef THREAD
+  pthread_mutex_destroy(&cache->lock);
+#endif
+  my_free(cache, MYF(0));
+}
+
+
+/*
+  Change the maximum size of a cache, freeing the most recently cached
+  blocks that are over it.
+*/
+
+void resize_alloc_root_cache(ALLOC_ROOT_CACHE *cache, size_t max_size)
+{
+  USED_MEM *block, *free_blocks= 0;
+
+  cache_lock(cache);
+  cache->max_size= max_size;
+  while (cache->stats.size > max_size)
+  {
+    block= cache->blocks;
+    cache->blocks= block->next;
+    cache->stats.blocks--;
+    cache->stats.size-= block->size;
+    cache->stats.discarded++;
+    block->next= free_blocks;
+    free_blocks= block;
+  }
+  cache_unlock(cache);
+  while ((block= free_blocks))
+  {
+    free_blocks= block->next;
+    my_free(block, MYF(0));
+  }
+}
+
+
+void get_alloc_root_cache_stats(ALLOC_ROOT_CACHE *cache,
+                                ALLOC_ROOT_CACHE_STATS *stats)
+{
+  cache_lock(cache);
+  *stats= cache->stats;
+  cache_unlock(cache);
+}
+
+
+/*
+  Attach a root to a block cache, or detach it with cache 0
+
+  NOTES
+    The root keeps a reference to the cache until it is freed with
+    free_root() without MY_KEEP_PREALLOC.
+
+  RETURN
+    0   ok
+    1   out of memory
+*/
+
+my_bool set_alloc_root_cache(MEM_ROOT *root, ALLOC_ROOT_CACHE *cache)
+{
+  ROOT_CONTROL *ctl;
+  DBUG_ENTER("set_alloc_root_cache");
+
+  if (!cache && !root_control(root))
+    DBUG_RETURN(0);
+  if (!(ctl= get_root_control(root)))
+    DBUG_RETURN(1);
+  if (ctl->cache != cache)
+  {
+    if (cache)
+    {
+      cache_lock(cache);
+      cache->refs++;
+      cache_unlock(cache);
+    }
+    if (ctl->cache)
+      release_alloc_root_cache(ctl->cache);
+    ctl->cache= cache;
+  }
+  DBUG_RETURN(0);
+}
+
+
 /*
   Find block that contains an object and set the pre_alloc to it
 */
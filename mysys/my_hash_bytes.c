@@ -0,0 +1,135 @@
+/* Copyright (C) 2026 MySQL Connector/C contributors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*
+  Hash function for keys compared byte by byte
+
+  This is the wyhash function: the key is read 16 or 48 bytes at a time
+  and each pair of 64 bit words is folded with a 64x64->128 bit
+  multiplication.  It is much faster than the hash_sort() functions of
+  the binary collations and all its output bits are well distributed.
+*/
+
+#include "mysys_priv.h"
+#include <hash.h>
+
+static const ulonglong secret[4]=
+{
+  0xA0761D6478BD642FULL, 0xE7037ED1A0B428DBULL,
+  0x8EBC6AF09C88C6E3ULL, 0x589965CC75374CC3ULL
+};
+
+/* Replace a and b with the low and the high half of a * b */
+
+static inline void multiply(ulonglong *a, ulonglong *b)
+{
+#if defined(__GNUC__) && defined(__SIZEOF_INT128__)
+  unsigned __int128 r= (unsigned __int128) *a * *b;
+  *a= (ulonglong) r;
+  *b= (ulonglong) (r >> 64);
+#else
+  ulonglong ha= *a >> 32, hb= *b >> 32, la= (uint32) *a, lb= (uint32) *b;
+  ulonglong rh= ha * hb, rm0= ha * lb, rm1= hb * la, rl= la * lb;
+  ulonglong t= rl + (rm0 << 32), lo, carry= t < rl;
+  lo= t + (rm1 << 32);
+  carry+= lo < t;
+  *a= lo;
+  *b= rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+}
+
+static inline ulonglong mix(ulonglong a, ulonglong b)
+{
+  multiply(&a, &b);
+  return a ^ b;
+}
+
+/* 1 to 3 bytes, each of them used once or more */
+
+static inline ulonglong read_small(const uchar *key, size_t length)
+{
+  return (((ulonglong) key[0]) << 16) |
+         (((ulonglong) key[length >> 1]) << 8) | key[length - 1];
+}
+
+
+/*
+  Calculate the hash number of a key
+
+  SYNOPSIS
+    my_hash_bytes()
+    key      key to hash
+    length   length of key
+    seed     start value, different seeds give unrelated hash numbers
+
+  RETURN
+    64 bit hash number, any part of it can be used
+*/
+
+ulonglong my_hash_bytes(const uchar *key, size_t length, ulonglong seed)
+{
+  ulonglong a, b;
+
+  seed^= mix(seed ^ secret[0], secret[1]);
+  if (length <= 16)
+  {
+    if (length >= 4)
+    {
+      size_t middle= (length >> 3) << 2;
+      a= ((ulonglong) uint4korr(key) << 32) | uint4korr(key + middle);
+      b= ((ulonglong) uint4korr(key + length - 4) << 32) |
+         uint4korr(key + length - 4 - middle);
+    }
+    else if (length)
+    {
+      a= read_small(key, length);
+      b= 0;
+    }
+    else
+      a= b= 0;
+  }
+  else
+  {
+    size_t left= length;
+    if (left > 48)
+    {
+      ulonglong seed1= seed, seed2= seed;
+      do
+      {
+        seed= mix(uint8korr(key) ^ secret[1], uint8korr(key + 8) ^ seed);
+        seed1= mix(uint8korr(key + 16) ^ secret[2],
+                   uint8korr(key + 24) ^ seed1);
+        seed2= mix(uint8korr(key + 32) ^ secret[3],
+                   uint8korr(key + 40) ^ seed2);
+        key+= 48;
+        left-= 48;
+      } while (left > 48);
+      seed^= seed1 ^ seed2;
+    }
+    while (left > 16)
+    {
+      seed= mix(uint8korr(key) ^ secret[1], uint8korr(key + 8) ^ seed);
+      key+= 16;
+      left-= 16;
+    }
+    /* The last 16 bytes, overlapping the ones already used */
+    a= uint8korr(key + left - 16);
+    b= uint8korr(key + left - 8);
+  }
+  a^= secret[1];
+  b^= seed;
+  multiply(&a, &b);
+  return mix(a ^ secret[0] ^ length, b ^ secret[1]);
+}
@@ -14,6 +14,7 @@
    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
 
 #include "mysys_priv.h"
+#include <m_string.h>
 
 #ifdef HAVE_LARGE_PAGES
 
@@ -164,3 +165,154 @@ my_bool my_large_free_int(uchar *ptr, myf my_flags __attribute__((unused)))
 #endif /* HAVE_DECL_SHM_HUGETLB */
 
 #endif /* HAVE_LARGE_PAGES */
+
+
+/*
+  Blocks of my_malloc() with MY_HUGE_PAGES. They are mapped aligned on
+  a huge page and in whole huge pages, and marked with MADV_HUGEPAGE so
+  that Linux backs them with transparent huge pages where it can. With
+  reserved set, the huge pages reserved for MAP_HUGETLB are tried
+  first. Where huge pages are not available the pages are normal ones,
+  and where the block can't be mapped 0 is returned and my_malloc()
+  takes the block from its allocator instead.
+*/
+
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+#include <sys/mman.h>
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
+
+#define DEFAULT_HUGE_PAGE_SIZE (2*1024*1024L)
+
+static size_t huge_page_size= 0;
+
+/* Read a size in bytes, or in kB after key, from a file of the system */
+
+static size_t read_page_size(const char *file_name, const char *key)
+{
+  FILE *f;
+  char buf[256];
+  ulong size= 0;
+  size_t key_length= key ? strlen(key) : 0;
+
+  if (!(f= fopen(file_name, "r")))
+    return 0;
+  while (fgets(buf, sizeof(buf), f))
+  {
+    if (!key)
+    {
+      if (sscanf(buf, "%lu", &size) != 1)
+        size= 0;
+      break;
+    }
+    if (!strncmp(buf, key, key_length) &&
+        sscanf(buf + key_length, " %lu kB", &size) == 1)
+    {
+      size*= 1024;
+      break;
+    }
+  }
+  fclose(f);
+  return (size_t) size;
+}
+
+
+/*
+  Size of the huge pages of the system, or the usual 2M where it can't
+  be found out. Blocks of this size or more are put on huge pages.
+*/
+
+size_t my_huge_page_size(void)
+{
+  size_t size;
+  if (!(size= huge_page_size))
+  {
+#ifdef __linux__
+    if (!(size= read_page_size("/sys/kernel/mm/transparent_hugepage/"
+                               "hpage_pmd_size", 0)))
+      size= read_page_size("/proc/meminfo", "Hugepagesize:");
+#endif
+    if (!size || (size & (size - 1)))
+      size= DEFAULT_HUGE_PAGE_SIZE;
+    huge_page_size= size;
+  }
+  return size;
+}
+
+
+void *my_huge_page_malloc(size_t size __attribute__((unused)),
+                          my_bool reserved __attribute__((unused)))
+{
+#if defined(HAVE_MMAP) && defined(MAP_ANONYMOUS)
+  size_t page= my_huge_page_size(), length= MY_ALIGN(size, page), offset;
+  char *ptr;
+
+#ifdef MAP_HUGETLB
+  if (reserved &&
+      (ptr= (char*) mmap(0, length, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                         -1, 0)) != (char*) MAP_FAILED)
+    return ptr;
+#endif
+  /* Map a page more and unmap what is around the aligned block */
+  if ((ptr= (char*) mmap(0, length + page, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS,
+                         -1, 0)) == (char*) MAP_FAILED)
+    return 0;
+  offset= MY_ALIGN((size_t) ptr, page) - (size_t) ptr;
+  if (offset)
+    munmap(ptr, offset);
+  munmap(ptr + offset + length, page - offset);
+  ptr+= offset;
+#ifdef MADV_HUGEPAGE
+  /* Fails if transparent huge pages are not compiled in, which is ok */
+  madvise(ptr, length, MADV_HUGEPAGE);
+#endif
+  return ptr;
+#else
+  return 0;
+#endif
+}
+
+
+/*
+  Change the size of a block from my_huge_page_malloc(). The block is
+  moved if it grows beyond its huge pages.
+
+  RETURN
+    0      Out of memory, ptr is not changed
+    #      The block
+*/
+
+void *my_huge_page_realloc(void *ptr, size_t old_size, size_t size,
+                           my_bool reserved)
+{
+  size_t page= my_huge_page_size();
+  size_t old_length= MY_ALIGN(old_size, page), length= MY_ALIGN(size, page);
+  void *new_ptr;
+
+  if (length <= old_length)
+  {
+#if defined(HAVE_MMAP) && defined(MAP_ANONYMOUS)
+    if (length < old_length)
+      munmap((char*) ptr + length, old_length - length);
+#endif
+    return ptr;
+  }
+  if (!(new_ptr= my_huge_page_malloc(size, reserved)))
+    return 0;
+  memcpy(new_ptr, ptr, old_size);
+  my_huge_page_free(ptr, old_size);
+  return new_ptr;
+}
+
+
+void my_huge_page_free(void *ptr __attribute__((unused)),
+                       size_t size __attribute__((unused)))
+{
+#if defined(HAVE_MMAP) && defined(MAP_ANONYMOUS)
+  munmap(ptr, MY_ALIGN(size, my_huge_page_size()));
+#endif
+}
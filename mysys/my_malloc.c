@@ -21,10 +21,266 @@
 #include "mysys_err.h"
 #include <m_string.h>
 
+/*
+  Each block from my_malloc() starts with a header that tells its size,
+  its category and which allocator it came from. my_realloc() and
+  my_free() use the same allocator again, also after my_set_allocator()
+  installed another one, and keep the counters of the category right.
+*/
+
+typedef struct st_my_memory_header
+{
+  size_t size;
+  uint category;
+  uint allocator;
+} MY_MEMORY_HEADER;
+
+#define HEADER_SIZE ALIGN_SIZE(sizeof(MY_MEMORY_HEADER))
+#define USER_PTR(H) ((void*) ((char*) (H) + HEADER_SIZE))
+#define HEADER_PTR(P) ((MY_MEMORY_HEADER*) ((char*) (P) - HEADER_SIZE))
+
+#define MAX_ALLOCATORS 16
+
+static void *sys_malloc(void *context __attribute__((unused)), size_t size,
+                        uint category __attribute__((unused)))
+{
+  return malloc(size);
+}
+
+static void *sys_realloc(void *context __attribute__((unused)), void *ptr,
+                         size_t size, uint category __attribute__((unused)))
+{
+  return realloc(ptr, size);
+}
+
+static void sys_free(void *context __attribute__((unused)), void *ptr,
+                     size_t size __attribute__((unused)),
+                     uint category __attribute__((unused)))
+{
+  free(ptr);
+}
+
+/*
+  Blocks on huge pages, for MY_HUGE_PAGES. The context tells if the
+  reserved huge pages are tried first.
+*/
+
+static my_bool huge_pages_reserved[2]= { 0, 1 };
+
+static void *huge_malloc(void *context, size_t size,
+                         uint category __attribute__((unused)))
+{
+  return my_huge_page_malloc(size, *(my_bool*) context);
+}
+
+static void *huge_realloc(void *context, void *ptr, size_t size,
+                          uint category __attribute__((unused)))
+{
+  size_t old_size= ((MY_MEMORY_HEADER*) ptr)->size + HEADER_SIZE;
+  return my_huge_page_realloc(ptr, old_size, size, *(my_bool*) context);
+}
+
+static void huge_free(void *context __attribute__((unused)), void *ptr,
+                      size_t size, uint category __attribute__((unused)))
+{
+  my_huge_page_free(ptr, size);
+}
+
+#define HUGE_PAGE_ALLOCATOR          1
+#define RESERVED_HUGE_PAGE_ALLOCATOR 2
+#define FIRST_USER_ALLOCATOR         3
+#define IS_HUGE_PAGE_ALLOCATOR(A) \
+  ((A) == HUGE_PAGE_ALLOCATOR || (A) == RESERVED_HUGE_PAGE_ALLOCATOR)
+
+/*
+  Allocators ever installed, after the system allocator and the huge
+  page ones
+*/
+static MY_ALLOCATOR allocators[MAX_ALLOCATORS]=
+{
+  { sys_malloc, sys_realloc, sys_free, 0 },
+  { huge_malloc, huge_realloc, huge_free, huge_pages_reserved },
+  { huge_malloc, huge_realloc, huge_free, huge_pages_reserved + 1 }
+};
+static uint allocator_count= FIRST_USER_ALLOCATOR, current_allocator= 0;
+
+/*
+  Bytes in use by category, counted per thread. A thread adds its bytes
+  to memory_bytes when they have grown or shrunk by MEMORY_FLUSH_SIZE,
+  and that is when the peak is updated, so the peak can be up to
+  MEMORY_FLUSH_SIZE per thread below the real one. Its allocations are
+  added when the thread ends. my_get_memory_stats() adds up the counters
+  of all threads. Threads without my_thread_init() count directly in
+  memory_bytes.
+*/
+
+#define MEMORY_FLUSH_SIZE (64*1024L)
+
+typedef struct st_my_memory_counters
+{
+  longlong bytes[MY_MEMORY_CATEGORIES];
+  ulonglong allocations[MY_MEMORY_CATEGORIES];
+  struct st_my_memory_counters *next, **prev;
+} MY_MEMORY_COUNTERS;
+
+static longlong memory_bytes[MY_MEMORY_CATEGORIES];
+static longlong memory_peak[MY_MEMORY_CATEGORIES];
+static ulonglong memory_allocations[MY_MEMORY_CATEGORIES];
+#ifdef THREAD
+static MY_MEMORY_COUNTERS *thread_counters;
+#endif
+
+/*
+  The allocators and the counters are protected by THR_LOCK_malloc,
+  which only exists between my_init() and my_end().
+*/
+
+static my_bool lock_memory(void)
+{
+#ifdef THREAD
+  if (my_init_done)
+  {
+    pthread_mutex_lock(&THR_LOCK_malloc);
+    return 1;
+  }
+#endif
+  return 0;
+}
+
+static void unlock_memory(my_bool locked __attribute__((unused)))
+{
+#ifdef THREAD
+  if (locked)
+    pthread_mutex_unlock(&THR_LOCK_malloc);
+#endif
+}
+
+/* Add bytes to memory_bytes, which is locked */
+
+static void add_memory_bytes(uint category, longlong bytes)
+{
+  if ((memory_bytes[category]+= bytes) > memory_peak[category])
+    memory_peak[category]= memory_bytes[category];
+}
+
+#ifdef THREAD
+/*
+  The counters of the thread, created on first use. They are not
+  allocated with my_malloc() as that would count them.
+*/
+
+static MY_MEMORY_COUNTERS *get_thread_counters(void)
+{
+  struct st_my_thread_var *tmp;
+  MY_MEMORY_COUNTERS *counters;
+
+  if (!my_init_done || !(tmp= _my_thread_var()))
+    return 0;
+  if ((counters= tmp->memory_counters))
+    return counters;
+  if (!(counters= (MY_MEMORY_COUNTERS*) calloc(1, sizeof(*counters))))
+    return 0;
+  pthread_mutex_lock(&THR_LOCK_malloc);
+  if ((counters->next= thread_counters))
+    thread_counters->prev= &counters->next;
+  counters->prev= &thread_counters;
+  thread_counters= counters;
+  pthread_mutex_unlock(&THR_LOCK_malloc);
+  return tmp->memory_counters= counters;
+}
+
+
+/* Add the counters of a thread to the totals, called by my_thread_end() */
+
+void my_memory_thread_end(struct st_my_thread_var *tmp)
+{
+  MY_MEMORY_COUNTERS *counters= tmp->memory_counters;
+  uint i;
+
+  if (!counters)
+    return;
+  pthread_mutex_lock(&THR_LOCK_malloc);
+  for (i= 0; i < MY_MEMORY_CATEGORIES; i++)
+  {
+    add_memory_bytes(i, counters->bytes[i]);
+    memory_allocations[i]+= counters->allocations[i];
+  }
+  if ((*counters->prev= counters->next))
+    counters->next->prev= counters->prev;
+  pthread_mutex_unlock(&THR_LOCK_malloc);
+  tmp->memory_counters= 0;
+  free(counters);
+}
+#endif /* THREAD */
+
+static void count_memory(uint category, longlong bytes, uint allocations)
+{
+  my_bool locked;
+#ifdef THREAD
+  MY_MEMORY_COUNTERS *counters;
+  if ((counters= get_thread_counters()))
+  {
+    counters->allocations[category]+= allocations;
+    counters->bytes[category]+= bytes;
+    if (counters->bytes[category] < MEMORY_FLUSH_SIZE &&
+        counters->bytes[category] > -MEMORY_FLUSH_SIZE)
+      return;
+    pthread_mutex_lock(&THR_LOCK_malloc);
+    add_memory_bytes(category, counters->bytes[category]);
+    counters->bytes[category]= 0;
+    pthread_mutex_unlock(&THR_LOCK_malloc);
+    return;
+  }
+#endif
+  locked= lock_memory();
+  add_memory_bytes(category, bytes);
+  memory_allocations[category]+= allocations;
+  unlock_memory(locked);
+}
+
+
+/*
+  A block is large enough for huge pages when it fills one with the
+  overhead of my_malloc(), which is what roots round their blocks to
+*/
+#define HUGE_PAGE_BLOCK(S) ((S) + MALLOC_OVERHEAD >= my_huge_page_size())
+
+/*
+  Allocate a block with a header for size bytes, on huge pages if
+  my_flags asks for it and it is large enough, else from the current
+  allocator. allocator_nr is set to where it came from.
+*/
+
+static MY_MEMORY_HEADER *allocate_block(size_t size, uint category,
+                                        myf my_flags, uint *allocator_nr)
+{
+  MY_ALLOCATOR *allocator;
+  MY_MEMORY_HEADER *header;
+
+  if ((my_flags & MY_HUGE_PAGES) && HUGE_PAGE_BLOCK(size))
+  {
+    *allocator_nr= (my_flags & MY_HUGE_PAGES_RESERVED) ?
+                   RESERVED_HUGE_PAGE_ALLOCATOR : HUGE_PAGE_ALLOCATOR;
+    allocator= allocators + *allocator_nr;
+    if ((header= (MY_MEMORY_HEADER*)
+         allocator->malloc_func(allocator->context, size + HEADER_SIZE,
+                                category)))
+      return header;
+  }
+  *allocator_nr= current_allocator;
+  allocator= allocators + *allocator_nr;
+  return (MY_MEMORY_HEADER*) allocator->malloc_func(allocator->context,
+                                                    size + HEADER_SIZE,
+                                                    category);
+}
+
+
 	/* My memory allocator */
 
 void *my_malloc(size_t size, myf my_flags)
 {
+  MY_MEMORY_HEADER *header;
+  uint category= MY_MEMORY_CATEGORY(my_flags), allocator_nr;
   void* point;
   DBUG_ENTER("my_malloc");
   DBUG_PRINT("my",("size: %lu  my_flags: %d", (ulong) size, my_flags));
@@ -34,7 +290,8 @@ void *my_malloc(size_t size, myf my_flags)
 
   /* If compiled with DBUG, test for error injection. Described in my_sys.h. */
   /* purecov: begin tested */
-  if (!(point= IF_DBUG(my_malloc_error_inject ? NULL :) (char*) malloc(size)))
+  if (!(header= IF_DBUG(my_malloc_error_inject ? NULL :)
+        allocate_block(size, category, my_flags, &allocator_nr)))
   {
     IF_DBUG(if (my_malloc_error_inject) errno= ENOMEM;
             my_malloc_error_inject= 0);
@@ -45,8 +302,14 @@ void *my_malloc(size_t size, myf my_flags)
       my_error(EE_OUTOFMEMORY, MYF(ME_BELL+ME_WAITTANG+ME_NOREFRESH),size);
     if (my_flags & MY_FAE)
       exit(1);
+    DBUG_RETURN(0);
   }
-  else if (my_flags & MY_ZEROFILL)
+  header->size= size;
+  header->category= category;
+  header->allocator= allocator_nr;
+  count_memory(category, (longlong) size, 1);
+  point= USER_PTR(header);
+  if (my_flags & MY_ZEROFILL)
     bzero(point,size);
   DBUG_PRINT("exit",("ptr: %p", point));
   DBUG_RETURN((void*) point);
@@ -54,19 +317,170 @@ void *my_malloc(size_t size, myf my_flags)
 } /* my_malloc */
 
 
+/* Copy a block into a new one allocated with my_flags and free it */
+
+static void *move_block(void *ptr, size_t size, myf my_flags)
+{
+  MY_MEMORY_HEADER *header= HEADER_PTR(ptr);
+  void *point;
+
+  my_flags&= MY_HUGE_PAGES | MY_HUGE_PAGES_RESERVED;
+  if (!(point= my_malloc(size, MYF(my_flags | (header->category <<
+                                              MY_MEMORY_CATEGORY_SHIFT)))))
+    return 0;
+  memcpy(point, ptr, min(size, header->size));
+  my_no_flags_free(ptr);
+  return point;
+}
+
+
+/*
+  Change the size of a block from my_malloc()
+
+  SYNOPSIS
+    my_memory_realloc()
+    ptr         Block from my_malloc()
+    size        New size, > 0
+
+    my_flags    MY_HUGE_PAGES and MY_HUGE_PAGES_RESERVED are used
+
+  NOTES
+    This is the part of my_realloc() that knows about the header. The
+    block keeps its category and, unless it is moved to or from huge
+    pages, its allocator. A block that grows to a huge page with
+    MY_HUGE_PAGES is moved to huge pages, and one on huge pages that
+    can't grow there is moved to the current allocator.
+
+  RETURN
+    0      Out of memory, ptr is not changed
+    #      The block
+*/
+
+void *my_memory_realloc(void *ptr, size_t size, myf my_flags)
+{
+  MY_MEMORY_HEADER *header= HEADER_PTR(ptr);
+  MY_ALLOCATOR *allocator= allocators + header->allocator;
+  size_t old_size= header->size;
+  my_bool huge_pages= IS_HUGE_PAGE_ALLOCATOR(header->allocator);
+
+  if ((my_flags & MY_HUGE_PAGES) && !huge_pages && HUGE_PAGE_BLOCK(size))
+    return move_block(ptr, size, my_flags);
+  if (!(header= (MY_MEMORY_HEADER*)
+        allocator->realloc_func(allocator->context, header,
+                                size + HEADER_SIZE, header->category)))
+    return huge_pages ? move_block(ptr, size, 0) : 0;
+  header->size= size;
+  count_memory(header->category, (longlong) size - (longlong) old_size, 0);
+  return USER_PTR(header);
+}
+
+
 	/* Free memory allocated with my_malloc */
 	/*ARGSUSED*/
 
 void my_no_flags_free(void* ptr)
 {
+  MY_MEMORY_HEADER *header;
   DBUG_ENTER("my_free");
   DBUG_PRINT("my",("ptr: %p", ptr));
   if (ptr)
-    free(ptr);
+  {
+    MY_ALLOCATOR *allocator;
+    header= HEADER_PTR(ptr);
+    allocator= allocators + header->allocator;
+    count_memory(header->category, -(longlong) header->size, 0);
+    allocator->free_func(allocator->context, header,
+                         header->size + HEADER_SIZE, header->category);
+  }
   DBUG_VOID_RETURN;
 } /* my_free */
 
 
+/*
+  Install the functions my_malloc() gets its memory from
+
+  SYNOPSIS
+    my_set_allocator()
+    allocator   Functions and their context, copied. 0 goes back to
+                malloc(), realloc() and free()
+
+  NOTES
+    Blocks allocated before are still reallocated and freed with the
+    functions they came from, so the context of an allocator must stay
+    valid until all its memory is freed. Install the allocator before
+    memory is allocated in other threads. Blocks put on huge pages with
+    MY_HUGE_PAGES are mapped directly and don't go through it.
+
+  RETURN
+    0  ok
+    1  Functions missing or too many allocators installed
+*/
+
+my_bool my_set_allocator(const MY_ALLOCATOR *allocator)
+{
+  uint i;
+  my_bool error= 0, locked;
+  DBUG_ENTER("my_set_allocator");
+
+  if (!allocator)
+  {
+    current_allocator= 0;
+    DBUG_RETURN(0);
+  }
+  if (!allocator->malloc_func || !allocator->realloc_func ||
+      !allocator->free_func)
+    DBUG_RETURN(1);
+  locked= lock_memory();
+  for (i= FIRST_USER_ALLOCATOR; i < allocator_count; i++)
+    if (!memcmp(allocators + i, allocator, sizeof(*allocator)))
+      break;
+  if (i == MAX_ALLOCATORS)
+    error= 1;
+  else
+  {
+    if (i == allocator_count)
+      allocators[allocator_count++]= *allocator;
+    current_allocator= i;
+  }
+  unlock_memory(locked);
+  DBUG_RETURN(error);
+}
+
+
+/*
+  Bytes in use, their peak and number of allocations of each category
+
+  NOTES
+    The counters of the other threads are read without waiting for
+    them, so what they allocate meanwhile may or may not be included.
+*/
+
+void my_get_memory_stats(MY_MEMORY_STATS *stats)
+{
+  my_bool locked= lock_memory();
+  uint i;
+
+  for (i= 0; i < MY_MEMORY_CATEGORIES; i++)
+  {
+    longlong bytes= memory_bytes[i];
+    ulonglong allocations= memory_allocations[i];
+#ifdef THREAD
+    MY_MEMORY_COUNTERS *counters;
+    for (counters= thread_counters; counters; counters= counters->next)
+    {
+      bytes+= counters->bytes[i];
+      allocations+= counters->allocations[i];
+    }
+#endif
+    set_if_bigger(memory_peak[i], bytes);
+    stats->bytes[i]= (ulonglong) max(bytes, 0);
+    stats->peak[i]= (ulonglong) memory_peak[i];
+    stats->allocations[i]= allocations;
+  }
+  unlock_memory(locked);
+}
+
+
 	/* malloc and copy */
 
 void* my_memdup(const void *from, size_t length, myf my_flags)
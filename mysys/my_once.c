@@ -58,7 +58,9 @@ void* my_once_alloc(size_t Size, myf MyFlags)
     if (max_left*4 < my_once_extra && get_size < my_once_extra)
       get_size=my_once_extra;			/* Normal alloc */
 
-    if ((next = (USED_MEM*) malloc(get_size)) == 0)
+    if ((next = (USED_MEM*) my_malloc(get_size,
+                                      MYF(MyFlags & MY_MEM_CATEGORY_MASK)))
+        == 0)
     {
       my_errno=errno;
       if (MyFlags & (MY_FAE+MY_WME))
@@ -114,7 +116,7 @@ void my_once_free(void)
   for (next=my_once_root_block ; next ; )
   {
     old=next; next= next->next ;
-    free((uchar*) old);
+    my_free(old, MYF(0));
   }
   my_once_root_block=0;
 
@@ -43,7 +43,7 @@ void* my_realloc(void* oldpoint, size_t size, myf my_flags)
   if (!oldpoint && (my_flags & MY_ALLOW_ZERO_PTR))
     DBUG_RETURN(my_malloc(size,my_flags));
 #ifdef USE_HALLOC
-  if (!(point = malloc(size)))
+  if (!(point = my_malloc(size, MYF(0))))
   {
     if (my_flags & MY_FREE_ON_ERROR)
       my_free(oldpoint,my_flags);
@@ -56,10 +56,10 @@ void* my_realloc(void* oldpoint, size_t size, myf my_flags)
   else
   {
     memcpy(point,oldpoint,size);
-    free(oldpoint);
+    my_free(oldpoint, MYF(0));
   }
 #else
-  if ((point= (uchar*) realloc(oldpoint,size)) == NULL)
+  if ((point= my_memory_realloc(oldpoint, size, my_flags)) == NULL)
   {
     if (my_flags & MY_FREE_ON_ERROR)
       my_free(oldpoint, my_flags);
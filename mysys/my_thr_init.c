@@ -399,6 +399,7 @@ void my_thread_end(void)
       tmp->dbug=0;
     }
 #endif
+    my_memory_thread_end(tmp);
 #ifndef DBUG_OFF
     /* To find bugs when accessing unallocated data */
     bfill(tmp, sizeof(tmp), 0x8F);
@@ -29,6 +29,7 @@
 extern pthread_mutex_t THR_LOCK_malloc, THR_LOCK_open, THR_LOCK_keycache;
 extern pthread_mutex_t THR_LOCK_lock, THR_LOCK_isam, THR_LOCK_net;
 extern pthread_mutex_t THR_LOCK_charset, THR_LOCK_time;
+void my_memory_thread_end(struct st_my_thread_var *tmp);
 #else
 #include <my_no_pthread.h>
 #endif
@@ -43,6 +44,11 @@ extern pthread_mutex_t THR_LOCK_charset, THR_LOCK_time;
 #endif
 
 void my_error_unregister_all(void);
+void *my_memory_realloc(void *ptr, size_t size, myf my_flags);
+void *my_huge_page_malloc(size_t size, my_bool reserved);
+void *my_huge_page_realloc(void *ptr, size_t old_size, size_t size,
+                           my_bool reserved);
+void my_huge_page_free(void *ptr, size_t size);
 
 #ifdef _WIN32
 /* my_winfile.c exports, should not be used outside mysys */
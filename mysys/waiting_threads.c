@@ -426,8 +426,8 @@ void wt_init()
   DBUG_ENTER("wt_init");
   DBUG_ASSERT(reshash.alloc.constructor != wt_resource_init);
 
-  lf_hash_init(&reshash, sizeof(WT_RESOURCE), LF_HASH_UNIQUE, 0,
-               sizeof_WT_RESOURCE_ID, 0, 0);
+  lf_hash_init(&reshash, sizeof(WT_RESOURCE),
+               LF_HASH_UNIQUE | LF_HASH_BINARY, 0, sizeof_WT_RESOURCE_ID, 0, 0);
   reshash.alloc.constructor= wt_resource_init;
   reshash.alloc.destructor= wt_resource_destroy;
   /*
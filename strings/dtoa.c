@@ -53,6 +53,7 @@
 
 static double my_strtod_int(const char *, char **, int *, char *, size_t);
 static char *dtoa(double, int, int, int *, int *, char **, char *, size_t);
+static char *dtoa_fast(double, int, int, int *, int *, char **, char *, size_t);
 static void dtoa_free(char *, char *, size_t);
 
 /**
@@ -93,7 +94,7 @@ size_t my_fcvt(double x, int precision, char *to, my_bool *error)
   char buf[DTOA_BUFF_SIZE];
   DBUG_ASSERT(precision >= 0 && precision < NOT_FIXED_DEC && to != NULL);
   
-  res= dtoa(x, 5, precision, &decpt, &sign, &end, buf, sizeof(buf));
+  res= dtoa_fast(x, 5, precision, &decpt, &sign, &end, buf, sizeof(buf));
 
   if (decpt == DTOA_OVERFLOW)
   {
@@ -222,8 +223,9 @@ size_t my_gcvt(double x, my_gcvt_arg_type type, int width, char *to,
   if (x < 0.)
     width--;
 
-  res= dtoa(x, 4, type == MY_GCVT_ARG_DOUBLE ? width : min(width, FLT_DIG),
-            &decpt, &sign, &end, buf, sizeof(buf));
+  res= dtoa_fast(x, 4,
+                 type == MY_GCVT_ARG_DOUBLE ? width : min(width, FLT_DIG),
+                 &decpt, &sign, &end, buf, sizeof(buf));
   if (decpt == DTOA_OVERFLOW)
   {
     dtoa_free(res, buf, sizeof(buf));
@@ -328,7 +330,8 @@ size_t my_gcvt(double x, my_gcvt_arg_type type, int width, char *to,
         number of significant digits = (len-decpt) - (len-width) = width-decpt
       */
       dtoa_free(res, buf, sizeof(buf));
-      res= dtoa(x, 5, width - decpt, &decpt, &sign, &end, buf, sizeof(buf));
+      res= dtoa_fast(x, 5, width - decpt, &decpt, &sign, &end,
+                     buf, sizeof(buf));
       src= res;
       len= end - res;
     }
@@ -394,7 +397,7 @@ size_t my_gcvt(double x, my_gcvt_arg_type type, int width, char *to,
     {
       /* Yes, re-convert with a smaller width */
       dtoa_free(res, buf, sizeof(buf));
-      res= dtoa(x, 4, width, &decpt, &sign, &end, buf, sizeof(buf));
+      res= dtoa_fast(x, 4, width, &decpt, &sign, &end, buf, sizeof(buf));
       src= res;
       len= end - res;
       if (--decpt < 0)
@@ -477,6 +480,368 @@ double my_atof(const char *nptr)
 }
 
 
+/*
+  Shortest round-trip digits for dtoa() modes 4 and 5.
+
+  The Ryu algorithm (Ulf Adams, "Ryu: fast float-to-string conversion",
+  PLDI 2018) finds the shortest digit string S that reads back as d, and
+  among those the one closest to d, using two 64x128 bit multiplications
+  by a precomputed power of 5. That is exactly what dtoa() in modes 4 and
+  5 returns when S has no more digits than were asked for, which is the
+  usual case for my_gcvt() with a wide field.
+
+  When fewer digits n are asked for, S is rounded to n digits. This gives
+  the correctly rounded result: if the midpoint M between two n digit
+  neighbours lay strictly between d and S, M would be inside the rounding
+  interval of d as well, have no more digits than S and be closer to d,
+  so S would not be the shortest and closest. The only case left is S
+  itself being a tie (digit n + 1 is the last one and is a 5), where d
+  may be on either side of M; that and the other rare cases (0,
+  denormals, inf, nan, no digits at all in mode 5) are left to dtoa().
+*/
+
+#if defined(__SIZEOF_INT128__)
+
+#include "dtoa_pow5.h"
+
+typedef unsigned __int128 dtoa_uint128;
+
+/* ceil(log2(5^e)) for e > 0 (1 for e == 0) */
+static inline int dtoa_pow5_bits(int e)
+{
+  return (int) (((uint32) e * 1217359) >> 19) + 1;
+}
+
+/* floor(log10(2^e)) */
+static inline int dtoa_log10_pow2(int e)
+{
+  return (int) (((uint32) e * 78913) >> 18);
+}
+
+/* floor(log10(5^e)) */
+static inline int dtoa_log10_pow5(int e)
+{
+  return (int) (((uint32) e * 732923) >> 20);
+}
+
+static inline my_bool dtoa_multiple_of_pow5(ulonglong value, int p)
+{
+  int count= 0;
+  for (; value % 5 == 0; value/= 5)
+    count++;
+  return count >= p;
+}
+
+static inline my_bool dtoa_multiple_of_pow2(ulonglong value, int p)
+{
+  return (value & ((1ULL << p) - 1)) == 0;
+}
+
+/* (m * mul) >> j, mul being a 128 bit value and j >= 64 */
+static inline ulonglong dtoa_mul_shift(ulonglong m, const ulonglong *mul,
+                                       int j)
+{
+  dtoa_uint128 b0= (dtoa_uint128) m * mul[0];
+  dtoa_uint128 b2= (dtoa_uint128) m * mul[1];
+  return (ulonglong) (((b0 >> 64) + b2) >> (j - 64));
+}
+
+
+/*
+  Find the shortest decimal representation of a positive finite double.
+
+  SYNOPSIS
+    dtoa_shortest()
+    bits        IEEE 754 representation of the number, sign bit clear
+    exp10       Out: the decimal exponent
+
+  RETURN VALUE
+    The significant digits as an integer; the number is that times
+    10^exp10. The result may have trailing zeros.
+*/
+
+static ulonglong dtoa_shortest(ulonglong bits, int *exp10)
+{
+  ulonglong mantissa= bits & ((1ULL << 52) - 1);
+  int exponent= (int) (bits >> 52), e2, e10, q, i, removed= 0;
+  ulonglong m2, mv, vr, vp, vm;
+  my_bool accept_bounds, vm_trailing_zeros= FALSE, vr_trailing_zeros= FALSE;
+  uint mm_shift;
+
+  /* The factor 4 leaves room for the bounds of the rounding interval */
+  if (exponent == 0)
+  {
+    e2= 1 - 1023 - 52 - 2;
+    m2= mantissa;
+  }
+  else
+  {
+    e2= exponent - 1023 - 52 - 2;
+    m2= (1ULL << 52) | mantissa;
+  }
+  accept_bounds= (m2 & 1) == 0;              /* round half even on read */
+  mv= 4 * m2;
+  /* The interval is asymmetric just above a power of 2 */
+  mm_shift= mantissa != 0 || exponent <= 1;
+
+  /* vr, vp, vm= (mv, mv + 2, mv - 1 - mm_shift) * 2^e2 / 10^e10 */
+  if (e2 >= 0)
+  {
+    int k;
+    q= dtoa_log10_pow2(e2) - (e2 > 3);
+    e10= q;
+    k= DTOA_POW5_INV_BITCOUNT + dtoa_pow5_bits(q) - 1;
+    i= -e2 + q + k;
+    vr= dtoa_mul_shift(4 * m2, dtoa_pow5_inv[q], i);
+    vp= dtoa_mul_shift(4 * m2 + 2, dtoa_pow5_inv[q], i);
+    vm= dtoa_mul_shift(4 * m2 - 1 - mm_shift, dtoa_pow5_inv[q], i);
+    if (q <= 21)
+    {
+      /* Only one of mp, mv and mm can be a multiple of 5, if any */
+      if (mv % 5 == 0)
+        vr_trailing_zeros= dtoa_multiple_of_pow5(mv, q);
+      else if (accept_bounds)
+        vm_trailing_zeros= dtoa_multiple_of_pow5(mv - 1 - mm_shift, q);
+      else
+        vp-= dtoa_multiple_of_pow5(mv + 2, q);
+    }
+  }
+  else
+  {
+    int k, j;
+    q= dtoa_log10_pow5(-e2) - (-e2 > 1);
+    e10= q + e2;
+    i= -e2 - q;
+    k= dtoa_pow5_bits(i) - DTOA_POW5_BITCOUNT;
+    j= q - k;
+    vr= dtoa_mul_shift(4 * m2, dtoa_pow5[i], j);
+    vp= dtoa_mul_shift(4 * m2 + 2, dtoa_pow5[i], j);
+    vm= dtoa_mul_shift(4 * m2 - 1 - mm_shift, dtoa_pow5[i], j);
+    if (q <= 1)
+    {
+      /* mv has at least q trailing 0 bits, and so has mp */
+      vr_trailing_zeros= TRUE;
+      if (accept_bounds)
+        vm_trailing_zeros= mm_shift == 1;
+      else
+        vp--;
+    }
+    else if (q < 63)
+      vr_trailing_zeros= dtoa_multiple_of_pow2(mv, q);
+  }
+
+  /* Remove digits as long as the interval [vm, vp] still holds a number */
+  if (vm_trailing_zeros || vr_trailing_zeros)
+  {
+    /* Rare: the interval bounds or d itself may be exact */
+    uint last_removed= 0;
+    for (; vp / 10 > vm / 10; removed++)
+    {
+      vm_trailing_zeros&= vm % 10 == 0;
+      vr_trailing_zeros&= last_removed == 0;
+      last_removed= (uint) (vr % 10);
+      vr/= 10;
+      vp/= 10;
+      vm/= 10;
+    }
+    if (vm_trailing_zeros)
+    {
+      for (; vm % 10 == 0; removed++)
+      {
+        vr_trailing_zeros&= last_removed == 0;
+        last_removed= (uint) (vr % 10);
+        vr/= 10;
+        vp/= 10;
+        vm/= 10;
+      }
+    }
+    if (vr_trailing_zeros && last_removed == 5 && vr % 2 == 0)
+      last_removed= 4;                          /* exact tie: round to even */
+    vr+= (vr == vm && (!accept_bounds || !vm_trailing_zeros)) ||
+         last_removed >= 5;
+  }
+  else
+  {
+    my_bool round_up= FALSE;
+    if (vp / 100 > vm / 100)
+    {
+      round_up= vr % 100 >= 50;
+      vr/= 100;
+      vp/= 100;
+      vm/= 100;
+      removed+= 2;
+    }
+    for (; vp / 10 > vm / 10; removed++)
+    {
+      round_up= vr % 10 >= 5;
+      vr/= 10;
+      vp/= 10;
+      vm/= 10;
+    }
+    vr+= vr == vm || round_up;
+  }
+  *exp10= e10 + removed;
+  return vr;
+}
+
+
+/*
+  dtoa() for modes 4 and 5 using dtoa_shortest() where it gives the
+  same result; see the comment above. Arguments and result are the same
+  as for dtoa().
+*/
+
+static char *dtoa_fast(double d, int mode, int ndigits, int *decpt, int *sign,
+                       char **rve, char *buf, size_t buf_size)
+{
+  ulonglong bits, digits;
+  int exp10, len, n;
+  char tmp[24], *s= tmp + sizeof(tmp);
+
+  DBUG_ASSERT(mode == 4 || mode == 5);
+  memcpy(&bits, &d, sizeof(bits));
+  /*
+    dtoa() does not shorten the digits of denormals in modes 4 and 5, so
+    leave those to it as well as 0, inf and nan.
+  */
+  if ((bits & 0x7FF0000000000000ULL) == 0x7FF0000000000000ULL ||
+      !(bits & 0x7FF0000000000000ULL) || buf_size < sizeof(tmp))
+    return dtoa(d, mode, ndigits, decpt, sign, rve, buf, buf_size);
+
+  digits= dtoa_shortest(bits & ~(1ULL << 63), &exp10);
+  for (; digits % 10 == 0; exp10++)
+    digits/= 10;
+  do
+  {
+    *--s= (char) ('0' + digits % 10);
+  } while ((digits/= 10));
+  len= (int) (tmp + sizeof(tmp) - s);
+  *decpt= exp10 + len;
+
+  n= mode == 4 ? max(ndigits, 1) : *decpt + ndigits;
+  if (n < len)
+  {
+    if (n <= 0 || (s[n] == '5' && n + 1 == len))
+      return dtoa(d, mode, ndigits, decpt, sign, rve, buf, buf_size);
+    if (s[n] >= '5')
+    {
+      for (len= n; len > 0 && s[len - 1] == '9'; len--) ;
+      if (len == 0)
+      {
+        /* 99..9 rounded up */
+        s[0]= '1';
+        len= 1;
+        (*decpt)++;
+      }
+      else
+        s[len - 1]++;
+    }
+    else
+    {
+      for (len= n; s[len - 1] == '0'; len--) ;
+    }
+  }
+
+  *sign= (int) (bits >> 63);
+  memcpy(buf, s, len);
+  buf[len]= '\0';
+  if (rve)
+    *rve= buf + len;
+  return buf;
+}
+
+
+
+/*
+  Correctly rounded w * 10^q for the common case of my_strtod_int().
+
+  SYNOPSIS
+    dtoa_eisel_lemire()
+    w           Decimal significand, 0 < w < 2^64
+    q           Decimal exponent
+    result      Out: the nearest double
+
+  DESCRIPTION
+    The Eisel-Lemire algorithm (D. Lemire, "Number Parsing at a Gigabyte
+    per Second", 2021) multiplies w by a 128 bit truncation of 5^q. The
+    truncation error can only change the result when the bits below the
+    53 bit mantissa are all ones or the product is right between two
+    doubles; those cases, results out of the normal range, and exponents
+    outside the table are left to the caller.
+
+  RETURN VALUE
+    FALSE  *result is set
+    TRUE   the value could not be decided
+*/
+
+static my_bool dtoa_eisel_lemire(ulonglong w, int q, double *result)
+{
+  const ulonglong *pow5;
+  dtoa_uint128 product;
+  ulonglong upper, lower, mantissa, upper_bit, bits;
+  int lz, exponent;
+
+  if (q < DTOA_POW5_128_MIN || q > DTOA_POW5_128_MAX)
+    return TRUE;
+  lz= __builtin_clzll(w);
+  w<<= lz;
+  pow5= dtoa_pow5_128[q - DTOA_POW5_128_MIN];
+
+  product= (dtoa_uint128) w * pow5[1];
+  upper= (ulonglong) (product >> 64);
+  lower= (ulonglong) product;
+  if ((upper & 0x1FF) == 0x1FF && lower + w < lower)
+  {
+    /* The low half of 5^q may carry into the mantissa; add it in */
+    dtoa_uint128 product_low= (dtoa_uint128) w * pow5[0];
+    ulonglong middle= lower + (ulonglong) (product_low >> 64);
+    if (middle < lower)
+      upper++;
+    if (middle + 1 == 0 && (upper & 0x1FF) == 0x1FF &&
+        (ulonglong) product_low + w < (ulonglong) product_low)
+      return TRUE;
+    lower= middle;
+  }
+
+  /* 54 bits with a leading 1, one more than the mantissa for rounding */
+  upper_bit= upper >> 63;
+  mantissa= upper >> (upper_bit + 9);
+  lz+= (int) (1 ^ upper_bit);
+
+  /* Possibly halfway between two doubles, where rounding is to even */
+  if (lower == 0 && (upper & 0x1FF) == 0 && (mantissa & 3) == 1)
+    return TRUE;
+
+  mantissa+= mantissa & 1;
+  mantissa>>= 1;
+  if (mantissa >= (1ULL << 53))
+  {
+    mantissa= 1ULL << 52;
+    lz--;
+  }
+  mantissa&= ~(1ULL << 52);
+
+  /* 217706 / 2^16 ~ log2(10) */
+  exponent= ((217706 * q) >> 16) + 1024 + 63 - lz;
+  if (exponent < 1 || exponent > 2046)
+    return TRUE;
+
+  bits= mantissa | (ulonglong) exponent << 52;
+  memcpy(result, &bits, sizeof(bits));
+  return FALSE;
+}
+
+#else
+
+static char *dtoa_fast(double d, int mode, int ndigits, int *decpt, int *sign,
+                       char **rve, char *buf, size_t buf_size)
+{
+  return dtoa(d, mode, ndigits, decpt, sign, rve, buf, buf_size);
+}
+
+#endif /* __SIZEOF_INT128__ */
+
+
 /****************************************************************
  *
  * The author of this software is David M. Gay.
@@ -1556,6 +1921,23 @@ static double my_strtod_int(const char *s00, char **se, int *error, char *buf, s
     }
 #endif
   }
+
+#if defined(__SIZEOF_INT128__) && !defined(Honor_FLT_ROUNDS)
+  if (nd <= 19 && Flt_Rounds == 1)
+  {
+    /* All digits fit in 64 bits; try the fast exact algorithm first */
+    ulonglong w= 0;
+    for (i= 0, s1= s0; i < nd; i++, s1++)
+    {
+      if (i == nd0)
+        s1++;                                   /* skip the decimal point */
+      w= 10 * w + (*s1 - '0');
+    }
+    if (!dtoa_eisel_lemire(w, e, &dval(rv)))
+      goto ret;
+  }
+#endif
+
   e1+= nd - k;
 
 #ifdef SET_INEXACT
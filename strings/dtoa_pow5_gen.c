@@ -0,0 +1,220 @@
+/* Copyright (C) 2026 MySQL Connector/C contributors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*
+  Generates dtoa_pow5.h:
+
+    cc -o dtoa_pow5_gen dtoa_pow5_gen.c && ./dtoa_pow5_gen > dtoa_pow5.h
+
+  The numbers are kept as arrays of 32 bit limbs, least significant first.
+  Only multiplication and division by small numbers are needed: 5^q is
+  built by multiplying by 5, and x / 5^q is x divided by 5 q times, as
+  floor(floor(x / a) / b) == floor(x / (a * b)).
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#define LIMBS 64
+
+#define INV_BITCOUNT 125
+#define POW5_BITCOUNT 125
+#define INV_SIZE 342
+#define POW5_SIZE 326
+#define POW5_128_MIN (-342)
+#define POW5_128_MAX 308
+
+typedef struct { unsigned int d[LIMBS]; } BIG;
+
+static void big_set(BIG *b, unsigned int v)
+{
+  memset(b, 0, sizeof(*b));
+  b->d[0]= v;
+}
+
+static void big_mul(BIG *b, unsigned int m)
+{
+  unsigned long long carry= 0;
+  int i;
+  for (i= 0; i < LIMBS; i++)
+  {
+    carry+= (unsigned long long) b->d[i] * m;
+    b->d[i]= (unsigned int) carry;
+    carry>>= 32;
+  }
+}
+
+static void big_div(BIG *b, unsigned int m)
+{
+  unsigned long long rem= 0;
+  int i;
+  for (i= LIMBS - 1; i >= 0; i--)
+  {
+    rem= rem << 32 | b->d[i];
+    b->d[i]= (unsigned int) (rem / m);
+    rem%= m;
+  }
+}
+
+static void big_add1(BIG *b)
+{
+  int i;
+  for (i= 0; i < LIMBS && !++b->d[i]; i++)
+    ;
+}
+
+static int big_bits(const BIG *b)
+{
+  unsigned int top;
+  int i, n;
+  for (i= LIMBS - 1; i >= 0 && !b->d[i]; i--)
+    ;
+  if (i < 0)
+    return 0;
+  for (n= 0, top= b->d[i]; top; n++)
+    top>>= 1;
+  return i * 32 + n;
+}
+
+/* b * 2^shift, or b / 2^-shift truncated */
+static void big_shift(BIG *b, int shift)
+{
+  BIG r;
+  int i;
+  memset(&r, 0, sizeof(r));
+  for (i= 0; i < LIMBS * 32; i++)
+  {
+    int to= i + shift;
+    if ((b->d[i / 32] >> (i % 32) & 1) && to >= 0 && to < LIMBS * 32)
+      r.d[to / 32]|= 1U << (to % 32);
+  }
+  *b= r;
+}
+
+static void big_pow5(BIG *b, int q)
+{
+  big_set(b, 1);
+  while (q--)
+    big_mul(b, 5);
+}
+
+/* floor(2^(bitlength(5^q) + extra) / 5^q) */
+static void big_inv5(BIG *b, int q, int extra)
+{
+  BIG p;
+  big_pow5(&p, q);
+  big_set(b, 1);
+  big_shift(b, big_bits(&p) + extra);
+  while (q--)
+    big_div(b, 5);
+}
+
+static void print_row(const BIG *b, int last)
+{
+  printf("  { %lluULL, %lluULL }%s\n",
+         (unsigned long long) b->d[1] << 32 | b->d[0],
+         (unsigned long long) b->d[3] << 32 | b->d[2], last ? "" : ",");
+}
+
+
+int main(void)
+{
+  BIG b;
+  int q;
+
+  printf("/* Copyright (C) 2026 MySQL Connector/C contributors\n"
+         "\n"
+         "   This library is free software; you can redistribute it and/or\n"
+         "   modify it under the terms of the GNU Library General Public\n"
+         "   License as published by the Free Software Foundation; version 2\n"
+         "   of the License.\n"
+         "\n"
+         "   This program is distributed in the hope that it will be useful,\n"
+         "   but WITHOUT ANY WARRANTY; without even the implied warranty of\n"
+         "   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n"
+         "   GNU General Public License for more details.\n"
+         "\n"
+         "   You should have received a copy of the GNU General Public License\n"
+         "   along with this program; if not, write to the Free Software\n"
+         "   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  "
+         "02111-1307  USA */\n"
+         "\n"
+         "/*\n"
+         "  Powers of 5 used by dtoa.c, as { low 64 bits, high 64 bits }.\n"
+         "\n"
+         "  For the shortest digit generator, 125 bit fixed point values:\n"
+         "\n"
+         "    dtoa_pow5_inv[q]= floor(2^(bitlength(5^q) - 1 + 125) / 5^q) + 1\n"
+         "    dtoa_pow5[i]=     floor(5^i * 2^(125 - bitlength(5^i)))\n"
+         "\n"
+         "  For reading numbers, 128 bit values, rounded as in the table of the\n"
+         "  Eisel-Lemire paper: truncated, except for -27 <= q < 0, where 5^-q\n"
+         "  is below 2^64, which are rounded up:\n"
+         "\n"
+         "    dtoa_pow5_128[q + 342]=\n"
+         "      floor(5^q * 2^(128 - bitlength(5^q)))             q >= 0\n"
+         "      floor(2^(bitlength(5^-q) + 127) / 5^-q) + 1        -27 <= q < 0\n"
+         "      floor(2^(bitlength(5^-q) + 127) / 5^-q)            q < -27\n"
+         "\n"
+         "  bitlength(x) is the number of significant bits of x. The quotients\n"
+         "  for q < 0 are never exact, so the + 1 rounds them up.\n"
+         "\n"
+         "  Generated by dtoa_pow5_gen.c; do not edit.\n"
+         "*/\n"
+         "\n"
+         "#define DTOA_POW5_INV_BITCOUNT %d\n"
+         "#define DTOA_POW5_BITCOUNT %d\n"
+         "#define DTOA_POW5_128_MIN (%d)\n"
+         "#define DTOA_POW5_128_MAX %d\n",
+         INV_BITCOUNT, POW5_BITCOUNT, POW5_128_MIN, POW5_128_MAX);
+
+  printf("\nstatic const ulonglong dtoa_pow5_inv[%d][2]=\n{\n", INV_SIZE);
+  for (q= 0; q < INV_SIZE; q++)
+  {
+    big_inv5(&b, q, INV_BITCOUNT - 1);
+    big_add1(&b);
+    print_row(&b, q == INV_SIZE - 1);
+  }
+  printf("};\n");
+
+  printf("\nstatic const ulonglong dtoa_pow5[%d][2]=\n{\n", POW5_SIZE);
+  for (q= 0; q < POW5_SIZE; q++)
+  {
+    big_pow5(&b, q);
+    big_shift(&b, POW5_BITCOUNT - big_bits(&b));
+    print_row(&b, q == POW5_SIZE - 1);
+  }
+  printf("};\n");
+
+  printf("\nstatic const ulonglong dtoa_pow5_128[%d][2]=\n{\n",
+         POW5_128_MAX - POW5_128_MIN + 1);
+  for (q= POW5_128_MIN; q <= POW5_128_MAX; q++)
+  {
+    if (q >= 0)
+    {
+      big_pow5(&b, q);
+      big_shift(&b, 128 - big_bits(&b));
+    }
+    else
+    {
+      big_inv5(&b, -q, 127);
+      if (q >= -27)
+        big_add1(&b);
+    }
+    print_row(&b, q == POW5_128_MAX);
+  }
+  printf("};\n");
+  return 0;
+}
@@ -0,0 +1,300 @@
+/* Copyright (C) 2026 MySQL Connector/C contributors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*  File   : str_hex.c
+    Defines: my_hex_encode, my_hex_decode
+
+    my_hex_encode(to, from, length) writes the 2*length upper case hex
+    digits of from[0..length-1] to 'to'. No terminating null is added.
+    Returns 2*length.
+
+    my_hex_decode(to, from, length) converts the hex digits (either case)
+    in from[0..length-1] back to length/2 bytes. Returns the number of
+    bytes written, or (size_t) -1 if length is odd or from contains
+    anything but hex digits; 'to' is undefined in that case.
+
+    Both work on 16 bytes at a time with SSE2 and on 32 bytes at a time
+    with AVX2. The AVX2 code is compiled for a target attribute and only
+    used if the CPU has it, which is checked on the first call.
+*/
+
+#include <my_global.h>
+#include "m_string.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 8))
+#define HEX_HAVE_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+
+static inline int hex_digit_val(uchar c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  c|= 0x20;
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  return -1;
+}
+
+
+static size_t hex_encode_scalar(char *to, const uchar *from, size_t length)
+{
+  const uchar *end= from + length;
+  for (; from < end; from++)
+  {
+    *to++= _dig_vec_upper[*from >> 4];
+    *to++= _dig_vec_upper[*from & 0x0F];
+  }
+  return length * 2;
+}
+
+
+static size_t hex_decode_scalar(uchar *to, const char *from, size_t length)
+{
+  const char *end= from + length;
+  for (; from < end; from+= 2)
+  {
+    int hi= hex_digit_val((uchar) from[0]), lo= hex_digit_val((uchar) from[1]);
+    if ((hi | lo) < 0)
+      return (size_t) -1;
+    *to++= (uchar) ((hi << 4) | lo);
+  }
+  return length / 2;
+}
+
+
+#ifdef __SSE2__
+
+/* Map 16 nibbles (0..15) to '0'..'9', 'A'..'F' */
+static inline __m128i hex_nibbles_sse2(__m128i n)
+{
+  __m128i letter= _mm_cmpgt_epi8(n, _mm_set1_epi8(9));
+  return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')),
+                      _mm_and_si128(letter, _mm_set1_epi8('A' - '0' - 10)));
+}
+
+/*
+  Map 16 hex digits to their values. Bytes of *invalid are set to 0xFF
+  where the input was not a hex digit.
+*/
+
+static inline __m128i hex_values_sse2(__m128i c, __m128i *invalid)
+{
+  __m128i d= _mm_sub_epi8(c, _mm_set1_epi8('0'));
+  __m128i l= _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)),
+                          _mm_set1_epi8('a'));
+  __m128i is_digit= _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+  __m128i is_alpha= _mm_cmpeq_epi8(_mm_min_epu8(l, _mm_set1_epi8(5)), l);
+  *invalid= _mm_or_si128(*invalid,
+                         _mm_andnot_si128(_mm_or_si128(is_digit, is_alpha),
+                                          _mm_set1_epi8((char) 0xFF)));
+  return _mm_or_si128(_mm_and_si128(is_digit, d),
+                      _mm_and_si128(is_alpha,
+                                    _mm_add_epi8(l, _mm_set1_epi8(10))));
+}
+
+/* Combine pairs of nibble values (high first) into 16 bit values <= 255 */
+static inline __m128i hex_pairs_sse2(__m128i v)
+{
+  __m128i hi= _mm_and_si128(v, _mm_set1_epi16(0x00FF));
+  return _mm_or_si128(_mm_slli_epi16(hi, 4), _mm_srli_epi16(v, 8));
+}
+
+static size_t hex_encode_sse2(char *to, const uchar *from, size_t length)
+{
+  const uchar *end= from + (length & ~(size_t) 15);
+  char *to0= to;
+  for (; from < end; from+= 16, to+= 32)
+  {
+    __m128i v= _mm_loadu_si128((const __m128i*) from);
+    __m128i hi= hex_nibbles_sse2(_mm_and_si128(_mm_srli_epi16(v, 4),
+                                               _mm_set1_epi8(0x0F)));
+    __m128i lo= hex_nibbles_sse2(_mm_and_si128(v, _mm_set1_epi8(0x0F)));
+    _mm_storeu_si128((__m128i*) to, _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128((__m128i*) (to + 16), _mm_unpackhi_epi8(hi, lo));
+  }
+  return (size_t) (to - to0) + hex_encode_scalar(to, from, length & 15);
+}
+
+static size_t hex_decode_sse2(uchar *to, const char *from, size_t length)
+{
+  const char *end= from + (length & ~(size_t) 31);
+  uchar *to0= to;
+  size_t rest;
+  for (; from < end; from+= 32, to+= 16)
+  {
+    __m128i invalid= _mm_setzero_si128();
+    __m128i v0= hex_values_sse2(_mm_loadu_si128((const __m128i*) from),
+                                &invalid);
+    __m128i v1= hex_values_sse2(_mm_loadu_si128((const __m128i*) (from + 16)),
+                                &invalid);
+    if (_mm_movemask_epi8(invalid))
+      return (size_t) -1;
+    _mm_storeu_si128((__m128i*) to,
+                     _mm_packus_epi16(hex_pairs_sse2(v0), hex_pairs_sse2(v1)));
+  }
+  if ((rest= hex_decode_scalar(to, from, length & 31)) == (size_t) -1)
+    return rest;
+  return (size_t) (to - to0) + rest;
+}
+
+#endif /* __SSE2__ */
+
+
+#ifdef HEX_HAVE_AVX2
+
+#define HEX_AVX2 __attribute__((target("avx2")))
+
+static inline HEX_AVX2 __m256i hex_nibbles_avx2(__m256i n)
+{
+  __m256i letter= _mm256_cmpgt_epi8(n, _mm256_set1_epi8(9));
+  return _mm256_add_epi8(_mm256_add_epi8(n, _mm256_set1_epi8('0')),
+                         _mm256_and_si256(letter,
+                                          _mm256_set1_epi8('A' - '0' - 10)));
+}
+
+static inline HEX_AVX2 __m256i hex_values_avx2(__m256i c, __m256i *invalid)
+{
+  __m256i d= _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+  __m256i l= _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)),
+                             _mm256_set1_epi8('a'));
+  __m256i is_digit= _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)),
+                                      d);
+  __m256i is_alpha= _mm256_cmpeq_epi8(_mm256_min_epu8(l, _mm256_set1_epi8(5)),
+                                      l);
+  *invalid= _mm256_or_si256(*invalid,
+                            _mm256_andnot_si256(_mm256_or_si256(is_digit,
+                                                                is_alpha),
+                                                _mm256_set1_epi8((char) 0xFF)));
+  return _mm256_or_si256(_mm256_and_si256(is_digit, d),
+                         _mm256_and_si256(is_alpha,
+                                          _mm256_add_epi8(l,
+                                                          _mm256_set1_epi8(10))));
+}
+
+static inline HEX_AVX2 __m256i hex_pairs_avx2(__m256i v)
+{
+  __m256i hi= _mm256_and_si256(v, _mm256_set1_epi16(0x00FF));
+  return _mm256_or_si256(_mm256_slli_epi16(hi, 4), _mm256_srli_epi16(v, 8));
+}
+
+static HEX_AVX2 size_t hex_encode_avx2(char *to, const uchar *from,
+                                       size_t length)
+{
+  const uchar *end= from + (length & ~(size_t) 31);
+  char *to0= to;
+  for (; from < end; from+= 32, to+= 64)
+  {
+    __m256i v= _mm256_loadu_si256((const __m256i*) from);
+    __m256i hi= hex_nibbles_avx2(_mm256_and_si256(_mm256_srli_epi16(v, 4),
+                                                  _mm256_set1_epi8(0x0F)));
+    __m256i lo= hex_nibbles_avx2(_mm256_and_si256(v, _mm256_set1_epi8(0x0F)));
+    /* unpack works within 128 bit lanes; put the lanes back in order */
+    __m256i a= _mm256_unpacklo_epi8(hi, lo), b= _mm256_unpackhi_epi8(hi, lo);
+    _mm256_storeu_si256((__m256i*) to, _mm256_permute2x128_si256(a, b, 0x20));
+    _mm256_storeu_si256((__m256i*) (to + 32),
+                        _mm256_permute2x128_si256(a, b, 0x31));
+  }
+  return (size_t) (to - to0) + hex_encode_sse2(to, from, length & 31);
+}
+
+static HEX_AVX2 size_t hex_decode_avx2(uchar *to, const char *from,
+                                       size_t length)
+{
+  const char *end= from + (length & ~(size_t) 63);
+  uchar *to0= to;
+  size_t rest;
+  for (; from < end; from+= 64, to+= 32)
+  {
+    __m256i invalid= _mm256_setzero_si256();
+    __m256i v0= hex_values_avx2(_mm256_loadu_si256((const __m256i*) from),
+                                &invalid);
+    __m256i v1= hex_values_avx2(_mm256_loadu_si256((const __m256i*)
+                                                   (from + 32)), &invalid);
+    if (_mm256_movemask_epi8(invalid))
+      return (size_t) -1;
+    _mm256_storeu_si256((__m256i*) to,
+                        _mm256_permute4x64_epi64(
+                          _mm256_packus_epi16(hex_pairs_avx2(v0),
+                                              hex_pairs_avx2(v1)), 0xD8));
+  }
+  if ((rest= hex_decode_sse2(to, from, length & 63)) == (size_t) -1)
+    return rest;
+  return (size_t) (to - to0) + rest;
+}
+
+#endif /* HEX_HAVE_AVX2 */
+
+
+/*
+  The implementations are picked on the first call. The pointers are only
+  ever set to equivalent functions, so racing first calls are harmless.
+*/
+
+static size_t hex_encode_init(char *to, const uchar *from, size_t length);
+static size_t hex_decode_init(uchar *to, const char *from, size_t length);
+
+static size_t (*hex_encode_func)(char*, const uchar*, size_t)= hex_encode_init;
+static size_t (*hex_decode_func)(uchar*, const char*, size_t)= hex_decode_init;
+
+static void hex_select_impl(void)
+{
+#if defined(HEX_HAVE_AVX2)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+  {
+    hex_encode_func= hex_encode_avx2;
+    hex_decode_func= hex_decode_avx2;
+    return;
+  }
+#endif
+#if defined(__SSE2__)
+  hex_encode_func= hex_encode_sse2;
+  hex_decode_func= hex_decode_sse2;
+#else
+  hex_encode_func= hex_encode_scalar;
+  hex_decode_func= hex_decode_scalar;
+#endif
+}
+
+static size_t hex_encode_init(char *to, const uchar *from, size_t length)
+{
+  hex_select_impl();
+  return hex_encode_func(to, from, length);
+}
+
+static size_t hex_decode_init(uchar *to, const char *from, size_t length)
+{
+  hex_select_impl();
+  return hex_decode_func(to, from, length);
+}
+
+
+size_t my_hex_encode(char *to, const uchar *from, size_t length)
+{
+  return hex_encode_func(to, from, length);
+}
+
+
+size_t my_hex_decode(uchar *to, const char *from, size_t length)
+{
+  if (length & 1)
+    return (size_t) -1;
+  return hex_decode_func(to, from, length);
+}
@@ -1790,6 +1790,82 @@ static int test_bug9643(MYSQL *mysql)
   return OK;
 }
 
+/*
+  Cursor fetch with adaptive batch size and pipelined fetch requests
+*/
+
+static int test_cursor_prefetch_adaptive(MYSQL *mysql)
+{
+  MYSQL_STMT *stmt;
+  MYSQL_BIND my_bind[1];
+  int32 a;
+  int rc, i;
+  const char *stmt_text;
+  int num_rows= 0;
+  ulong type= (ulong) CURSOR_TYPE_READ_ONLY;
+  ulong prefetch_bytes= 4096, value;
+  my_bool pipeline= 1, flag;
+
+  rc= mysql_query(mysql, "drop table if exists t1");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "create table t1 (id integer not null primary key)");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "insert into t1 values (1)");
+  check_mysql_rc(rc, mysql);
+  for (i= 0; i < 10; i++)
+  {
+    rc= mysql_query(mysql, "insert into t1 select id + (select count(*) "
+                           "from t1) from t1");
+    check_mysql_rc(rc, mysql);
+  }
+
+  stmt= mysql_stmt_init(mysql);
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_CURSOR_TYPE, (void*) &type);
+  check_stmt_rc(rc, stmt);
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_PREFETCH_BYTES,
+                          (void*) &prefetch_bytes);
+  check_stmt_rc(rc, stmt);
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_PREFETCH_PIPELINE,
+                          (void*) &pipeline);
+  check_stmt_rc(rc, stmt);
+  mysql_stmt_attr_get(stmt, STMT_ATTR_PREFETCH_BYTES, (void*) &value);
+  FAIL_UNLESS(value == prefetch_bytes, "Wrong STMT_ATTR_PREFETCH_BYTES");
+  mysql_stmt_attr_get(stmt, STMT_ATTR_PREFETCH_PIPELINE, (void*) &flag);
+  FAIL_UNLESS(flag == 1, "Wrong STMT_ATTR_PREFETCH_PIPELINE");
+
+  stmt_text= "select id from t1 order by id";
+  rc= mysql_stmt_prepare(stmt, stmt_text, strlen(stmt_text));
+  check_stmt_rc(rc, stmt);
+
+  memset(my_bind, '\0', sizeof(my_bind));
+  my_bind[0].buffer_type= MYSQL_TYPE_LONG;
+  my_bind[0].buffer= (void*) &a;
+  my_bind[0].buffer_length= sizeof(a);
+  mysql_stmt_bind_result(stmt, my_bind);
+
+  rc= mysql_stmt_execute(stmt);
+  check_stmt_rc(rc, stmt);
+  while ((rc= mysql_stmt_fetch(stmt)) == 0)
+  {
+    ++num_rows;
+    FAIL_UNLESS(a == num_rows, "Wrong row");
+  }
+  FAIL_UNLESS(rc == MYSQL_NO_DATA, mysql_stmt_error(stmt));
+  FAIL_UNLESS(num_rows == 1024, "num_rows != 1024");
+
+  /* Statement is closed while a fetch is still in flight */
+  rc= mysql_stmt_execute(stmt);
+  check_stmt_rc(rc, stmt);
+  rc= mysql_stmt_fetch(stmt);
+  check_stmt_rc(rc, stmt);
+  rc= mysql_stmt_close(stmt);
+  FAIL_UNLESS(rc == 0, "");
+
+  rc= mysql_query(mysql, "drop table t1");
+  check_mysql_rc(rc, mysql);
+  return OK;
+}
+
 
 struct my_tests_st my_tests[] = {
   {"test_basic_cursors", test_basic_cursors, TEST_CONNECTION_DEFAULT, 0, NULL , NULL},
@@ -1818,6 +1894,7 @@ struct my_tests_st my_tests[] = {
   {"test_bug9478", test_bug9478, TEST_CONNECTION_DEFAULT, 0, NULL , NULL},
   {"test_bug9520", test_bug9520, TEST_CONNECTION_DEFAULT, 0, NULL , NULL},
   {"test_bug9643", test_bug9643, TEST_CONNECTION_DEFAULT, 0, NULL , NULL},
+  {"test_cursor_prefetch_adaptive", test_cursor_prefetch_adaptive, TEST_CONNECTION_DEFAULT, 0, NULL , NULL},
   {NULL, NULL, 0, 0, NULL, NULL}
 };
 
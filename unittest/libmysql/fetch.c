@@ -343,6 +343,105 @@ static int test_fetch_offset(MYSQL *mysql)
   return OK;
 }
 
+/* Test STMT_ATTR_ROW_OFFSETS: columns fetched without binding, in any order */
+
+static int test_fetch_row_offsets(MYSQL *mysql)
+{
+  MYSQL_STMT *stmt;
+  MYSQL_BIND my_bind[1], res_bind[3];
+  char       data[20];
+  ulong      length;
+  my_bool    is_null, on= 1, value= 0;
+  int        rc, a;
+  double     c;
+  char       *query= "SELECT a, b, c FROM t1 ORDER BY a";
+
+  rc= mysql_query(mysql, "drop table if exists t1");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "create table t1(a int, b varchar(10), c double)");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "insert into t1 values(1, 'one', 1.5), "
+                         "(2, null, 2.5), (3, 'three', null)");
+  check_mysql_rc(rc, mysql);
+
+  stmt= mysql_stmt_init(mysql);
+  FAIL_IF(!stmt, mysql_error(mysql));
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_ROW_OFFSETS, &on);
+  FAIL_IF(rc, "Can't set STMT_ATTR_ROW_OFFSETS");
+  rc= mysql_stmt_attr_get(stmt, STMT_ATTR_ROW_OFFSETS, &value);
+  FAIL_IF(rc || !value, "Wrong STMT_ATTR_ROW_OFFSETS");
+
+  rc= mysql_stmt_prepare(stmt, query, strlen(query));
+  check_stmt_rc(rc,stmt);
+  rc= mysql_stmt_execute(stmt);
+  check_stmt_rc(rc,stmt);
+  rc= mysql_stmt_store_result(stmt);
+  check_stmt_rc(rc,stmt);
+
+  memset(my_bind, '\0', sizeof(my_bind));
+  my_bind[0].buffer_type= MYSQL_TYPE_STRING;
+  my_bind[0].buffer= (void *)data;
+  my_bind[0].buffer_length= sizeof(data);
+  my_bind[0].is_null= &is_null;
+  my_bind[0].length= &length;
+
+  /* No mysql_stmt_bind_result(): last column first */
+  rc= mysql_stmt_fetch(stmt);
+  check_stmt_rc(rc,stmt);
+  rc= mysql_stmt_fetch_column(stmt, my_bind, 2, 0);
+  check_stmt_rc(rc,stmt);
+  FAIL_IF(is_null || strcmp(data, "1.5"), "Wrong value for c");
+  rc= mysql_stmt_fetch_column(stmt, my_bind, 1, 1);
+  check_stmt_rc(rc,stmt);
+  FAIL_IF(is_null || length != 3 || strncmp(data, "ne", 2),
+          "Wrong value for b");
+
+  rc= mysql_stmt_fetch(stmt);
+  check_stmt_rc(rc,stmt);
+  rc= mysql_stmt_fetch_column(stmt, my_bind, 1, 0);
+  check_stmt_rc(rc,stmt);
+  FAIL_IF(!is_null, "Null flag not set");
+
+  /* Reading a row again after a seek */
+  mysql_stmt_data_seek(stmt, 2);
+  rc= mysql_stmt_fetch(stmt);
+  check_stmt_rc(rc,stmt);
+  rc= mysql_stmt_fetch_column(stmt, my_bind, 2, 0);
+  check_stmt_rc(rc,stmt);
+  FAIL_IF(!is_null, "Null flag not set");
+  rc= mysql_stmt_fetch_column(stmt, my_bind, 1, 0);
+  check_stmt_rc(rc,stmt);
+  FAIL_IF(is_null || strcmp(data, "three"), "Wrong value for b");
+
+  /* Bound columns are filled from the table as well */
+  memset(res_bind, '\0', sizeof(res_bind));
+  res_bind[0].buffer_type= MYSQL_TYPE_LONG;
+  res_bind[0].buffer= (void *)&a;
+  res_bind[1].buffer_type= MYSQL_TYPE_STRING;
+  res_bind[1].buffer= (void *)data;
+  res_bind[1].buffer_length= sizeof(data);
+  res_bind[1].is_null= &is_null;
+  res_bind[2].buffer_type= MYSQL_TYPE_DOUBLE;
+  res_bind[2].buffer= (void *)&c;
+  rc= mysql_stmt_execute(stmt);
+  check_stmt_rc(rc,stmt);
+  rc= mysql_stmt_store_result(stmt);
+  check_stmt_rc(rc,stmt);
+  rc= mysql_stmt_bind_result(stmt, res_bind);
+  check_stmt_rc(rc,stmt);
+  mysql_stmt_data_seek(stmt, 1);
+  rc= mysql_stmt_fetch(stmt);
+  check_stmt_rc(rc,stmt);
+  FAIL_IF(a != 2 || !is_null || c != 2.5, "Wrong values");
+
+  mysql_stmt_close(stmt);
+
+  rc= mysql_query(mysql, "drop table t1");
+  check_mysql_rc(rc, mysql);
+
+  return OK;
+}
+
 /* Test mysql_stmt_fetch_column() */
 
 static int test_fetch_column(MYSQL *mysql)
@@ -866,6 +965,7 @@ struct my_tests_st my_tests[] = {
   {"test_fetch_seek", test_fetch_seek, 1, 0, NULL , NULL},
   {"test_fetch_offset", test_fetch_offset, 1, 0, NULL , NULL},
   {"test_fetch_column", test_fetch_column, 1, 0, NULL , NULL},
+  {"test_fetch_row_offsets", test_fetch_row_offsets, 1, 0, NULL , NULL},
   {"test_fetch_nobuffs", test_fetch_nobuffs, 1, 0, NULL , NULL},
   {"test_fetch_null", test_fetch_null, 1, 0, NULL , NULL},
   {"test_fetch_date", test_fetch_date, 1, 0, NULL , NULL},
@@ -763,6 +763,132 @@ static int test_wl4284_1(MYSQL *mysql)
 }
 
 
+/*
+  LOAD DATA LOCAL INFILE through all the ways the file is sent: sendfile()
+  or the reader thread with the default handler, and read and send in
+  turn or the reader thread with a handler of our own.
+*/
+
+#define INFILE_ROWS 100000
+
+static int infile_init(void **ptr, const char *filename,
+                       void *userdata __attribute__((unused)))
+{
+  return !(*ptr= fopen(filename, "rb"));
+}
+
+static int infile_read(void *ptr, char *buf, unsigned int buf_len)
+{
+  /* Odd sized blocks, rows are split across packets */
+  return (int) fread(buf, 1, buf_len / 3 + 1, (FILE*) ptr);
+}
+
+static void infile_end(void *ptr)
+{
+  if (ptr)
+    fclose((FILE*) ptr);
+}
+
+static int infile_error(void *ptr __attribute__((unused)),
+                        char *error_msg, unsigned int error_msg_len)
+{
+  strncpy(error_msg, "Can't read infile", error_msg_len);
+  return CR_UNKNOWN_ERROR;
+}
+
+static int test_local_infile(MYSQL *mysql __attribute__((unused)))
+{
+  const char *fname= "local_infile.txt";
+  MYSQL_RES *res;
+  MYSQL_ROW row;
+  FILE *file;
+  ulonglong start;
+  char query[128];
+  my_bool on= 1;
+  int rc, i, j, use;
+
+  FAIL_IF(!(file= fopen(fname, "wb")), "Can't create infile");
+  for (i= 0; i < INFILE_ROWS; i++)
+  {
+    fprintf(file, "%d\t", i);
+    for (j= i % 100; j; j--)
+      fputc('x', file);
+    fputc('\n', file);
+  }
+  fclose(file);
+
+  for (use= 0; use < 4; use++)
+  {
+    MYSQL *conn= mysql_init(NULL);
+    FAIL_IF(!conn, "not enough memory");
+    rc= mysql_options(conn, MYSQL_OPT_LOCAL_INFILE, NULL);
+    FAIL_IF(rc, "Can't set MYSQL_OPT_LOCAL_INFILE");
+    if (use & 1)
+      FAIL_IF(mysql_options(conn, MYSQL_OPT_COMPRESS, NULL),
+              "Can't set MYSQL_OPT_COMPRESS");
+    if (use & 2)
+    {
+      mysql_set_local_infile_handler(conn, infile_init, infile_read,
+                                     infile_end, infile_error, NULL);
+      FAIL_IF(use == 3 &&
+              mysql_options(conn, MYSQL_OPT_LOCAL_INFILE_THREAD, &on),
+              "Can't set MYSQL_OPT_LOCAL_INFILE_THREAD");
+    }
+    if (!mysql_real_connect(conn, hostname, username, password, schema,
+                            port, socketname, 0))
+    {
+      diag("connection failed");
+      mysql_close(conn);
+      unlink(fname);
+      return FAIL;
+    }
+
+    rc= mysql_query(conn, "DROP TABLE IF EXISTS t_local_infile");
+    check_mysql_rc(rc, conn);
+    rc= mysql_query(conn, "CREATE TABLE t_local_infile (a int, b varchar(100))");
+    check_mysql_rc(rc, conn);
+
+    start= my_getsystime();
+    sprintf(query, "LOAD DATA LOCAL INFILE '%s' INTO TABLE t_local_infile",
+            fname);
+    if ((rc= mysql_query(conn, query)) &&
+        mysql_errno(conn) == 1148)            /* ER_NOT_ALLOWED_COMMAND */
+    {
+      mysql_close(conn);
+      unlink(fname);
+      diag("Test requires local_infile enabled in the server");
+      return SKIP;
+    }
+    check_mysql_rc(rc, conn);
+    diag("LOAD DATA LOCAL INFILE %s%s: %.3fs",
+         use & 2 ? "own handler" : "default handler",
+         use == 1 ? ", compressed" :
+         use == 3 ? ", compressed, read thread" : "",
+         (double) (my_getsystime() - start) / 10000000.0);
+
+    rc= mysql_query(conn, "SELECT COUNT(*), SUM(a), SUM(LENGTH(b)) "
+                          "FROM t_local_infile");
+    check_mysql_rc(rc, conn);
+    res= mysql_store_result(conn);
+    FAIL_IF(!res, "Invalid result set");
+    row= mysql_fetch_row(res);
+    FAIL_UNLESS(atol(row[0]) == INFILE_ROWS, "Wrong row count");
+    FAIL_UNLESS(strtoull(row[1], NULL, 10) ==
+                (ulonglong) INFILE_ROWS * (INFILE_ROWS - 1) / 2,
+                "Wrong values");
+    FAIL_UNLESS(strtoull(row[2], NULL, 10) == (INFILE_ROWS / 100) * 4950,
+                "Wrong lengths");
+    mysql_free_result(res);
+
+    rc= mysql_query(conn, "DROP TABLE t_local_infile");
+    check_mysql_rc(rc, conn);
+    mysql_close(conn);
+  }
+  unlink(fname);
+  return OK;
+}
+
+
 struct my_tests_st my_tests[] = {
   {"test_bug28075", test_bug28075, TEST_CONNECTION_DEFAULT, 0,  NULL, NULL},
   {"test_bug28505", test_bug28505, TEST_CONNECTION_DEFAULT, 0,  NULL, NULL},
@@ -776,6 +902,7 @@ struct my_tests_st my_tests[] = {
   {"test_wl4166_3", test_wl4166_3, TEST_CONNECTION_NEW, 0,  NULL, NULL},
   {"test_wl4166_4", test_wl4166_4, TEST_CONNECTION_NEW, 0,  NULL, NULL},
   {"test_wl4284_1", test_wl4284_1, TEST_CONNECTION_NEW, 0,  NULL, NULL},
+  {"test_local_infile", test_local_infile, TEST_CONNECTION_NONE, 0,  NULL, NULL},
   {NULL, NULL, 0, 0, NULL, 0}
 };
 
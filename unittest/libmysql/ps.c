@@ -1494,6 +1494,86 @@ static int test_long_data_bin(MYSQL *mysql)
 }
 
 
+/* Test long data streaming */
+
+static int test_long_data_stream(MYSQL *mysql)
+{
+  MYSQL_STMT *stmt;
+  int        rc, i, fd;
+  char       *data;
+  MYSQL_BIND my_bind[2];
+  char query[MAX_TEST_QUERY_LENGTH];
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS test_long_data_stream");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "CREATE TABLE test_long_data_stream(col1 longblob, "
+                         "col2 longblob)");
+  check_mysql_rc(rc, mysql);
+
+  strcpy(query, "INSERT INTO test_long_data_stream VALUES(?, ?)");
+  stmt= mysql_stmt_init(mysql);
+  FAIL_IF(!stmt, mysql_error(mysql));
+  rc= mysql_stmt_prepare(stmt, query, strlen(query));
+  check_stmt_rc(rc, stmt);
+
+  memset(my_bind, '\0', sizeof(my_bind));
+  my_bind[0].buffer_type= MYSQL_TYPE_BLOB;
+  my_bind[1].buffer_type= MYSQL_TYPE_BLOB;
+  rc= mysql_stmt_bind_param(stmt, my_bind);
+  check_stmt_rc(rc, stmt);
+
+  /* no open stream */
+  rc= mysql_stmt_long_data_write(stmt, "a", 1);
+  FAIL_IF(!rc, "Error expected");
+
+  data= (char *)malloc(600000);
+  memset(data, 'a', 600000);
+
+  /* many small pieces and one big piece */
+  rc= mysql_stmt_long_data_open(stmt, 0);
+  check_stmt_rc(rc, stmt);
+  for (i= 0; i < 100; i++)
+  {
+    rc= mysql_stmt_long_data_write(stmt, data, 3000);
+    check_stmt_rc(rc, stmt);
+  }
+  rc= mysql_stmt_long_data_write(stmt, data, 600000);
+  check_stmt_rc(rc, stmt);
+  free(data);
+  rc= mysql_stmt_long_data_close(stmt);
+  check_stmt_rc(rc, stmt);
+
+  /* empty stream, closed by execute */
+  rc= mysql_stmt_long_data_open(stmt, 1);
+  check_stmt_rc(rc, stmt);
+
+  /* a read error is a client error of the statement */
+  fd= open(".", O_RDONLY);
+  FAIL_IF(fd < 0, "Can't open directory");
+  rc= mysql_stmt_long_data_write_fd(stmt, fd);
+  close(fd);
+  FAIL_IF(!rc, "Error expected");
+  FAIL_UNLESS(mysql_stmt_errno(stmt) == CR_FILE_READ, "Wrong error code");
+  FAIL_UNLESS(strstr(mysql_stmt_error(stmt), "Errcode"), "Wrong error message");
+
+  rc= mysql_stmt_execute(stmt);
+  check_stmt_rc(rc, stmt);
+  mysql_stmt_close(stmt);
+
+  if (verify_col_data(mysql, "test_long_data_stream", "length(col1)", "900000"))
+    return FAIL;
+  if (verify_col_data(mysql, "test_long_data_stream", "col2", ""))
+    return FAIL;
+  if (verify_col_data(mysql, "test_long_data_stream",
+                      "col1 = repeat('a', 900000)", "1"))
+    return FAIL;
+
+  rc= mysql_query(mysql, "DROP TABLE test_long_data_stream");
+  check_mysql_rc(rc, mysql);
+  return OK;
+}
+
+
 /* Test simple delete */
 
 static int test_simple_delete(MYSQL *mysql)
@@ -4542,6 +4622,7 @@ struct my_tests_st my_tests[] = {
   {"test_long_data_str", test_long_data_str, TEST_CONNECTION_DEFAULT, 0, NULL , NULL},
   {"test_long_data_str1", test_long_data_str1, TEST_CONNECTION_DEFAULT, 0, NULL , NULL},
   {"test_long_data_bin", test_long_data_bin, TEST_CONNECTION_DEFAULT, 0, NULL , NULL},
+  {"test_long_data_stream", test_long_data_stream, TEST_CONNECTION_DEFAULT, 0, NULL , NULL},
   {"test_simple_update", test_simple_update, TEST_CONNECTION_DEFAULT, 0, NULL , NULL},
   {"test_simple_delete", test_simple_delete, TEST_CONNECTION_DEFAULT, 0, NULL , NULL},
   {"test_update", test_update, TEST_CONNECTION_DEFAULT, 0, NULL , NULL},
@@ -1020,6 +1020,746 @@ DROP TABLE IF EXISTS test_multi_tab";
 
 
 
+struct stream_sum
+{
+  ulong length;
+  uint  calls;
+};
+
+static my_bool stream_count(void *arg, const char *data, unsigned long length)
+{
+  struct stream_sum *sum= (struct stream_sum *)arg;
+  ulong i;
+  for (i= 0; i < length; i++)
+    if (data[i] != 'x')
+      return 1;
+  sum->length+= length;
+  sum->calls++;
+  return 0;
+}
+
+static int test_fetch_row_stream(MYSQL *mysql)
+{
+  MYSQL_RES *result;
+  MYSQL_ROW row;
+  struct stream_sum sum;
+  int rc, rowcount= 0;
+
+  rc= mysql_query(mysql, "SELECT 1, REPEAT('x', 1000000), 'abc' UNION ALL "
+                         "SELECT 2, REPEAT('x', 10), 'def'");
+  check_mysql_rc(rc, mysql);
+
+  result= mysql_use_result(mysql);
+  FAIL_IF(!result, "Invalid result set");
+
+  /* invalid column number */
+  FAIL_IF(mysql_fetch_row_stream(result, 3, stream_count, &sum),
+          "Error expected");
+  FAIL_UNLESS(mysql_errno(mysql) == CR_INVALID_PARAMETER_NO,
+              "Wrong error code");
+
+  memset(&sum, 0, sizeof(sum));
+  while ((row= mysql_fetch_row_stream(result, 1, stream_count, &sum)))
+  {
+    rowcount++;
+    FAIL_UNLESS(atoi(row[0]) == rowcount, "Wrong value in column 0");
+    FAIL_UNLESS(strlen(row[2]) == 3, "Wrong value in column 2");
+    FAIL_UNLESS(mysql_fetch_lengths(result)[2] == 3, "Wrong length");
+  }
+  FAIL_UNLESS(rowcount == 2, "rowcount != 2");
+  FAIL_UNLESS(sum.length == 1000010, "Wrong streamed length");
+  FAIL_UNLESS(sum.calls >= 2, "Callback not called for every row");
+
+  mysql_free_result(result);
+  return OK;
+}
+
+
+/*
+  A streamed column is an empty string in the row, while its length is
+  the full one; the typed accessors must not read it.
+*/
+static int test_fetch_row_stream_typed(MYSQL *mysql)
+{
+  MYSQL_RES *result;
+  MYSQL_ROW row;
+  struct stream_sum sum;
+  long long ival;
+  int rc;
+
+  rc= mysql_query(mysql, "SELECT 1, REPEAT('1', 1000000) UNION ALL "
+                         "SELECT 2, '42'");
+  check_mysql_rc(rc, mysql);
+  result= mysql_use_result(mysql);
+  FAIL_IF(!result, "Invalid result set");
+
+  memset(&sum, 0, sizeof(sum));
+  row= mysql_fetch_row_stream(result, 1, stream_count, &sum);
+  FAIL_IF(!row, mysql_error(mysql));
+  FAIL_UNLESS(mysql_fetch_lengths(result)[1] == 1000000, "Wrong length");
+  FAIL_UNLESS(mysql_fetch_int64(result, 1, &ival, NULL) == 1,
+              "Error expected");
+  FAIL_UNLESS(mysql_errno(mysql) == CR_NO_DATA, "Wrong error code");
+  FAIL_UNLESS(mysql_fetch_int64(result, 0, &ival, NULL) == 0 && ival == 1,
+              "Wrong value in column 0");
+
+  /* the next row is small enough not to be streamed */
+  row= mysql_fetch_row_stream(result, 1, stream_count, &sum);
+  FAIL_IF(!row, mysql_error(mysql));
+  FAIL_UNLESS(mysql_fetch_int64(result, 1, &ival, NULL) == 0 && ival == 42,
+              "Wrong value in column 1");
+  FAIL_IF(mysql_fetch_row(result), "Only two rows expected");
+
+  mysql_free_result(result);
+  return OK;
+}
+
+
+/*
+  A row of one column with 0xFFFFFF-4 bytes is exactly one full packet
+  followed by an empty one, a 0xFFFFFF byte value takes the column
+  header into a second packet.
+*/
+static int test_fetch_row_stream_max_packet(MYSQL *mysql)
+{
+  MYSQL_RES *result;
+  MYSQL_ROW row;
+  struct stream_sum sum;
+  char query[128];
+  unsigned long lengths[2]= {0xFFFFFF - 4, 0xFFFFFF};
+  int rc, i;
+
+  rc= mysql_query(mysql, "SELECT @@max_allowed_packet");
+  check_mysql_rc(rc, mysql);
+  result= mysql_store_result(mysql);
+  FAIL_IF(!result, "Invalid result set");
+  row= mysql_fetch_row(result);
+  FAIL_IF(!row, "Row expected");
+  if (strtoul(row[0], NULL, 10) < 0xFFFFFF + 16)
+  {
+    mysql_free_result(result);
+    diag("Test requires max_allowed_packet of 16M or more");
+    return SKIP;
+  }
+  mysql_free_result(result);
+
+  for (i= 0; i < 2; i++)
+  {
+    sprintf(query, "SELECT REPEAT('x', %lu)", lengths[i]);
+    rc= mysql_query(mysql, query);
+    check_mysql_rc(rc, mysql);
+    result= mysql_use_result(mysql);
+    FAIL_IF(!result, "Invalid result set");
+
+    memset(&sum, 0, sizeof(sum));
+    row= mysql_fetch_row_stream(result, 0, stream_count, &sum);
+    FAIL_IF(!row, mysql_error(mysql));
+    FAIL_UNLESS(mysql_fetch_lengths(result)[0] == lengths[i], "Wrong length");
+    FAIL_UNLESS(sum.length == lengths[i], "Wrong streamed length");
+    FAIL_IF(mysql_fetch_row_stream(result, 0, stream_count, &sum),
+            "Only one row expected");
+    FAIL_IF(mysql_errno(mysql), mysql_error(mysql));
+    mysql_free_result(result);
+
+    /* the same without a callback is a plain fetch */
+    rc= mysql_query(mysql, query);
+    check_mysql_rc(rc, mysql);
+    result= mysql_store_result(mysql);
+    FAIL_IF(!result, "Invalid result set");
+    row= mysql_fetch_row_stream(result, 0, NULL, NULL);
+    FAIL_IF(!row, "Row expected");
+    FAIL_UNLESS(mysql_fetch_lengths(result)[0] == lengths[i], "Wrong length");
+    mysql_free_result(result);
+  }
+  return OK;
+}
+
+static int test_fetch_typed(MYSQL *mysql)
+{
+  MYSQL_RES *result;
+  MYSQL_ROW row;
+  MYSQL_TIME tm;
+  long long ival, ivals[4];
+  unsigned long long uval, uvals[4];
+  double dval, dvals[4];
+  my_bool is_null, nulls[4];
+  int rc, status[4];
+  unsigned long rows;
+  int use;
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t_fetch_typed");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "CREATE TABLE t_fetch_typed (a bigint, b bigint unsigned, "
+                         "c double, d datetime, e time, f varchar(20))");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "INSERT INTO t_fetch_typed VALUES "
+                         "(-9223372036854775808, 18446744073709551615, 2.5, "
+                         "'2010-02-03 04:05:06', '-838:59:59', '12abc'), "
+                         "(1, 2, -1e300, '0000-00-00 00:00:00', '01:02:03', '7'), "
+                         "(NULL, NULL, NULL, NULL, NULL, NULL)");
+  check_mysql_rc(rc, mysql);
+
+  for (use= 0; use < 2; use++)
+  {
+    rc= mysql_query(mysql, "SELECT * FROM t_fetch_typed");
+    check_mysql_rc(rc, mysql);
+    result= use ? mysql_use_result(mysql) : mysql_store_result(mysql);
+    FAIL_IF(!result, "Invalid result set");
+
+    FAIL_UNLESS(mysql_fetch_int64(result, 0, &ival, NULL) == 1,
+                "Error expected");
+
+    row= mysql_fetch_row(result);
+    FAIL_IF(!row, "Row expected");
+    FAIL_UNLESS(mysql_fetch_int64(result, 0, &ival, &is_null) == 0 &&
+                !is_null && ival == -9223372036854775807LL - 1,
+                "Wrong bigint value");
+    FAIL_UNLESS(mysql_fetch_int64(result, 1, &ival, NULL) ==
+                MYSQL_DATA_TRUNCATED && ival == 9223372036854775807LL,
+                "Unsigned overflow expected");
+    FAIL_UNLESS(result->fields[1].flags & UNSIGNED_FLAG, "Unsigned expected");
+    FAIL_UNLESS(mysql_fetch_uint64(result, 1, &uval, &is_null) == 0 &&
+                !is_null && uval == 18446744073709551615ULL,
+                "Wrong unsigned bigint value");
+    FAIL_UNLESS(mysql_fetch_uint64(result, 0, &uval, NULL) ==
+                MYSQL_DATA_TRUNCATED && uval == 0,
+                "Negative value truncation expected");
+    FAIL_UNLESS(mysql_fetch_double(result, 2, &dval, NULL) == 0 &&
+                dval == 2.5, "Wrong double value");
+    FAIL_UNLESS(mysql_fetch_datetime(result, 3, &tm, NULL) == 0 &&
+                tm.year == 2010 && tm.month == 2 && tm.day == 3 &&
+                tm.hour == 4 && tm.minute == 5 && tm.second == 6,
+                "Wrong datetime value");
+    FAIL_UNLESS(mysql_fetch_datetime(result, 4, &tm, NULL) == 0 && tm.neg &&
+                tm.hour == 838 && tm.minute == 59, "Wrong time value");
+    FAIL_UNLESS(mysql_fetch_int64(result, 5, &ival, NULL) ==
+                MYSQL_DATA_TRUNCATED && ival == 12, "Truncation expected");
+    FAIL_UNLESS(mysql_fetch_int64(result, 3, &ival, NULL) == 1,
+                "Error expected");
+    FAIL_UNLESS(mysql_errno(mysql) == CR_UNSUPPORTED_PARAM_TYPE || !use,
+                "Wrong error code");
+    FAIL_UNLESS(mysql_fetch_datetime(result, 0, &tm, NULL) == 1,
+                "Error expected");
+    FAIL_UNLESS(mysql_fetch_double(result, 6, &dval, NULL) == 1,
+                "Error expected");
+
+    rows= mysql_fetch_double_batch(result, 2, dvals, nulls, status, 4);
+    FAIL_UNLESS(rows == 2, "Wrong number of rows");
+    FAIL_UNLESS(status[0] == 0 && !nulls[0] && dvals[0] == -1e300,
+                "Wrong double value");
+    FAIL_UNLESS(status[1] == 0 && nulls[1] && dvals[1] == 0.0,
+                "NULL expected");
+    FAIL_UNLESS(mysql_fetch_int64_batch(result, 0, ivals, NULL, NULL, 4) == 0,
+                "End of result expected");
+    mysql_free_result(result);
+  }
+
+  /* NULL in each accessor */
+  rc= mysql_query(mysql, "SELECT * FROM t_fetch_typed WHERE a IS NULL");
+  check_mysql_rc(rc, mysql);
+  result= mysql_store_result(mysql);
+  FAIL_IF(!result, "Invalid result set");
+  FAIL_IF(!mysql_fetch_row(result), "Row expected");
+  is_null= 0;
+  FAIL_UNLESS(mysql_fetch_int64(result, 0, &ival, &is_null) == 0 &&
+              is_null && ival == 0, "NULL expected");
+  is_null= 0;
+  FAIL_UNLESS(mysql_fetch_uint64(result, 1, &uval, &is_null) == 0 &&
+              is_null && uval == 0, "NULL expected");
+  is_null= 0;
+  FAIL_UNLESS(mysql_fetch_double(result, 2, &dval, &is_null) == 0 &&
+              is_null, "NULL expected");
+  is_null= 0;
+  FAIL_UNLESS(mysql_fetch_datetime(result, 3, &tm, &is_null) == 0 &&
+              is_null && tm.time_type == MYSQL_TIMESTAMP_NONE,
+              "NULL expected");
+  mysql_free_result(result);
+
+  rc= mysql_query(mysql, "SELECT f FROM t_fetch_typed");
+  check_mysql_rc(rc, mysql);
+  result= mysql_store_result(mysql);
+  FAIL_IF(!result, "Invalid result set");
+  rows= mysql_fetch_int64_batch(result, 0, ivals, nulls, status, 4);
+  FAIL_UNLESS(rows == 3, "Wrong number of rows");
+  FAIL_UNLESS(status[0] == MYSQL_DATA_TRUNCATED && status[1] == 0 &&
+              ivals[1] == 7 && !nulls[1] && status[2] == 0 && nulls[2],
+              "Wrong values");
+  mysql_free_result(result);
+
+  rc= mysql_query(mysql, "SELECT b FROM t_fetch_typed");
+  check_mysql_rc(rc, mysql);
+  result= mysql_store_result(mysql);
+  FAIL_IF(!result, "Invalid result set");
+  rows= mysql_fetch_uint64_batch(result, 0, uvals, nulls, status, 4);
+  FAIL_UNLESS(rows == 3, "Wrong number of rows");
+  FAIL_UNLESS(status[0] == 0 && uvals[0] == 18446744073709551615ULL &&
+              status[1] == 0 && uvals[1] == 2 && !nulls[1] && nulls[2],
+              "Wrong values");
+  mysql_free_result(result);
+
+  /* no result set at all */
+  FAIL_UNLESS(mysql_fetch_int64(NULL, 0, &ival, NULL) == 1, "Error expected");
+  FAIL_UNLESS(mysql_fetch_uint64(NULL, 0, &uval, NULL) == 1, "Error expected");
+  FAIL_UNLESS(mysql_fetch_double(NULL, 0, &dval, NULL) == 1, "Error expected");
+  FAIL_UNLESS(mysql_fetch_datetime(NULL, 0, &tm, NULL) == 1, "Error expected");
+  FAIL_UNLESS(mysql_fetch_int64_batch(NULL, 0, ivals, NULL, status, 4) == 0 &&
+              mysql_fetch_double_batch(NULL, 0, dvals, NULL, status, 4) == 0,
+              "No rows expected");
+
+  rc= mysql_query(mysql, "DROP TABLE t_fetch_typed");
+  check_mysql_rc(rc, mysql);
+  return OK;
+}
+
+
+static int compare_fields(MYSQL_FIELD *a, MYSQL_FIELD *b, unsigned int count)
+{
+  unsigned int i;
+  for (i= 0; i < count; i++)
+  {
+    FAIL_UNLESS(!strcmp(a[i].name, b[i].name) &&
+                !strcmp(a[i].org_name, b[i].org_name) &&
+                !strcmp(a[i].table, b[i].table) &&
+                !strcmp(a[i].org_table, b[i].org_table) &&
+                !strcmp(a[i].db, b[i].db) &&
+                !strcmp(a[i].catalog, b[i].catalog), "Different field names");
+    FAIL_UNLESS(a[i].name_length == b[i].name_length &&
+                a[i].table_length == b[i].table_length &&
+                a[i].type == b[i].type && a[i].flags == b[i].flags &&
+                a[i].length == b[i].length &&
+                a[i].charsetnr == b[i].charsetnr &&
+                a[i].decimals == b[i].decimals, "Different field attributes");
+    FAIL_UNLESS((!a[i].def && !b[i].def) ||
+                (a[i].def && b[i].def && !strcmp(a[i].def, b[i].def)),
+                "Different default values");
+  }
+  return OK;
+}
+
+static int test_lazy_metadata(MYSQL *mysql)
+{
+  MYSQL_RES *res[2], *list[2], *meta;
+  MYSQL_STMT *stmt;
+  const char *query= "SELECT a, b AS bb, c FROM t_lazy_metadata t1";
+  my_bool lazy;
+  int rc, i;
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t_lazy_metadata");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "CREATE TABLE t_lazy_metadata (a int unsigned not null "
+                         "default 5, b varchar(30) default 'abc', c double(8,3))");
+  check_mysql_rc(rc, mysql);
+
+  for (i= 0; i < 2; i++)
+  {
+    lazy= i;
+    rc= mysql_options(mysql, MYSQL_OPT_LAZY_METADATA, &lazy);
+    check_mysql_rc(rc, mysql);
+    rc= mysql_query(mysql, query);
+    check_mysql_rc(rc, mysql);
+    res[i]= mysql_store_result(mysql);
+    FAIL_IF(!res[i], "Invalid result set");
+    list[i]= mysql_list_fields(mysql, "t_lazy_metadata", NULL);
+    FAIL_IF(!list[i], "Invalid result set");
+  }
+  FAIL_UNLESS(!strcmp(res[1]->fields[1].name, "bb") &&
+              !strcmp(res[1]->fields[1].org_name, "b") &&
+              !strcmp(res[1]->fields[1].table, "t1"), "Wrong field names");
+  if (compare_fields(res[0]->fields, res[1]->fields, 3) ||
+      compare_fields(list[0]->fields, list[1]->fields, 3))
+    return FAIL;
+
+  stmt= mysql_stmt_init(mysql);
+  FAIL_IF(!stmt, mysql_error(mysql));
+  rc= mysql_stmt_prepare(stmt, query, strlen(query));
+  check_stmt_rc(rc, stmt);
+  meta= mysql_stmt_result_metadata(stmt);
+  FAIL_IF(!meta, "Invalid result set");
+  if (compare_fields(res[0]->fields, meta->fields, 3))
+    return FAIL;
+  mysql_free_result(meta);
+  mysql_stmt_close(stmt);
+
+  for (i= 0; i < 2; i++)
+  {
+    mysql_free_result(res[i]);
+    mysql_free_result(list[i]);
+  }
+  lazy= 0;
+  rc= mysql_options(mysql, MYSQL_OPT_LAZY_METADATA, &lazy);
+  check_mysql_rc(rc, mysql);
+
+  rc= mysql_query(mysql, "DROP TABLE t_lazy_metadata");
+  check_mysql_rc(rc, mysql);
+  return OK;
+}
+
+static int read_all_rows(MYSQL *mysql, my_bool parallel, ulonglong *checksum,
+                         double *elapsed)
+{
+  MYSQL_RES *result;
+  MYSQL_ROW row;
+  unsigned long *lengths;
+  ulonglong start;
+  int rc;
+
+  rc= mysql_options(mysql, MYSQL_OPT_PARALLEL_READ, &parallel);
+  check_mysql_rc(rc, mysql);
+
+  start= my_getsystime();
+  rc= mysql_query(mysql, "SELECT a, b FROM t_parallel_read ORDER BY a");
+  check_mysql_rc(rc, mysql);
+  result= mysql_store_result(mysql);
+  FAIL_IF(!result, "Invalid result set");
+  *elapsed= (double)(my_getsystime() - start) / 10000000.0;
+
+  *checksum= 0;
+  while ((row= mysql_fetch_row(result)))
+  {
+    lengths= mysql_fetch_lengths(result);
+    *checksum= *checksum * 31 + atoi(row[0]) + lengths[1];
+  }
+  FAIL_UNLESS(mysql_num_rows(result) == 32768, "rowcount != 32768");
+  mysql_free_result(result);
+  return OK;
+}
+
+static int test_parallel_read(MYSQL *mysql)
+{
+  ulonglong sum_plain, sum_parallel;
+  double time_plain, time_parallel;
+  int rc, i;
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t_parallel_read");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "CREATE TABLE t_parallel_read "
+                         "(a int not null auto_increment primary key, b blob)");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "INSERT INTO t_parallel_read (b) VALUES (REPEAT('x', 300))");
+  check_mysql_rc(rc, mysql);
+  for (i= 0; i < 15; i++)
+  {
+    rc= mysql_query(mysql, "INSERT INTO t_parallel_read (b) "
+                           "SELECT REPEAT('y', LENGTH(b) % 997 + a) FROM t_parallel_read");
+    check_mysql_rc(rc, mysql);
+  }
+
+  if (read_all_rows(mysql, 0, &sum_plain, &time_plain) ||
+      read_all_rows(mysql, 1, &sum_parallel, &time_parallel))
+    return FAIL;
+  FAIL_UNLESS(sum_plain == sum_parallel, "Parallel read returned different rows");
+  diag("store_result: %.3fs, with MYSQL_OPT_PARALLEL_READ: %.3fs",
+       time_plain, time_parallel);
+
+  /* result sets which are not read to the end must not hang the reader */
+  rc= mysql_query(mysql, "SELECT a FROM t_parallel_read WHERE a < 0");
+  check_mysql_rc(rc, mysql);
+  mysql_free_result(mysql_store_result(mysql));
+  rc= mysql_query(mysql, "SELECT * FROM t_parallel_read_missing");
+  FAIL_UNLESS(rc, "Error expected");
+
+  rc= mysql_query(mysql, "DROP TABLE t_parallel_read");
+  check_mysql_rc(rc, mysql);
+  return OK;
+}
+
+
+/* Result memory allocations of at least this size fail after the first */
+static size_t fail_result_size;
+static int result_allocs;
+
+static void *oom_malloc(void *context __attribute__((unused)), size_t size,
+                        unsigned int category)
+{
+  if (category == MYSQL_MEMORY_RESULT && fail_result_size &&
+      size >= fail_result_size && ++result_allocs > 1)
+    return NULL;
+  return malloc(size);
+}
+
+static void *oom_realloc(void *context __attribute__((unused)), void *ptr,
+                         size_t size,
+                         unsigned int category __attribute__((unused)))
+{
+  return realloc(ptr, size);
+}
+
+static void oom_free(void *context __attribute__((unused)), void *ptr,
+                     size_t size __attribute__((unused)),
+                     unsigned int category __attribute__((unused)))
+{
+  free(ptr);
+}
+
+/*
+  The reader thread of MYSQL_OPT_PARALLEL_READ can't get memory for its
+  buffers: the result set must fail with CR_OUT_OF_MEMORY, not come back
+  short.
+*/
+
+static int test_parallel_read_out_of_memory(MYSQL *mysql)
+{
+  MYSQL_ALLOCATOR allocator= { oom_malloc, oom_realloc, oom_free, NULL };
+  MYSQL_RES *result;
+  my_bool parallel= 1;
+  int rc, i;
+
+  rc= mysql_query(mysql, "CREATE TEMPORARY TABLE t_parallel_oom (b blob)");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "INSERT INTO t_parallel_oom VALUES (REPEAT('x', 1000))");
+  check_mysql_rc(rc, mysql);
+  for (i= 0; i < 12; i++)
+  {
+    rc= mysql_query(mysql, "INSERT INTO t_parallel_oom SELECT * FROM t_parallel_oom");
+    check_mysql_rc(rc, mysql);
+  }
+  rc= mysql_options(mysql, MYSQL_OPT_PARALLEL_READ, &parallel);
+  check_mysql_rc(rc, mysql);
+
+  rc= mysql_query(mysql, "SELECT b FROM t_parallel_oom");
+  check_mysql_rc(rc, mysql);
+  /* The reader's slabs are the only result allocations this big */
+  fail_result_size= 128 * 1024;
+  result_allocs= 0;
+  FAIL_IF(mysql_set_allocator(&allocator), "Can't set allocator");
+  result= mysql_store_result(mysql);
+  mysql_set_allocator(NULL);
+  fail_result_size= 0;
+
+  FAIL_UNLESS(result_allocs > 1, "Allocation failure not reached");
+  FAIL_IF(result, "Error expected");
+  FAIL_UNLESS(mysql_errno(mysql) == CR_OUT_OF_MEMORY, "Wrong error code");
+  /* The rest of the result set is still on this connection */
+  return OK;
+}
+
+
+/* mysql_data_seek() and mysql_stmt_data_seek() through the row index */
+
+static int test_data_seek_index(MYSQL *mysql)
+{
+  static const uint seeks[]= { 1000, 3, 2047, 64, 1024, 0, 1023, 1500 };
+  MYSQL_RES *res;
+  MYSQL_ROW row;
+  MYSQL_STMT *stmt;
+  MYSQL_BIND my_bind[1];
+  const char *query= "SELECT a FROM t_seek ORDER BY a";
+  int rc, a;
+  uint i;
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t_seek");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "CREATE TABLE t_seek "
+                         "(a int not null auto_increment primary key)");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "INSERT INTO t_seek VALUES (NULL)");
+  check_mysql_rc(rc, mysql);
+  for (i= 0; i < 11; i++)
+  {
+    rc= mysql_query(mysql, "INSERT INTO t_seek SELECT NULL FROM t_seek");
+    check_mysql_rc(rc, mysql);
+  }
+
+  rc= mysql_query(mysql, query);
+  check_mysql_rc(rc, mysql);
+  res= mysql_store_result(mysql);
+  FAIL_IF(!res || mysql_num_rows(res) != 2048, "Expected 2048 rows");
+  for (i= 0; i < array_elements(seeks); i++)
+  {
+    mysql_data_seek(res, seeks[i]);
+    row= mysql_fetch_row(res);
+    FAIL_UNLESS(row && (uint) atoi(row[0]) == seeks[i] + 1, "Wrong row");
+  }
+  mysql_data_seek(res, 2048);
+  FAIL_IF(mysql_fetch_row(res), "No row expected");
+  mysql_free_result(res);
+
+  stmt= mysql_stmt_init(mysql);
+  FAIL_IF(!stmt, mysql_error(mysql));
+  rc= mysql_stmt_prepare(stmt, query, strlen(query));
+  check_stmt_rc(rc, stmt);
+  memset(my_bind, 0, sizeof(my_bind));
+  my_bind[0].buffer_type= MYSQL_TYPE_LONG;
+  my_bind[0].buffer= (void *) &a;
+  rc= mysql_stmt_bind_result(stmt, my_bind);
+  check_stmt_rc(rc, stmt);
+  rc= mysql_stmt_execute(stmt);
+  check_stmt_rc(rc, stmt);
+  rc= mysql_stmt_store_result(stmt);
+  check_stmt_rc(rc, stmt);
+  for (i= 0; i < array_elements(seeks); i++)
+  {
+    mysql_stmt_data_seek(stmt, seeks[i]);
+    rc= mysql_stmt_fetch(stmt);
+    check_stmt_rc(rc, stmt);
+    FAIL_UNLESS((uint) a == seeks[i] + 1, "Wrong row");
+  }
+  /* A new result set must not use the index of the old one */
+  rc= mysql_stmt_execute(stmt);
+  check_stmt_rc(rc, stmt);
+  rc= mysql_stmt_store_result(stmt);
+  check_stmt_rc(rc, stmt);
+  mysql_stmt_data_seek(stmt, 100);
+  rc= mysql_stmt_fetch(stmt);
+  check_stmt_rc(rc, stmt);
+  FAIL_UNLESS(a == 101, "Wrong row");
+  mysql_stmt_close(stmt);
+
+  rc= mysql_query(mysql, "DROP TABLE t_seek");
+  check_mysql_rc(rc, mysql);
+  return OK;
+}
+
+
+/* A result set over MYSQL_OPT_RESULT_MEMORY_LIMIT is refused */
+
+static int test_result_memory_limit(MYSQL *mysql)
+{
+  MYSQL *mysql_local;
+  MYSQL_RES *res;
+  ulong limit= 64 * 1024;
+  const char *query= "SELECT REPEAT('x', 1000) FROM t_mem_limit";
+  int rc, i;
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t_mem_limit");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "CREATE TABLE t_mem_limit (a int)");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "INSERT INTO t_mem_limit VALUES (1)");
+  check_mysql_rc(rc, mysql);
+  for (i= 0; i < 8; i++)
+  {
+    rc= mysql_query(mysql, "INSERT INTO t_mem_limit SELECT a FROM t_mem_limit");
+    check_mysql_rc(rc, mysql);
+  }
+
+  /* The result set takes about 256K */
+  mysql_local= mysql_init(NULL);
+  FAIL_IF(!mysql_local, "mysql_init failed");
+  rc= mysql_options(mysql_local, MYSQL_OPT_RESULT_MEMORY_LIMIT, &limit);
+  FAIL_IF(rc, "mysql_options failed");
+  FAIL_IF(!mysql_real_connect(mysql_local, hostname, username, password,
+                              schema, port, socketname, 0),
+          mysql_error(mysql_local));
+  rc= mysql_query(mysql_local, query);
+  check_mysql_rc(rc, mysql_local);
+  res= mysql_store_result(mysql_local);
+  FAIL_IF(res, "Limit of the result set was not checked");
+  FAIL_UNLESS(mysql_errno(mysql_local) == CR_OUT_OF_MEMORY, "Wrong error");
+  mysql_close(mysql_local);
+
+  rc= mysql_query(mysql, query);
+  check_mysql_rc(rc, mysql);
+  res= mysql_store_result(mysql);
+  FAIL_IF(!res || mysql_num_rows(res) != 256, "Expected 256 rows");
+  mysql_free_result(res);
+
+  rc= mysql_query(mysql, "DROP TABLE t_mem_limit");
+  check_mysql_rc(rc, mysql);
+  return OK;
+}
+
+/* Result sets reuse the blocks of earlier ones with a block cache */
+
+static int test_result_block_cache(MYSQL *mysql)
+{
+  MYSQL *mysql_local;
+  MYSQL_RES *res;
+  MYSQL_BLOCK_CACHE_STATS stats;
+  ulong size= 256 * 1024;
+  int rc, i;
+
+  FAIL_UNLESS(mysql_block_cache_stats(mysql, &stats), "No cache expected");
+  mysql_local= mysql_init(NULL);
+  FAIL_IF(!mysql_local, "mysql_init failed");
+  rc= mysql_options(mysql_local, MYSQL_OPT_RESULT_BLOCK_CACHE, &size);
+  FAIL_IF(rc, "mysql_options failed");
+  FAIL_IF(!mysql_real_connect(mysql_local, hostname, username, password,
+                              schema, port, socketname, 0),
+          mysql_error(mysql_local));
+  for (i= 0; i < 20; i++)
+  {
+    rc= mysql_query(mysql_local, "SELECT REPEAT('x', 20000), 1, 'abc'");
+    check_mysql_rc(rc, mysql_local);
+    res= mysql_store_result(mysql_local);
+    FAIL_IF(!res || mysql_num_rows(res) != 1, "Expected 1 row");
+    mysql_free_result(res);
+  }
+  FAIL_IF(mysql_block_cache_stats(mysql_local, &stats), "Cache expected");
+  FAIL_UNLESS(stats.hits >= 19 && stats.bytes <= size, "Blocks not reused");
+
+  /* A result set may outlive the cache and the connection */
+  rc= mysql_query(mysql_local, "SELECT 1");
+  check_mysql_rc(rc, mysql_local);
+  res= mysql_store_result(mysql_local);
+  FAIL_IF(!res, "Result set expected");
+  size= 0;
+  rc= mysql_options(mysql_local, MYSQL_OPT_RESULT_BLOCK_CACHE, &size);
+  FAIL_IF(rc, "mysql_options failed");
+  mysql_close(mysql_local);
+  mysql_free_result(res);
+  return OK;
+}
+
+/* Large result sets and packets on huge pages read the same */
+
+static int test_huge_pages(MYSQL *mysql)
+{
+  MYSQL *mysql_local;
+  MYSQL_RES *res;
+  MYSQL_ROW row;
+  uint mode;
+  int rc, i;
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t_huge_pages");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "CREATE TABLE t_huge_pages (a INT, b VARCHAR(255))");
+  check_mysql_rc(rc, mysql);
+  rc= mysql_query(mysql, "INSERT INTO t_huge_pages "
+                         "VALUES (0, REPEAT('x', 200))");
+  check_mysql_rc(rc, mysql);
+  for (i= 0; i < 14; i++)
+  {
+    rc= mysql_query(mysql, "INSERT INTO t_huge_pages SELECT a + 1, b "
+                           "FROM t_huge_pages");
+    check_mysql_rc(rc, mysql);
+  }
+
+  mysql_local= mysql_init(NULL);
+  FAIL_IF(!mysql_local, "mysql_init failed");
+  mode= 7;
+  FAIL_UNLESS(mysql_options(mysql_local, MYSQL_OPT_HUGE_PAGES, &mode),
+              "Invalid value accepted");
+  mode= MYSQL_HUGE_PAGES_TRANSPARENT;
+  rc= mysql_options(mysql_local, MYSQL_OPT_HUGE_PAGES, &mode);
+  FAIL_IF(rc, "mysql_options failed");
+  FAIL_IF(!mysql_real_connect(mysql_local, hostname, username, password,
+                              schema, port, socketname, 0),
+          mysql_error(mysql_local));
+  rc= mysql_query(mysql_local, "SELECT a, b FROM t_huge_pages");
+  check_mysql_rc(rc, mysql_local);
+  res= mysql_store_result(mysql_local);
+  FAIL_IF(!res || mysql_num_rows(res) != 16384, "Expected 16384 rows");
+  while ((row= mysql_fetch_row(res)))
+    FAIL_IF(strlen(row[1]) != 200, "Wrong row");
+  mysql_free_result(res);
+
+  /* A packet of 4M grows the network buffer */
+  rc= mysql_query(mysql_local, "SELECT REPEAT('y', 4 * 1024 * 1024)");
+  check_mysql_rc(rc, mysql_local);
+  res= mysql_store_result(mysql_local);
+  FAIL_IF(!res, "Result set expected");
+  row= mysql_fetch_row(res);
+  FAIL_IF(!row || mysql_fetch_lengths(res)[0] != 4 * 1024 * 1024,
+          "Wrong length");
+  mysql_free_result(res);
+  mysql_close(mysql_local);
+
+  rc= mysql_query(mysql, "DROP TABLE t_huge_pages");
+  check_mysql_rc(rc, mysql);
+  return OK;
+}
+
 struct my_tests_st my_tests[] = {
   {"client_store_result", client_store_result, TEST_CONNECTION_DEFAULT, 0,  NULL,  NULL},
   {"client_use_result", client_use_result, TEST_CONNECTION_DEFAULT, 0,  NULL,  NULL},
@@ -1039,6 +1779,17 @@ struct my_tests_st my_tests[] = {
   {"test_bug9735", test_bug9735, TEST_CONNECTION_DEFAULT, 0,  NULL,  NULL},
   {"test_bug9992", test_bug9992, TEST_CONNECTION_NEW, CLIENT_MULTI_STATEMENTS,  NULL,  NULL},
   {"test_multi_statements", test_multi_statements, TEST_CONNECTION_NEW, CLIENT_MULTI_STATEMENTS,  NULL,  NULL},
+  {"test_fetch_row_stream", test_fetch_row_stream, TEST_CONNECTION_DEFAULT, 0,  NULL,  NULL},
+  {"test_fetch_row_stream_typed", test_fetch_row_stream_typed, TEST_CONNECTION_DEFAULT, 0,  NULL,  NULL},
+  {"test_fetch_row_stream_max_packet", test_fetch_row_stream_max_packet, TEST_CONNECTION_DEFAULT, 0,  NULL,  NULL},
+  {"test_parallel_read", test_parallel_read, TEST_CONNECTION_NEW, 0,  NULL,  NULL},
+  {"test_parallel_read_out_of_memory", test_parallel_read_out_of_memory, TEST_CONNECTION_NEW, 0,  NULL,  NULL},
+  {"test_fetch_typed", test_fetch_typed, TEST_CONNECTION_DEFAULT, 0,  NULL,  NULL},
+  {"test_lazy_metadata", test_lazy_metadata, TEST_CONNECTION_DEFAULT, 0,  NULL,  NULL},
+  {"test_data_seek_index", test_data_seek_index, TEST_CONNECTION_DEFAULT, 0,  NULL,  NULL},
+  {"test_result_memory_limit", test_result_memory_limit, TEST_CONNECTION_DEFAULT, 0,  NULL,  NULL},
+  {"test_result_block_cache", test_result_block_cache, TEST_CONNECTION_DEFAULT, 0,  NULL,  NULL},
+  {"test_huge_pages", test_huge_pages, TEST_CONNECTION_DEFAULT, 0,  NULL,  NULL},
   {NULL, NULL, 0, 0, NULL, NULL}
 };
 
@@ -0,0 +1,268 @@
+/* Copyright (C) 2026 MySQL Connector/C contributors
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA */
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <tap.h>
+#include <string.h>
+
+/*
+  my_time.c is part of libmysql only, so it is compiled in here.
+*/
+#include "../../libmysql/my_time.c"
+
+#define MUTATE_COUNT 200000
+#define BENCH_COUNT  200000
+#define BENCH_ROUNDS 10
+
+static const uint flag_sets[]=
+{
+  0, TIME_FUZZY_DATE, TIME_DATETIME_ONLY, TIME_NO_ZERO_IN_DATE,
+  TIME_NO_ZERO_DATE, TIME_INVALID_DATES,
+  TIME_FUZZY_DATE | TIME_INVALID_DATES,
+  TIME_NO_ZERO_IN_DATE | TIME_NO_ZERO_DATE | TIME_DATETIME_ONLY
+};
+
+
+/*
+  Parse str with str_to_datetime() and compare the result with the
+  general parser. A leading space is never taken by the fast path and
+  is skipped by the general one, so that is used to get the reference.
+*/
+
+static int compare_parse(const char *str, uint length, uint flags)
+{
+  char buf[64];
+  MYSQL_TIME t1, t2;
+  enum enum_mysql_timestamp_type r1, r2;
+  int cut1, cut2;
+
+  buf[0]= ' ';
+  memcpy(buf + 1, str, length);
+  memset(&t1, 0x5A, sizeof(t1));
+  memset(&t2, 0x5A, sizeof(t2));
+  r1= str_to_datetime(str, length, &t1, flags, &cut1);
+  r2= str_to_datetime(buf, length + 1, &t2, flags, &cut2);
+  if (r1 == r2 && cut1 == cut2 && t1.year == t2.year &&
+      t1.month == t2.month && t1.day == t2.day && t1.hour == t2.hour &&
+      t1.minute == t2.minute && t1.second == t2.second &&
+      t1.second_part == t2.second_part && t1.neg == t2.neg &&
+      t1.time_type == t2.time_type)
+    return 1;
+  diag("'%.*s' flags %u: %d/%d, cut %d/%d, %u-%u-%u %u:%u:%u.%lu / "
+       "%u-%u-%u %u:%u:%u.%lu", (int) length, str, flags, (int) r1,
+       (int) r2, cut1, cut2, t1.year, t1.month, t1.day, t1.hour, t1.minute,
+       t1.second, t1.second_part, t2.year, t2.month, t2.day, t2.hour,
+       t2.minute, t2.second, t2.second_part);
+  return 0;
+}
+
+
+/* Every year with all months 0..13 and days 0..32, date and datetime */
+
+static void test_all_dates(void)
+{
+  char buf[40];
+  uint year, month, day, n= 0;
+  int failed= 0;
+
+  for (year= 0; year <= 9999 && failed < 10; year++)
+    for (month= 0; month <= 13; month++)
+      for (day= 0; day <= 32; day++, n++)
+      {
+        uint flags= flag_sets[n % array_elements(flag_sets)];
+        sprintf(buf, "%04u-%02u-%02u %02u:%02u:%02u", year, month, day,
+                n % 24, n % 61, n % 60);
+        if (!compare_parse(buf, 10, flags) ||
+            !compare_parse(buf, 19, flags))
+          failed++;
+      }
+  ok(!failed, "all dates");
+}
+
+
+/* Every time of day, with and without fractions of each length */
+
+static void test_all_times(void)
+{
+  static const char *dates[]= { "0000-00-00", "2000-02-29", "1999-12-31" };
+  char buf[40];
+  uint hour, minute, second, n= 0;
+  int failed= 0;
+
+  for (hour= 0; hour <= 25 && failed < 10; hour++)
+    for (minute= 0; minute <= 61; minute++)
+      for (second= 0; second <= 61; second++, n++)
+      {
+        uint flags= flag_sets[n % array_elements(flag_sets)];
+        uint length= 19 + n % 9;
+        sprintf(buf, "%s %02u:%02u:%02u.%07u", dates[n % 3], hour, minute,
+                second, (uint) (n * 7919 % 10000000));
+        if (!compare_parse(buf, length, flags))
+          failed++;
+      }
+  ok(!failed, "all times");
+}
+
+
+/* Canonical strings with one byte changed, and cut at any length */
+
+static void test_mutations(void)
+{
+  static const char interesting[]= "0123456789 -:.T\t/aZ\0\x80\xff";
+  char buf[40];
+  int i, failed= 0;
+
+  memset(buf, 0, sizeof(buf));
+  for (i= 0; i < MUTATE_COUNT && failed < 10; i++)
+  {
+    uint flags= flag_sets[i % array_elements(flag_sets)];
+    uint length= 26, pos;
+    sprintf(buf, "%04u-%02u-%02u %02u:%02u:%02u.%06u", rand() % 10000,
+            rand() % 13, rand() % 32, rand() % 24, rand() % 60,
+            rand() % 60, (uint) (rand() % 1000000));
+    pos= rand() % length;
+    if (rand() & 1)
+      buf[pos]= interesting[rand() % (sizeof(interesting) - 1)];
+    else
+      buf[pos]= (char) rand();
+    if (rand() & 1)
+      length= rand() % 28;
+    if (!compare_parse(buf, length, flags))
+      failed++;
+  }
+  ok(!failed, "mutated strings");
+}
+
+
+/* my_date_to_str() and my_datetime_to_str() against sprintf() */
+
+static void test_format(void)
+{
+  MYSQL_TIME t;
+  char buf1[MAX_DATE_STRING_REP_LENGTH + 20], buf2[sizeof(buf1)];
+  int i, failed= 0;
+
+  memset(&t, 0, sizeof(t));
+  for (i= 0; i < MUTATE_COUNT && failed < 10; i++)
+  {
+    int len1, len2;
+    /* mostly valid values, sometimes too wide for their field */
+    t.year=   i & 7 ? rand() % 10000 : rand() % 100000;
+    t.month=  i & 8 ? rand() % 13 : rand() % 1000;
+    t.day=    i & 16 ? rand() % 32 : rand() % 1000;
+    t.hour=   i & 32 ? rand() % 24 : rand() % 1000;
+    t.minute= i & 64 ? rand() % 60 : rand() % 1000;
+    t.second= i & 128 ? rand() % 60 : rand() % 1000;
+
+    len1= my_datetime_to_str(&t, buf1);
+    len2= sprintf(buf2, "%04u-%02u-%02u %02u:%02u:%02u", t.year, t.month,
+                  t.day, t.hour, t.minute, t.second);
+    if (len1 != len2 || strcmp(buf1, buf2))
+    {
+      diag("datetime '%s', expected '%s'", buf1, buf2);
+      failed++;
+    }
+    len1= my_date_to_str(&t, buf1);
+    len2= sprintf(buf2, "%04u-%02u-%02u", t.year, t.month, t.day);
+    if (len1 != len2 || strcmp(buf1, buf2))
+    {
+      diag("date '%s', expected '%s'", buf1, buf2);
+      failed++;
+    }
+  }
+  ok(!failed, "formatting");
+}
+
+
+static void run_benchmark(void)
+{
+  char *buf= malloc(BENCH_COUNT * 32);
+  MYSQL_TIME t;
+  int i, round, cut;
+  ulonglong start, parse, general, format, reference;
+  volatile uint sum= 0;
+
+  /* with a leading space in front for the general parser */
+  for (i= 0; i < BENCH_COUNT; i++)
+    sprintf(buf + i * 32, " %04u-%02u-%02u %02u:%02u:%02u.%06u",
+            1970 + rand() % 100, rand() % 12 + 1, rand() % 28 + 1,
+            rand() % 24, rand() % 60, rand() % 60,
+            (uint) (rand() % 1000000));
+
+  start= my_getsystime();
+  for (round= 0; round < BENCH_ROUNDS; round++)
+    for (i= 0; i < BENCH_COUNT; i++)
+    {
+      str_to_datetime(buf + i * 32 + 1, 26, &t, TIME_FUZZY_DATE, &cut);
+      sum+= t.second;
+    }
+  parse= my_getsystime() - start + 1;
+  start= my_getsystime();
+  for (round= 0; round < BENCH_ROUNDS; round++)
+    for (i= 0; i < BENCH_COUNT; i++)
+    {
+      str_to_datetime(buf + i * 32, 27, &t, TIME_FUZZY_DATE, &cut);
+      sum+= t.second;
+    }
+  general= my_getsystime() - start + 1;
+
+  start= my_getsystime();
+  for (round= 0; round < BENCH_ROUNDS; round++)
+    for (i= 0; i < BENCH_COUNT; i++)
+    {
+      t.second= i % 60;
+      sum+= my_datetime_to_str(&t, buf + (i & 1023) * 32);
+    }
+  format= my_getsystime() - start + 1;
+  start= my_getsystime();
+  for (round= 0; round < BENCH_ROUNDS; round++)
+    for (i= 0; i < BENCH_COUNT; i++)
+    {
+      t.second= i % 60;
+      sum+= my_sprintf(buf + (i & 1023) * 32,
+                       (buf + (i & 1023) * 32,
+                        "%04u-%02u-%02u %02u:%02u:%02u", t.year, t.month,
+                        t.day, t.hour, t.minute, t.second));
+    }
+  reference= my_getsystime() - start + 1;
+
+  diag("parse  %5.1f ns per value (general parser: %5.1f ns)",
+       parse * 100.0 / BENCH_COUNT / BENCH_ROUNDS,
+       general * 100.0 / BENCH_COUNT / BENCH_ROUNDS);
+  diag("format %5.1f ns per value (my_sprintf: %5.1f ns)",
+       format * 100.0 / BENCH_COUNT / BENCH_ROUNDS,
+       reference * 100.0 / BENCH_COUNT / BENCH_ROUNDS);
+  free(buf);
+}
+
+
+int main(void)
+{
+  MY_INIT("datetime-t");
+
+  plan(4);
+
+  test_all_dates();
+  test_all_times();
+  test_mutations();
+  test_format();
+
+  if (getenv("MYTAP_BENCHMARK"))
+    run_benchmark();
+
+  my_end(0);
+  return exit_status();
+}
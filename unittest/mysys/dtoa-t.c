@@ -0,0 +1,382 @@
+/* Copyright (C) 2026 MySQL Connector/C contributors
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA */
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <tap.h>
+#include <string.h>
+
+/*
+  dtoa() and dtoa_fast() are static, so the file is compiled in here;
+  its my_gcvt() and friends take the place of the ones in libstrings.
+*/
+#include "../../strings/dtoa.c"
+
+#define RANDOM_COUNT 50000
+#define BENCH_COUNT  200000
+
+static ulonglong rand64(void)
+{
+  return ((ulonglong) (rand() & 0xFFFF) << 48) |
+         ((ulonglong) (rand() & 0xFFFF) << 32) |
+         ((ulonglong) (rand() & 0xFFFF) << 16) | (ulonglong) (rand() & 0xFFFF);
+}
+
+static double from_bits(ulonglong bits)
+{
+  double d;
+  memcpy(&d, &bits, sizeof(d));
+  return d;
+}
+
+
+/* Compare dtoa_fast() with dtoa() for one mode and number of digits */
+
+static int compare_one(double x, int mode, int ndigits)
+{
+  char buf1[DTOA_BUFF_SIZE], buf2[DTOA_BUFF_SIZE];
+  char *res1, *res2, *end1, *end2;
+  int decpt1, decpt2, sign1, sign2, res;
+
+  res1= dtoa(x, mode, ndigits, &decpt1, &sign1, &end1, buf1, sizeof(buf1));
+  res2= dtoa_fast(x, mode, ndigits, &decpt2, &sign2, &end2,
+                  buf2, sizeof(buf2));
+  res= end1 - res1 == end2 - res2 && !memcmp(res1, res2, end1 - res1) &&
+       sign1 == sign2 && (decpt1 == decpt2 || end1 == res1);
+  if (!res)
+    diag("%.17g mode %d ndigits %d: dtoa '%.*s' e%d, fast '%.*s' e%d",
+         x, mode, ndigits, (int) (end1 - res1), res1, decpt1,
+         (int) (end2 - res2), res2, decpt2);
+  dtoa_free(res1, buf1, sizeof(buf1));
+  dtoa_free(res2, buf2, sizeof(buf2));
+  return res;
+}
+
+/* All the modes and digit counts my_gcvt() and my_fcvt() use */
+
+static int compare_all(double x)
+{
+  int n;
+  for (n= 0; n <= 25; n++)
+  {
+    if (!compare_one(x, 4, n) || !compare_one(x, 5, n) ||
+        !compare_one(x, 5, -n))
+      return 0;
+  }
+  return compare_one(x, 4, 60) && compare_one(x, 5, 350);
+}
+
+/* Random bit patterns of finite doubles */
+
+static void test_random_bits(void)
+{
+  int i, failed= 0;
+  for (i= 0; i < RANDOM_COUNT && failed < 10; i++)
+  {
+    double x= from_bits(rand64());
+    if (!isnan(x) && !isinf(x))
+      failed+= !compare_all(x);
+  }
+  ok(!failed, "random doubles");
+}
+
+/* Numbers with few digits, where ties and exact values are common */
+
+static void test_random_short(void)
+{
+  int i, failed= 0;
+  for (i= 0; i < RANDOM_COUNT && failed < 10; i++)
+  {
+    char str[32], *end= str + sizeof(str);
+    int error;
+    my_snprintf(str, sizeof(str), "%d.%de%d", rand() % 1000, rand() % 10000,
+                rand() % 60 - 30);
+    failed+= !compare_all(my_strtod(str, &end, &error));
+  }
+  ok(!failed, "random short decimals");
+}
+
+static void test_random_float(void)
+{
+  int i, failed= 0;
+  for (i= 0; i < RANDOM_COUNT && failed < 10; i++)
+  {
+    uint32 bits= (uint32) rand64();
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    if (!isnan(f) && !isinf(f))
+      failed+= !compare_all((double) f);
+  }
+  ok(!failed, "random floats");
+}
+
+static void test_edge_cases(void)
+{
+  static const double values[]=
+  {
+    0.0, -0.0, 1.0, -1.0, 0.5, 0.125, 0.375, 2.5, 1.5, 0.05, 0.15, 0.25,
+    0.35, 0.45, 1e23, 9.999999999999999e22, 5e-324, 1e-323,
+    2.2250738585072009e-308, 2.2250738585072014e-308, 1.7976931348623157e308, 9007199254740993.0,
+    9007199254740992.0, 123456789012345678.0, 0.1, 0.2, 0.3, 1.0 / 3,
+    2.0 / 3, 3.4028234663852886e38, 1.1754943508222875e-38,
+    1.401298464324817e-45, 999999999999999.9, 9.5, 99.5, 0.95, 0.995,
+    4.35, 1e-7, 123456.789e3, 1e21, 1e22, 4294967296.0, 1.0e15, 1.0e16,
+    1.0e17, 5e-1, 5e-5, 1.2345e-300, 1.2345e300
+  };
+  uint i;
+  int failed= 0, e;
+  for (i= 0; i < array_elements(values); i++)
+    failed+= !compare_all(values[i]) + !compare_all(-values[i]);
+  /* powers of 10 and 2, and their neighbours */
+  for (e= -325; e <= 308; e++)
+  {
+    double x= pow(10.0, e);
+    failed+= !compare_all(x) + !compare_all(nextafter(x, 0.0)) +
+             !compare_all(nextafter(x, DBL_MAX));
+  }
+  for (e= -1074; e <= 1023; e++)
+  {
+    double x= ldexp(1.0, e);
+    failed+= !compare_all(x) + !compare_all(nextafter(x, 0.0)) +
+             !compare_all(nextafter(x, DBL_MAX));
+  }
+  ok(!failed, "edge cases");
+}
+
+/* Known output of the wrappers */
+
+static void test_known_values(void)
+{
+  char buf[FLOATING_POINT_BUFFER];
+  int failed= 0;
+
+#define CHECK_GCVT(x, type, width, expected)                         \
+  do {                                                                \
+    my_gcvt(x, type, width, buf, NULL);                               \
+    if (strcmp(buf, expected))                                        \
+    {                                                                 \
+      diag("my_gcvt(%.17g, %d): '%s', expected '%s'", (double) (x),   \
+           width, buf, expected);                                     \
+      failed++;                                                       \
+    }                                                                 \
+  } while (0)
+#define CHECK_FCVT(x, precision, expected)                            \
+  do {                                                                \
+    my_fcvt(x, precision, buf, NULL);                                 \
+    if (strcmp(buf, expected))                                        \
+    {                                                                 \
+      diag("my_fcvt(%.17g, %d): '%s', expected '%s'", (double) (x),   \
+           precision, buf, expected);                                 \
+      failed++;                                                       \
+    }                                                                 \
+  } while (0)
+
+  CHECK_GCVT(0.1, MY_GCVT_ARG_DOUBLE, 30, "0.1");
+  CHECK_GCVT(1.0 / 3, MY_GCVT_ARG_DOUBLE, 30, "0.3333333333333333");
+  CHECK_GCVT(1e23, MY_GCVT_ARG_DOUBLE, 30, "1e23");
+  CHECK_GCVT(-1.5e-300, MY_GCVT_ARG_DOUBLE, 30, "-1.5e-300");
+  CHECK_GCVT(123456789.125, MY_GCVT_ARG_DOUBLE, 8, "1.2346e8");
+  CHECK_GCVT(1.87e-3, MY_GCVT_ARG_DOUBLE, 4, "2e-3");
+  CHECK_GCVT(55, MY_GCVT_ARG_DOUBLE, 1, "6");
+  CHECK_GCVT(0.1f, MY_GCVT_ARG_FLOAT, 30, "0.1");
+  CHECK_GCVT(3.4028234663852886e38, MY_GCVT_ARG_FLOAT, 30, "3.40282e38");
+  CHECK_GCVT(1.7976931348623157e308, MY_GCVT_ARG_DOUBLE, 30,
+             "1.7976931348623157e308");
+  CHECK_FCVT(0.125, 2, "0.12");
+  CHECK_FCVT(0.375, 2, "0.38");
+  CHECK_FCVT(2.675, 2, "2.67");
+  CHECK_FCVT(1e23, 0, "100000000000000000000000");
+  CHECK_FCVT(-0.0004, 2, "-0.00");
+  CHECK_FCVT(2.5, 0, "2");
+  CHECK_FCVT(1.5, 0, "2");
+  CHECK_FCVT(123.456, 5, "123.45600");
+  ok(!failed, "known values");
+}
+
+
+/*
+  my_strtod() takes the Eisel-Lemire path for up to 19 significant
+  digits. The same number with zeros appended to 20 digits goes the
+  Bigint way, which is what the result is compared against.
+*/
+
+static double strtod_len(const char *str, size_t length, int *error)
+{
+  char *end= (char*) str + length;
+  return my_strtod(str, &end, error);
+}
+
+static int compare_strtod(const char *digits, int ndigits, int point, int exp)
+{
+  char str[64], padded[64];
+  double res1, res2;
+  int len1, len2, error1, error2;
+
+  len1= snprintf(str, sizeof(str), "%.*s.%.*se%d", point, digits,
+                 ndigits - point, digits + point, exp);
+  len2= snprintf(padded, sizeof(padded), "%.*s%0*de%d", ndigits, digits,
+                 20 - ndigits, 0, exp - (20 - ndigits) - (ndigits - point));
+  res1= strtod_len(str, len1, &error1);
+  res2= strtod_len(padded, len2, &error2);
+  if (memcmp(&res1, &res2, sizeof(double)) || error1 != error2)
+  {
+    diag("my_strtod('%s'): %.17g, '%s': %.17g", str, res1, padded, res2);
+    return 0;
+  }
+  return 1;
+}
+
+/* Random digit strings */
+
+static void test_strtod_random(void)
+{
+  int i, j, failed= 0;
+  for (i= 0; i < RANDOM_COUNT && failed < 10; i++)
+  {
+    char digits[20];
+    int ndigits= rand() % 19 + 1;
+    for (j= 0; j < ndigits; j++)
+      digits[j]= (char) ('0' + rand() % 10);
+    if (digits[0] == '0')
+      digits[0]= '1';
+    failed+= !compare_strtod(digits, ndigits, rand() % (ndigits + 1),
+                             rand() % 700 - 360);
+  }
+  ok(!failed, "my_strtod of random digits");
+}
+
+/*
+  Shortest and 17 digit forms of random doubles, and 19 digits of the
+  points halfway between two doubles, where the fast path has to give up
+*/
+
+static void test_strtod_near(void)
+{
+  int i, failed= 0;
+  for (i= 0; i < RANDOM_COUNT && failed < 10; i++)
+  {
+    double x= from_bits(rand64() & ~(1ULL << 63));
+    char str[64], *e;
+    int precision;
+    if (isnan(x) || isinf(x))
+      continue;
+    for (precision= 0; precision < 3; precision++)
+    {
+      if (precision == 0)
+        my_gcvt(x, MY_GCVT_ARG_DOUBLE, 40, str, NULL);
+      else if (precision == 1)
+        sprintf(str, "%.16e", x);
+      else
+        sprintf(str, "%.18Le",
+                (long double) x + ((long double) nextafter(x, DBL_MAX) -
+                                   (long double) x) / 2);
+      if ((e= strchr(str, 'e')))
+      {
+        /* d.ddde-N -> ddd and the exponent */
+        char digits[24];
+        int ndigits= 0, exp= atoi(e + 1);
+        const char *p;
+        for (p= str; p < e; p++)
+          if (*p >= '0' && *p <= '9')
+            digits[ndigits++]= *p;
+        for (; ndigits > 1 && digits[ndigits - 1] == '0'; ndigits--) ;
+        if (digits[0] != '0')
+          failed+= !compare_strtod(digits, ndigits, 1, exp);
+      }
+    }
+  }
+  ok(!failed, "my_strtod near doubles and halfway points");
+}
+
+
+static void run_benchmark(void)
+{
+  double *values= malloc(BENCH_COUNT * sizeof(double));
+  char buf[DTOA_BUFF_SIZE], *end, *strs;
+  int i, decpt, sign, n, error;
+  ulonglong start, fast, slow;
+  volatile double sum= 0;
+
+  for (i= 0; i < BENCH_COUNT; i++)
+    values[i]= (double) rand() / RAND_MAX * pow(10.0, rand() % 40 - 20);
+
+  for (n= 6; n <= 24; n+= 9)
+  {
+    start= my_getsystime();
+    for (i= 0; i < BENCH_COUNT; i++)
+      dtoa_free(dtoa_fast(values[i], 4, n, &decpt, &sign, &end, buf,
+                          sizeof(buf)), buf, sizeof(buf));
+    fast= my_getsystime() - start + 1;
+    start= my_getsystime();
+    for (i= 0; i < BENCH_COUNT; i++)
+      dtoa_free(dtoa(values[i], 4, n, &decpt, &sign, &end, buf,
+                     sizeof(buf)), buf, sizeof(buf));
+    slow= my_getsystime() - start + 1;
+    diag("%2d digits: %6.1f ns per double (dtoa: %6.1f ns)", n,
+         fast * 100.0 / BENCH_COUNT, slow * 100.0 / BENCH_COUNT);
+  }
+
+  /* Typical DOUBLE column text, and the same padded to 20 digits */
+  strs= malloc(BENCH_COUNT * 2 * 32);
+  for (i= 0; i < BENCH_COUNT; i++)
+  {
+    int ndigits= rand() % 17 + 1, point= rand() % (ndigits + 1);
+    char digits[20];
+    for (n= 0; n < ndigits; n++)
+      digits[n]= (char) ('0' + rand() % 10);
+    snprintf(strs + 2 * i * 32, 32, "%.*s.%.*s", point, digits,
+             ndigits - point, digits + point);
+    snprintf(strs + (2 * i + 1) * 32, 32, "%.*s%0*de%d", ndigits, digits,
+             20 - ndigits, 0, -(20 - ndigits) - (ndigits - point));
+  }
+  for (n= 0; n < 2; n++)
+  {
+    start= my_getsystime();
+    for (i= 0; i < BENCH_COUNT; i++)
+    {
+      const char *str= strs + (2 * i + n) * 32;
+      sum+= strtod_len(str, strlen(str), &error);
+    }
+    slow= my_getsystime() - start + 1;
+    if (n == 0)
+      fast= slow;
+  }
+  diag("my_strtod: %6.1f ns per number (Bigint: %6.1f ns)",
+       fast * 100.0 / BENCH_COUNT, slow * 100.0 / BENCH_COUNT);
+  free(strs);
+  free(values);
+}
+
+
+int main(void)
+{
+  MY_INIT("dtoa-t");
+
+  plan(7);
+
+  test_random_bits();
+  test_random_short();
+  test_random_float();
+  test_edge_cases();
+  test_known_values();
+  test_strtod_random();
+  test_strtod_near();
+
+  if (getenv("MYTAP_BENCHMARK"))
+    run_benchmark();
+
+  my_end(0);
+  return exit_status();
+}
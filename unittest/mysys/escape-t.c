@@ -0,0 +1,320 @@
+/* Copyright (C) 2026 MySQL Connector/C contributors
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA */
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <m_ctype.h>
+#include <tap.h>
+#include <string.h>
+
+#define ESCAPE_LOOP_COUNT 300
+#define BENCH_LENGTH      (4*1024*1024)
+#define BENCH_ROUNDS      8
+
+/*
+  The byte at a time version of escape_string_for_mysql(), which the
+  results are compared against.
+*/
+
+static size_t ref_escape(CHARSET_INFO *cs, char *to, size_t to_length,
+                         const char *from, size_t length)
+{
+  const char *to_start= to;
+  const char *end, *to_end= to_start + (to_length ? to_length-1 : 2*length);
+  my_bool overflow= FALSE;
+  my_bool use_mb_flag= use_mb(cs);
+  for (end= from + length; from < end; from++)
+  {
+    char escape= 0;
+    int tmp_length;
+    if (use_mb_flag && (tmp_length= my_ismbchar(cs, from, end)))
+    {
+      if (to + tmp_length > to_end)
+      {
+        overflow= TRUE;
+        break;
+      }
+      while (tmp_length--)
+        *to++= *from++;
+      from--;
+      continue;
+    }
+    if (use_mb_flag && (tmp_length= my_mbcharlen(cs, *from)) > 1)
+      escape= *from;
+    else
+    switch (*from) {
+    case 0:    escape= '0'; break;
+    case '\n': escape= 'n'; break;
+    case '\r': escape= 'r'; break;
+    case '\\': escape= '\\'; break;
+    case '\'': escape= '\''; break;
+    case '"':  escape= '"'; break;
+    case '\032': escape= 'Z'; break;
+    }
+    if (escape)
+    {
+      if (to + 2 > to_end)
+      {
+        overflow= TRUE;
+        break;
+      }
+      *to++= '\\';
+      *to++= escape;
+    }
+    else
+    {
+      if (to + 1 > to_end)
+      {
+        overflow= TRUE;
+        break;
+      }
+      *to++= *from;
+    }
+  }
+  *to= 0;
+  return overflow ? (size_t) -1 : (size_t) (to - to_start);
+}
+
+
+static CHARSET_INFO *charsets[]=
+{
+  &my_charset_latin1,
+  &my_charset_utf8mb3_general_ci,
+  &my_charset_utf8mb4_general_ci,
+  &my_charset_gbk_chinese_ci,
+  &my_charset_sjis_japanese_ci
+};
+
+
+static void fill_random(char *src, size_t length, int special_pct,
+                        int high_pct)
+{
+  static const char special[]= { 0, '\n', '\r', '\\', '\'', '"', '\032' };
+  static const char plain[]= "abcdefghijklmnopqrstuvwxyz0123456789 ,.-";
+  size_t i;
+  for (i= 0; i < length; i++)
+  {
+    int r= rand() % 100;
+    if (r < special_pct)
+      src[i]= special[rand() % sizeof(special)];
+    else if (r < special_pct + high_pct)
+      src[i]= (char) (0x80 + rand() % 0x80);
+    else
+      src[i]= plain[rand() % (sizeof(plain) - 1)];
+  }
+}
+
+
+/*
+  Well-formed utf8 characters of one to four bytes, with 'bad_pct'
+  percent of ill-formed ones: stray continuation bytes, overlong forms,
+  surrogates, truncated characters and lead bytes beyond U+10FFFF.
+*/
+
+static void fill_utf8(char *src, size_t length, int bad_pct)
+{
+  static const char *good[]=
+  {
+    "a", "'", "\\", "\xc3\xa9", "\xdf\xbf", "\xe2\x82\xac", "\xef\xbf\xbf",
+    "\xe0\xa0\x80", "\xed\xa0\x80", "\xf0\x90\x80\x80", "\xf4\x8f\xbf\xbf",
+    "\xf3\xa0\x80\x81"
+  };
+  static const char *bad[]=
+  {
+    "\x80", "\xbf", "\xc0\xaf", "\xc1\xbf", "\xc3'", "\xe0\x80\xaf", "\xe2\x82",
+    "\xe2\x82'", "\xf0\x80\x80\xaf", "\xf4\x90\x80\x80", "\xf5\x80\x80\x80",
+    "\xf8", "\xff", "\xf0\x9f\x98\\"
+  };
+  size_t i= 0;
+  while (i < length)
+  {
+    const char *chr= (rand() % 100 < bad_pct ?
+                      bad[rand() % array_elements(bad)] :
+                      good[rand() % array_elements(good)]);
+    for (; *chr && i < length; chr++)
+      src[i++]= *chr;
+  }
+}
+
+
+static int compare_escape(CHARSET_INFO *cs, const char *src, size_t length,
+                          size_t to_length)
+{
+  char *to1= malloc(2 * length + 1), *to2= malloc(2 * length + 1);
+  size_t len1, len2;
+  int res;
+
+  len1= escape_string_for_mysql(cs, to1, to_length, src, length);
+  len2= ref_escape(cs, to2, to_length, src, length);
+  res= len1 == len2 && !strcmp(to1, to2) &&
+       (len1 == (size_t) -1 || !memcmp(to1, to2, len1));
+  free(to1);
+  free(to2);
+  return res;
+}
+
+
+static void test_gbk_invalid_lead(void)
+{
+  static const char src[]= "ab\xbf\x27" "cd\xbf\x5c";
+  char to[32];
+  size_t len= escape_string_for_mysql(&my_charset_gbk_chinese_ci, to, 0,
+                                      src, sizeof(src) - 1);
+  ok(len == 10 && !memcmp(to, "ab\\\xbf\\'cd\xbf\x5c", 10),
+     "invalid GBK lead byte is escaped");
+}
+
+
+static void test_utf8(void)
+{
+  static const char src[]= "\xc3\xa9'\xf0\x9f\x98\x80\x80\xe2\x82'\xed\xa0\x80";
+  static const char res[]=
+    "\xc3\xa9\\'\xf0\x9f\x98\x80\x80\xe2\x82\\'\xed\xa0\x80";
+  char to[32];
+  size_t len;
+
+  /*
+    The four byte character is ill-formed in utf8mb3 and its bytes are
+    copied one by one, as are the stray continuation byte and the bytes
+    of the truncated three byte character.
+  */
+  len= escape_string_for_mysql(&my_charset_utf8mb3_general_ci, to, 0,
+                               src, sizeof(src) - 1);
+  ok(len == sizeof(res) - 1 && !memcmp(to, res, len),
+     "utf8mb3 with ill-formed characters");
+  len= escape_string_for_mysql(&my_charset_utf8mb4_general_ci, to, 0,
+                               src, sizeof(src) - 1);
+  ok(len == sizeof(res) - 1 && !memcmp(to, res, len),
+     "utf8mb4 with ill-formed characters");
+}
+
+
+/* random utf8, valid and not, against the byte at a time version */
+static void test_utf8_random(void)
+{
+  static CHARSET_INFO *utf8[]=
+  {
+    &my_charset_utf8mb3_general_ci, &my_charset_utf8mb4_general_ci
+  };
+  char src[300];
+  uint i, j, failed= 0;
+
+  for (i= 0; i < ESCAPE_LOOP_COUNT; i++)
+  {
+    size_t length= rand() % sizeof(src) + 1;
+    fill_utf8(src, length, i % 10);
+    for (j= 0; j < array_elements(utf8); j++)
+    {
+      if (!compare_escape(utf8[j], src, length, 0) ||
+          !compare_escape(utf8[j], src, length, rand() % (length * 2) + 1))
+        failed++;
+    }
+  }
+  ok(!failed, "random utf8 with ill-formed characters");
+}
+
+
+/* a single special or 8-bit byte at every offset of a plain string */
+static void test_every_offset(void)
+{
+  static const char special[]= { 0, '\n', '\r', '\\', '\'', '"', '\032',
+                                 (char) 0xe9 };
+  char src[100];
+  uint i, j, k, failed= 0;
+
+  for (i= 0; i < sizeof(src); i++)
+  {
+    for (j= 0; j < sizeof(special); j++)
+    {
+      memset(src, 'x', sizeof(src));
+      src[i]= special[j];
+      for (k= 0; k < array_elements(charsets); k++)
+      {
+        if (!compare_escape(charsets[k], src, sizeof(src), 0))
+          failed++;
+      }
+    }
+  }
+  ok(!failed, "special byte at every offset");
+}
+
+
+static double bench(size_t (*func)(CHARSET_INFO*, char*, size_t,
+                                   const char*, size_t),
+                    CHARSET_INFO *cs, char *to, const char *src, size_t length)
+{
+  ulonglong start= my_getsystime();
+  int i;
+  for (i= 0; i < BENCH_ROUNDS; i++)
+    func(cs, to, 0, src, length);
+  return (double) length * BENCH_ROUNDS / (1024.0 * 1024.0) /
+         ((double) (my_getsystime() - start + 1) / 10000000.0);
+}
+
+
+static void run_benchmark(void)
+{
+  char *src= malloc(BENCH_LENGTH), *to= malloc(2 * BENCH_LENGTH + 1);
+  uint i;
+
+  /* mostly plain text with an occasional quote, as in bulk inserts */
+  fill_random(src, BENCH_LENGTH, 1, 0);
+  for (i= 0; i < array_elements(charsets); i++)
+  {
+    double fast= bench(escape_string_for_mysql, charsets[i], to, src,
+                       BENCH_LENGTH);
+    double ref= bench(ref_escape, charsets[i], to, src, BENCH_LENGTH);
+    diag("%-24s %8.1f MB/s (byte at a time: %8.1f MB/s)",
+         charsets[i]->name, fast, ref);
+  }
+  free(src);
+  free(to);
+}
+
+
+int main(void)
+{
+  int i;
+  uint j;
+  MY_INIT("escape-t");
+
+  plan(ESCAPE_LOOP_COUNT * array_elements(charsets) * 2 + 5);
+
+  for (i= 0; i < ESCAPE_LOOP_COUNT; i++)
+  {
+    size_t length= rand() % 200 + 1;
+    char *src= malloc(length);
+    for (j= 0; j < array_elements(charsets); j++)
+    {
+      fill_random(src, length, i % 20, i % 50);
+      ok(compare_escape(charsets[j], src, length, 0),
+         "escape %s, length %u", charsets[j]->name, (uint) length);
+      ok(compare_escape(charsets[j], src, length, rand() % (length * 2) + 1),
+         "escape %s with short buffer", charsets[j]->name);
+    }
+    free(src);
+  }
+
+  test_gbk_invalid_lead();
+  test_utf8();
+  test_utf8_random();
+  test_every_offset();
+
+  if (getenv("MYTAP_BENCHMARK"))
+    run_benchmark();
+
+  my_end(0);
+  return exit_status();
+}
@@ -0,0 +1,454 @@
+/* Copyright (C) 2026 MySQL Connector/C contributors
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA */
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <m_string.h>
+#include <m_ctype.h>
+#include <hash.h>
+#include <lf.h>
+#include <tap.h>
+
+#define RECORD_COUNT 5000
+#define ROUNDS       50000
+#define BENCH_COUNT  500000
+#define BENCH_BYTES  (64 * 1024 * 1024)
+#define BUCKETS      65536
+#define DISTRIBUTION_KEYS (16 * BUCKETS)
+/* About 6 standard deviations above the chi-square of uniform buckets */
+#define CHI_SQUARE_LIMIT (BUCKETS + 1600)
+
+static volatile ulonglong hash_sink;
+
+typedef struct st_record
+{
+  char key[24];
+  size_t length;
+  my_bool inserted;
+} RECORD;
+
+static uchar *get_key(const uchar *record, size_t *length,
+                      my_bool not_used __attribute__((unused)))
+{
+  *length= ((RECORD*) record)->length;
+  return (uchar*) ((RECORD*) record)->key;
+}
+
+static void make_key(RECORD *record, uint nr)
+{
+  record->length= my_snprintf(record->key, sizeof(record->key),
+                              nr & 1 ? "key-%u" : "a longer key %u", nr);
+}
+
+static my_bool count_record(void *record __attribute__((unused)), void *arg)
+{
+  (*(uint*) arg)++;
+  return 0;
+}
+
+#ifndef DBUG_OFF
+#define hash_ok(H) (!my_hash_check(H))
+#else
+#define hash_ok(H) 1
+#endif
+
+
+/*
+  Run random inserts, deletes, updates and searches against a hash,
+  checking each against the records and the hash structure at the end
+*/
+
+static void test_random(uint flags, CHARSET_INFO *cs, const char *name)
+{
+  HASH hash;
+  RECORD *records= calloc(RECORD_COUNT, sizeof(RECORD));
+  uint i, inserted= 0, bad= 0, iterated= 0;
+
+  srand(flags + 1);
+  for (i= 0; i < RECORD_COUNT; i++)
+    make_key(records + i, i);
+  my_hash_init(&hash, cs, 16, 0, 0, get_key, 0, flags | HASH_UNIQUE);
+
+  for (i= 0; i < ROUNDS; i++)
+  {
+    RECORD *record= records + rand() % RECORD_COUNT;
+    uchar *found;
+    switch (rand() % 4) {
+    case 0:
+      found= my_hash_search(&hash, (uchar*) record->key, record->length);
+      if (my_hash_insert(&hash, (uchar*) record) != (found != 0) ||
+          record->inserted != (found == (uchar*) record))
+        bad++;
+      else if (!found)
+      {
+        record->inserted= 1;
+        inserted++;
+      }
+      break;
+    case 1:
+      if (my_hash_delete(&hash, (uchar*) record) != !record->inserted)
+        bad++;
+      else if (record->inserted)
+      {
+        record->inserted= 0;
+        inserted--;
+      }
+      break;
+    case 2:
+    {
+      /* Give the record the key of another one, if that is not used */
+      RECORD old= *record;
+      uint nr= rand() % (RECORD_COUNT * 2);
+      make_key(record, nr);
+      if (!record->inserted)
+        break;
+      found= my_hash_search(&hash, (uchar*) record->key, record->length);
+      if (my_hash_update(&hash, (uchar*) record, (uchar*) old.key,
+                         old.length) != (found && found != (uchar*) record))
+        bad++;
+      if (found && found != (uchar*) record)
+        *record= old;
+      break;
+    }
+    default:
+      found= my_hash_search(&hash, (uchar*) record->key, record->length);
+      if ((found == (uchar*) record) != record->inserted ||
+          (record->inserted && !found))
+        bad++;
+    }
+  }
+  for (i= 0; i < RECORD_COUNT; i++)
+  {
+    if ((my_hash_search(&hash, (uchar*) records[i].key, records[i].length) ==
+         (uchar*) (records + i)) != records[i].inserted)
+      bad++;
+  }
+  for (i= 0; i < hash.records; i++)
+  {
+    if (!((RECORD*) my_hash_element(&hash, i))->inserted)
+      bad++;
+  }
+  my_hash_iterate(&hash, count_record, &iterated);
+  ok(!bad && hash.records == inserted && iterated == inserted &&
+     hash_ok(&hash), "%s: %u operations on %u records", name, ROUNDS,
+     inserted);
+
+  my_hash_reset(&hash);
+  for (i= 0; i < 100; i++)
+  {
+    make_key(records + i, i);
+    my_hash_insert(&hash, (uchar*) (records + i));
+  }
+  ok(hash.records == 100 &&
+     my_hash_search(&hash, (uchar*) records[7].key, records[7].length) ==
+     (uchar*) (records + 7) && hash_ok(&hash), "%s: reset", name);
+  my_hash_free(&hash);
+  free(records);
+}
+
+
+static void test_duplicates(uint flags, const char *name)
+{
+  HASH hash;
+  RECORD records[40], other;
+  HASH_SEARCH_STATE state;
+  uchar *found;
+  uint i, count= 0, replaced= 0;
+
+  my_hash_init(&hash, &my_charset_bin, 0, 0, 0, get_key, 0, flags);
+  for (i= 0; i < 40; i++)
+  {
+    make_key(records + i, i % 4 ? i : 1000);
+    my_hash_insert(&hash, (uchar*) (records + i));
+  }
+  (void) my_hash_first(&hash, (uchar*) records[0].key, records[0].length,
+                       &state);
+  found= my_hash_next(&hash, (uchar*) records[0].key, records[0].length,
+                      &state);
+  other= *(RECORD*) found;
+  my_hash_replace(&hash, &state, (uchar*) &other);
+  for (found= my_hash_first(&hash, (uchar*) "a longer key 1000", 17, &state) ;
+       found ;
+       found= my_hash_next(&hash, (uchar*) "a longer key 1000", 17, &state))
+  {
+    count++;
+    replaced+= found == (uchar*) &other;
+  }
+  ok(count == 10 && replaced == 1 && hash_ok(&hash), "%s: duplicate keys",
+     name);
+  my_hash_free(&hash);
+}
+
+
+static void test_collation(void)
+{
+  HASH hash;
+  RECORD record;
+
+  my_hash_init(&hash, &my_charset_latin1, 0, 0, 0, get_key, 0,
+               HASH_OPEN | HASH_UNIQUE);
+  strmov(record.key, "Some Key");
+  record.length= 8;
+  my_hash_insert(&hash, (uchar*) &record);
+  ok(my_hash_search(&hash, (uchar*) "sOME kEY", 8) == (uchar*) &record &&
+     my_hash_insert(&hash, (uchar*) &record), "collation of the keys");
+  my_hash_free(&hash);
+}
+
+
+/* The collation hash of the binary keys, replaced by my_hash_bytes() */
+
+static ulonglong hash_sort_bin(const uchar *key, size_t length)
+{
+  ulong nr1= 1, nr2= 4;
+  my_charset_bin.coll->hash_sort(&my_charset_bin, key, length, &nr1, &nr2);
+  return nr1;
+}
+
+static double chi_square(const uint *buckets)
+{
+  double sum= 0, expected= DISTRIBUTION_KEYS / (double) BUCKETS;
+  uint i;
+  for (i= 0; i < BUCKETS; i++)
+    sum+= (buckets[i] - expected) * (buckets[i] - expected) / expected;
+  return sum;
+}
+
+
+/*
+  Put counters and text keys in buckets by the low and by the high
+  16 bits of the 32 bit hash numbers used by HASH and LF_HASH
+*/
+
+static void test_distribution(void)
+{
+  uint *low= malloc(BUCKETS * sizeof(uint));
+  uint *high= malloc(BUCKETS * sizeof(uint));
+  double result[2][4];
+  uint function, keys, i;
+
+  for (function= 0; function < 2; function++)
+  {
+    for (keys= 0; keys < 2; keys++)
+    {
+      bzero(low, BUCKETS * sizeof(uint));
+      bzero(high, BUCKETS * sizeof(uint));
+      for (i= 0; i < DISTRIBUTION_KEYS; i++)
+      {
+        uchar key[24];
+        size_t length= 4;
+        uint nr;
+        if (keys)
+          length= my_snprintf((char*) key, sizeof(key), "key-%u", i);
+        else
+          int4store(key, i);
+        nr= (uint) (function ? hash_sort_bin(key, length) :
+                    my_hash_bytes(key, length, 0));
+        low[nr & 0xFFFF]++;
+        high[nr >> 16]++;
+      }
+      result[function][keys * 2]= chi_square(low);
+      result[function][keys * 2 + 1]= chi_square(high);
+    }
+  }
+  diag("chi-square of %u buckets, low/high bits of counters, text keys:",
+       BUCKETS);
+  for (function= 0; function < 2; function++)
+    diag("%-14s %10.0f %10.0f %10.0f %10.0f",
+         function ? "hash_sort()" : "my_hash_bytes()", result[function][0],
+         result[function][1], result[function][2], result[function][3]);
+  ok(result[0][0] < CHI_SQUARE_LIMIT && result[0][1] < CHI_SQUARE_LIMIT &&
+     result[0][2] < CHI_SQUARE_LIMIT && result[0][3] < CHI_SQUARE_LIMIT,
+     "distribution of my_hash_bytes()");
+  free(low);
+  free(high);
+}
+
+
+/* Each bit of a key should change each bit of the hash half of the time */
+
+static void test_avalanche(void)
+{
+  uint flips[64], samples= 0, key_nr, bit, i;
+  uchar key[16];
+  double worst= 0;
+
+  bzero(flips, sizeof(flips));
+  for (key_nr= 0; key_nr < 2000; key_nr++)
+  {
+    size_t length= 1 + key_nr % sizeof(key);
+    ulonglong base, diff;
+    for (i= 0; i < sizeof(key); i++)
+      key[i]= (uchar) rand();
+    base= my_hash_bytes(key, length, 0);
+    for (bit= 0; bit < length * 8; bit++)
+    {
+      key[bit / 8]^= 1 << (bit % 8);
+      diff= base ^ my_hash_bytes(key, length, 0);
+      key[bit / 8]^= 1 << (bit % 8);
+      for (i= 0; i < 64; i++)
+        flips[i]+= (uint) (diff >> i) & 1;
+      samples++;
+    }
+  }
+  for (i= 0; i < 64; i++)
+  {
+    double bias= flips[i] / (double) samples - 0.5;
+    if (bias < 0)
+      bias= -bias;
+    if (bias > worst)
+      worst= bias;
+  }
+  ok(worst < 0.02 && my_hash_bytes(key, 16, 0) != my_hash_bytes(key, 16, 1),
+     "avalanche of my_hash_bytes(): %u flips, worst bit off by %.4f",
+     samples, worst);
+}
+
+
+static void test_lf_hash_binary(void)
+{
+  LF_HASH lf_hash;
+  LF_PINS *pins;
+  uint i, bad= 0;
+
+  lf_hash_init(&lf_hash, sizeof(uint), LF_HASH_UNIQUE | LF_HASH_BINARY, 0,
+               sizeof(uint), 0, &my_charset_bin);
+  pins= lf_hash_get_pins(&lf_hash);
+  for (i= 0; i < RECORD_COUNT; i++)
+    bad+= lf_hash_insert(&lf_hash, pins, &i) != 0;
+  for (i= 0; i < RECORD_COUNT; i++)
+    bad+= lf_hash_insert(&lf_hash, pins, &i) != 1;
+  for (i= 0; i < RECORD_COUNT; i+= 2)
+    bad+= lf_hash_delete(&lf_hash, pins, &i, sizeof(i)) != 0;
+  for (i= 0; i < RECORD_COUNT; i++)
+  {
+    uint *found= lf_hash_search(&lf_hash, pins, &i, sizeof(i));
+    bad+= i & 1 ? !found || *found != i : found != 0;
+    lf_hash_search_unpin(pins);
+  }
+  ok(!bad && lf_hash.count == RECORD_COUNT / 2, "LF_HASH with binary keys");
+  lf_hash_put_pins(pins);
+  lf_hash_destroy(&lf_hash);
+}
+
+
+static double rate(ulonglong start, uint count)
+{
+  return count / ((double) (my_getsystime() - start + 1) / 10000000.0);
+}
+
+static void run_benchmark(uint flags, const char *name)
+{
+  HASH hash;
+  RECORD *records= malloc(BENCH_COUNT * sizeof(RECORD));
+  ulonglong start;
+  double insert, search, miss, erase;
+  uint i, found= 0;
+
+  for (i= 0; i < BENCH_COUNT; i++)
+    make_key(records + i, i);
+  my_hash_init(&hash, &my_charset_bin, 0, 0, 0, get_key, 0, flags);
+
+  start= my_getsystime();
+  for (i= 0; i < BENCH_COUNT; i++)
+    my_hash_insert(&hash, (uchar*) (records + i));
+  insert= rate(start, BENCH_COUNT);
+
+  start= my_getsystime();
+  for (i= 0; i < BENCH_COUNT; i++)
+  {
+    RECORD *record= records + (i * 7919) % BENCH_COUNT;
+    found+= my_hash_search(&hash, (uchar*) record->key,
+                           record->length) != 0;
+  }
+  search= rate(start, BENCH_COUNT);
+
+  start= my_getsystime();
+  for (i= 0; i < BENCH_COUNT; i++)
+    found+= my_hash_search(&hash, (uchar*) "no such key", 11) != 0;
+  miss= rate(start, BENCH_COUNT);
+
+  start= my_getsystime();
+  for (i= 0; i < BENCH_COUNT; i++)
+    my_hash_delete(&hash, (uchar*) (records + (i * 7919) % BENCH_COUNT));
+  erase= rate(start, BENCH_COUNT);
+
+  diag("%-14s insert %5.1f M/s, search %5.1f M/s, miss %5.1f M/s, "
+       "delete %5.1f M/s", name, insert / 1e6, search / 1e6, miss / 1e6,
+       erase / 1e6);
+  if (found != BENCH_COUNT || hash.records)
+    diag("%s: %u records found, %lu left", name, found, hash.records);
+  my_hash_free(&hash);
+  free(records);
+}
+
+
+static void run_bytes_benchmark(void)
+{
+  static const size_t lengths[]= { 4, 16, 64, 1024 };
+  uchar *buffer= malloc(BENCH_BYTES);
+  uint i, function;
+
+  for (i= 0; i < BENCH_BYTES; i++)
+    buffer[i]= (uchar) rand();
+  for (i= 0; i < array_elements(lengths); i++)
+  {
+    double speed[2];
+    for (function= 0; function < 2; function++)
+    {
+      ulonglong start= my_getsystime(), sum= 0;
+      uchar *key;
+      for (key= buffer; key + lengths[i] <= buffer + BENCH_BYTES;
+           key+= lengths[i])
+        sum+= function ? hash_sort_bin(key, lengths[i]) :
+                         my_hash_bytes(key, lengths[i], 0);
+      hash_sink+= sum;
+      speed[function]= rate(start, BENCH_BYTES) / (1024 * 1024);
+    }
+    diag("%4u byte keys: my_hash_bytes() %6.0f MB/s, hash_sort() %6.0f MB/s",
+         (uint) lengths[i], speed[0], speed[1]);
+  }
+  free(buffer);
+}
+
+
+int main(void)
+{
+  MY_INIT("hash-t");
+
+  plan(14);
+
+  test_random(0, &my_charset_bin, "chained");
+  test_random(HASH_BINARY, &my_charset_bin, "chained binary");
+  test_random(HASH_OPEN, &my_charset_bin, "open");
+  test_random(HASH_OPEN, &my_charset_latin1, "open latin1");
+  test_duplicates(0, "chained");
+  test_duplicates(HASH_OPEN, "open");
+  test_collation();
+  test_distribution();
+  test_avalanche();
+  test_lf_hash_binary();
+
+  if (getenv("MYTAP_BENCHMARK"))
+  {
+    run_benchmark(0, "chained");
+    run_benchmark(HASH_BINARY, "chained binary");
+    run_benchmark(HASH_OPEN, "open");
+    run_bytes_benchmark();
+  }
+
+  my_end(0);
+  return exit_status();
+}
@@ -0,0 +1,171 @@
+/* Copyright (C) 2026 MySQL Connector/C contributors
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA */
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <m_string.h>
+#include <tap.h>
+#include <string.h>
+
+#define HEX_LOOP_COUNT 500
+#define HEX_ROWS 4                              /* Number of ok(..) */
+#define BENCH_LENGTH   (4*1024*1024)
+#define BENCH_ROUNDS   8
+
+/* The byte at a time versions, which the results are compared against */
+
+static size_t ref_encode(char *to, const uchar *from, size_t length)
+{
+  const uchar *end= from + length;
+  for (; from < end; from++)
+  {
+    *to++= _dig_vec_upper[*from >> 4];
+    *to++= _dig_vec_upper[*from & 0x0F];
+  }
+  return length * 2;
+}
+
+static int ref_val(uchar c)
+{
+  const char *pos= strchr(_dig_vec_upper, my_toupper(&my_charset_latin1, c));
+  return c && pos && pos - _dig_vec_upper < 16 ? (int) (pos - _dig_vec_upper)
+                                               : -1;
+}
+
+static size_t ref_decode(uchar *to, const char *from, size_t length)
+{
+  size_t i;
+  if (length & 1)
+    return (size_t) -1;
+  for (i= 0; i < length; i+= 2)
+  {
+    int hi= ref_val(from[i]), lo= ref_val(from[i + 1]);
+    if (hi < 0 || lo < 0)
+      return (size_t) -1;
+    *to++= (uchar) (hi << 4 | lo);
+  }
+  return length / 2;
+}
+
+
+static double bench_rate(ulonglong start, size_t length)
+{
+  return (double) length * BENCH_ROUNDS / (1024.0 * 1024.0) /
+         ((double) (my_getsystime() - start + 1) / 10000000.0);
+}
+
+static void run_benchmark(void)
+{
+  uchar *bin= malloc(BENCH_LENGTH);
+  char *hex= malloc(2 * BENCH_LENGTH);
+  ulonglong start;
+  double enc, ref_enc, dec, ref_dec;
+  size_t i;
+
+  for (i= 0; i < BENCH_LENGTH; i++)
+    bin[i]= (uchar) rand();
+
+  start= my_getsystime();
+  for (i= 0; i < BENCH_ROUNDS; i++)
+    my_hex_encode(hex, bin, BENCH_LENGTH);
+  enc= bench_rate(start, BENCH_LENGTH);
+  start= my_getsystime();
+  for (i= 0; i < BENCH_ROUNDS; i++)
+    ref_encode(hex, bin, BENCH_LENGTH);
+  ref_enc= bench_rate(start, BENCH_LENGTH);
+
+  start= my_getsystime();
+  for (i= 0; i < BENCH_ROUNDS; i++)
+    my_hex_decode(bin, hex, 2 * BENCH_LENGTH);
+  dec= bench_rate(start, BENCH_LENGTH);
+  start= my_getsystime();
+  for (i= 0; i < BENCH_ROUNDS; i++)
+    ref_decode(bin, hex, 2 * BENCH_LENGTH);
+  ref_dec= bench_rate(start, BENCH_LENGTH);
+
+  diag("encode %8.1f MB/s (byte at a time: %8.1f MB/s)", enc, ref_enc);
+  diag("decode %8.1f MB/s (byte at a time: %8.1f MB/s)", dec, ref_dec);
+  free(bin);
+  free(hex);
+}
+
+
+int
+main(void)
+{
+  int i;
+  MY_INIT("hex-t");
+
+  plan(HEX_LOOP_COUNT * HEX_ROWS + 1);
+
+  for (i= 0; i < HEX_LOOP_COUNT; i++)
+  {
+    size_t src_len= rand() % 300, j, pos;
+    uchar *src= malloc(src_len + 1), *dst= malloc(src_len + 1);
+    char *hex= malloc(2 * src_len + 1), *ref= malloc(2 * src_len + 1);
+    int bad;
+
+    for (j= 0; j < src_len; j++)
+      src[j]= (uchar) rand();
+
+    ok(my_hex_encode(hex, src, src_len) == 2 * src_len &&
+       ref_encode(ref, src, src_len) == 2 * src_len &&
+       !memcmp(hex, ref, 2 * src_len), "encode %u bytes", (uint) src_len);
+
+    /* decoding must accept lower case digits as well */
+    for (j= 0; j < 2 * src_len; j++)
+      if (rand() & 1)
+        hex[j]= my_tolower(&my_charset_latin1, hex[j]);
+    ok(my_hex_decode(dst, hex, 2 * src_len) == src_len &&
+       !memcmp(dst, src, src_len), "decode %u bytes", (uint) src_len);
+
+    /* a single bad character anywhere must be detected */
+    bad= 0;
+    if (src_len)
+    {
+      pos= rand() % (2 * src_len);
+      do
+        hex[pos]= (char) rand();
+      while (ref_val(hex[pos]) >= 0);
+      bad= 1;
+    }
+    ok(my_hex_decode(dst, hex, 2 * src_len) ==
+       (bad ? (size_t) -1 : src_len), "invalid digit in %u bytes",
+       (uint) src_len);
+
+    ok(my_hex_decode(dst, ref, 2 * src_len + 1) == (size_t) -1,
+       "odd length %u", (uint) (2 * src_len + 1));
+
+    free(src);
+    free(dst);
+    free(hex);
+    free(ref);
+  }
+
+  {
+    char buf[40];
+    uchar bin[20];
+    ok(my_hex_decode(bin, "00fFa5C3", 8) == 4 &&
+       !memcmp(bin, "\x00\xff\xa5\xc3", 4) &&
+       my_hex_encode(buf, bin, 4) == 8 && !memcmp(buf, "00FFA5C3", 8),
+       "known values");
+  }
+
+  if (getenv("MYTAP_BENCHMARK"))
+    run_benchmark();
+
+  my_end(0);
+  return exit_status();
+}
@@ -26,6 +26,8 @@
 int32 inserts= 0, N;
 LF_ALLOCATOR lf_allocator;
 LF_HASH lf_hash;
+LF_QUEUE lf_queue;
+my_atomic_rwlock_t rwl;
 
 /*
   pin allocator - alloc and release an element in a loop
@@ -105,7 +107,9 @@ pthread_handler_t test_lf_alloc(void *arg)
   return 0;
 }
 
+/* the iterations are divided by 2*N_TLH, that many make one round */
 #define N_TLH 1000
+#define LF_HASH_CYCLES (20*2*N_TLH)
 pthread_handler_t test_lf_hash(void *arg)
 {
   int    m= (*(int *)arg)/(2*N_TLH);
@@ -157,9 +161,401 @@ pthread_handler_t test_lf_hash(void *arg)
 }
 
 
+/*
+  with epochs a found element is held in a critical section: one hold
+  per LF_PINS, like pin 2, released by the next search or the unpin
+*/
+void test_lf_hash_search_hold()
+{
+  LF_PINS *pins= lf_hash_get_pins(&lf_hash);
+  int key= 1, missing= 2, errors= 0;
+
+  if (lf_hash_insert(&lf_hash, pins, &key) < 0)
+    errors++;
+  errors+= !lf_hash_search(&lf_hash, pins, &key, sizeof(key));
+  errors+= !lf_hash_search(&lf_hash, pins, &key, sizeof(key));
+  errors+= pins->epoch_depth != 1;
+  lf_hash_search_unpin(pins);
+  errors+= pins->epoch_depth != 0;
+
+  /* a miss releases the previous hit, and the unpin after it is a no-op */
+  _lf_epoch_enter(pins);
+  errors+= !lf_hash_search(&lf_hash, pins, &key, sizeof(key));
+  errors+= lf_hash_search(&lf_hash, pins, &missing, sizeof(missing)) != 0;
+  errors+= pins->epoch_depth != 1;
+  lf_hash_search_unpin(pins);
+  lf_hash_search_unpin(pins);
+  errors+= pins->epoch_depth != 1;
+  _lf_epoch_leave(pins);
+
+  errors+= lf_hash_delete(&lf_hash, pins, &key, sizeof(key)) != 0;
+  lf_hash_put_pins(pins);
+  ok(!errors && !lf_hash.count, "lf_hash_search holds one epoch");
+}
+
+
+static my_bool sum_element(void *element, void *arg)
+{
+  ((int64 *)arg)[0]+= *(int *)element;
+  ((int64 *)arg)[1]++;
+  return 0;
+}
+
+static uint32 chain_buckets(LF_HASH_STATS *stats)
+{
+  uint32 i, buckets= 0;
+  for (i= 0; i < LF_HASH_CHAIN_LENGTHS; i++)
+    buckets+= stats->chains[i];
+  return buckets;
+}
+
+/*
+  growing and shrinking with a load factor of 2, iteration and stats
+*/
+void test_lf_hash_resize()
+{
+  LF_HASH hash;
+  LF_HASH_STATS full, empty;
+  LF_PINS *pins;
+  int64 sum[2]= {0, 0}, left[2]= {0, 0};
+  int i, errors= 0;
+
+  lf_hash_init(&hash, sizeof(int), LF_HASH_UNIQUE | LF_HASH_BINARY, 0,
+               sizeof(int), 0, &my_charset_bin);
+  hash.max_load= 2.0;
+  pins= lf_hash_get_pins(&hash);
+  for (i= 0; i < 10000; i++)
+    errors+= lf_hash_insert(&hash, pins, &i) != 0;
+  lf_hash_iterate(&hash, pins, sum_element, sum);
+  lf_hash_get_stats(&hash, pins, &full);
+  for (i= 0; i < 10000; i++)
+    errors+= lf_hash_delete(&hash, pins, &i, sizeof(i)) != 0;
+  lf_hash_iterate(&hash, pins, sum_element, left);
+  lf_hash_get_stats(&hash, pins, &empty);
+  diag("10000 elements: %u buckets, %u used, longest chain %u; "
+       "empty: %u buckets, %u dummy nodes", full.size, full.buckets,
+       full.max_chain, empty.size, empty.dummies);
+  ok(!errors && sum[0] == 9999*10000/2 && sum[1] == 10000 &&
+     full.size == 8192 && chain_buckets(&full) == full.buckets &&
+     !left[1] && !empty.count && empty.size <= 4 &&
+     empty.dummies >= full.buckets,
+     "lf_hash resize, iterate and stats");
+  lf_hash_put_pins(pins);
+  lf_hash_destroy(&hash);
+}
+
+/*
+  scaling benchmark: a mix of 90% searches, 5% inserts and 5% deletes
+  of random keys, from 1 to 64 threads, with pins or with epochs.
+  without MYTAP_BENCHMARK only a short run with 8 threads is done, to
+  check the element count
+*/
+#define BENCH_OPS  2000000
+#define BENCH_KEYS 65536
+int32 bench_ops;
+int64 bench_net;
+
+pthread_handler_t bench_lf_hash(void *arg)
+{
+  int m= *(int *)arg;
+  uint32 x= (uint32)(intptr)&m;
+  int64 net= 0;
+  LF_PINS *pins;
+
+  my_thread_init();
+  pins= lf_hash_get_pins(&lf_hash);
+  for (; m ; m--)
+  {
+    int key, op;
+    x= x*1103515245 + 12345;
+    key= (x >> 8) % BENCH_KEYS;
+    op= (x >> 24) % 20;
+    if (op == 0)
+      net+= lf_hash_insert(&lf_hash, pins, &key) == 0;
+    else if (op == 1)
+      net-= lf_hash_delete(&lf_hash, pins, &key, sizeof(key)) == 0;
+    else
+    {
+      lf_hash_search(&lf_hash, pins, &key, sizeof(key));
+      lf_hash_search_unpin(pins);
+    }
+  }
+  lf_hash_put_pins(pins);
+  pthread_mutex_lock(&mutex);
+  bench_net+= net;
+  if (!--running_threads) pthread_cond_signal(&cond);
+  pthread_mutex_unlock(&mutex);
+  my_thread_end();
+  return 0;
+}
+
+void run_lf_hash_scaling(uint flags)
+{
+  const char *name= flags & LF_HASH_EPOCHS ? "epochs" : "pins";
+  LF_PINS *pins;
+  LF_HASH_STATS stats;
+  int64 counted[2];
+  int threads, i, m;
+  uint32 retries= 0;
+  my_bool bench= getenv("MYTAP_BENCHMARK") != 0;
+  int ops= bench ? BENCH_OPS : BENCH_OPS / 20;
+
+  lf_hash_init(&lf_hash, sizeof(int), LF_HASH_UNIQUE | LF_HASH_BINARY | flags,
+               0, sizeof(int), 0, &my_charset_bin);
+  pins= lf_hash_get_pins(&lf_hash);
+  for (i= 0, bench_net= 0; i < BENCH_KEYS; i+= 2)
+    bench_net+= lf_hash_insert(&lf_hash, pins, &i) == 0;
+  lf_hash_put_pins(pins);
+
+  for (threads= bench ? 1 : 8; threads <= (bench ? 64 : 8); threads*= 2)
+  {
+    pthread_t t;
+    ulonglong now= my_getsystime();
+    m= ops / threads;
+    for (running_threads= i= threads ; i ; i--)
+    {
+      if (pthread_create(&t, &thr_attr, bench_lf_hash, &m) != 0)
+      {
+        diag("Could not create thread");
+        abort();
+      }
+    }
+    pthread_mutex_lock(&mutex);
+    while (running_threads)
+      pthread_cond_wait(&cond, &mutex);
+    pthread_mutex_unlock(&mutex);
+    now= my_getsystime() - now;
+    if (!bench)
+      continue;
+
+    pins= lf_hash_get_pins(&lf_hash);
+    lf_hash_get_stats(&lf_hash, pins, &stats);
+    lf_hash_put_pins(pins);
+    diag("%s, %2d threads: %6.2f Mops/s, %u elements, longest chain %u, "
+         "%u pins, %u in purgatory, %u pin retries", name, threads,
+         (double)BENCH_OPS / now * 10, stats.count, stats.max_chain,
+         stats.pins, stats.purgatory, stats.pin_retries - retries);
+    retries= stats.pin_retries;
+  }
+
+  counted[0]= counted[1]= 0;
+  pins= lf_hash_get_pins(&lf_hash);
+  lf_hash_iterate(&lf_hash, pins, sum_element, counted);
+  lf_hash_put_pins(pins);
+  ok(lf_hash.count == bench_net && counted[1] == bench_net,
+     "lf_hash scaling with %s, %d elements", name, lf_hash.count);
+  lf_hash_destroy(&lf_hash);
+}
+
+/*
+  queue: half of the threads push, half pop, with and without waiting.
+  a small queue is full or empty most of the time
+*/
+int32 queue_threads;
+
+pthread_handler_t test_lf_queue(void *arg)
+{
+  int    m= *(int *)arg;
+  int32 x, y, sum= 0;
+  my_bool pusher;
+
+  my_thread_init();
+  my_atomic_rwlock_wrlock(&rwl);
+  pusher= my_atomic_add32(&queue_threads, 1) & 1;
+  my_atomic_rwlock_wrunlock(&rwl);
+
+  for (x= ((int)(intptr)(&m)); m ; m--)
+  {
+    if (pusher)
+    {
+      x= (x*m+0x87654321) & INT_MAX32;
+      if (m % 3)
+        lf_queue_push_wait(&lf_queue, &x);
+      else
+        while (lf_queue_push(&lf_queue, &x))
+          pthread_yield();
+      sum+= x;
+    }
+    else
+    {
+      if (m % 3)
+        lf_queue_pop_wait(&lf_queue, &y);
+      else
+        while (lf_queue_pop(&lf_queue, &y))
+          pthread_yield();
+      sum-= y;
+    }
+  }
+  pthread_mutex_lock(&mutex);
+  bad+= sum;
+  if (!--running_threads) pthread_cond_signal(&cond);
+  pthread_mutex_unlock(&mutex);
+  my_thread_end();
+  return 0;
+}
+
+/*
+  queue: popping threads block on an empty queue, then get some elements
+  and one stop element each. every thread must wake up and stop
+*/
+#define STOP_POPPERS 8
+#define STOP_ROUNDS  20
+int64 stop_sum;
+
+pthread_handler_t test_lf_queue_stop_popper(void *arg __attribute__((unused)))
+{
+  int32 x;
+  int64 sum= 0;
+
+  my_thread_init();
+  for (;;)
+  {
+    lf_queue_pop_wait(&lf_queue, &x);
+    if (x < 0)
+      break;
+    sum+= x;
+  }
+  pthread_mutex_lock(&mutex);
+  stop_sum+= sum;
+  if (!--running_threads) pthread_cond_signal(&cond);
+  pthread_mutex_unlock(&mutex);
+  my_thread_end();
+  return 0;
+}
+
+void test_lf_queue_stop()
+{
+  int round, i, errors= 0;
+  int32 x;
+  struct timespec abstime;
+
+  lf_queue_init(&lf_queue, sizeof(int32), 4);
+  for (round= 0; round < STOP_ROUNDS && !errors; round++)
+  {
+    pthread_t t;
+    stop_sum= 0;
+    for (running_threads= i= STOP_POPPERS ; i ; i--)
+    {
+      if (pthread_create(&t, &thr_attr, test_lf_queue_stop_popper, 0) != 0)
+      {
+        diag("Could not create thread");
+        abort();
+      }
+    }
+    /* let them block, most of the time */
+    my_sleep(10000);
+    for (x= 0; x < round * 10; x++)
+      lf_queue_push_wait(&lf_queue, &x);
+    for (i= 0, x= -1; i < STOP_POPPERS; i++)
+      lf_queue_push_wait(&lf_queue, &x);
+
+    set_timespec(abstime, 60);
+    pthread_mutex_lock(&mutex);
+    while (running_threads)
+    {
+      if (pthread_cond_timedwait(&cond, &mutex, &abstime) == ETIMEDOUT)
+      {
+        diag("round %d: %u threads did not stop", round, running_threads);
+        errors++;
+        break;
+      }
+    }
+    pthread_mutex_unlock(&mutex);
+    errors+= stop_sum != (int64) round * 10 * (round * 10 - 1) / 2;
+  }
+  ok(!errors && lf_queue_pop(&lf_queue, &x), "lf_queue stop elements");
+  /* threads that did not stop still use the queue */
+  if (!errors)
+    lf_queue_destroy(&lf_queue);
+}
+
+/*
+  queue throughput, from 1 to 32 pushing and as many popping threads.
+  every element is the number of its pusher and a sequence number, a
+  popping thread must see the elements of each pusher in order.
+  without MYTAP_BENCHMARK only a short run with 4+4 threads is done
+*/
+#define QUEUE_OPS 2000000
+int32 queue_pushers;
+uint32 queue_disorder;
+
+pthread_handler_t bench_lf_queue(void *arg)
+{
+  int m= *(int *)arg;
+  uint32 i, x, last[32], disorder= 0;
+
+  my_thread_init();
+  my_atomic_rwlock_wrlock(&rwl);
+  if ((int32) (x= my_atomic_add32(&queue_pushers, -1)) > 0)
+  {
+    my_atomic_rwlock_wrunlock(&rwl);
+    for (i= 0; i < (uint32) m; i++)
+    {
+      uint32 element= (x << 24) | i;
+      lf_queue_push_wait(&lf_queue, &element);
+    }
+  }
+  else
+  {
+    my_atomic_rwlock_wrunlock(&rwl);
+    for (i= 0; i < 32; i++)
+      last[i]= ~0U;
+    for (i= 0; i < (uint32) m; i++)
+    {
+      lf_queue_pop_wait(&lf_queue, &x);
+      if ((x & 0xFFFFFF) != last[(x >> 24) % 32] + 1)
+        disorder+= (int32) ((x & 0xFFFFFF) - last[(x >> 24) % 32]) <= 0;
+      last[(x >> 24) % 32]= x & 0xFFFFFF;
+    }
+  }
+  pthread_mutex_lock(&mutex);
+  queue_disorder+= disorder;
+  if (!--running_threads) pthread_cond_signal(&cond);
+  pthread_mutex_unlock(&mutex);
+  my_thread_end();
+  return 0;
+}
+
+void run_lf_queue_throughput()
+{
+  int threads, i, m;
+  uint32 left;
+  my_bool bench= getenv("MYTAP_BENCHMARK") != 0;
+  int ops= bench ? QUEUE_OPS : QUEUE_OPS / 20;
+
+  lf_queue_init(&lf_queue, sizeof(uint32), 1024);
+  queue_disorder= 0;
+  for (threads= bench ? 1 : 4; threads <= (bench ? 32 : 4); threads*= 2)
+  {
+    pthread_t t;
+    ulonglong now= my_getsystime();
+    m= ops / threads;
+    queue_pushers= threads;
+    for (running_threads= i= 2 * threads ; i ; i--)
+    {
+      if (pthread_create(&t, &thr_attr, bench_lf_queue, &m) != 0)
+      {
+        diag("Could not create thread");
+        abort();
+      }
+    }
+    pthread_mutex_lock(&mutex);
+    while (running_threads)
+      pthread_cond_wait(&cond, &mutex);
+    pthread_mutex_unlock(&mutex);
+    now= my_getsystime() - now;
+    if (bench)
+      diag("%2d+%-2d threads: %6.2f Mops/s", threads, threads,
+           (double) m * threads / now * 10);
+  }
+  ok(!queue_disorder && lf_queue_pop(&lf_queue, &left),
+     "lf_queue throughput, %u out of order", queue_disorder);
+  lf_queue_destroy(&lf_queue);
+}
+
 void do_tests()
 {
-  plan(4);
+  plan(13);
 
   lf_alloc_init(&lf_allocator, sizeof(TLA), offsetof(TLA, not_used));
   lf_hash_init(&lf_hash, sizeof(int), LF_HASH_UNIQUE, 0, sizeof(int), 0,
@@ -170,9 +566,35 @@ void do_tests()
 
   test_concurrently("lf_pinbox", test_lf_pinbox, N= THREADS, CYCLES);
   test_concurrently("lf_alloc",  test_lf_alloc,  N= THREADS, CYCLES);
-  test_concurrently("lf_hash",   test_lf_hash,   N= THREADS, CYCLES/10);
+  test_concurrently("lf_hash",   test_lf_hash,   N= THREADS, LF_HASH_CYCLES);
 
   lf_hash_destroy(&lf_hash);
   lf_alloc_destroy(&lf_allocator);
+
+  lf_alloc_init(&lf_allocator, sizeof(TLA), offsetof(TLA, not_used));
+  lf_alloc_use_epochs(&lf_allocator);
+  lf_hash_init(&lf_hash, sizeof(int), LF_HASH_UNIQUE | LF_HASH_EPOCHS, 0,
+               sizeof(int), 0, &my_charset_bin);
+
+  test_concurrently("lf_alloc with epochs", test_lf_alloc,
+                    N= THREADS, CYCLES);
+  test_concurrently("lf_hash with epochs",  test_lf_hash,
+                    N= THREADS, LF_HASH_CYCLES);
+  test_lf_hash_search_hold();
+
+  lf_hash_destroy(&lf_hash);
+  lf_alloc_destroy(&lf_allocator);
+
+  test_lf_hash_resize();
+  run_lf_hash_scaling(0);
+  run_lf_hash_scaling(LF_HASH_EPOCHS);
+
+  my_atomic_rwlock_init(&rwl);
+  lf_queue_init(&lf_queue, sizeof(int32), 64);
+  test_concurrently("lf_queue", test_lf_queue, THREADS, CYCLES);
+  lf_queue_destroy(&lf_queue);
+  test_lf_queue_stop();
+  run_lf_queue_throughput();
+  my_atomic_rwlock_destroy(&rwl);
 }
 
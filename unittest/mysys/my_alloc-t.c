@@ -0,0 +1,473 @@
+/* Copyright (C) 2026 MySQL Connector/C contributors
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA */
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <tap.h>
+#include <string.h>
+
+#define OBJECT_COUNT 20000
+#define BENCH_COUNT  1000000
+#define BENCH_ROUNDS 10
+#define BENCH_RESULTS 200000
+#define BENCH_RESULT_ROWS 50
+#define BENCH_SCAN_SIZE (256 * 1024 * 1024L)
+#define BENCH_SCAN_ROW 64
+
+static uint limit_calls;
+static size_t limit_size;
+
+static void limit_handler(MEM_ROOT *root, size_t size, void *arg)
+{
+  limit_calls++;
+  limit_size= size;
+  *(MEM_ROOT**) arg= root;
+}
+
+
+/*
+  Allocate objects of random sizes, fill each with its own byte and
+  check that none of them was overwritten by another.
+*/
+
+static int fill_and_check(MEM_ROOT *root, uint count)
+{
+  uchar **objects= malloc(count * sizeof(uchar*));
+  size_t *sizes= malloc(count * sizeof(size_t));
+  uint i, bad= 0;
+
+  for (i= 0; i < count; i++)
+  {
+    sizes[i]= rand() % 8 ? rand() % 100 + 1 : rand() % 20000 + 1;
+    objects[i]= (uchar*) (i & 1 ? alloc_root(root, sizes[i]) :
+                          alloc_root_inline(root, sizes[i]));
+    if (!objects[i] || ((size_t) objects[i] & (ALIGN_SIZE(1) - 1)))
+    {
+      bad++;
+      break;
+    }
+    memset(objects[i], (uchar) i, sizes[i]);
+  }
+  for (; i-- > 0;)
+  {
+    size_t j;
+    for (j= 0; j < sizes[i]; j++)
+      if (objects[i][j] != (uchar) i)
+      {
+        bad++;
+        break;
+      }
+  }
+  free(objects);
+  free(sizes);
+  return !bad;
+}
+
+
+static void test_objects(void)
+{
+  MEM_ROOT root;
+  int res;
+
+  init_alloc_root(&root, 1024, 512);
+  root.min_malloc= 24;
+  res= fill_and_check(&root, OBJECT_COUNT);
+  free_root(&root, MYF(MY_MARK_BLOCKS_FREE));
+  res&= fill_and_check(&root, OBJECT_COUNT);
+  free_root(&root, MYF(MY_KEEP_PREALLOC));
+  res&= fill_and_check(&root, OBJECT_COUNT);
+  free_root(&root, MYF(0));
+  ok(res, "objects do not overlap");
+}
+
+
+static void test_limit(void)
+{
+  MEM_ROOT root, other;
+  MEM_ROOT *handler_root= 0;
+  size_t allocated;
+  uint count= 0;
+  int res= 1;
+
+  init_alloc_root(&root, 8192, 0);
+  res&= !set_alloc_root_limit(&root, 100000, limit_handler, &handler_root);
+  while (alloc_root(&root, 100))
+    count++;
+  allocated= alloc_root_allocated(&root);
+  res&= allocated <= 100000 && allocated > 100000 - 8192;
+  res&= limit_calls == 1 && limit_size > 100 && handler_root == &root;
+  /* an object larger than the limit fails at once */
+  res&= !alloc_root(&root, 200000) && limit_calls == 2;
+  ok(res, "limit of %lu bytes reached after %u objects in %lu bytes",
+     100000UL, count, (ulong) allocated);
+
+  /* The limit stays when the root is reused */
+  free_root(&root, MYF(MY_KEEP_PREALLOC));
+  res= alloc_root_allocated(&root) == 0;
+  count= 0;
+  while (alloc_root_inline(&root, 100))
+    count++;
+  res&= alloc_root_allocated(&root) <= 100000 && limit_calls == 3;
+  res&= !set_alloc_root_limit(&root, 0, 0, 0) && alloc_root(&root, 200000);
+
+  /* Memory moved into a limited root counts against its limit */
+  init_alloc_root(&other, 8192, 0);
+  res&= !set_alloc_root_limit(&other, 50000, 0, 0);
+  res&= alloc_root(&other, 1000) != 0;
+  allocated= alloc_root_allocated(&root);
+  move_root(&other, &root);
+  res&= alloc_root_allocated(&root) == 0;
+  res&= alloc_root_allocated(&other) >= allocated;
+  res&= !alloc_root(&other, 10000) && limit_calls == 3;
+  free_root(&other, MYF(0));
+  free_root(&root, MYF(0));
+  ok(res, "limit after free_root() and move_root()");
+}
+
+
+static void test_growth(void)
+{
+  MEM_ROOT root;
+  size_t last= 0, size, expect= 1024 - ALLOC_ROOT_MIN_BLOCK_SIZE;
+  uint i;
+  int res;
+
+  init_alloc_root(&root, 1024, 0);
+  res= !set_alloc_root_growth(&root, 100, 16384);
+  for (i= 0; i < 10;)
+  {
+    alloc_root(&root, 600);
+    if (!(size= alloc_root_allocated(&root) - last))
+      continue;                                 /* No new block */
+    last+= size;
+    if (size != expect)
+    {
+      diag("block %u: %lu bytes, expected %lu", i, (ulong) size,
+           (ulong) expect);
+      res= 0;
+    }
+    expect= min(expect * 2, 16384);
+    i++;
+  }
+  free_root(&root, MYF(0));
+
+  /* The maximum applies to the default growth as well */
+  init_alloc_root(&root, 1024, 0);
+  res&= !set_alloc_root_growth(&root, ALLOC_ROOT_GROWTH_LINEAR, 1024);
+  for (i= 0; i < 20; i++)
+    alloc_root(&root, 600);
+  res&= alloc_root_allocated(&root) ==
+        4 * (1024 - ALLOC_ROOT_MIN_BLOCK_SIZE) + 16 * 1024;
+  free_root(&root, MYF(0));
+  ok(res, "block growth");
+}
+
+
+static void test_cache(void)
+{
+  ALLOC_ROOT_CACHE *cache= create_alloc_root_cache(64 * 1024);
+  ALLOC_ROOT_CACHE_STATS stats;
+  MEM_ROOT root, other;
+  uint i;
+  int res;
+
+  /* A root filled and freed again takes its blocks from the cache */
+  init_alloc_root(&root, 8192, 0);
+  res= !set_alloc_root_cache(&root, cache);
+  res&= fill_and_check(&root, 200);
+  free_root(&root, MYF(0));
+  get_alloc_root_cache_stats(cache, &stats);
+  res&= stats.hits == 0 && stats.blocks > 0 && stats.size <= 64 * 1024;
+  for (i= 0; i < 10; i++)
+  {
+    init_alloc_root(&root, 8192, 0);
+    res&= !set_alloc_root_cache(&root, cache);
+    res&= fill_and_check(&root, 200);
+    free_root(&root, MYF(i & 1 ? 0 : MY_KEEP_PREALLOC));
+    free_root(&root, MYF(0));
+  }
+  get_alloc_root_cache_stats(cache, &stats);
+  res&= stats.hits > 10 && stats.size <= 64 * 1024;
+  ok(res, "block cache: %lu hits, %lu misses, %lu discarded, %lu blocks",
+     (ulong) stats.hits, (ulong) stats.misses, (ulong) stats.discarded,
+     (ulong) stats.blocks);
+
+  /* Cached blocks do not take a root over its limit */
+  init_alloc_root(&root, 8192, 0);
+  res= !set_alloc_root_cache(&root, cache) &&
+       !set_alloc_root_limit(&root, 20000, 0, 0);
+  while (alloc_root(&root, 1000))
+    ;
+  res&= alloc_root_allocated(&root) <= 20000;
+
+  /* The cache lives on while a root uses it */
+  init_alloc_root(&other, 8192, 0);
+  res&= !set_alloc_root_cache(&other, cache) && alloc_root(&other, 100);
+  resize_alloc_root_cache(cache, 8192);
+  get_alloc_root_cache_stats(cache, &stats);
+  res&= stats.size <= 8192;
+  release_alloc_root_cache(cache);
+  free_root(&root, MYF(0));
+  res&= alloc_root(&other, 10000) != 0;
+  free_root(&other, MYF(0));
+  ok(res, "block cache with a limit and after release");
+}
+
+
+/* Number of blocks of a root that are whole huge pages */
+
+static uint huge_page_blocks(MEM_ROOT *root)
+{
+  size_t page= my_huge_page_size();
+  USED_MEM *lists[2], *block;
+  uint i, count= 0;
+
+  lists[0]= root->used;
+  lists[1]= root->free;
+  for (i= 0; i < 2; i++)
+    for (block= lists[i]; block; block= block->next)
+      if (block->size && (block->size + MALLOC_OVERHEAD) % page == 0)
+        count++;
+  return count;
+}
+
+static void test_huge_pages(void)
+{
+  MEM_ROOT root;
+  size_t page= my_huge_page_size();
+  uint blocks;
+  int res;
+
+  /* A small root keeps its normal blocks */
+  init_alloc_root(&root, 8192, 0);
+  res= !set_alloc_root_huge_pages(&root, MY_HUGE_PAGES);
+  res&= fill_and_check(&root, 100);
+  res&= huge_page_blocks(&root) == 0;
+
+  /* A large one gets blocks of whole huge pages */
+  res&= fill_and_check(&root, OBJECT_COUNT);
+  blocks= huge_page_blocks(&root);
+  res&= blocks > 0;
+  free_root(&root, MYF(MY_MARK_BLOCKS_FREE));
+  res&= fill_and_check(&root, OBJECT_COUNT);
+  res&= huge_page_blocks(&root) >= blocks;
+  free_root(&root, MYF(0));
+
+  /* Within a limit, and with the reserved huge pages */
+  init_alloc_root(&root, 8192, 0);
+  res&= !set_alloc_root_huge_pages(&root,
+                                   MY_HUGE_PAGES | MY_HUGE_PAGES_RESERVED);
+  res&= !set_alloc_root_limit(&root, page * 3, 0, 0);
+  while (alloc_root(&root, 1000))
+    ;
+  res&= alloc_root_allocated(&root) <= page * 3 &&
+        alloc_root_allocated(&root) > page * 2;
+  free_root(&root, MYF(0));
+  ok(res, "huge pages, %lu bytes each: %u blocks", (ulong) page, blocks);
+}
+
+
+static double bench_rate(ulonglong start)
+{
+  return (double) BENCH_COUNT * BENCH_ROUNDS /
+         ((double) (my_getsystime() - start + 1) / 10.0);
+}
+
+/*
+  Allocation rate in million objects per second, for the two objects
+  per row of a stored result.
+*/
+
+static void run_benchmark(void)
+{
+  MEM_ROOT root;
+  void **objects= malloc(BENCH_COUNT * sizeof(void*));
+  ulonglong start;
+  double inline_rate, call_rate, malloc_rate;
+  uint i, round;
+
+  init_alloc_root(&root, 8192, 0);
+  root.min_malloc= 24;
+  start= my_getsystime();
+  for (round= 0; round < BENCH_ROUNDS; round++)
+  {
+    for (i= 0; i < BENCH_COUNT; i+= 2)
+    {
+      objects[i]= alloc_root_inline(&root, 24);
+      objects[i + 1]= alloc_root_inline(&root, 40 + (i & 63));
+    }
+    free_root(&root, MYF(MY_MARK_BLOCKS_FREE));
+  }
+  inline_rate= bench_rate(start);
+
+  start= my_getsystime();
+  for (round= 0; round < BENCH_ROUNDS; round++)
+  {
+    for (i= 0; i < BENCH_COUNT; i+= 2)
+    {
+      objects[i]= alloc_root(&root, 24);
+      objects[i + 1]= alloc_root(&root, 40 + (i & 63));
+    }
+    free_root(&root, MYF(MY_MARK_BLOCKS_FREE));
+  }
+  call_rate= bench_rate(start);
+  free_root(&root, MYF(0));
+
+  start= my_getsystime();
+  for (round= 0; round < BENCH_ROUNDS; round++)
+  {
+    for (i= 0; i < BENCH_COUNT; i+= 2)
+    {
+      objects[i]= malloc(24);
+      objects[i + 1]= malloc(40 + (i & 63));
+    }
+    for (i= 0; i < BENCH_COUNT; i++)
+      free(objects[i]);
+  }
+  malloc_rate= bench_rate(start);
+
+  diag("alloc_root_inline %6.1f M/s, alloc_root %6.1f M/s "
+       "(malloc and free: %6.1f M/s)", inline_rate, call_rate, malloc_rate);
+  free(objects);
+}
+
+
+/*
+  Result sets per second for small result sets, which are stored in a
+  new root each and freed again, with and without a block cache.
+*/
+
+static double bench_results(ALLOC_ROOT_CACHE *cache)
+{
+  MEM_ROOT root;
+  ulonglong start= my_getsystime();
+  uint i, row;
+
+  for (i= 0; i < BENCH_RESULTS; i++)
+  {
+    init_alloc_root(&root, 8192, 0);
+    root.min_malloc= 24;
+    if (cache)
+      set_alloc_root_cache(&root, cache);
+    for (row= 0; row < BENCH_RESULT_ROWS; row++)
+    {
+      alloc_root_inline(&root, 24);
+      alloc_root_inline(&root, 40 + (row & 255));
+    }
+    free_root(&root, MYF(0));
+  }
+  return (double) BENCH_RESULTS /
+         ((double) (my_getsystime() - start + 1) / 10000000.0);
+}
+
+/*
+  Rows of a large stored result read in random order, as seeking in it
+  would, where nearly every row is on another page. With huge pages the
+  pages of the rows fit in the TLB. The kernel tells how much is on
+  transparent huge pages in AnonHugePages of /proc/self/smaps.
+*/
+
+static ulong anon_huge_pages(void)
+{
+  FILE *f= fopen("/proc/self/smaps_rollup", "r");
+  char buf[256];
+  ulong kb= 0;
+  if (!f)
+    return 0;
+  while (fgets(buf, sizeof(buf), f))
+    if (sscanf(buf, "AnonHugePages: %lu kB", &kb) == 1)
+      break;
+  fclose(f);
+  return kb;
+}
+
+static double bench_scan(myf huge_pages, ulong *huge_kb)
+{
+  MEM_ROOT root;
+  uint rows= BENCH_SCAN_SIZE / BENCH_SCAN_ROW, i;
+  uchar **objects= malloc(rows * sizeof(uchar*));
+  ulonglong start, sum= 0;
+  ulong huge_before= anon_huge_pages();
+
+  init_alloc_root(&root, 8192, 0);
+  set_alloc_root_huge_pages(&root, huge_pages);
+  for (i= 0; i < rows; i++)
+  {
+    objects[i]= alloc_root_inline(&root, BENCH_SCAN_ROW);
+    memset(objects[i], (uchar) i, BENCH_SCAN_ROW);
+  }
+  /* Shuffle, so that the rows are read all over the root */
+  for (i= rows - 1; i > 0; i--)
+  {
+    uint j= (uint) (((ulonglong) rand() * RAND_MAX + rand()) % (i + 1));
+    uchar *tmp= objects[i];
+    objects[i]= objects[j];
+    objects[j]= tmp;
+  }
+  *huge_kb= anon_huge_pages() - huge_before;
+  start= my_getsystime();
+  for (i= 0; i < rows; i++)
+    sum+= objects[i][i & (BENCH_SCAN_ROW - 1)];
+  start= my_getsystime() - start + 1;
+  free_root(&root, MYF(0));
+  free(objects);
+  if (sum == 1)
+    diag("never");                              /* Use sum */
+  return (double) rows / ((double) start / 10.0);
+}
+
+static void run_scan_benchmark(void)
+{
+  ulong plain_kb, huge_kb;
+  double plain= bench_scan(0, &plain_kb);
+  double huge= bench_scan(MY_HUGE_PAGES, &huge_kb);
+  diag("random reads of %luM of rows: %6.1f M/s, with huge pages %6.1f M/s "
+       "(%luM on huge pages)", BENCH_SCAN_SIZE / (1024 * 1024L), plain, huge,
+       huge_kb / 1024);
+}
+
+
+static void run_cache_benchmark(void)
+{
+  ALLOC_ROOT_CACHE *cache= create_alloc_root_cache(256 * 1024);
+  double plain= bench_results(0), cached= bench_results(cache);
+  diag("%u row result sets: %8.0f/s, with a block cache %8.0f/s",
+       BENCH_RESULT_ROWS, plain, cached);
+  release_alloc_root_cache(cache);
+}
+
+
+int main(void)
+{
+  MY_INIT("my_alloc-t");
+
+  plan(7);
+
+  test_objects();
+  test_limit();
+  test_growth();
+  test_cache();
+  test_huge_pages();
+
+  if (getenv("MYTAP_BENCHMARK"))
+  {
+    run_benchmark();
+    run_cache_benchmark();
+    run_scan_benchmark();
+  }
+
+  my_end(0);
+  return exit_status();
+}
@@ -0,0 +1,348 @@
+/* Copyright (C) 2026 MySQL Connector/C contributors
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA */
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <m_ctype.h>
+#include <tap.h>
+#include <string.h>
+
+#define BENCH_COUNT  1000000
+#define BENCH_ROUNDS 10
+#define THREADS 8
+#define THREAD_BLOCKS 1000
+
+/* An allocator that counts what goes through it */
+
+typedef struct st_test_context
+{
+  size_t bytes;
+  uint blocks, mallocs, reallocs, frees;
+  uint category_blocks[MY_MEMORY_CATEGORIES];
+  my_bool fail;
+} TEST_CONTEXT;
+
+static void *test_malloc(void *context, size_t size, uint category)
+{
+  TEST_CONTEXT *ctx= (TEST_CONTEXT*) context;
+  size_t *block;
+  if (ctx->fail || !(block= (size_t*) malloc(size + sizeof(double))))
+    return 0;
+  *block= size;
+  ctx->bytes+= size;
+  ctx->blocks++;
+  ctx->mallocs++;
+  ctx->category_blocks[category]++;
+  return (double*) block + 1;
+}
+
+static void *test_realloc(void *context, void *ptr, size_t size,
+                          uint category __attribute__((unused)))
+{
+  TEST_CONTEXT *ctx= (TEST_CONTEXT*) context;
+  size_t *block= (size_t*) ((double*) ptr - 1), old_size= *block;
+  if (ctx->fail || !(block= (size_t*) realloc(block, size + sizeof(double))))
+    return 0;
+  *block= size;
+  ctx->bytes+= size - old_size;
+  ctx->reallocs++;
+  return (double*) block + 1;
+}
+
+static void test_free(void *context, void *ptr, size_t size, uint category)
+{
+  TEST_CONTEXT *ctx= (TEST_CONTEXT*) context;
+  size_t *block= (size_t*) ((double*) ptr - 1);
+  if (*block != size)
+    diag("free of %lu bytes, allocated %lu", (ulong) size, (ulong) *block);
+  ctx->bytes-= *block;
+  ctx->blocks--;
+  ctx->frees++;
+  ctx->category_blocks[category]--;
+  free(block);
+}
+
+
+static void test_allocator(void)
+{
+  TEST_CONTEXT ctx1, ctx2;
+  MY_ALLOCATOR alloc1, alloc2;
+  MEM_ROOT root;
+  uchar *a, *b, *c;
+  int res;
+
+  bzero(&ctx1, sizeof(ctx1));
+  bzero(&ctx2, sizeof(ctx2));
+  alloc1.malloc_func= alloc2.malloc_func= test_malloc;
+  alloc1.realloc_func= alloc2.realloc_func= test_realloc;
+  alloc1.free_func= alloc2.free_func= test_free;
+  alloc1.context= &ctx1;
+  alloc2.context= &ctx2;
+
+  res= !my_set_allocator(&alloc1);
+  a= my_malloc(100, MYF(MY_ZEROFILL | MY_MEM_NET));
+  b= (uchar*) my_strdup("allocator", MYF(0));
+  init_alloc_root(&root, 1024, 0);
+  alloc_root(&root, 2000);
+  res&= a && b && !a[0] && !a[99] && !strcmp((char*) b, "allocator");
+  res&= ctx1.blocks == 3 && ctx1.category_blocks[MY_MEMORY_NET] == 1 &&
+        ctx1.category_blocks[MY_MEMORY_ROOT] == 1;
+
+  /* Blocks go back to where they came from after a switch */
+  res&= !my_set_allocator(&alloc2);
+  c= my_malloc(10, MYF(0));
+  a= my_realloc(a, 100000, MYF(0));
+  res&= a && !a[99];
+  my_free(b, MYF(0));
+  free_root(&root, MYF(0));
+  res&= ctx1.blocks == 1 && ctx1.reallocs == 1 && ctx2.blocks == 1;
+  my_free(a, MYF(0));
+  my_free(c, MYF(0));
+  res&= !ctx1.blocks && !ctx1.bytes && !ctx2.blocks && !ctx2.bytes;
+
+  /* Installing the same allocator again does not take a new slot */
+  res&= !my_set_allocator(&alloc1) && !my_set_allocator(&alloc2) &&
+        !my_set_allocator(&alloc1);
+  alloc1.free_func= 0;
+  res&= my_set_allocator(&alloc1) != 0;
+  res&= !my_set_allocator(0);
+  a= my_malloc(10, MYF(0));
+  my_free(a, MYF(0));
+  res&= ctx1.mallocs == 3 && ctx2.mallocs == 1;
+  ok(res, "allocator callbacks");
+
+  /* Failures of the allocator are failures of my_malloc() */
+  res= !my_set_allocator(&alloc2);
+  ctx2.fail= 1;
+  a= my_malloc(10, MYF(0));
+  res&= !a;
+  ctx2.fail= 0;
+  a= my_malloc(10, MYF(0));
+  ctx2.fail= 1;
+  res&= my_realloc(a, 1000, MYF(MY_HOLD_ON_ERROR)) == a;
+  ctx2.fail= 0;
+  my_free(a, MYF(0));
+  res&= !ctx2.blocks && !my_set_allocator(0);
+  ok(res, "allocator failures");
+}
+
+
+static void test_stats(void)
+{
+  MY_MEMORY_STATS before, after;
+  uchar *a, *b;
+  int res;
+
+  my_get_memory_stats(&before);
+  a= my_malloc(1000, MYF(MY_MEM_RESULT));
+  b= my_malloc(500, MYF(MY_MEM_STATEMENT));
+  b= my_realloc(b, 5000, MYF(MY_MEM_STATEMENT));
+  my_get_memory_stats(&after);
+  res= after.bytes[MY_MEMORY_RESULT] - before.bytes[MY_MEMORY_RESULT] == 1000;
+  res&= after.bytes[MY_MEMORY_STATEMENT] -
+        before.bytes[MY_MEMORY_STATEMENT] == 5000;
+  res&= after.allocations[MY_MEMORY_RESULT] -
+        before.allocations[MY_MEMORY_RESULT] == 1;
+  my_free(a, MYF(0));
+  my_free(b, MYF(0));
+  my_get_memory_stats(&after);
+  res&= after.bytes[MY_MEMORY_RESULT] == before.bytes[MY_MEMORY_RESULT] &&
+        after.bytes[MY_MEMORY_STATEMENT] ==
+        before.bytes[MY_MEMORY_STATEMENT];
+  ok(res, "bytes by category");
+}
+
+
+static void test_peak(void)
+{
+  MY_MEMORY_STATS before, after;
+  uchar *a;
+  int res;
+
+  my_get_memory_stats(&before);
+  a= my_malloc(1024 * 1024, MYF(MY_MEM_RESULT));
+  my_free(a, MYF(0));
+  my_get_memory_stats(&after);
+  res= after.bytes[MY_MEMORY_RESULT] == before.bytes[MY_MEMORY_RESULT];
+  res&= after.peak[MY_MEMORY_RESULT] >= before.bytes[MY_MEMORY_RESULT] +
+                                        1024 * 1024;
+  res&= after.peak[MY_MEMORY_RESULT] >= before.peak[MY_MEMORY_RESULT];
+  ok(res, "peak of a category");
+
+  /* Character sets are loaded into memory that is kept until my_end() */
+  res= get_charset_by_name("latin2_czech_cs", MYF(0)) != 0;
+  my_get_memory_stats(&after);
+  ok(res && after.bytes[MY_MEMORY_CHARSET] > before.bytes[MY_MEMORY_CHARSET],
+     "character sets");
+}
+
+
+/*
+  Threads allocate and free in their own counters, and keep some
+  blocks which are freed by the main thread after they have ended.
+*/
+
+static uchar *thread_blocks[THREADS];
+
+pthread_handler_t memory_thread(void *arg)
+{
+  uint n= (uint) (size_t) arg, i;
+  uchar *block;
+
+  my_thread_init();
+  for (i= 0; i < THREAD_BLOCKS; i++)
+  {
+    block= my_malloc(1000, MYF(MY_MEM_STATEMENT));
+    my_free(block, MYF(0));
+  }
+  thread_blocks[n]= my_malloc(100000, MYF(MY_MEM_STATEMENT));
+  my_thread_end();
+  return 0;
+}
+
+static void test_threads(void)
+{
+  MY_MEMORY_STATS before, during, after;
+  pthread_t threads[THREADS];
+  uint i;
+  int res;
+
+  my_get_memory_stats(&before);
+  for (i= 0; i < THREADS; i++)
+    pthread_create(&threads[i], 0, memory_thread, (void*) (size_t) i);
+  for (i= 0; i < THREADS; i++)
+    pthread_join(threads[i], 0);
+  my_get_memory_stats(&during);
+  for (i= 0; i < THREADS; i++)
+    my_free(thread_blocks[i], MYF(0));
+  my_get_memory_stats(&after);
+  res= during.bytes[MY_MEMORY_STATEMENT] -
+       before.bytes[MY_MEMORY_STATEMENT] == THREADS * 100000;
+  res&= during.allocations[MY_MEMORY_STATEMENT] -
+        before.allocations[MY_MEMORY_STATEMENT] ==
+        THREADS * (THREAD_BLOCKS + 1);
+  res&= after.bytes[MY_MEMORY_STATEMENT] == before.bytes[MY_MEMORY_STATEMENT];
+  ok(res, "counters of %u threads", THREADS);
+}
+
+
+/*
+  Blocks of a huge page or more with MY_HUGE_PAGES are mapped aligned on
+  huge pages, where mmap() is available, and don't go through the
+  allocator.
+*/
+
+static void test_huge_pages(void)
+{
+  TEST_CONTEXT ctx;
+  MY_ALLOCATOR alloc;
+  MY_MEMORY_STATS before, after;
+  size_t page= my_huge_page_size(), i;
+  uchar *a, *b;
+  int res;
+
+  bzero(&ctx, sizeof(ctx));
+  alloc.malloc_func= test_malloc;
+  alloc.realloc_func= test_realloc;
+  alloc.free_func= test_free;
+  alloc.context= &ctx;
+  my_get_memory_stats(&before);
+  res= !my_set_allocator(&alloc);
+
+  /* Too small for huge pages at first */
+  a= my_malloc(1000, MYF(MY_HUGE_PAGES | MY_MEM_RESULT));
+  memset(a, 'a', 1000);
+  res&= a && ctx.blocks == 1;
+  a= my_realloc(a, page * 2, MYF(MY_HUGE_PAGES));
+  res&= a && ctx.blocks == 0 && a[0] == 'a' && a[999] == 'a';
+  memset(a, 'b', page * 2);
+  a= my_realloc(a, page * 5, MYF(MY_HUGE_PAGES));
+  res&= a && a[0] == 'b' && a[page * 2 - 1] == 'b';
+  a= my_realloc(a, page, MYF(MY_HUGE_PAGES));
+  b= my_malloc(page * 3, MYF(MY_HUGE_PAGES | MY_HUGE_PAGES_RESERVED));
+  res&= b != 0;
+  for (i= 0; i < page * 3; i+= 4096)
+    b[i]= 1;
+#if defined(__linux__)
+  res&= ((size_t) a & (page - 1)) < 64 && ((size_t) b & (page - 1)) < 64;
+#endif
+  my_get_memory_stats(&after);
+  res&= after.bytes[MY_MEMORY_RESULT] - before.bytes[MY_MEMORY_RESULT] == page;
+  my_free(a, MYF(0));
+  my_free(b, MYF(0));
+  res&= ctx.blocks == 0 && ctx.mallocs == 1 && !my_set_allocator(0);
+  ok(res, "huge pages of %lu bytes", (ulong) page);
+}
+
+
+static double bench_rate(ulonglong start)
+{
+  return (double) BENCH_COUNT * BENCH_ROUNDS /
+         ((double) (my_getsystime() - start + 1) / 10.0);
+}
+
+/* Allocations and frees in million per second */
+
+static void run_benchmark(void)
+{
+  void **objects= malloc(BENCH_COUNT * sizeof(void*));
+  ulonglong start;
+  double my_rate, malloc_rate;
+  uint i, round;
+
+  start= my_getsystime();
+  for (round= 0; round < BENCH_ROUNDS; round++)
+  {
+    for (i= 0; i < BENCH_COUNT; i++)
+      objects[i]= my_malloc(24 + (i & 63), MYF(MY_MEM_RESULT));
+    for (i= 0; i < BENCH_COUNT; i++)
+      my_free(objects[i], MYF(0));
+  }
+  my_rate= bench_rate(start);
+
+  start= my_getsystime();
+  for (round= 0; round < BENCH_ROUNDS; round++)
+  {
+    for (i= 0; i < BENCH_COUNT; i++)
+      objects[i]= malloc(24 + (i & 63));
+    for (i= 0; i < BENCH_COUNT; i++)
+      free(objects[i]);
+  }
+  malloc_rate= bench_rate(start);
+
+  diag("my_malloc and my_free %6.1f M/s (malloc and free: %6.1f M/s)",
+       my_rate, malloc_rate);
+  free(objects);
+}
+
+
+int main(void)
+{
+  MY_INIT("my_malloc-t");
+
+  plan(7);
+
+  test_allocator();
+  test_stats();
+  test_peak();
+  test_threads();
+  test_huge_pages();
+
+  if (getenv("MYTAP_BENCHMARK"))
+    run_benchmark();
+
+  my_end(0);
+  return exit_status();
+}
@@ -0,0 +1,273 @@
+/* Copyright (C) 2026 MySQL Connector/C contributors
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA */
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <m_string.h>
+#include <tap.h>
+#include <string.h>
+
+#define RANDOM_COUNT 200000
+#define BATCH_SIZE   100
+#define BENCH_COUNT  4096
+#define BENCH_ROUNDS 250
+
+/*
+  A character at a time version of my_strtoll10() for numbers of up to
+  19 significant digits, which the results are compared against.
+*/
+
+static longlong ref_strtoll10(const char *nptr, const char *end,
+                              const char **stop, int *error)
+{
+  const char *s= nptr;
+  ulonglong value= 0;
+  int negative= 0;
+
+  while (s != end && (*s == ' ' || *s == '\t'))
+    s++;
+  if (s == end)
+    goto no_conv;
+  *error= 0;
+  if (*s == '-' || *s == '+')
+  {
+    if ((negative= *s == '-'))
+      *error= -1;
+    if (++s == end)
+      goto no_conv;
+  }
+  if (*s < '0' || *s > '9')
+    goto no_conv;
+  for (; s != end && *s >= '0' && *s <= '9'; s++)
+    value= value * 10 + *s - '0';
+  *stop= s;
+  if (negative && value > (ulonglong) LONGLONG_MAX + 1)
+  {
+    *error= MY_ERRNO_ERANGE;
+    return LONGLONG_MIN;
+  }
+  return negative ? -(longlong) value : (longlong) value;
+
+no_conv:
+  *error= MY_ERRNO_EDOM;
+  *stop= nptr;
+  return 0;
+}
+
+
+/* A random number with blanks, sign, leading zeros and trailing junk */
+
+static size_t random_number(char *to)
+{
+  static const char *prefix[]= { "", "", "", " ", "\t  " };
+  static const char *sign[]= { "", "", "-", "+" };
+  static const char *suffix[]= { "", "", "", "x", ".5", " ", "e3", "-" };
+  char *pos= to;
+  int i, digits= rand() % 20, zeros= rand() % 4 ? 0 : rand() % 4;
+
+  pos= strmov(pos, prefix[rand() % array_elements(prefix)]);
+  pos= strmov(pos, sign[rand() % array_elements(sign)]);
+  for (i= 0; i < zeros; i++)
+    *pos++= '0';
+  for (i= 0; i < digits; i++)
+    *pos++= (char) ('0' + (i || zeros ? rand() % 10 : rand() % 9 + 1));
+  pos= strmov(pos, suffix[rand() % array_elements(suffix)]);
+  return (size_t) (pos - to);
+}
+
+
+static int compare_one(const char *str, size_t length)
+{
+  char *end= (char*) str + length;
+  const char *ref_end;
+  int error, ref_error;
+  longlong value= my_strtoll10(str, &end, &error);
+  longlong ref= ref_strtoll10(str, str + length, &ref_end, &ref_error);
+  if (value != ref || error != ref_error || end != ref_end)
+  {
+    diag("'%.*s': %lld error %d length %d, expected %lld error %d length %d",
+         (int) length, str, value, error, (int) (end - str), ref, ref_error,
+         (int) (ref_end - str));
+    return 0;
+  }
+  return 1;
+}
+
+
+static void test_random(void)
+{
+  int i, failed= 0;
+  for (i= 0; i < RANDOM_COUNT && failed < 10; i++)
+  {
+    char str[64];
+    size_t length= random_number(str);
+    str[length]= 0;
+    failed+= !compare_one(str, length);
+    /* the end may also be in the middle of the number */
+    if (length)
+      failed+= !compare_one(str, rand() % length);
+  }
+  ok(!failed, "random numbers");
+}
+
+
+/* Numbers the fast path leaves to the character at a time code */
+
+static void test_overflow(void)
+{
+  static const struct
+  {
+    const char *str;
+    longlong value;
+    int error;
+  } tests[]=
+  {
+    { "18446744073709551615", (longlong) ~(ulonglong) 0, 0 },
+    { "18446744073709551616", (longlong) ~(ulonglong) 0, MY_ERRNO_ERANGE },
+    { "123456789012345678901", (longlong) ~(ulonglong) 0, MY_ERRNO_ERANGE },
+    { "-9223372036854775808", LONGLONG_MIN, -1 },
+    { "-9223372036854775809", LONGLONG_MIN, MY_ERRNO_ERANGE },
+    { "9999999999999999", 9999999999999999LL, 0 },
+    { "-999999999999999999", -999999999999999999LL, -1 },
+    { "000000000000000000000000000042", 42, 0 },
+    { "-0", 0, -1 },
+    { "+", 0, MY_ERRNO_EDOM },
+    { "  ", 0, MY_ERRNO_EDOM }
+  };
+  uint i;
+  int failed= 0;
+  for (i= 0; i < array_elements(tests); i++)
+  {
+    char *end= (char*) tests[i].str + strlen(tests[i].str);
+    int error, error2;
+    longlong value= my_strtoll10(tests[i].str, &end, &error);
+    longlong value2= my_strtoll10(tests[i].str, NULL, &error2);
+    if (value != tests[i].value || error != tests[i].error ||
+        value2 != value || error2 != error)
+    {
+      diag("'%s': %lld error %d, expected %lld error %d", tests[i].str,
+           value, error, tests[i].value, tests[i].error);
+      failed++;
+    }
+  }
+  ok(!failed, "overflow and edge cases");
+}
+
+
+static void test_batch(void)
+{
+  char buf[BATCH_SIZE][64];
+  const char *strs[BATCH_SIZE];
+  char *ends[BATCH_SIZE];
+  longlong values[BATCH_SIZE];
+  int errors[BATCH_SIZE], i, failed= 0;
+
+  for (i= 0; i < BATCH_SIZE; i++)
+  {
+    size_t length= random_number(buf[i]);
+    strs[i]= rand() % 10 ? buf[i] : NULL;
+    ends[i]= buf[i] + length;
+  }
+  my_strtoll10_batch(strs, ends, values, errors, BATCH_SIZE);
+  for (i= 0; i < BATCH_SIZE; i++)
+  {
+    if (strs[i])
+    {
+      char *end= buf[i] + strlen(buf[i]);
+      int error;
+      longlong value= my_strtoll10(buf[i], &end, &error);
+      failed+= value != values[i] || error != errors[i] || end != ends[i];
+    }
+    else
+      failed+= values[i] != 0 || errors[i] != MY_ERRNO_EDOM;
+  }
+  ok(!failed, "batch conversion");
+}
+
+
+static void run_benchmark(uint max_bits, const char *name)
+{
+  char *buf= malloc(BENCH_COUNT * 24);
+  const char **strs= malloc(BENCH_COUNT * sizeof(char*));
+  char **ends= malloc(BENCH_COUNT * sizeof(char*));
+  longlong *values= malloc(BENCH_COUNT * sizeof(longlong));
+  int *errors= malloc(BENCH_COUNT * sizeof(int)), i, round, error;
+  volatile longlong sum= 0;
+  ulonglong start, fast, slow, batch;
+
+  /* with a leading 0 in front for the character at a time run */
+  for (i= 0; i < BENCH_COUNT; i++)
+  {
+    char *pos= buf + i * 24;
+    ulonglong value= ((ulonglong) rand() << 31 | (ulonglong) rand()) %
+                     (1ULL << (rand() % max_bits + 1));
+    pos[0]= '0';
+    ends[i]= longlong10_to_str((longlong) value, pos + 1, 10);
+    strs[i]= pos + 1;
+  }
+
+  start= my_getsystime();
+  for (round= 0; round < BENCH_ROUNDS; round++)
+    for (i= 0; i < BENCH_COUNT; i++)
+    {
+      char *end= ends[i];
+      sum+= my_strtoll10(strs[i], &end, &error);
+    }
+  fast= my_getsystime() - start + 1;
+  start= my_getsystime();
+  for (round= 0; round < BENCH_ROUNDS; round++)
+    for (i= 0; i < BENCH_COUNT; i++)
+    {
+      char *end= ends[i];
+      sum+= my_strtoll10(strs[i] - 1, &end, &error);
+    }
+  slow= my_getsystime() - start + 1;
+  start= my_getsystime();
+  for (round= 0; round < BENCH_ROUNDS; round++)
+    my_strtoll10_batch(strs, ends, values, errors, BENCH_COUNT);
+  batch= my_getsystime() - start + 1;
+
+  diag("%-6s %5.1f ns per number, batch %5.1f ns "
+       "(character at a time: %5.1f ns)", name,
+       fast * 100.0 / BENCH_COUNT / BENCH_ROUNDS,
+       batch * 100.0 / BENCH_COUNT / BENCH_ROUNDS,
+       slow * 100.0 / BENCH_COUNT / BENCH_ROUNDS);
+  free(buf);
+  free(strs);
+  free(ends);
+  free(values);
+  free(errors);
+}
+
+
+int main(void)
+{
+  MY_INIT("strtoll10-t");
+
+  plan(3);
+
+  test_random();
+  test_overflow();
+  test_batch();
+
+  if (getenv("MYTAP_BENCHMARK"))
+  {
+    run_benchmark(31, "INT");
+    run_benchmark(62, "BIGINT");
+  }
+
+  my_end(0);
+  return exit_status();
+}